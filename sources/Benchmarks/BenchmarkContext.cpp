@@ -0,0 +1,41 @@
+/**************************************************************************
+ *   Created: 2026/10/17 03:45:30
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "BenchmarkContext.hpp"
+
+using namespace trdk;
+using namespace trdk::Lib;
+using namespace trdk::Tests;
+
+Benchmarks::Context &Benchmarks::Context::GetInstance() {
+  static Benchmarks::Context result;
+  return result;
+}
+
+DropCopy *Benchmarks::Context::GetDropCopy() const { return nullptr; }
+
+namespace {
+MarketDataSource &GetMarketDataSource() {
+  static Dummies::MarketDataSource result(&Benchmarks::Context::GetInstance());
+  return result;
+}
+}  // namespace
+
+Benchmarks::Security::Security(const char *symbol)
+    : trdk::Security(Context::GetInstance(),
+                     Symbol(symbol),
+                     GetMarketDataSource(),
+                     SupportedLevel1Types()) {}
+
+std::unique_ptr<Benchmarks::Security> Benchmarks::CreateSecurity(
+    const char *symbol) {
+  return boost::make_unique<Security>(symbol);
+}
@@ -0,0 +1,47 @@
+/**************************************************************************
+ *   Created: 2026/10/17 03:45:30
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#pragma once
+
+#include "Core/ContextDummy.hpp"
+#include "Core/MarketDataSourceDummy.hpp"
+#include "Core/Security.hpp"
+
+namespace trdk {
+namespace Benchmarks {
+
+//! Dummy context without drop copy, so market data could be set.
+class Context : public Tests::Dummies::Context {
+ public:
+  Context() = default;
+  ~Context() override = default;
+
+  static Context &GetInstance();
+
+  DropCopy *GetDropCopy() const override;
+};
+
+//! Security with market data setters which are available for benchmarks.
+class Security : public trdk::Security {
+ public:
+  explicit Security(const char *symbol);
+  ~Security() override = default;
+
+  using trdk::Security::SetBook;
+  using trdk::Security::SetLevel1;
+};
+
+//! Creates security of the benchmark context with all Level 1 types
+//! unsupported, so Level 1 is started at the first update.
+std::unique_ptr<Security> CreateSecurity(
+    const char *symbol = "BTC_USD::CRYPTO");
+
+}  // namespace Benchmarks
+}  // namespace trdk
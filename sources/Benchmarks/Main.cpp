@@ -0,0 +1,36 @@
+/**************************************************************************
+ *   Created: 2026/10/17 03:43:17
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+
+int main(int argc, char **argv) {
+  std::vector<char *> args(argv, argv + argc);
+
+  // Results are written into the JSON-file with the build identity in the
+  // name if other output is not set, so results of different builds could be
+  // compared by the Google Benchmark tool "compare.py".
+  std::string out = "--benchmark_out=" TRDK_BENCHMARKS_FILE_NAME
+                    "." TRDK_BUILD_IDENTITY ".json";
+  std::string outFormat = "--benchmark_out_format=json";
+  if (std::none_of(args.cbegin(), args.cend(), [](const char *arg) {
+        return boost::starts_with(arg, "--benchmark_out=");
+      })) {
+    args.emplace_back(&out[0]);
+    args.emplace_back(&outFormat[0]);
+  }
+
+  auto numberOfArgs = static_cast<int>(args.size());
+  benchmark::Initialize(&numberOfArgs, args.data());
+  if (benchmark::ReportUnrecognizedArguments(numberOfArgs, args.data())) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
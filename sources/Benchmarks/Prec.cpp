@@ -0,0 +1,11 @@
+/**************************************************************************
+ *   Created: 2026/10/17 03:41:52
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
@@ -0,0 +1,37 @@
+/**************************************************************************
+ *   Created: 2026/10/17 03:41:52
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#pragma once
+
+#include "Common/Common.hpp"
+// Interaction/FixProtocol sources which are compiled into benchmarks:
+#include "Core/MarketDataSource.hpp"
+#include "Core/Module.hpp"
+#include "Core/Security.hpp"
+#include "Core/Settings.hpp"
+#include "Core/Trade.hpp"
+#include "Core/TradingLog.hpp"
+#include "Core/TradingSystem.hpp"
+#include "Core/TransactionContext.hpp"
+#include "TradingLib/PriceBookBuilder.hpp"
+#include "Interaction/FixProtocol/Api.h"
+#include "Interaction/FixProtocol/Fwd.hpp"
+#include "Common/NetworkStreamClient.hpp"
+#include "Common/NetworkStreamClientService.hpp"
+#include <boost/algorithm/string.hpp>
+#include <boost/bind.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/random.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/variant.hpp>
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
@@ -0,0 +1,194 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 23:31:05
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Clock.hpp"
+#if defined(BOOST_MSVC)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#ifndef BOOST_WINDOWS
+#include <time.h>
+#endif
+
+using namespace trdk;
+using namespace trdk::Lib;
+
+namespace pt = boost::posix_time;
+namespace ch = boost::chrono;
+
+namespace {
+
+bool CheckInvariantTsc() {
+#if defined(BOOST_MSVC)
+  int info[4] = {};
+  __cpuid(info, 0x80000000);
+  if (static_cast<unsigned int>(info[0]) < 0x80000007) {
+    return false;
+  }
+  __cpuid(info, 0x80000007);
+  return (info[3] & (1 << 8)) != 0;
+#elif defined(__x86_64__) || defined(__i386__)
+  unsigned int eax = 0;
+  unsigned int ebx = 0;
+  unsigned int ecx = 0;
+  unsigned int edx = 0;
+  if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+    return false;
+  }
+  return (edx & (1 << 8)) != 0;
+#else
+  return false;
+#endif
+}
+
+intmax_t GetMonotonicNanoseconds() {
+#ifdef BOOST_WINDOWS
+  return ch::duration_cast<ch::nanoseconds>(
+             ch::steady_clock::now().time_since_epoch())
+      .count();
+#else
+  timespec result;
+  Verify(clock_gettime(CLOCK_MONOTONIC_RAW, &result) == 0);
+  return static_cast<intmax_t>(result.tv_sec) * 1000000000 + result.tv_nsec;
+#endif
+}
+
+Clock::Ticks ReadTsc() {
+#if defined(BOOST_MSVC) || defined(__x86_64__) || defined(__i386__)
+  return static_cast<Clock::Ticks>(__rdtsc());
+#else
+  AssertFail("Time-stamp counter is not supported.");
+  return GetMonotonicNanoseconds();
+#endif
+}
+
+double CalibrateNanosecondsPerTick() {
+  if (!Clock::HasInvariantTsc()) {
+    return 1;
+  }
+  // The error of the monotonic clock reading is fixed, so the longer period
+  // gives the smaller relative error.
+  const auto startTicks = ReadTsc();
+  const auto startTime = GetMonotonicNanoseconds();
+  auto time = startTime;
+  while (time - startTime < 50000000) {
+    time = GetMonotonicNanoseconds();
+  }
+  return static_cast<double>(time - startTime) / (ReadTsc() - startTicks);
+}
+
+double GetNanosecondsPerTick() {
+  static const double result = CalibrateNanosecondsPerTick();
+  return result;
+}
+}  // namespace
+
+bool Clock::HasInvariantTsc() {
+  static const bool result = CheckInvariantTsc();
+  return result;
+}
+
+Clock::Ticks Clock::GetTicks() {
+  return HasInvariantTsc() ? ReadTsc() : GetMonotonicNanoseconds();
+}
+
+intmax_t Clock::ConvertToNanoseconds(const Ticks &ticks) {
+  return static_cast<intmax_t>(ticks * GetNanosecondsPerTick());
+}
+
+Clock::Clock(const Source &source, const pt::time_duration &anchoringPeriod)
+    : m_source(source == SOURCE_TSC && !HasInvariantTsc() ? SOURCE_MONOTONIC
+                                                          : source),
+      m_startTime(pt::microsec_clock::universal_time()),
+      m_anchoringPeriod(0),
+      m_offset(0),
+      m_nextAnchoringTicks(0) {
+  if (m_source == SOURCE_SYSTEM) {
+    return;
+  }
+  m_anchoringPeriod = static_cast<Ticks>(
+      anchoringPeriod.total_nanoseconds() /
+      (m_source == SOURCE_TSC ? GetNanosecondsPerTick() : 1));
+  m_nextAnchoringTicks = ReadTicks() + m_anchoringPeriod;
+  Anchor();
+}
+
+Clock::Ticks Clock::ReadTicks() const {
+  AssertNe(SOURCE_SYSTEM, m_source);
+  return m_source == SOURCE_TSC ? GetTicks() : GetMonotonicNanoseconds();
+}
+
+intmax_t Clock::ConvertTicksToNanoseconds(const Ticks &ticks) const {
+  AssertNe(SOURCE_SYSTEM, m_source);
+  return m_source == SOURCE_TSC ? ConvertToNanoseconds(ticks) : ticks;
+}
+
+void Clock::Anchor() const {
+  // Takes the system time between two ticks reads to halve the error.
+  const auto startTicks = ReadTicks();
+  const auto &time = pt::microsec_clock::universal_time();
+  const auto endTicks = ReadTicks();
+  m_offset.store(
+      (time - m_startTime).total_nanoseconds() -
+          ConvertTicksToNanoseconds(startTicks + (endTicks - startTicks) / 2),
+      boost::memory_order_relaxed);
+}
+
+pt::ptime Clock::GetUniversalTime() const {
+  if (m_source == SOURCE_SYSTEM) {
+    return pt::microsec_clock::universal_time();
+  }
+  const auto ticks = ReadTicks();
+  auto nextAnchoringTicks =
+      m_nextAnchoringTicks.load(boost::memory_order_relaxed);
+  if (ticks >= nextAnchoringTicks &&
+      m_nextAnchoringTicks.compare_exchange_strong(
+          nextAnchoringTicks, ticks + m_anchoringPeriod,
+          boost::memory_order_relaxed)) {
+    // Only one thread anchors the clock, others use the previous anchor.
+    Anchor();
+  }
+  return m_startTime +
+         pt::microseconds(
+             (m_offset.load(boost::memory_order_relaxed) +
+              ConvertTicksToNanoseconds(ticks)) /
+             1000);
+}
+
+const char *Lib::ConvertToPch(const Clock::Source &source) {
+  static_assert(Clock::numberOfSources == 3, "List changed.");
+  switch (source) {
+    case Clock::SOURCE_SYSTEM:
+      return "system";
+    case Clock::SOURCE_MONOTONIC:
+      return "monotonic";
+    case Clock::SOURCE_TSC:
+      return "tsc";
+    default:
+      AssertEq(Clock::SOURCE_SYSTEM, source);
+      return "unknown";
+  }
+}
+
+Clock::Source Lib::ConvertClockSourceFromString(const std::string &source) {
+  static_assert(Clock::numberOfSources == 3, "List changed.");
+  for (int i = 0; i < Clock::numberOfSources; ++i) {
+    const auto result = static_cast<Clock::Source>(i);
+    if (boost::iequals(source, ConvertToPch(result))) {
+      return result;
+    }
+  }
+  boost::format error("Unknown clock source \"%1%\"");
+  error % source;
+  throw Exception(error.str().c_str());
+}
@@ -0,0 +1,80 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 23:31:05
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#pragma once
+
+namespace trdk {
+namespace Lib {
+
+//! Low-overhead clock for UTC timestamps and intervals.
+/**
+ * Ticks are the invariant time-stamp counter if the CPU has it, or
+ * nanoseconds of CLOCK_MONOTONIC_RAW (the steady clock on Windows) otherwise.
+ * Both are system-wide, so ticks from different threads and modules are
+ * comparable. The tick frequency is calibrated by the monotonic clock at the
+ * first conversion in the module, it takes about 50 milliseconds.
+ *
+ * UTC time is the system time of the last anchoring plus the ticks since it.
+ * The clock is anchored to the system time at the creation and then
+ * periodically by the first call after the anchoring period, so the drift of
+ * ticks against the system time and changes of the system time are corrected
+ * by steps, not at each call.
+ */
+class Clock : private boost::noncopyable {
+ public:
+  enum Source {
+    //! The system time at each call, the slowest one.
+    SOURCE_SYSTEM,
+    //! The system time of the calibration plus CLOCK_MONOTONIC_RAW.
+    SOURCE_MONOTONIC,
+    //! The system time of the calibration plus the invariant time-stamp
+    //! counter, it's SOURCE_MONOTONIC if the CPU doesn't have invariant TSC.
+    SOURCE_TSC,
+    numberOfSources
+  };
+
+  typedef intmax_t Ticks;
+
+ public:
+  explicit Clock(const Source &,
+                 const boost::posix_time::time_duration &anchoringPeriod =
+                     boost::posix_time::seconds(10));
+
+ public:
+  const Source &GetSource() const { return m_source; }
+
+  boost::posix_time::ptime GetUniversalTime() const;
+
+ public:
+  static bool HasInvariantTsc();
+
+  //! Returns system-wide ticks, see class description.
+  static Ticks GetTicks();
+  static intmax_t ConvertToNanoseconds(const Ticks &);
+
+ private:
+  Ticks ReadTicks() const;
+  intmax_t ConvertTicksToNanoseconds(const Ticks &) const;
+  void Anchor() const;
+
+ private:
+  const Source m_source;
+  const boost::posix_time::ptime m_startTime;
+  Ticks m_anchoringPeriod;
+  //! UTC time is m_startTime plus this offset plus nanoseconds of ticks.
+  mutable boost::atomic<intmax_t> m_offset;
+  mutable boost::atomic<Ticks> m_nextAnchoringTicks;
+};
+
+const char *ConvertToPch(const Clock::Source &);
+Clock::Source ConvertClockSourceFromString(const std::string &);
+
+}  // namespace Lib
+}  // namespace trdk
@@ -0,0 +1,54 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 23:58:40
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Clock.hpp"
+
+using namespace trdk::Lib;
+namespace pt = boost::posix_time;
+
+TEST(Common_Clock, Ticks) {
+  const auto start = Clock::GetTicks();
+  boost::this_thread::sleep(pt::milliseconds(20));
+  const auto period = Clock::ConvertToNanoseconds(Clock::GetTicks() - start);
+  EXPECT_GE(period, 20000000);
+  EXPECT_LT(period, 1000000000);
+}
+
+TEST(Common_Clock, UniversalTime) {
+  for (int i = 0; i < Clock::numberOfSources; ++i) {
+    const Clock clock(static_cast<Clock::Source>(i));
+    if (clock.GetSource() == Clock::SOURCE_TSC) {
+      EXPECT_TRUE(Clock::HasInvariantTsc());
+    }
+    EXPECT_EQ(clock.GetSource(),
+              ConvertClockSourceFromString(ConvertToPch(clock.GetSource())));
+    const auto &time = clock.GetUniversalTime();
+    EXPECT_LT((time - pt::microsec_clock::universal_time()).abs(),
+              pt::milliseconds(10));
+    EXPECT_LE(time, clock.GetUniversalTime());
+  }
+  EXPECT_THROW(ConvertClockSourceFromString("xxx"), Exception);
+}
+
+TEST(Common_Clock, Anchoring) {
+  for (int i = 0; i < Clock::numberOfSources; ++i) {
+    const Clock clock(static_cast<Clock::Source>(i), pt::milliseconds(5));
+    auto prevTime = clock.GetUniversalTime();
+    for (int j = 0; j < 10; ++j) {
+      boost::this_thread::sleep(pt::milliseconds(3));
+      const auto &time = clock.GetUniversalTime();
+      EXPECT_LT((time - pt::microsec_clock::universal_time()).abs(),
+                pt::milliseconds(10));
+      EXPECT_GT(time, prevTime);
+      prevTime = time;
+    }
+  }
+}
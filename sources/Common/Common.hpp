@@ -43,7 +43,9 @@
 #include "Currency.hpp"
 #include "Dll.hpp"
 #include "Exception.hpp"
+#include "Json.hpp"
 #include "Numeric.hpp"
+#include "SlotList.hpp"
 #include "Spin.hpp"
 #include "Symbol.hpp"
 #include "SysError.hpp"
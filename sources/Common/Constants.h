@@ -96,6 +96,10 @@ enum Profile { PROFILE_RELAX, PROFILE_HFT, numberOfProfiles };
 #define TRDK_TESTS_EXE_FILE_NAME \
   TRDK_TESTS_FILE_NAME TRDK_FILE_MODIFICATOR ".exe"
 
+#define TRDK_BENCHMARKS_FILE_NAME "Benchmarks"
+#define TRDK_BENCHMARKS_EXE_FILE_NAME \
+  TRDK_BENCHMARKS_FILE_NAME TRDK_FILE_MODIFICATOR ".exe"
+
 #define TRDK_INTERACTION_TEST_FILE_NAME "TestTradingSystems"
 #define TRDK_INTERACTION_TEST_DLL_FILE_NAME \
   TRDK_INTERACTION_TEST_FILE_NAME TRDK_FILE_MODIFICATOR ".dll"
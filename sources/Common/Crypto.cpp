@@ -146,6 +146,121 @@ boost::array<unsigned char, SHA256_DIGEST_LENGTH> Hmac::CalcSha256Digest(
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+template <size_t DigestSize>
+struct ShaTraits {};
+template <>
+struct ShaTraits<SHA256_DIGEST_LENGTH> {
+  typedef SHA256_CTX Context;
+  enum { BLOCK_SIZE = SHA256_CBLOCK };
+  static void Init(Context &context) { SHA256_Init(&context); }
+  static void Update(Context &context, const void *data, size_t len) {
+    SHA256_Update(&context, data, len);
+  }
+  static void Final(unsigned char *result, Context &context) {
+    SHA256_Final(result, &context);
+  }
+};
+template <>
+struct ShaTraits<SHA512_DIGEST_LENGTH> {
+  typedef SHA512_CTX Context;
+  enum { BLOCK_SIZE = SHA512_CBLOCK };
+  static void Init(Context &context) { SHA512_Init(&context); }
+  static void Update(Context &context, const void *data, size_t len) {
+    SHA512_Update(&context, data, len);
+  }
+  static void Final(unsigned char *result, Context &context) {
+    SHA512_Final(result, &context);
+  }
+};
+}  // namespace
+
+template <size_t DigestSize>
+class Hmac::Signer<DigestSize>::Implementation {
+ public:
+  typedef ShaTraits<DigestSize> Traits;
+
+ public:
+  typename Traits::Context m_inner;
+  typename Traits::Context m_outer;
+
+ public:
+  explicit Implementation(const unsigned char *key, const size_t keyLen) {
+    boost::array<unsigned char, Traits::BLOCK_SIZE> block;
+    block.fill(0);
+    if (keyLen > block.size()) {
+      // RFC 2104: keys longer than the block are hashed.
+      typename Traits::Context context;
+      Traits::Init(context);
+      Traits::Update(context, key, keyLen);
+      Traits::Final(&block[0], context);
+    } else if (keyLen) {
+      std::memcpy(&block[0], key, keyLen);
+    }
+
+    boost::array<unsigned char, Traits::BLOCK_SIZE> pad;
+    for (size_t i = 0; i < block.size(); ++i) {
+      pad[i] = block[i] ^ 0x36;
+    }
+    Traits::Init(m_inner);
+    Traits::Update(m_inner, &pad[0], pad.size());
+    for (size_t i = 0; i < block.size(); ++i) {
+      pad[i] = block[i] ^ 0x5c;
+    }
+    Traits::Init(m_outer);
+    Traits::Update(m_outer, &pad[0], pad.size());
+  }
+};
+
+template <size_t DigestSize>
+Hmac::Signer<DigestSize>::Signer(const unsigned char *key, const size_t keyLen)
+    : m_pimpl(boost::make_unique<Implementation>(key, keyLen)) {}
+template <size_t DigestSize>
+Hmac::Signer<DigestSize>::Signer(const std::string &key)
+    : Signer(reinterpret_cast<const unsigned char *>(key.c_str()),
+             key.size()) {}
+template <size_t DigestSize>
+Hmac::Signer<DigestSize>::Signer(Signer &&) noexcept = default;
+template <size_t DigestSize>
+Hmac::Signer<DigestSize>::Signer(const Signer &rhs)
+    : m_pimpl(boost::make_unique<Implementation>(*rhs.m_pimpl)) {}
+template <size_t DigestSize>
+Hmac::Signer<DigestSize> &Hmac::Signer<DigestSize>::operator=(
+    Signer &&) noexcept = default;
+template <size_t DigestSize>
+Hmac::Signer<DigestSize> &Hmac::Signer<DigestSize>::operator=(
+    const Signer &rhs) {
+  Signer(rhs).m_pimpl.swap(m_pimpl);
+  return *this;
+}
+template <size_t DigestSize>
+Hmac::Signer<DigestSize>::~Signer() = default;
+
+template <size_t DigestSize>
+typename Hmac::Signer<DigestSize>::Digest Hmac::Signer<DigestSize>::Sign(
+    const unsigned char *source, const size_t sourceLen) const {
+  typedef typename Implementation::Traits Traits;
+  Digest result;
+  auto context = m_pimpl->m_inner;
+  Traits::Update(context, source, sourceLen);
+  Traits::Final(&result[0], context);
+  context = m_pimpl->m_outer;
+  Traits::Update(context, &result[0], result.size());
+  Traits::Final(&result[0], context);
+  return result;
+}
+template <size_t DigestSize>
+typename Hmac::Signer<DigestSize>::Digest Hmac::Signer<DigestSize>::Sign(
+    const std::string &source) const {
+  return Sign(reinterpret_cast<const unsigned char *>(source.c_str()),
+              source.size());
+}
+
+template class Hmac::Signer<SHA256_DIGEST_LENGTH>;
+template class Hmac::Signer<SHA512_DIGEST_LENGTH>;
+
+////////////////////////////////////////////////////////////////////////////////
+
 boost::array<unsigned char, MD5_DIGEST_LENGTH> Crypto::CalcMd5(
     const std::string &source) {
   boost::array<unsigned char, MD5_DIGEST_LENGTH> result;
@@ -10,6 +10,11 @@
 
 #pragma once
 
+#include <boost/array.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace trdk {
 namespace Lib {
 namespace Crypto {
@@ -68,6 +73,38 @@ boost::array<unsigned char, 32> CalcSha256Digest(const std::string &source,
                                                  const Key &key) {
   return CalcSha256Digest(source, &key[0], key.size());
 }
+
+//! HMAC signer with the precomputed key state.
+/**
+ * Keeps hash states after the inner and the outer key pads, so signing
+ * doesn't derive pads from the key each time. Sign is thread-safe and doesn't
+ * allocate memory.
+ */
+template <size_t DigestSize>
+class Signer {
+ public:
+  typedef boost::array<unsigned char, DigestSize> Digest;
+
+ public:
+  explicit Signer(const unsigned char *key, size_t keyLen);
+  explicit Signer(const std::string &key);
+  Signer(Signer &&) noexcept;
+  Signer(const Signer &);
+  Signer &operator=(Signer &&) noexcept;
+  Signer &operator=(const Signer &);
+  ~Signer();
+
+ public:
+  Digest Sign(const unsigned char *source, size_t sourceLen) const;
+  Digest Sign(const std::string &source) const;
+
+ private:
+  class Implementation;
+  std::unique_ptr<Implementation> m_pimpl;
+};
+typedef Signer<32> Sha256Signer;
+typedef Signer<64> Sha512Signer;
+
 }  // namespace Hmac
 
 boost::array<unsigned char, 16> CalcMd5(const std::string &);
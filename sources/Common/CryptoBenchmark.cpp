@@ -0,0 +1,42 @@
+/**************************************************************************
+ *   Created: 2026/10/17 08:31:05
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Common/Crypto.hpp"
+
+using namespace trdk::Lib::Crypto;
+
+namespace {
+
+const std::string key(64, 's');
+//! Typical new-order request parameters.
+const std::string source =
+    "pair=eth_btc&type=buy&rate=0.03125&amount=1.5&method=Trade&nonce="
+    "1508838412";
+
+//! One-shot HMAC, which derives key pads for each request.
+void Lib_Crypto_HmacSha512(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Hmac::CalcSha512Digest(source, key));
+  }
+}
+
+//! Signer with the precomputed key state, which is used by exchange adapters.
+void Lib_Crypto_HmacSha512Signer(benchmark::State &state) {
+  const Hmac::Sha512Signer signer(key);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(signer.Sign(source));
+  }
+}
+
+}  // namespace
+
+BENCHMARK(Lib_Crypto_HmacSha512);
+BENCHMARK(Lib_Crypto_HmacSha512Signer);
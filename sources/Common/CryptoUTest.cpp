@@ -0,0 +1,60 @@
+/**************************************************************************
+ *   Created: 2026/10/17 08:12:47
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Common/Crypto.hpp"
+
+using namespace trdk::Lib::Crypto;
+
+TEST(Lib_Crypto, HmacSigner) {
+  {
+    // RFC 4231, test case 2.
+    const std::string key = "Jefe";
+    const std::string source = "what do ya want for nothing?";
+    const Hmac::Sha256Signer sha256Signer(key);
+    EXPECT_EQ(
+        "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843",
+        EncodeToHex(sha256Signer.Sign(source)));
+    const Hmac::Sha512Signer sha512Signer(key);
+    EXPECT_EQ(
+        "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea250554"
+        "9758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737",
+        EncodeToHex(sha512Signer.Sign(source)));
+    // The key state isn't changed by signing.
+    EXPECT_EQ(sha512Signer.Sign(source), sha512Signer.Sign(source));
+  }
+  {
+    // RFC 4231, test case 6: the key is longer than the block.
+    const std::string key(131, '\xaa');
+    const std::string source =
+        "Test Using Larger Than Block-Size Key - Hash Key First";
+    EXPECT_EQ(
+        "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54",
+        EncodeToHex(Hmac::Sha256Signer(key).Sign(source)));
+    EXPECT_EQ(
+        "80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f352"
+        "6b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598",
+        EncodeToHex(Hmac::Sha512Signer(key).Sign(source)));
+  }
+  for (const std::string key : {std::string(), std::string(64, 'k'),
+                                std::string(128, 'k'), std::string(200, 'k')}) {
+    const std::string source = "nonce=1&method=Trade&pair=btc_usd";
+    Hmac::Sha256Signer sha256Signer(key);
+    EXPECT_EQ(Hmac::CalcSha256Digest(source, key), sha256Signer.Sign(source))
+        << key.size();
+    const auto copy = sha256Signer;
+    sha256Signer = Hmac::Sha256Signer("other");
+    EXPECT_EQ(Hmac::CalcSha256Digest(source, key), copy.Sign(source))
+        << key.size();
+    EXPECT_EQ(Hmac::CalcSha512Digest(source, key),
+              Hmac::Sha512Signer(key).Sign(source))
+        << key.size();
+  }
+}
@@ -0,0 +1,623 @@
+/*******************************************************************************
+ *   Created: 2026/10/17 00:41:12
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Json.hpp"
+
+using namespace trdk::Lib;
+using namespace trdk::Lib::Json;
+
+namespace {
+
+const size_t maxDepth = 64;
+
+//! Powers of 10 which are exactly representable as double.
+const double exactPowersOf10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                  1e18, 1e19, 1e20, 1e21, 1e22};
+
+bool IsDigit(const char ch) { return ch >= '0' && ch <= '9'; }
+
+void ThrowConversionError(const boost::string_ref &source, const char *type) {
+  boost::format error(R"(Failed to convert JSON value "%1%" to %2%)");
+  error % source  // 1
+      % type;     // 2
+  throw ParseError(error.str().c_str());
+}
+
+double ParseDouble(const boost::string_ref &source) {
+  auto it = source.cbegin();
+  const auto end = source.cend();
+
+  bool isNegative = false;
+  if (it != end && (*it == '-' || *it == '+')) {
+    isNegative = *it++ == '-';
+  }
+
+  // Fast path: if the significant digits fit into 53 bits and the decimal
+  // exponent is not bigger than 22 - the result of one multiplication or
+  // division of two exact values is correctly rounded.
+  uintmax_t mantissa = 0;
+  size_t numberOfDigits = 0;
+  int exponent = 0;
+  bool isExact = true;
+  bool hasDigits = false;
+  for (; it != end && IsDigit(*it); ++it) {
+    hasDigits = true;
+    if (numberOfDigits < 19) {
+      mantissa = mantissa * 10 + (*it - '0');
+      if (mantissa) {
+        ++numberOfDigits;
+      }
+    } else {
+      isExact = false;
+      ++exponent;
+    }
+  }
+  if (it != end && *it == '.') {
+    for (++it; it != end && IsDigit(*it); ++it) {
+      hasDigits = true;
+      if (numberOfDigits < 19) {
+        mantissa = mantissa * 10 + (*it - '0');
+        if (mantissa) {
+          ++numberOfDigits;
+        }
+        --exponent;
+      } else {
+        isExact = false;
+      }
+    }
+  }
+  if (!hasDigits) {
+    ThrowConversionError(source, "number");
+  }
+  if (it != end && (*it == 'e' || *it == 'E')) {
+    ++it;
+    bool isNegativeExponent = false;
+    if (it != end && (*it == '-' || *it == '+')) {
+      isNegativeExponent = *it++ == '-';
+    }
+    if (it == end || !IsDigit(*it)) {
+      ThrowConversionError(source, "number");
+    }
+    int value = 0;
+    for (; it != end && IsDigit(*it); ++it) {
+      if (value < 100000) {
+        value = value * 10 + (*it - '0');
+      }
+    }
+    exponent += isNegativeExponent ? -value : value;
+  }
+  if (it != end) {
+    ThrowConversionError(source, "number");
+  }
+
+  if (isExact && mantissa <= (uintmax_t(1) << 53) && exponent >= -22 &&
+      exponent <= 22) {
+    auto result = static_cast<double>(mantissa);
+    if (exponent < 0) {
+      result /= exactPowersOf10[-exponent];
+    } else {
+      result *= exactPowersOf10[exponent];
+    }
+    return isNegative ? -result : result;
+  }
+
+  std::istringstream is(source.to_string());
+  is.imbue(std::locale::classic());
+  double result;
+  is >> result;
+  if (!is) {
+    ThrowConversionError(source, "number");
+  }
+  return result;
+}
+
+uintmax_t ParseUInt(boost::string_ref::const_iterator it,
+                    const boost::string_ref &source) {
+  if (it == source.cend()) {
+    ThrowConversionError(source, "integer");
+  }
+  uintmax_t result = 0;
+  for (; it != source.cend(); ++it) {
+    if (!IsDigit(*it)) {
+      ThrowConversionError(source, "integer");
+    }
+    const auto digit = static_cast<uintmax_t>(*it - '0');
+    if (result > (std::numeric_limits<uintmax_t>::max() - digit) / 10) {
+      ThrowConversionError(source, "integer");
+    }
+    result = result * 10 + digit;
+  }
+  return result;
+}
+
+void AppendUtf8(const uint32_t codePoint, std::string &result) {
+  if (codePoint < 0x80) {
+    result.push_back(static_cast<char>(codePoint));
+  } else if (codePoint < 0x800) {
+    result.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+    result.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  } else if (codePoint < 0x10000) {
+    result.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+    result.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+    result.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  } else {
+    result.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+    result.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+    result.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+    result.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+  }
+}
+
+uint32_t ReadCodeUnit(boost::string_ref::const_iterator &it,
+                      const boost::string_ref &source) {
+  uint32_t result = 0;
+  for (int i = 0; i < 4; ++i, ++it) {
+    if (it == source.cend()) {
+      ThrowConversionError(source, "string");
+    }
+    result <<= 4;
+    if (IsDigit(*it)) {
+      result |= *it - '0';
+    } else if (*it >= 'a' && *it <= 'f') {
+      result |= *it - 'a' + 10;
+    } else if (*it >= 'A' && *it <= 'F') {
+      result |= *it - 'A' + 10;
+    } else {
+      ThrowConversionError(source, "string");
+    }
+  }
+  return result;
+}
+
+std::string Unescape(const boost::string_ref &source) {
+  std::string result;
+  result.reserve(source.size());
+  for (auto it = source.cbegin(); it != source.cend();) {
+    if (*it != '\\') {
+      result.push_back(*it++);
+      continue;
+    }
+    if (++it == source.cend()) {
+      ThrowConversionError(source, "string");
+    }
+    switch (*it++) {
+      case '"':
+        result.push_back('"');
+        break;
+      case '\\':
+        result.push_back('\\');
+        break;
+      case '/':
+        result.push_back('/');
+        break;
+      case 'b':
+        result.push_back('\b');
+        break;
+      case 'f':
+        result.push_back('\f');
+        break;
+      case 'n':
+        result.push_back('\n');
+        break;
+      case 'r':
+        result.push_back('\r');
+        break;
+      case 't':
+        result.push_back('\t');
+        break;
+      case 'u': {
+        auto codePoint = ReadCodeUnit(it, source);
+        if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+          if (it == source.cend() || *it++ != '\\' || it == source.cend() ||
+              *it++ != 'u') {
+            ThrowConversionError(source, "string");
+          }
+          const auto low = ReadCodeUnit(it, source);
+          if (low < 0xDC00 || low > 0xDFFF) {
+            ThrowConversionError(source, "string");
+          }
+          codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+        }
+        AppendUtf8(codePoint, result);
+        break;
+      }
+      default:
+        ThrowConversionError(source, "string");
+    }
+  }
+  return result;
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+class Document::Parser {
+ public:
+  explicit Parser(Document &document)
+      : m_tokens(document.m_tokens),
+        m_begin(document.m_data),
+        m_it(document.m_data),
+        m_end(document.m_data + document.m_size) {}
+  Parser(Parser &&) = delete;
+  Parser(const Parser &) = delete;
+  Parser &operator=(Parser &&) = delete;
+  Parser &operator=(const Parser &) = delete;
+  ~Parser() = default;
+
+  void Run() {
+    ParseValue(0, 0);
+    SkipWhitespaces();
+    if (m_it != m_end) {
+      Throw("unexpected data after the root value");
+    }
+  }
+
+ private:
+  uint32_t GetOffset() const { return static_cast<uint32_t>(m_it - m_begin); }
+
+  void Throw(const char *reason) const {
+    boost::format error("Failed to parse JSON at %1%: %2%");
+    error % GetOffset()  // 1
+        % reason;        // 2
+    throw ParseError(error.str().c_str());
+  }
+
+  void SkipWhitespaces() {
+    while (m_it != m_end &&
+           (*m_it == ' ' || *m_it == '\n' || *m_it == '\r' || *m_it == '\t')) {
+      ++m_it;
+    }
+  }
+
+  void Expect(const char ch) {
+    SkipWhitespaces();
+    if (m_it == m_end || *m_it != ch) {
+      boost::format reason(R"(expected "%1%")");
+      reason % ch;
+      Throw(reason.str().c_str());
+    }
+    ++m_it;
+  }
+
+  //! Returns true and skips the char if it is the next one.
+  bool Skip(const char ch) {
+    SkipWhitespaces();
+    if (m_it == m_end || *m_it != ch) {
+      return false;
+    }
+    ++m_it;
+    return true;
+  }
+
+  uint32_t AddToken(const ValueType &type, const uint32_t key) {
+    const auto result = static_cast<uint32_t>(m_tokens.size());
+    m_tokens.emplace_back(
+        Token{type, GetOffset(), GetOffset(), result + 1, 0, key, false});
+    return result;
+  }
+
+  void ParseValue(const uint32_t key, const size_t depth) {
+    if (depth > maxDepth) {
+      Throw("too deep nesting");
+    }
+    SkipWhitespaces();
+    if (m_it == m_end) {
+      Throw("unexpected end");
+    }
+    switch (*m_it) {
+      case '{':
+        ParseObject(AddToken(VALUE_TYPE_OBJECT, key), depth);
+        break;
+      case '[':
+        ParseArray(AddToken(VALUE_TYPE_ARRAY, key), depth);
+        break;
+      case '"':
+        ParseString(AddToken(VALUE_TYPE_STRING, key));
+        break;
+      case 't':
+        ParseLiteral(AddToken(VALUE_TYPE_BOOL, key), "true");
+        break;
+      case 'f':
+        ParseLiteral(AddToken(VALUE_TYPE_BOOL, key), "false");
+        break;
+      case 'n':
+        ParseLiteral(AddToken(VALUE_TYPE_NULL, key), "null");
+        break;
+      default:
+        ParseNumber(AddToken(VALUE_TYPE_NUMBER, key));
+        break;
+    }
+  }
+
+  void ParseObject(const uint32_t index, const size_t depth) {
+    ++m_it;
+    if (!Skip('}')) {
+      do {
+        SkipWhitespaces();
+        if (m_it == m_end || *m_it != '"') {
+          Throw("expected member name");
+        }
+        const auto key = AddToken(VALUE_TYPE_STRING, 0);
+        ParseString(key);
+        Expect(':');
+        ParseValue(key, depth + 1);
+        ++m_tokens[index].size;
+      } while (Skip(','));
+      Expect('}');
+    }
+    Close(index);
+  }
+
+  void ParseArray(const uint32_t index, const size_t depth) {
+    ++m_it;
+    if (!Skip(']')) {
+      do {
+        ParseValue(0, depth + 1);
+        ++m_tokens[index].size;
+      } while (Skip(','));
+      Expect(']');
+    }
+    Close(index);
+  }
+
+  void Close(const uint32_t index) {
+    auto &token = m_tokens[index];
+    token.end = GetOffset();
+    token.next = static_cast<uint32_t>(m_tokens.size());
+  }
+
+  void ParseString(const uint32_t index) {
+    ++m_it;
+    auto &token = m_tokens[index];
+    token.begin = GetOffset();
+    for (;;) {
+      if (m_it == m_end) {
+        Throw("unterminated string");
+      }
+      if (*m_it == '"') {
+        break;
+      }
+      if (*m_it == '\\') {
+        token.isEscaped = true;
+        if (++m_it == m_end) {
+          Throw("unterminated string");
+        }
+      }
+      ++m_it;
+    }
+    token.end = GetOffset();
+    ++m_it;
+  }
+
+  void ParseLiteral(const uint32_t index, const char *literal) {
+    for (auto ch = literal; *ch; ++ch, ++m_it) {
+      if (m_it == m_end || *m_it != *ch) {
+        Throw("unknown literal");
+      }
+    }
+    m_tokens[index].end = GetOffset();
+  }
+
+  void ParseNumber(const uint32_t index) {
+    const auto begin = m_it;
+    while (m_it != m_end &&
+           (IsDigit(*m_it) || *m_it == '-' || *m_it == '+' || *m_it == '.' ||
+            *m_it == 'e' || *m_it == 'E')) {
+      ++m_it;
+    }
+    if (m_it == begin) {
+      Throw("unexpected character");
+    }
+    m_tokens[index].end = GetOffset();
+  }
+
+  std::vector<Token> &m_tokens;
+  const char *const m_begin;
+  const char *m_it;
+  const char *const m_end;
+};
+
+Value Document::Parse(const char *data, const size_t size) {
+  if (size > std::numeric_limits<uint32_t>::max()) {
+    throw ParseError("JSON is too big");
+  }
+  m_data = data;
+  m_size = size;
+  m_tokens.clear();
+  try {
+    Parser(*this).Run();
+  } catch (...) {
+    m_tokens.clear();
+    throw;
+  }
+  return GetRoot();
+}
+
+Value Document::GetRoot() const {
+  Assert(!m_tokens.empty());
+  return Value(*this, 0);
+}
+
+std::string Document::ConvertToString() const {
+  return std::string(m_data, m_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Value::Iterator::Iterator(const Document &document,
+                          const size_t index,
+                          const size_t keyStep)
+    : m_document(&document), m_index(index), m_keyStep(keyStep) {}
+
+Value Value::Iterator::dereference() const {
+  return Value(*m_document, m_index);
+}
+
+void Value::Iterator::increment() {
+  m_index = m_document->m_tokens[m_index].next + m_keyStep;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Value::Value(const Document &document, const size_t index)
+    : m_document(&document), m_index(index) {
+  AssertGt(m_document->m_tokens.size(), m_index);
+}
+
+ValueType Value::GetType() const {
+  return m_document->m_tokens[m_index].type;
+}
+
+size_t Value::GetSize() const { return m_document->m_tokens[m_index].size; }
+
+Value::Iterator Value::begin() const {
+  const auto &token = m_document->m_tokens[m_index];
+  const size_t keyStep = token.type == VALUE_TYPE_OBJECT ? 1 : 0;
+  return Iterator(*m_document,
+                  (token.size ? m_index + 1 : token.next) + keyStep, keyStep);
+}
+
+Value::Iterator Value::end() const {
+  const auto &token = m_document->m_tokens[m_index];
+  const size_t keyStep = token.type == VALUE_TYPE_OBJECT ? 1 : 0;
+  return Iterator(*m_document, token.next + keyStep, keyStep);
+}
+
+Value Value::operator[](const size_t index) const {
+  if (!IsArray()) {
+    throw ParseError("JSON value is not an array");
+  }
+  if (index >= GetSize()) {
+    boost::format error("JSON array has no element %1%");
+    error % index;
+    throw ParseError(error.str().c_str());
+  }
+  auto result = begin();
+  for (size_t i = 0; i < index; ++i) {
+    ++result;
+  }
+  return *result;
+}
+
+Value Value::operator[](const boost::string_ref &key) const {
+  if (!IsObject()) {
+    boost::format error(R"(JSON value is not an object to get member "%1%")");
+    error % key;
+    throw ParseError(error.str().c_str());
+  }
+  const auto &result = Find(key);
+  if (!result) {
+    boost::format error(R"(JSON object has no member "%1%")");
+    error % key;
+    throw ParseError(error.str().c_str());
+  }
+  return *result;
+}
+
+boost::optional<Value> Value::Find(const boost::string_ref &key) const {
+  if (!IsObject()) {
+    return boost::none;
+  }
+  for (const auto &member : *this) {
+    if (member.GetKey() == key) {
+      return member;
+    }
+  }
+  return boost::none;
+}
+
+boost::string_ref Value::GetKey() const {
+  const auto &key = m_document->m_tokens[m_index].key;
+  if (!key) {
+    return {};
+  }
+  return Value(*m_document, key).GetRawString();
+}
+
+boost::string_ref Value::GetRawString() const {
+  const auto &token = m_document->m_tokens[m_index];
+  return {m_document->m_data + token.begin, token.end - token.begin};
+}
+
+std::string Value::GetString() const {
+  const auto &token = m_document->m_tokens[m_index];
+  switch (token.type) {
+    case VALUE_TYPE_ARRAY:
+    case VALUE_TYPE_OBJECT:
+      ThrowConversionError(GetRawString(), "string");
+      break;
+    case VALUE_TYPE_STRING:
+      if (token.isEscaped) {
+        return Unescape(GetRawString());
+      }
+      break;
+    default:
+      break;
+  }
+  return GetRawString().to_string();
+}
+
+double Value::GetDouble() const {
+  switch (GetType()) {
+    case VALUE_TYPE_NUMBER:
+    case VALUE_TYPE_STRING:
+      return ParseDouble(GetRawString());
+    default:
+      ThrowConversionError(GetRawString(), "number");
+      return 0;
+  }
+}
+
+intmax_t Value::GetInt() const {
+  switch (GetType()) {
+    case VALUE_TYPE_NUMBER:
+    case VALUE_TYPE_STRING:
+      break;
+    default:
+      ThrowConversionError(GetRawString(), "integer");
+  }
+  const auto &source = GetRawString();
+  const bool isNegative = !source.empty() && source.front() == '-';
+  const auto result = ParseUInt(
+      isNegative ? source.cbegin() + 1 : source.cbegin(), source);
+  if (result > static_cast<uintmax_t>(std::numeric_limits<intmax_t>::max()) +
+                   (isNegative ? 1 : 0)) {
+    ThrowConversionError(source, "integer");
+  }
+  return isNegative ? static_cast<intmax_t>(0 - result)
+                    : static_cast<intmax_t>(result);
+}
+
+uintmax_t Value::GetUInt() const {
+  switch (GetType()) {
+    case VALUE_TYPE_NUMBER:
+    case VALUE_TYPE_STRING:
+      break;
+    default:
+      ThrowConversionError(GetRawString(), "unsigned integer");
+  }
+  const auto &source = GetRawString();
+  return ParseUInt(source.cbegin(), source);
+}
+
+bool Value::GetBool() const {
+  const auto &source = GetRawString();
+  if (source == "true") {
+    return true;
+  }
+  if (source == "false") {
+    return false;
+  }
+  ThrowConversionError(source, "boolean");
+  return false;
+}
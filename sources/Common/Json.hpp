@@ -0,0 +1,162 @@
+/*******************************************************************************
+ *   Created: 2026/10/17 00:41:12
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#pragma once
+
+#include "Exception.hpp"
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/utility/string_ref.hpp>
+
+namespace trdk {
+namespace Lib {
+namespace Json {
+
+class ParseError : public Exception {
+ public:
+  explicit ParseError(const char *what) noexcept : Exception(what) {}
+};
+
+enum ValueType {
+  VALUE_TYPE_NULL,
+  VALUE_TYPE_BOOL,
+  VALUE_TYPE_NUMBER,
+  VALUE_TYPE_STRING,
+  VALUE_TYPE_ARRAY,
+  VALUE_TYPE_OBJECT,
+  numberOfValueTypes
+};
+
+class Document;
+
+//! Read-only view of a JSON value in the parsed buffer.
+/**
+ * Scalars are converted from the buffer text at each call, so a number from
+ * a string ("0.0012") is read as well as a number literal, like
+ * boost::property_tree does it. Object member lookup is a linear scan by the
+ * raw (not unescaped) key.
+ */
+class Value {
+ public:
+  class Iterator;
+
+ public:
+  explicit Value(const Document &, size_t index);
+
+ public:
+  ValueType GetType() const;
+  bool IsNull() const { return GetType() == VALUE_TYPE_NULL; }
+  bool IsArray() const { return GetType() == VALUE_TYPE_ARRAY; }
+  bool IsObject() const { return GetType() == VALUE_TYPE_OBJECT; }
+
+  //! Number of array elements or object members, 0 for scalars.
+  size_t GetSize() const;
+
+  //! Iterates array elements or object member values.
+  Iterator begin() const;
+  Iterator end() const;
+
+  //! Returns array element.
+  /** @throw ParseError If the value isn't an array or has no such element.
+   */
+  Value operator[](size_t) const;
+
+  //! Returns object member.
+  /** @throw ParseError If the value isn't an object or has no such member.
+   */
+  Value operator[](const boost::string_ref &key) const;
+  boost::optional<Value> Find(const boost::string_ref &key) const;
+  //! Returns the member key if this value is an object member.
+  boost::string_ref GetKey() const;
+
+  //! Returns string content without unescaping or scalar literal text.
+  boost::string_ref GetRawString() const;
+  std::string GetString() const;
+  double GetDouble() const;
+  intmax_t GetInt() const;
+  uintmax_t GetUInt() const;
+  bool GetBool() const;
+
+ private:
+  const Document *m_document;
+  size_t m_index;
+};
+
+class Value::Iterator
+    : public boost::iterator_facade<Iterator,
+                                    Value,
+                                    boost::forward_traversal_tag,
+                                    Value> {
+ public:
+  Iterator() = default;
+  explicit Iterator(const Document &, size_t index, size_t keyStep);
+
+ private:
+  friend class boost::iterator_core_access;
+  Value dereference() const;
+  bool equal(const Iterator &rhs) const { return m_index == rhs.m_index; }
+  void increment();
+
+  const Document *m_document = nullptr;
+  size_t m_index = 0;
+  //! 1 for object members as each member value follows its key, 0 for
+  //! array elements.
+  size_t m_keyStep = 0;
+};
+
+//! In-situ JSON parser.
+/**
+ * Builds a flat token list over the source buffer instead of a tree of nodes
+ * and strings. The buffer is not copied and has to be alive and unchanged
+ * while values are used. The token list keeps its capacity, so reusing the
+ * same document object for the next messages doesn't allocate memory.
+ */
+class Document : private boost::noncopyable {
+  friend class Value;
+  friend class Value::Iterator;
+
+ public:
+  //! Parses buffer and returns the root value.
+  /** @throw ParseError
+   */
+  Value Parse(const char *data, size_t size);
+  Value Parse(const std::string &source) {
+    return Parse(source.data(), source.size());
+  }
+  //! Values would refer to the destroyed buffer.
+  Value Parse(std::string &&) = delete;
+
+  Value GetRoot() const;
+
+  //! Returns the source buffer as a string, to report errors.
+  std::string ConvertToString() const;
+
+ private:
+  struct Token {
+    ValueType type;
+    uint32_t begin;
+    uint32_t end;
+    //! Index of the first token after this value with all its children.
+    uint32_t next;
+    uint32_t size;
+    //! Key token index for object members, 0 otherwise.
+    uint32_t key;
+    bool isEscaped;
+  };
+
+  class Parser;
+
+  const char *m_data = nullptr;
+  size_t m_size = 0;
+  std::vector<Token> m_tokens;
+};
+
+}  // namespace Json
+}  // namespace Lib
+}  // namespace trdk
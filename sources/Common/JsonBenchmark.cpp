@@ -0,0 +1,83 @@
+/**************************************************************************
+ *   Created: 2026/10/17 04:29:03
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Common/Json.hpp"
+#include <boost/property_tree/json_parser.hpp>
+
+using namespace trdk::Lib;
+
+namespace ptr = boost::property_tree;
+
+namespace {
+
+//! Binance depth stream message with 10 levels on each side.
+std::string CreateDepthMessage() {
+  std::ostringstream result;
+  result << R"({"stream":"btcusdt@depth","data":{"e":"depthUpdate",)"
+         << R"("E":1516142325034,"s":"BTCUSDT","U":157,"u":160,"b":[)";
+  for (size_t i = 0; i < 10; ++i) {
+    result << (i ? "," : "") << R"([")" << (7654.32 - i * .01) << R"(",")"
+           << (.001 * (i + 1)) << R"(",[]])";
+  }
+  result << R"(],"a":[)";
+  for (size_t i = 0; i < 10; ++i) {
+    result << (i ? "," : "") << R"([")" << (7654.33 + i * .01) << R"(",")"
+           << (.002 * (i + 1)) << R"(",[]])";
+  }
+  result << "]}}";
+  return result.str();
+}
+
+//! In-situ parser, which is used by exchange adapters.
+void Lib_Json_ParseDepth(benchmark::State &state) {
+  const auto &message = CreateDepthMessage();
+  Json::Document document;
+  for (auto _ : state) {
+    const auto &data = document.Parse(message)["data"];
+    double sum = 0;
+    for (const auto &side : {data["b"], data["a"]}) {
+      for (const auto &level : side) {
+        sum += level[0].GetDouble() * level[1].GetDouble();
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(message.size()));
+}
+
+//! Property tree parser, which was used by exchange adapters before, as the
+//! reference.
+void Lib_Json_ParseDepthPropertyTree(benchmark::State &state) {
+  const auto &message = CreateDepthMessage();
+  for (auto _ : state) {
+    std::istringstream is(message);
+    ptr::ptree root;
+    ptr::read_json(is, root);
+    const auto &data = root.get_child("data");
+    double sum = 0;
+    for (const auto *side : {&data.get_child("b"), &data.get_child("a")}) {
+      for (const auto &level : *side) {
+        auto it = level.second.begin();
+        const auto price = it->second.get_value<double>();
+        sum += price * (++it)->second.get_value<double>();
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(message.size()));
+}
+
+}  // namespace
+
+BENCHMARK(Lib_Json_ParseDepth);
+BENCHMARK(Lib_Json_ParseDepthPropertyTree);
@@ -0,0 +1,82 @@
+/*******************************************************************************
+ *   Created: 2026/10/17 01:27:50
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Json.hpp"
+
+using namespace trdk::Lib;
+
+TEST(Common_Json, Object) {
+  const std::string source =
+      R"({"stream":"bnbbtc@depth","data":{"e":"depthUpdate","U":157,)"
+      R"("u":160,"b":[["0.0024","10"],["0.0023","0.5"]],"a":[],)"
+      R"("x":null,"y":true,"z":-1.5e2,"s":"a\"bé\n"}})";
+  Json::Document document;
+  const auto &root = document.Parse(source);
+  ASSERT_TRUE(root.IsObject());
+  EXPECT_EQ(2, root.GetSize());
+  EXPECT_EQ("bnbbtc@depth", root["stream"].GetRawString());
+  EXPECT_FALSE(root.Find("unknown"));
+  EXPECT_THROW(root["unknown"], Json::ParseError);
+
+  const auto &data = root["data"];
+  EXPECT_EQ("data", data.GetKey());
+  EXPECT_EQ(157, data["U"].GetUInt());
+  EXPECT_EQ(160, data["u"].GetInt());
+  EXPECT_TRUE(data["x"].IsNull());
+  EXPECT_TRUE(data["y"].GetBool());
+  EXPECT_DOUBLE_EQ(-150, data["z"].GetDouble());
+  EXPECT_THROW(data["z"].GetUInt(), Json::ParseError);
+  EXPECT_EQ("a\"b\xC3\xA9\n", data["s"].GetString());
+
+  const auto &bids = data["b"];
+  ASSERT_TRUE(bids.IsArray());
+  EXPECT_EQ(2, bids.GetSize());
+  EXPECT_DOUBLE_EQ(0.0024, bids[0][0].GetDouble());
+  EXPECT_DOUBLE_EQ(0.5, bids[1][1].GetDouble());
+  EXPECT_THROW(bids[2], Json::ParseError);
+  EXPECT_EQ(0, data["a"].GetSize());
+  EXPECT_TRUE(data["a"].begin() == data["a"].end());
+
+  std::vector<std::string> keys;
+  for (const auto &member : data) {
+    keys.emplace_back(member.GetKey().to_string());
+  }
+  EXPECT_EQ(std::vector<std::string>({"e", "U", "u", "b", "a", "x", "y", "z",
+                                      "s"}),
+            keys);
+}
+
+TEST(Common_Json, Numbers) {
+  const std::string source =
+      "[0, 1.25, \"0.00000001\", 12345678.12345678, 1e-30, "
+      "123456789012345678901234567890, 18446744073709551616]";
+  Json::Document document;
+  const auto &root = document.Parse(source);
+  EXPECT_EQ(0, root[0].GetInt());
+  EXPECT_DOUBLE_EQ(1.25, root[1].GetDouble());
+  EXPECT_DOUBLE_EQ(0.00000001, root[2].GetDouble());
+  EXPECT_DOUBLE_EQ(12345678.12345678, root[3].GetDouble());
+  EXPECT_DOUBLE_EQ(1e-30, root[4].GetDouble());
+  EXPECT_DOUBLE_EQ(123456789012345678901234567890.0, root[5].GetDouble());
+  EXPECT_THROW(root[6].GetUInt(), Json::ParseError);
+  EXPECT_THROW(root[1].GetInt(), Json::ParseError);
+}
+
+TEST(Common_Json, Errors) {
+  Json::Document document;
+  for (const std::string source :
+       {"", "{", R"({"a")", R"({"a":})", "[1,]", R"(["a)", "tru", "[1] 2",
+        "{1:2}"}) {
+    EXPECT_THROW(document.Parse(source), Json::ParseError) << source;
+  }
+  const std::string source = " [ 1 ] ";
+  EXPECT_EQ(1, document.Parse(source).GetSize());
+}
@@ -0,0 +1,295 @@
+/**************************************************************************
+ *   Created: 2026/10/16 10:12:41
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#pragma once
+
+#include "Exception.hpp"
+#include "Spin.hpp"
+#include <boost/atomic.hpp>
+#include <boost/make_unique.hpp>
+#include <boost/thread/thread.hpp>
+#include <deque>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace trdk {
+namespace Lib {
+namespace Concurrency {
+
+//! Preallocated lock-free ring buffer for one producer and one consumer.
+template <typename ItemT>
+class SingleProducerRingBuffer : private boost::noncopyable {
+ public:
+  typedef ItemT Item;
+
+ private:
+  typedef typename std::aligned_storage<sizeof(Item), alignof(Item)>::type
+      Storage;
+  enum { CACHE_LINE_SIZE = 64 };
+
+ public:
+  explicit SingleProducerRingBuffer(size_t capacity)
+      : m_size(capacity + 1),
+        m_buffer(new Storage[m_size]),
+        m_writeIndex(0),
+        m_readIndex(0) {
+    AssertLt(0, capacity);
+  }
+  ~SingleProducerRingBuffer() {
+    ConsumeAll([](const Item &) {});
+  }
+
+ public:
+  //! Adds new item, could be called only from producer thread.
+  /**
+   * @return false if the buffer is full, the source item is not moved in this
+   *         case.
+   */
+  template <typename SourceItem>
+  bool Push(SourceItem &&item) {
+    const size_t writeIndex = m_writeIndex.load(boost::memory_order_relaxed);
+    const size_t nextIndex = GetNextIndex(writeIndex);
+    if (nextIndex == m_readIndex.load(boost::memory_order_acquire)) {
+      return false;
+    }
+    new (&m_buffer[writeIndex]) Item(std::forward<SourceItem>(item));
+    m_writeIndex.store(nextIndex, boost::memory_order_release);
+    return true;
+  }
+
+  //! Takes all available items, could be called only from consumer thread.
+  /**
+   * If callback throws an exception, the item which caused it is lost.
+   * @return Number of consumed items.
+   */
+  template <typename Callback>
+  size_t ConsumeAll(const Callback &callback) {
+    size_t readIndex = m_readIndex.load(boost::memory_order_relaxed);
+    const size_t writeIndex = m_writeIndex.load(boost::memory_order_acquire);
+    size_t result = 0;
+    while (readIndex != writeIndex) {
+      auto &item = reinterpret_cast<Item &>(m_buffer[readIndex]);
+      readIndex = GetNextIndex(readIndex);
+      try {
+        callback(item);
+      } catch (...) {
+        item.~Item();
+        m_readIndex.store(readIndex, boost::memory_order_release);
+        throw;
+      }
+      item.~Item();
+      m_readIndex.store(readIndex, boost::memory_order_release);
+      ++result;
+    }
+    return result;
+  }
+
+  //! Checks for available items, could be called only from consumer thread.
+  bool IsEmpty() const {
+    return m_readIndex.load(boost::memory_order_relaxed) ==
+           m_writeIndex.load(boost::memory_order_acquire);
+  }
+
+ private:
+  size_t GetNextIndex(size_t index) const {
+    return ++index < m_size ? index : 0;
+  }
+
+ private:
+  const size_t m_size;
+  const std::unique_ptr<Storage[]> m_buffer;
+  // Producer and consumer indexes are in different cache lines to avoid false
+  // sharing:
+  char m_padding1[CACHE_LINE_SIZE];
+  boost::atomic_size_t m_writeIndex;
+  char m_padding2[CACHE_LINE_SIZE];
+  boost::atomic_size_t m_readIndex;
+  char m_padding3[CACHE_LINE_SIZE];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+//! Set of preallocated lock-free single-producer ring buffers with one
+//! consumer.
+/**
+ * Each producer thread gets own ring buffer at the first push and uses it
+ * until the object is destroyed, so the producer never waits for other
+ * producers and never allocates memory. If all ring buffers are already taken
+ * by other threads, the producer uses shared locked queue with the same
+ * capacity, so short-living threads degrade performance but don't break event
+ * delivery. Events from one producer are consumed in the order they were
+ * pushed, order between producers is not defined.
+ */
+template <typename ItemT>
+class MultiProducerRingBuffer : private boost::noncopyable {
+ public:
+  typedef ItemT Item;
+
+ private:
+  struct Producer {
+    boost::thread::id threadId;
+    SingleProducerRingBuffer<Item> queue;
+
+    explicit Producer(size_t capacity) : queue(capacity) {}
+  };
+
+ public:
+  explicit MultiProducerRingBuffer(size_t numberOfProducers,
+                                   size_t producerCapacity)
+      : m_numberOfActiveProducers(0),
+        m_overflowCapacity(producerCapacity),
+        m_overflowSize(0) {
+    AssertLt(0, numberOfProducers);
+    AssertLt(0, producerCapacity);
+    m_producers.reserve(numberOfProducers);
+    for (size_t i = 0; i < numberOfProducers; ++i) {
+      m_producers.emplace_back(boost::make_unique<Producer>(producerCapacity));
+    }
+  }
+
+ public:
+  size_t GetNumberOfProducers() const { return m_producers.size(); }
+  size_t GetNumberOfActiveProducers() const {
+    return m_numberOfActiveProducers.load(boost::memory_order_acquire);
+  }
+
+  //! Pushes new item into the ring buffer of the current thread.
+  /**
+   * Could be called from any thread. If the current thread has no own ring
+   * buffer and all ring buffers are busy, the item is pushed into the shared
+   * locked queue.
+   * @return false if the producer ring buffer (or the shared queue) is full.
+   */
+  template <typename SourceItem>
+  bool Push(SourceItem &&item) {
+    auto *const producer = GetProducer();
+    if (!producer) {
+      return PushToOverflow(std::forward<SourceItem>(item));
+    }
+    return producer->queue.Push(std::forward<SourceItem>(item));
+  }
+
+  //! Takes all available items. Should be called only from one thread.
+  /**
+   * @return Number of consumed items.
+   */
+  template <typename Callback>
+  size_t ConsumeAll(const Callback &callback) {
+    size_t result = 0;
+    const size_t numberOfProducers = GetNumberOfActiveProducers();
+    for (size_t i = 0; i < numberOfProducers; ++i) {
+      result += m_producers[i]->queue.ConsumeAll(callback);
+    }
+    result += ConsumeOverflow(callback);
+    return result;
+  }
+
+  //! Checks for available items. Should be called only from consumer thread.
+  bool IsEmpty() const {
+    const size_t numberOfProducers = GetNumberOfActiveProducers();
+    for (size_t i = 0; i < numberOfProducers; ++i) {
+      if (!m_producers[i]->queue.IsEmpty()) {
+        return false;
+      }
+    }
+    return m_overflowConsumerBuffer.empty() &&
+           m_overflowSize.load(boost::memory_order_acquire) == 0;
+  }
+
+ private:
+  template <typename SourceItem>
+  bool PushToOverflow(SourceItem &&item) {
+    const SpinScopedLock lock(m_overflowMutex);
+    if (m_overflow.size() >= m_overflowCapacity) {
+      return false;
+    }
+    m_overflow.emplace_back(std::forward<SourceItem>(item));
+    m_overflowSize.store(m_overflow.size(), boost::memory_order_release);
+    return true;
+  }
+
+  template <typename Callback>
+  size_t ConsumeOverflow(const Callback &callback) {
+    if (m_overflowConsumerBuffer.empty()) {
+      if (m_overflowSize.load(boost::memory_order_acquire) == 0) {
+        return 0;
+      }
+      const SpinScopedLock lock(m_overflowMutex);
+      m_overflow.swap(m_overflowConsumerBuffer);
+      m_overflowSize.store(0, boost::memory_order_release);
+    }
+    // If callback throws an exception, the item which caused it is lost, but
+    // other items stay in the consumer buffer and will be consumed first at the
+    // next call, so the order is kept.
+    size_t result = 0;
+    while (!m_overflowConsumerBuffer.empty()) {
+      Item item = std::move(m_overflowConsumerBuffer.front());
+      m_overflowConsumerBuffer.pop_front();
+      callback(item);
+      ++result;
+    }
+    return result;
+  }
+
+  //! Returns the ring buffer of the current thread or nullptr if all ring
+  //! buffers are taken by other threads.
+  Producer *GetProducer() {
+    const auto &threadId = boost::this_thread::get_id();
+    {
+      // Producers with index less than counter are immutable:
+      const size_t numberOfProducers = GetNumberOfActiveProducers();
+      for (size_t i = 0; i < numberOfProducers; ++i) {
+        auto &producer = *m_producers[i];
+        if (producer.threadId == threadId) {
+          return &producer;
+        }
+      }
+    }
+    return RegisterProducer(threadId);
+  }
+
+  Producer *RegisterProducer(const boost::thread::id &threadId) {
+    const SpinScopedLock lock(m_registrationMutex);
+    const size_t numberOfProducers =
+        m_numberOfActiveProducers.load(boost::memory_order_relaxed);
+    for (size_t i = 0; i < numberOfProducers; ++i) {
+      auto &producer = *m_producers[i];
+      if (producer.threadId == threadId) {
+        return &producer;
+      }
+    }
+    if (numberOfProducers >= m_producers.size()) {
+      // All slots are busy, the thread will use the shared locked queue.
+      return nullptr;
+    }
+    auto &result = *m_producers[numberOfProducers];
+    result.threadId = threadId;
+    m_numberOfActiveProducers.store(numberOfProducers + 1,
+                                    boost::memory_order_release);
+    return &result;
+  }
+
+ private:
+  std::vector<std::unique_ptr<Producer>> m_producers;
+  boost::atomic_size_t m_numberOfActiveProducers;
+  SpinMutex m_registrationMutex;
+
+  const size_t m_overflowCapacity;
+  SpinMutex m_overflowMutex;
+  std::deque<Item> m_overflow;
+  boost::atomic_size_t m_overflowSize;
+  //! Items taken from the shared queue, accessed only by the consumer.
+  std::deque<Item> m_overflowConsumerBuffer;
+};
+
+}  // namespace Concurrency
+}  // namespace Lib
+}  // namespace trdk
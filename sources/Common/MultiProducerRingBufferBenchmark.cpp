@@ -0,0 +1,70 @@
+/**************************************************************************
+ *   Created: 2026/10/17 04:21:36
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Common/MultiProducerRingBuffer.hpp"
+
+namespace con = trdk::Lib::Concurrency;
+
+namespace {
+
+//! Dispatcher event queue load: market data source threads push events, the
+//! dispatcher thread takes all available events at each flush.
+void Lib_Concurrency_MultiProducerRingBuffer_PushConsume(
+    benchmark::State &state) {
+  const auto numberOfProducers = static_cast<size_t>(state.range(0));
+  const size_t numberOfItemsPerProducer = 100000;
+  const size_t numberOfItems = numberOfProducers * numberOfItemsPerProducer;
+
+  size_t numberOfFlushes = 0;
+  for (auto _ : state) {
+    con::MultiProducerRingBuffer<std::pair<size_t, size_t>> buffer(
+        numberOfProducers, 1024);
+
+    boost::thread_group producers;
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+      producers.create_thread([&buffer, producer, numberOfItemsPerProducer]() {
+        for (size_t i = 0; i < numberOfItemsPerProducer; ++i) {
+          while (!buffer.Push(std::make_pair(producer, i))) {
+            boost::this_thread::yield();
+          }
+        }
+      });
+    }
+
+    size_t sum = 0;
+    for (size_t numberOfConsumed = 0; numberOfConsumed < numberOfItems;) {
+      const auto result = buffer.ConsumeAll(
+          [&sum](const std::pair<size_t, size_t> &item) { sum += item.second; });
+      if (result) {
+        numberOfConsumed += result;
+        ++numberOfFlushes;
+      }
+    }
+    producers.join_all();
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(numberOfItems));
+  state.counters["itemsPerFlush"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * numberOfItems) /
+      static_cast<double>(std::max<size_t>(numberOfFlushes, 1)));
+}
+
+}  // namespace
+
+BENCHMARK(Lib_Concurrency_MultiProducerRingBuffer_PushConsume)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
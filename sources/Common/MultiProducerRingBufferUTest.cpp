@@ -0,0 +1,180 @@
+/**************************************************************************
+ *   Created: 2026/10/16 11:02:17
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Common/MultiProducerRingBuffer.hpp"
+
+namespace con = trdk::Lib::Concurrency;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+class Item {
+ public:
+  Item(size_t producer, size_t value) : m_producer(producer), m_value(value) {}
+
+ public:
+  size_t GetProducer() const { return m_producer; }
+  size_t GetValue() const { return m_value; }
+
+ private:
+  size_t m_producer;
+  size_t m_value;
+};
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+TEST(Lib_Concurrency_MultiProducerRingBuffer, SingleProducer) {
+  con::SingleProducerRingBuffer<std::unique_ptr<size_t>> buffer(3);
+  EXPECT_TRUE(buffer.IsEmpty());
+
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_TRUE(buffer.Push(boost::make_unique<size_t>(i)));
+  }
+  EXPECT_FALSE(buffer.IsEmpty());
+  {
+    auto item = boost::make_unique<size_t>(3);
+    EXPECT_FALSE(buffer.Push(std::move(item)));
+    ASSERT_TRUE(item != nullptr);
+  }
+
+  std::vector<size_t> result;
+  EXPECT_EQ(3, buffer.ConsumeAll([&result](std::unique_ptr<size_t> &item) {
+    result.emplace_back(*item);
+  }));
+  EXPECT_TRUE(buffer.IsEmpty());
+  EXPECT_EQ(std::vector<size_t>({0, 1, 2}), result);
+
+  // Wraps around buffer end:
+  EXPECT_TRUE(buffer.Push(boost::make_unique<size_t>(4)));
+  EXPECT_TRUE(buffer.Push(boost::make_unique<size_t>(5)));
+  result.clear();
+  EXPECT_EQ(2, buffer.ConsumeAll([&result](std::unique_ptr<size_t> &item) {
+    result.emplace_back(*item);
+  }));
+  EXPECT_EQ(std::vector<size_t>({4, 5}), result);
+}
+
+TEST(Lib_Concurrency_MultiProducerRingBuffer, ProducerSlots) {
+  con::MultiProducerRingBuffer<Item> buffer(1, 10);
+  EXPECT_EQ(1, buffer.GetNumberOfProducers());
+  EXPECT_EQ(0, buffer.GetNumberOfActiveProducers());
+
+  EXPECT_TRUE(buffer.Push(Item(0, 1)));
+  EXPECT_TRUE(buffer.Push(Item(0, 2)));
+  EXPECT_EQ(1, buffer.GetNumberOfActiveProducers());
+
+  // All slots are busy, the thread uses the shared locked queue:
+  boost::thread([&buffer]() {
+    for (size_t i = 1; i <= 10; ++i) {
+      EXPECT_TRUE(buffer.Push(Item(1, i)));
+    }
+    EXPECT_FALSE(buffer.Push(Item(1, 11)));
+  }).join();
+  EXPECT_EQ(1, buffer.GetNumberOfActiveProducers());
+  EXPECT_FALSE(buffer.IsEmpty());
+
+  std::vector<size_t> result;
+  EXPECT_EQ(12, buffer.ConsumeAll([&result](const Item &item) {
+    result.emplace_back(item.GetProducer() * 100 + item.GetValue());
+  }));
+  EXPECT_TRUE(buffer.IsEmpty());
+  EXPECT_EQ(std::vector<size_t>(
+                {1, 2, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110}),
+            result);
+
+  // The shared queue is available again after consuming:
+  boost::thread([&buffer]() { EXPECT_TRUE(buffer.Push(Item(2, 1))); }).join();
+  EXPECT_EQ(1, buffer.ConsumeAll([](const Item &) {}));
+  EXPECT_TRUE(buffer.IsEmpty());
+}
+
+TEST(Lib_Concurrency_MultiProducerRingBuffer, MoreThreadsThanSlots) {
+  const size_t numberOfSlots = 2;
+  const size_t numberOfProducers = 6;
+  const size_t numberOfItems = 20000;
+
+  con::MultiProducerRingBuffer<Item> buffer(numberOfSlots, 64);
+  std::vector<size_t> lastValues(numberOfProducers, 0);
+  size_t numberOfConsumed = 0;
+  const auto &consume = [&](const Item &item) {
+    ASSERT_GT(lastValues.size(), item.GetProducer());
+    auto &lastValue = lastValues[item.GetProducer()];
+    EXPECT_EQ(lastValue + 1, item.GetValue());
+    lastValue = item.GetValue();
+    ++numberOfConsumed;
+  };
+
+  boost::thread_group producers;
+  for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+    producers.create_thread([&buffer, producer, numberOfItems]() {
+      for (size_t value = 1; value <= numberOfItems; ++value) {
+        while (!buffer.Push(Item(producer, value))) {
+          boost::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  while (numberOfConsumed < numberOfProducers * numberOfItems) {
+    if (!buffer.ConsumeAll(consume)) {
+      boost::this_thread::yield();
+    }
+  }
+  producers.join_all();
+
+  EXPECT_TRUE(buffer.IsEmpty());
+  EXPECT_EQ(numberOfSlots, buffer.GetNumberOfActiveProducers());
+  for (const auto &lastValue : lastValues) {
+    EXPECT_EQ(numberOfItems, lastValue);
+  }
+}
+
+TEST(Lib_Concurrency_MultiProducerRingBuffer, Concurrency) {
+  const size_t numberOfProducers = 4;
+  const size_t numberOfItems = 100000;
+
+  con::MultiProducerRingBuffer<Item> buffer(numberOfProducers, 64);
+  std::vector<size_t> lastValues(numberOfProducers, 0);
+  size_t numberOfConsumed = 0;
+  const auto &consume = [&](const Item &item) {
+    ASSERT_GT(lastValues.size(), item.GetProducer());
+    auto &lastValue = lastValues[item.GetProducer()];
+    // Order from one producer is kept:
+    EXPECT_EQ(lastValue + 1, item.GetValue());
+    lastValue = item.GetValue();
+    ++numberOfConsumed;
+  };
+
+  boost::thread_group producers;
+  for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+    producers.create_thread([&buffer, producer, numberOfItems]() {
+      for (size_t value = 1; value <= numberOfItems; ++value) {
+        while (!buffer.Push(Item(producer, value))) {
+          boost::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  while (numberOfConsumed < numberOfProducers * numberOfItems) {
+    if (!buffer.ConsumeAll(consume)) {
+      boost::this_thread::yield();
+    }
+  }
+  producers.join_all();
+
+  EXPECT_TRUE(buffer.IsEmpty());
+  EXPECT_EQ(numberOfProducers, buffer.GetNumberOfActiveProducers());
+  for (const auto &lastValue : lastValues) {
+    EXPECT_EQ(numberOfItems, lastValue);
+  }
+}
@@ -0,0 +1,151 @@
+/**************************************************************************
+ *   Created: 2026/10/17 14:26:33
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#pragma once
+
+#include "Assert.hpp"
+#include <boost/atomic.hpp>
+#include <algorithm>
+#include <memory>
+
+namespace trdk {
+namespace Lib {
+namespace Concurrency {
+
+//! Lock-free limit of the number of events in the sliding time window.
+/**
+ * Keeps times of the last events in the ring of atomic slots. The next event
+ * takes the slot of the event which is the limit of events before it, so the
+ * event is allowed only if that event is out of the window. The slot is taken
+ * by CAS, each slot value is tagged by the ring round, so concurrent callers
+ * can't take the same slot twice and the limit is never exceeded.
+ *
+ * Time is any integer units from zero, the limiter keeps 48 bits of it, so
+ * it's enough for 8 years in microseconds.
+ */
+class SlidingWindowLimiter : private boost::noncopyable {
+ public:
+  typedef int64_t Time;
+
+  enum Result {
+    //! The event is added.
+    RESULT_ADDED,
+    //! The event is added, the next event at the same time will be rejected.
+    RESULT_ADDED_LAST,
+    //! The limit is reached, the event isn't added.
+    RESULT_REJECTED,
+  };
+
+ private:
+  typedef uint64_t Slot;
+  enum : Slot {
+    TIME_BITS = 48,
+    TIME_MASK = (Slot(1) << TIME_BITS) - 1,
+    NUMBER_OF_TAGS = (Slot(1) << (64 - TIME_BITS)) - 1,
+  };
+
+ public:
+  explicit SlidingWindowLimiter(size_t maxNumberOfEvents, const Time &period)
+      : m_size(maxNumberOfEvents),
+        m_period(period),
+        m_slots(new boost::atomic<Slot>[m_size]),
+        m_nextIndex(0) {
+    AssertLt(0, m_size);
+    AssertLt(0, m_period);
+    for (size_t i = 0; i < m_size; ++i) {
+      m_slots[i].store(0, boost::memory_order_relaxed);
+    }
+  }
+  //! Creates new limiter with the last events of another limiter.
+  /**
+   * Events which are added to the source limiter at the same time could be
+   * lost.
+   */
+  explicit SlidingWindowLimiter(size_t maxNumberOfEvents,
+                                const Time &period,
+                                const SlidingWindowLimiter &history)
+      : SlidingWindowLimiter(maxNumberOfEvents, period) {
+    const auto end = history.m_nextIndex.load(boost::memory_order_acquire);
+    const auto numberOfEvents = std::min(std::min(end, history.m_size), m_size);
+    for (uint64_t i = 0; i < numberOfEvents; ++i) {
+      const auto event =
+          history.m_slots[(end - numberOfEvents + i) % history.m_size].load(
+              boost::memory_order_acquire);
+      m_slots[i].store((CalcTag(i) << TIME_BITS) | (event & TIME_MASK),
+                       boost::memory_order_relaxed);
+    }
+    m_nextIndex.store(numberOfEvents, boost::memory_order_release);
+  }
+
+ public:
+  size_t GetMaxNumberOfEvents() const { return static_cast<size_t>(m_size); }
+  const Time &GetPeriod() const { return m_period; }
+
+  //! Adds the event if the limit allows it.
+  Result Add(const Time &time) {
+    AssertLe(0, time);
+    const auto eventTime =
+        static_cast<Slot>(std::max<Time>(0, time)) & TIME_MASK;
+    for (;;) {
+      auto index = m_nextIndex.load(boost::memory_order_acquire);
+      auto &slot = m_slots[index % m_size];
+      const auto tag = CalcTag(index);
+      auto prevEvent = slot.load(boost::memory_order_acquire);
+
+      if ((prevEvent >> TIME_BITS) == tag) {
+        // The slot is taken by another thread which didn't move the index yet.
+        m_nextIndex.compare_exchange_strong(index, index + 1,
+                                            boost::memory_order_acq_rel);
+        continue;
+      }
+      if (prevEvent && !IsOutOfWindow(prevEvent, eventTime)) {
+        return RESULT_REJECTED;
+      }
+
+      if (!slot.compare_exchange_strong(prevEvent,
+                                        (tag << TIME_BITS) | eventTime,
+                                        boost::memory_order_acq_rel)) {
+        continue;
+      }
+      {
+        auto expectedIndex = index;
+        m_nextIndex.compare_exchange_strong(expectedIndex, index + 1,
+                                            boost::memory_order_acq_rel);
+      }
+
+      const auto nextEvent =
+          m_slots[(index + 1) % m_size].load(boost::memory_order_acquire);
+      return nextEvent && (nextEvent >> TIME_BITS) != CalcTag(index + 1) &&
+                     !IsOutOfWindow(nextEvent, eventTime)
+                 ? RESULT_ADDED_LAST
+                 : RESULT_ADDED;
+    }
+  }
+
+ private:
+  //! Tag is never zero, zero slot is the slot without events.
+  Slot CalcTag(uint64_t index) const {
+    return (index / m_size) % NUMBER_OF_TAGS + 1;
+  }
+
+  bool IsOutOfWindow(const Slot &event, const Slot &time) const {
+    const auto eventTime = event & TIME_MASK;
+    return eventTime <= time && Time(time - eventTime) >= m_period;
+  }
+
+ private:
+  const uint64_t m_size;
+  const Time m_period;
+  const std::unique_ptr<boost::atomic<Slot>[]> m_slots;
+  boost::atomic<uint64_t> m_nextIndex;
+};
+}  // namespace Concurrency
+}  // namespace Lib
+}  // namespace trdk
@@ -0,0 +1,108 @@
+/**************************************************************************
+ *   Created: 2026/10/17 14:58:02
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Common/SlidingWindowLimiter.hpp"
+
+namespace lib = trdk::Lib;
+
+namespace {
+typedef lib::Concurrency::SlidingWindowLimiter Limiter;
+}
+
+TEST(Lib_SlidingWindowLimiter, Burst) {
+  Limiter limiter(3, 1000);
+  EXPECT_EQ(Limiter::RESULT_ADDED, limiter.Add(0));
+  EXPECT_EQ(Limiter::RESULT_ADDED, limiter.Add(0));
+  EXPECT_EQ(Limiter::RESULT_ADDED_LAST, limiter.Add(10));
+  EXPECT_EQ(Limiter::RESULT_REJECTED, limiter.Add(10));
+  EXPECT_EQ(Limiter::RESULT_REJECTED, limiter.Add(999));
+  // Two first events are out of the window:
+  EXPECT_EQ(Limiter::RESULT_ADDED, limiter.Add(1000));
+  EXPECT_EQ(Limiter::RESULT_ADDED_LAST, limiter.Add(1000));
+  EXPECT_EQ(Limiter::RESULT_REJECTED, limiter.Add(1009));
+  EXPECT_EQ(Limiter::RESULT_ADDED_LAST, limiter.Add(1010));
+  EXPECT_EQ(Limiter::RESULT_REJECTED, limiter.Add(1999));
+}
+
+TEST(Lib_SlidingWindowLimiter, NotMoreThanLimitInAnyWindow) {
+  // Token bucket allows 2N-1 events in the period after the burst, the window
+  // doesn't allow more than N.
+  const size_t limit = 10;
+  const Limiter::Time period = 1000;
+  Limiter limiter(limit, period);
+  std::vector<Limiter::Time> events;
+  for (Limiter::Time time = 0; time < period * 5; time += 7) {
+    if (limiter.Add(time) != Limiter::RESULT_REJECTED) {
+      events.emplace_back(time);
+    }
+  }
+  ASSERT_LE(limit * 5, events.size());
+  for (size_t i = limit; i < events.size(); ++i) {
+    EXPECT_LE(period, events[i] - events[i - limit]);
+  }
+}
+
+TEST(Lib_SlidingWindowLimiter, SingleEvent) {
+  Limiter limiter(1, 1000);
+  EXPECT_EQ(Limiter::RESULT_ADDED_LAST, limiter.Add(0));
+  EXPECT_EQ(Limiter::RESULT_REJECTED, limiter.Add(0));
+  EXPECT_EQ(Limiter::RESULT_REJECTED, limiter.Add(999));
+  EXPECT_EQ(Limiter::RESULT_ADDED_LAST, limiter.Add(1000));
+}
+
+TEST(Lib_SlidingWindowLimiter, History) {
+  Limiter source(3, 1000);
+  EXPECT_EQ(Limiter::RESULT_ADDED, source.Add(0));
+  EXPECT_EQ(Limiter::RESULT_ADDED, source.Add(100));
+  EXPECT_EQ(Limiter::RESULT_ADDED_LAST, source.Add(200));
+
+  {
+    // Takes only two last events:
+    Limiter limiter(2, 1000, source);
+    EXPECT_EQ(2, limiter.GetMaxNumberOfEvents());
+    EXPECT_EQ(1000, limiter.GetPeriod());
+    EXPECT_EQ(Limiter::RESULT_REJECTED, limiter.Add(1099));
+    EXPECT_EQ(Limiter::RESULT_ADDED_LAST, limiter.Add(1100));
+  }
+  {
+    Limiter limiter(5, 1000, source);
+    EXPECT_EQ(Limiter::RESULT_ADDED, limiter.Add(300));
+    EXPECT_EQ(Limiter::RESULT_ADDED_LAST, limiter.Add(300));
+    EXPECT_EQ(Limiter::RESULT_REJECTED, limiter.Add(999));
+    EXPECT_EQ(Limiter::RESULT_ADDED_LAST, limiter.Add(1000));
+  }
+  {
+    Limiter limiter(3, 1000, Limiter(3, 1000));
+    EXPECT_EQ(Limiter::RESULT_ADDED, limiter.Add(0));
+  }
+}
+
+TEST(Lib_SlidingWindowLimiter, Concurrent) {
+  const size_t limit = 100;
+  const size_t numberOfThreads = 4;
+  Limiter limiter(limit, 1000000);
+  boost::atomic_size_t numberOfEvents(0);
+  boost::barrier startBarrier(numberOfThreads);
+  boost::thread_group threads;
+  for (size_t i = 0; i < numberOfThreads; ++i) {
+    threads.create_thread([&]() {
+      startBarrier.wait();
+      // All events are in the same window:
+      for (size_t j = 0; j < limit; ++j) {
+        if (limiter.Add(j) != Limiter::RESULT_REJECTED) {
+          ++numberOfEvents;
+        }
+      }
+    });
+  }
+  threads.join_all();
+  EXPECT_EQ(limit, numberOfEvents);
+}
@@ -0,0 +1,184 @@
+/**************************************************************************
+ *   Created: 2026/10/17 09:24:51
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#pragma once
+
+#include "Assert.hpp"
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/make_unique.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/signals2/connection.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/weak_ptr.hpp>
+#include <memory>
+#include <vector>
+
+namespace trdk {
+namespace Lib {
+
+//! Slot connection, which is returned by a subscription.
+/**
+ * Could hold a boost::signals2 connection too, so a subscriber keeps
+ * connections of both kinds in one list. Disconnecting is idempotent, the
+ * connection could outlive the slot list.
+ */
+class SlotConnection {
+ public:
+  SlotConnection() = default;
+  SlotConnection(const boost::signals2::connection &connection)
+      : m_disconnect([connection]() { connection.disconnect(); }) {}
+  explicit SlotConnection(boost::function<void()> &&disconnect)
+      : m_disconnect(std::move(disconnect)) {}
+
+ public:
+  void Disconnect() const {
+    if (m_disconnect) {
+      m_disconnect();
+    }
+  }
+
+ private:
+  boost::function<void()> m_disconnect;
+};
+
+//! Disconnects the slot at destruction.
+class ScopedSlotConnection : private boost::noncopyable {
+ public:
+  explicit ScopedSlotConnection(SlotConnection &&connection)
+      : m_connection(std::move(connection)) {}
+  ScopedSlotConnection(ScopedSlotConnection &&rhs)
+      : m_connection(std::move(rhs.m_connection)) {
+    rhs.m_connection = SlotConnection();
+  }
+  ~ScopedSlotConnection() {
+    try {
+      m_connection.Disconnect();
+    } catch (...) {
+      AssertFailNoException();
+      terminate();
+    }
+  }
+
+ private:
+  SlotConnection m_connection;
+};
+
+//! Flat list of subscriber slots.
+/**
+ * Invoking walks a contiguous array of slots without connection tracking and
+ * result combining, so it costs one indirect call per slot. Connecting and
+ * disconnecting rebuild the array copy-on-write and publish it by an atomic
+ * pointer, so invoking is lock-free and is thread-safe with them. A slot
+ * which is disconnected while the list is invoked could still be called by
+ * this invoking.
+ *
+ * Replaced arrays are kept until the list destruction, as invoking doesn't
+ * track array references. So the list is for subscriptions which are changed
+ * rarely, like strategy subscriptions at the start and at the stop.
+ */
+template <typename Signature>
+class SlotList : private boost::noncopyable {
+ public:
+  typedef boost::function<Signature> Slot;
+
+ private:
+  struct Array {
+    std::vector<Slot> slots;
+    //! Slot IDs by slot indexes.
+    std::vector<uint64_t> ids;
+  };
+
+  struct State : private boost::noncopyable {
+    boost::mutex mutex;
+    uint64_t nextId;
+    boost::atomic<const Array *> current;
+    std::vector<std::unique_ptr<const Array>> arrays;
+
+    State() : nextId(0), current(nullptr) {}
+
+    void Publish(std::unique_ptr<const Array> &&array) {
+      arrays.emplace_back(std::move(array));
+      current.store(arrays.back().get(), boost::memory_order_release);
+    }
+
+    void Disconnect(const uint64_t &id) {
+      const boost::mutex::scoped_lock lock(mutex);
+      const auto *const prev = current.load(boost::memory_order_relaxed);
+      if (!prev) {
+        return;
+      }
+      auto array = boost::make_unique<Array>();
+      array->slots.reserve(prev->slots.size());
+      array->ids.reserve(prev->ids.size());
+      for (size_t i = 0; i < prev->ids.size(); ++i) {
+        if (prev->ids[i] != id) {
+          array->slots.emplace_back(prev->slots[i]);
+          array->ids.emplace_back(prev->ids[i]);
+        }
+      }
+      if (array->ids.size() != prev->ids.size()) {
+        Publish(std::move(array));
+      }
+    }
+  };
+
+ public:
+  SlotList() : m_state(boost::make_shared<State>()) {}
+
+ public:
+  SlotConnection Connect(const Slot &slot) {
+    uint64_t id;
+    {
+      const boost::mutex::scoped_lock lock(m_state->mutex);
+      const auto *const prev =
+          m_state->current.load(boost::memory_order_relaxed);
+      auto array = prev ? boost::make_unique<Array>(*prev)
+                        : boost::make_unique<Array>();
+      id = m_state->nextId++;
+      array->slots.emplace_back(slot);
+      array->ids.emplace_back(id);
+      m_state->Publish(std::move(array));
+    }
+    const boost::weak_ptr<State> state = m_state;
+    return SlotConnection([state, id]() {
+      const auto &lockedState = state.lock();
+      if (lockedState) {
+        lockedState->Disconnect(id);
+      }
+    });
+  }
+
+  bool IsEmpty() const {
+    const auto *const array =
+        m_state->current.load(boost::memory_order_acquire);
+    return !array || array->slots.empty();
+  }
+
+  template <typename... Args>
+  void operator()(const Args &... args) const {
+    const auto *const array =
+        m_state->current.load(boost::memory_order_acquire);
+    if (!array) {
+      return;
+    }
+    for (const auto &slot : array->slots) {
+      slot(args...);
+    }
+  }
+
+ private:
+  const boost::shared_ptr<State> m_state;
+};
+
+}  // namespace Lib
+}  // namespace trdk
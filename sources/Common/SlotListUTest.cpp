@@ -0,0 +1,83 @@
+/**************************************************************************
+ *   Created: 2026/10/17 09:51:12
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Common/SlotList.hpp"
+
+namespace lib = trdk::Lib;
+
+namespace {
+typedef lib::SlotList<void(int, const std::string &)> Slots;
+}
+
+TEST(Lib_SlotList, Invoke) {
+  Slots slots;
+  EXPECT_TRUE(slots.IsEmpty());
+  slots(1, "a");
+
+  std::vector<std::string> calls;
+  const auto &connection1 =
+      slots.Connect([&calls](int value, const std::string &name) {
+        calls.emplace_back("1" + name + std::to_string(value));
+      });
+  const auto &connection2 =
+      slots.Connect([&calls](int value, const std::string &name) {
+        calls.emplace_back("2" + name + std::to_string(value));
+      });
+  EXPECT_FALSE(slots.IsEmpty());
+  slots(1, "a");
+  EXPECT_EQ(std::vector<std::string>({"1a1", "2a1"}), calls);
+
+  calls.clear();
+  connection1.Disconnect();
+  connection1.Disconnect();
+  slots(2, "b");
+  EXPECT_EQ(std::vector<std::string>({"2b2"}), calls);
+
+  calls.clear();
+  connection2.Disconnect();
+  EXPECT_TRUE(slots.IsEmpty());
+  slots(3, "c");
+  EXPECT_TRUE(calls.empty());
+}
+
+TEST(Lib_SlotList, DisconnectWhileInvoking) {
+  Slots slots;
+  size_t numberOfCalls = 0;
+  lib::SlotConnection connection;
+  connection = slots.Connect([&](int, const std::string &) {
+    ++numberOfCalls;
+    connection.Disconnect();
+  });
+  slots.Connect([&](int, const std::string &) { ++numberOfCalls; });
+  slots(1, "a");
+  EXPECT_EQ(2, numberOfCalls);
+  slots(1, "a");
+  EXPECT_EQ(3, numberOfCalls);
+}
+
+TEST(Lib_SlotList, ConnectionLifetime) {
+  size_t numberOfCalls = 0;
+  lib::SlotConnection connection;
+  {
+    Slots slots;
+    {
+      const lib::ScopedSlotConnection scopedConnection(slots.Connect(
+          [&](int, const std::string &) { ++numberOfCalls; }));
+      slots(1, "a");
+      connection = slots.Connect(
+          [&](int, const std::string &) { numberOfCalls += 10; });
+    }
+    slots(1, "a");
+    EXPECT_EQ(11, numberOfCalls);
+  }
+  // The list is already destroyed.
+  connection.Disconnect();
+}
@@ -40,6 +40,11 @@ class SpinMutex {
 
   void Unlock() { m_state.clear(); }
 
+  //! For boost lockable concept.
+  void lock() { Lock(); }
+  //! For boost lockable concept.
+  void unlock() { Unlock(); }
+
  private:
   boost::atomic_flag m_state;
 };
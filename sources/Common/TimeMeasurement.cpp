@@ -143,13 +143,121 @@ const std::string &TimeMeasurement::GetMilestoneName(
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void MilestoneStat::Dump(std::ostream &os, size_t numberOfSubPeriods) const {
+uintmax_t TimeMeasurement::Detail::TakeStatAccumId() {
+  static boost::atomic<uintmax_t> nextId(1);
+  return nextId++;
+}
+
+namespace {
+//! Slots of existing stat accumulators, freed slots are taken first.
+class StatAccumSlots : private boost::noncopyable {
+ public:
+  StatAccumSlots() : m_numberOfSlots(0) {}
+
+  size_t Take() {
+    const boost::mutex::scoped_lock lock(m_mutex);
+    if (m_freeSlots.empty()) {
+      return m_numberOfSlots++;
+    }
+    const auto result = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    return result;
+  }
+
+  void Release(size_t slot) {
+    const boost::mutex::scoped_lock lock(m_mutex);
+    AssertGt(m_numberOfSlots, slot);
+    m_freeSlots.emplace_back(slot);
+  }
+
+ private:
+  boost::mutex m_mutex;
+  size_t m_numberOfSlots;
+  std::vector<size_t> m_freeSlots;
+};
+
+StatAccumSlots &GetStatAccumSlots() {
+  static StatAccumSlots result;
+  return result;
+}
+}  // namespace
+
+size_t TimeMeasurement::Detail::TakeStatAccumSlot() {
+  return GetStatAccumSlots().Take();
+}
+
+void TimeMeasurement::Detail::ReleaseStatAccumSlot(size_t slot) {
+  GetStatAccumSlots().Release(slot);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+PeriodFromStart Histogram::GetLowestValue(size_t index) {
+  AssertGt(SIZE, index);
+  if (index < SUB_BUCKET_COUNT) {
+    return static_cast<PeriodFromStart>(index);
+  }
+  index -= SUB_BUCKET_COUNT;
+  const auto bucket = index / SUB_BUCKET_HALF_COUNT + 1;
+  const auto subBucket = index % SUB_BUCKET_HALF_COUNT + SUB_BUCKET_HALF_COUNT;
+  return static_cast<PeriodFromStart>(subBucket) << bucket;
+}
+
+PeriodFromStart Histogram::GetHighestValue(size_t index) {
+  AssertGt(SIZE, index);
+  if (index < SUB_BUCKET_COUNT) {
+    return static_cast<PeriodFromStart>(index);
+  }
+  const auto bucket = (index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF_COUNT + 1;
+  return GetLowestValue(index) + (PeriodFromStart(1) << bucket) - 1;
+}
+
+PeriodFromStart Histogram::GetMin() const {
+  for (size_t i = 0; i < m_counts.size(); ++i) {
+    if (m_counts[i]) {
+      return GetLowestValue(i);
+    }
+  }
+  return 0;
+}
+
+PeriodFromStart Histogram::GetMax() const {
+  for (size_t i = m_counts.size(); i > 0; --i) {
+    if (m_counts[i - 1]) {
+      return GetHighestValue(i - 1);
+    }
+  }
+  return 0;
+}
+
+PeriodFromStart Histogram::GetPercentile(double percentile) const {
+  if (!m_size) {
+    return 0;
+  }
+  const auto limit = std::max<size_t>(
+      1, static_cast<size_t>(
+             std::ceil(std::min(percentile, 100.0) / 100 * m_size)));
+  size_t size = 0;
+  for (size_t i = 0; i < m_counts.size(); ++i) {
+    size += m_counts[i];
+    if (size >= limit) {
+      return GetHighestValue(i);
+    }
+  }
+  AssertFail("Histogram size is wrong.");
+  return GetMax();
+}
+
+void Histogram::Dump(std::ostream &os, size_t numberOfSubPeriods) const {
   os.setf(std::ios::left);
   const auto size = GetSize();
   os << std::setfill(' ') << std::setw(10) << size << '\t' << std::setfill(' ')
      << std::setw(10) << (size / numberOfSubPeriods) << '\t'
      << std::setfill(' ') << std::setw(10) << GetAvg() << '\t'
      << std::setfill(' ') << std::setw(10) << GetMin() << '\t'
+     << std::setfill(' ') << std::setw(10) << GetPercentile(50) << '\t'
+     << std::setfill(' ') << std::setw(10) << GetPercentile(99) << '\t'
+     << std::setfill(' ') << std::setw(10) << GetPercentile(99.9) << '\t'
      << std::setfill(' ') << std::setw(10) << GetMax();
 }
 
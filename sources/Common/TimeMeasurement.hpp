@@ -10,8 +10,11 @@
 
 #pragma once
 
+#include "Clock.hpp"
 #include <boost/array.hpp>
+#include <boost/atomic.hpp>
 #include <boost/chrono.hpp>
+#include <boost/multiprecision/integer.hpp>
 
 namespace trdk {
 namespace Lib {
@@ -23,6 +26,7 @@ class Timer;
 class Stat;
 
 typedef size_t MilestoneIndex;
+//! Period in nanoseconds.
 typedef intmax_t PeriodFromStart;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -82,16 +86,16 @@ class StatAccum {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+//! Measures periods by system-wide ticks of Clock.
 class Milestones {
  public:
-  typedef boost::chrono::high_resolution_clock Clock;
-  typedef Clock::time_point TimePoint;
+  typedef Clock::Ticks TimePoint;
 
  public:
   Milestones() {}
 
   explicit Milestones(const boost::shared_ptr<StatAccum> &stat)
-      : m_start(Clock::now()), m_stat(stat) {}
+      : m_start(GetNow()), m_stat(stat) {}
 
   Milestones(const Milestones &rhs)
       : m_start(rhs.m_start), m_stat(rhs.m_stat) {}
@@ -128,13 +132,11 @@ class Milestones {
   }
 
  public:
-  static TimePoint GetNow() { return Clock::now(); }
+  static TimePoint GetNow() { return Clock::GetTicks(); }
 
   static PeriodFromStart CalcPeriod(const TimePoint &start,
                                     const TimePoint &end) {
-    typedef boost::chrono::microseconds Result;
-    const auto period = end - start;
-    return boost::chrono::duration_cast<Result>(period).count();
+    return Clock::ConvertToNanoseconds(end - start);
   }
 
  private:
@@ -144,90 +146,223 @@ class Milestones {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-class MilestoneStat : private boost::noncopyable {
+//! Period histogram with the layout of HDR histogram.
+/**
+ * Periods less than SUB_BUCKET_COUNT nanoseconds are counted exactly, each
+ * next power of two is divided into SUB_BUCKET_COUNT / 2 buckets, so the
+ * relative error of any period is less than 2 / SUB_BUCKET_COUNT. Periods
+ * more than the last bucket (about 17 seconds) are counted in the last bucket.
+ */
+class Histogram {
  public:
-  MilestoneStat() : m_min(0), m_max(0), m_sum(0), m_size(0) {}
+  enum {
+    SUB_BUCKET_BITS = 7,
+    SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS,
+    SUB_BUCKET_HALF_COUNT = SUB_BUCKET_COUNT / 2,
+    NUMBER_OF_BUCKETS = 28,
+    SIZE = SUB_BUCKET_COUNT + (NUMBER_OF_BUCKETS - 1) * SUB_BUCKET_HALF_COUNT
+  };
 
  public:
-  operator bool() const { return m_size > 0; }
+  Histogram() { Reset(); }
 
-  MilestoneStat &operator|=(const PeriodFromStart &measurement) {
-    for (;;) {
-      auto prev = m_min.load(boost::memory_order_relaxed);
-      if ((prev && measurement >= prev) ||
-          m_min.compare_exchange_weak(prev, measurement,
-                                      boost::memory_order_release,
-                                      boost::memory_order_relaxed)) {
-        break;
-      }
-    }
-    for (;;) {
-      auto prev = m_max.load(boost::memory_order_relaxed);
-      if ((prev && measurement <= prev) ||
-          m_max.compare_exchange_weak(prev, measurement,
-                                      boost::memory_order_release,
-                                      boost::memory_order_relaxed)) {
-        break;
-      }
+ public:
+  static size_t GetIndex(const PeriodFromStart &period) {
+    if (period < SUB_BUCKET_COUNT) {
+      return period > 0 ? static_cast<size_t>(period) : 0;
     }
-    for (;;) {
-      auto prev = m_sum.load(boost::memory_order_relaxed);
-      auto sum = prev + measurement;
-      if (m_sum.compare_exchange_weak(prev, sum, boost::memory_order_release,
-                                      boost::memory_order_relaxed)) {
-        break;
-      }
+    const size_t bucket =
+        boost::multiprecision::msb(static_cast<uintmax_t>(period)) -
+        (SUB_BUCKET_BITS - 1);
+    if (bucket >= NUMBER_OF_BUCKETS) {
+      return SIZE - 1;
     }
-    ++m_size;
-    return *this;
+    return SUB_BUCKET_COUNT + (bucket - 1) * SUB_BUCKET_HALF_COUNT +
+           static_cast<size_t>(period >> bucket) - SUB_BUCKET_HALF_COUNT;
   }
+  static PeriodFromStart GetLowestValue(size_t index);
+  static PeriodFromStart GetHighestValue(size_t index);
 
  public:
+  operator bool() const { return m_size > 0; }
+
+  void Add(const PeriodFromStart &period) {
+    AddCount(GetIndex(period), 1);
+    AddSum(period);
+  }
+  void AddCount(size_t index, size_t count) {
+    AssertGt(m_counts.size(), index);
+    m_counts[index] += count;
+    m_size += count;
+  }
+  void AddSum(const PeriodFromStart &sum) { m_sum += sum; }
+
   void Dump(std::ostream &, size_t numberOfSubPeriods) const;
 
   size_t GetSize() const { return m_size; }
 
-  PeriodFromStart GetMax() const { return m_max; }
+  PeriodFromStart GetMin() const;
+  PeriodFromStart GetMax() const;
+  PeriodFromStart GetAvg() const {
+    return m_size > 0 ? m_sum / static_cast<PeriodFromStart>(m_size) : 0;
+  }
+  //! Returns the highest period of the bucket with the percentile.
+  /**
+   * @param percentile Percentile from 0 to 100, 99.9 for example.
+   */
+  PeriodFromStart GetPercentile(double percentile) const;
 
-  PeriodFromStart GetMin() const { return m_min; }
+  void Reset() {
+    m_counts.fill(0);
+    m_size = 0;
+    m_sum = 0;
+  }
 
-  PeriodFromStart GetAvg() const { return m_size > 0 ? m_sum / m_size : 0; }
+ private:
+  boost::array<size_t, SIZE> m_counts;
+  size_t m_size;
+  PeriodFromStart m_sum;
+};
 
-  void Reset() throw() {
-    m_min = 0;
-    m_max = 0;
-    m_sum = 0;
-    m_size = 0;
+////////////////////////////////////////////////////////////////////////////////
+
+//! Histogram, which is written by one thread and read by another.
+/**
+ * Counters are never reset, the reader remembers the counters which it has
+ * taken, so neither the writer nor the reader uses locks or interlocked
+ * operations.
+ */
+class ThreadHistogram : private boost::noncopyable {
+ public:
+  ThreadHistogram() : m_sum(0), m_takenSum(0) {
+    for (auto &count : m_counts) {
+      count.store(0, boost::memory_order_relaxed);
+    }
+    m_takenCounts.fill(0);
+  }
+
+ public:
+  //! Adds period, must be called only by the owner thread.
+  void Add(const PeriodFromStart &period) {
+    auto &count = m_counts[Histogram::GetIndex(period)];
+    count.store(count.load(boost::memory_order_relaxed) + 1,
+                boost::memory_order_release);
+    const auto sum = m_sum.load(boost::memory_order_relaxed) +
+                     (period > 0 ? static_cast<uintmax_t>(period) : 0);
+    m_sum.store(sum, boost::memory_order_release);
+  }
+
+  //! Adds to the histogram all periods, which are added after the previous
+  //! call, must be called only by one thread.
+  void Take(Histogram &destination) {
+    for (size_t i = 0; i < m_counts.size(); ++i) {
+      const auto count = m_counts[i].load(boost::memory_order_acquire);
+      if (count == m_takenCounts[i]) {
+        continue;
+      }
+      // Unsigned subtraction works also after the counter overflow.
+      destination.AddCount(i, static_cast<uint32_t>(count - m_takenCounts[i]));
+      m_takenCounts[i] = count;
+    }
+    const auto sum = m_sum.load(boost::memory_order_acquire);
+    destination.AddSum(static_cast<PeriodFromStart>(sum - m_takenSum));
+    m_takenSum = sum;
   }
 
  private:
-  boost::atomic<PeriodFromStart> m_min;
-  boost::atomic<PeriodFromStart> m_max;
-  boost::atomic<PeriodFromStart> m_sum;
-  volatile boost::atomic_size_t m_size;
+  boost::array<boost::atomic<uint32_t>, Histogram::SIZE> m_counts;
+  boost::atomic<uintmax_t> m_sum;
+
+  boost::array<uint32_t, Histogram::SIZE> m_takenCounts;
+  uintmax_t m_takenSum;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace Detail {
+uintmax_t TakeStatAccumId();
+//! Takes the slot which is unique between existing stat accumulators.
+size_t TakeStatAccumSlot();
+void ReleaseStatAccumSlot(size_t);
+}
+
+//! Collects milestone periods in per-thread histograms.
+/**
+ * Each thread writes only into its own histograms, which are created at the
+ * first measurement of the milestone in this thread. The report thread merges
+ * periods from all threads by TakeMilestones.
+ */
 template <size_t milestonesCount>
 class MilestonesStatAccum : public StatAccum {
  public:
-  typedef boost::array<MilestoneStat, milestonesCount> MilestonesStat;
+  typedef boost::array<Histogram, milestonesCount> MilestonesStat;
+
+ private:
+  struct ThreadStat : private boost::noncopyable {
+    boost::array<boost::atomic<ThreadHistogram *>, milestonesCount> milestones;
+    ThreadStat *next;
+
+    ThreadStat() : next(nullptr) {
+      for (auto &milestone : milestones) {
+        milestone.store(nullptr, boost::memory_order_relaxed);
+      }
+    }
+    ~ThreadStat() {
+      for (auto &milestone : milestones) {
+        delete milestone.load(boost::memory_order_relaxed);
+      }
+    }
+  };
 
  public:
-  virtual ~MilestonesStatAccum() {}
+  MilestonesStatAccum()
+      : m_id(Detail::TakeStatAccumId()),
+        m_slot(Detail::TakeStatAccumSlot()),
+        m_threads(nullptr) {}
+  virtual ~MilestonesStatAccum() {
+    for (auto *stat = m_threads.load(boost::memory_order_acquire); stat;) {
+      auto *const next = stat->next;
+      delete stat;
+      stat = next;
+    }
+    Detail::ReleaseStatAccumSlot(m_slot);
+  }
 
  public:
   virtual void AddMeasurement(const MilestoneIndex &milestone,
                               const PeriodFromStart &period) {
-    AssertGt(m_milestones.size(), milestone);
-    if (milestone >= m_milestones.size()) {
+    AssertGt(milestonesCount, milestone);
+    if (milestone >= milestonesCount) {
       return;
     }
-    m_milestones[milestone] |= period;
+    auto &histogram = GetThreadStat().milestones[milestone];
+    auto *histogramPtr = histogram.load(boost::memory_order_relaxed);
+    if (!histogramPtr) {
+      histogramPtr = new ThreadHistogram;
+      histogram.store(histogramPtr, boost::memory_order_release);
+    }
+    histogramPtr->Add(period);
   }
 
  public:
+  //! Replaces milestone stat by periods from all threads, which are added
+  //! after the previous call. Must be called only by one thread.
+  void TakeMilestones() {
+    for (auto &milestone : m_milestones) {
+      milestone.Reset();
+    }
+    for (auto *stat = m_threads.load(boost::memory_order_acquire); stat;
+         stat = stat->next) {
+      for (size_t i = 0; i < milestonesCount; ++i) {
+        auto *const histogram =
+            stat->milestones[i].load(boost::memory_order_acquire);
+        if (histogram) {
+          histogram->Take(m_milestones[i]);
+        }
+      }
+    }
+  }
+
   bool HasMeasures() const {
     for (const auto &milestone : m_milestones) {
       if (milestone.GetSize()) {
@@ -239,13 +374,35 @@ class MilestonesStatAccum : public StatAccum {
 
   const MilestonesStat &GetMilestones() const { return m_milestones; }
 
-  void Reset() {
-    for (auto &milestone : m_milestones) {
-      milestone.Reset();
+ private:
+  ThreadStat &GetThreadStat() {
+    // The cache is indexed by accumulator slots. Slots of destroyed
+    // accumulators are reused, so their records are replaced by records of new
+    // accumulators, and the cache is not longer than the maximum number of
+    // accumulators which existed at the same time. Accumulator IDs are never
+    // reused, so the ID shows that the record is not left by the destroyed
+    // accumulator with the same slot.
+    static thread_local std::vector<std::pair<uintmax_t, ThreadStat *>> cache;
+    if (m_slot < cache.size() && cache[m_slot].first == m_id) {
+      return *cache[m_slot].second;
+    }
+    auto *const result = new ThreadStat;
+    result->next = m_threads.load(boost::memory_order_relaxed);
+    while (!m_threads.compare_exchange_weak(result->next, result,
+                                            boost::memory_order_release,
+                                            boost::memory_order_relaxed)) {
+    }
+    if (cache.size() <= m_slot) {
+      cache.resize(m_slot + 1, std::make_pair(0, nullptr));
     }
+    cache[m_slot] = std::make_pair(m_id, result);
+    return *result;
   }
 
  private:
+  const uintmax_t m_id;
+  const size_t m_slot;
+  boost::atomic<ThreadStat *> m_threads;
   MilestonesStat m_milestones;
 };
 
@@ -0,0 +1,114 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 23:02:18
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "TimeMeasurement.hpp"
+
+using namespace trdk::Lib::TimeMeasurement;
+
+TEST(Common_TimeMeasurement, HistogramIndex) {
+  for (PeriodFromStart period = 0; period < Histogram::SUB_BUCKET_COUNT;
+       ++period) {
+    EXPECT_EQ(period, Histogram::GetIndex(period));
+  }
+  EXPECT_EQ(0, Histogram::GetIndex(-10));
+  for (const PeriodFromStart period :
+       {128, 129, 255, 256, 1000, 123456, 987654321}) {
+    const auto index = Histogram::GetIndex(period);
+    EXPECT_LE(Histogram::GetLowestValue(index), period);
+    EXPECT_GE(Histogram::GetHighestValue(index), period);
+    EXPECT_EQ(index + 1, Histogram::GetIndex(
+                             Histogram::GetHighestValue(index) + 1));
+    EXPECT_LT(Histogram::GetHighestValue(index) - period, period / 32);
+  }
+  EXPECT_EQ(Histogram::SIZE - 1,
+            Histogram::GetIndex(std::numeric_limits<PeriodFromStart>::max()));
+}
+
+TEST(Common_TimeMeasurement, HistogramPercentiles) {
+  Histogram histogram;
+  EXPECT_FALSE(histogram);
+  EXPECT_EQ(0, histogram.GetPercentile(99));
+  for (PeriodFromStart period = 1; period <= 1000; ++period) {
+    histogram.Add(period * 1000);
+  }
+  ASSERT_TRUE(histogram);
+  EXPECT_EQ(1000, histogram.GetSize());
+  EXPECT_EQ(500500, histogram.GetAvg());
+  EXPECT_EQ(1000, histogram.GetMin());
+  EXPECT_NEAR(500000, histogram.GetPercentile(50), 500000 / 64);
+  EXPECT_NEAR(990000, histogram.GetPercentile(99), 990000 / 64);
+  EXPECT_NEAR(999000, histogram.GetPercentile(99.9), 999000 / 64);
+  EXPECT_EQ(histogram.GetMax(), histogram.GetPercentile(100));
+  EXPECT_NEAR(1000000, histogram.GetMax(), 1000000 / 64);
+  histogram.Reset();
+  EXPECT_FALSE(histogram);
+}
+
+TEST(Common_TimeMeasurement, MilestonesStatAccum) {
+  MilestonesStatAccum<2> accum;
+  accum.TakeMilestones();
+  EXPECT_FALSE(accum.HasMeasures());
+
+  const auto &measure = [&accum](size_t number) {
+    for (size_t i = 1; i <= number; ++i) {
+      accum.AddMeasurement(1, i);
+    }
+  };
+  boost::thread_group threads;
+  for (size_t i = 0; i < 4; ++i) {
+    threads.create_thread([&measure]() { measure(1000); });
+  }
+  measure(100);
+  threads.join_all();
+
+  accum.TakeMilestones();
+  ASSERT_TRUE(accum.HasMeasures());
+  EXPECT_FALSE(accum.GetMilestones()[0]);
+  EXPECT_EQ(4100, accum.GetMilestones()[1].GetSize());
+  EXPECT_EQ(1, accum.GetMilestones()[1].GetMin());
+  EXPECT_EQ(Histogram::GetHighestValue(Histogram::GetIndex(1000)),
+            accum.GetMilestones()[1].GetMax());
+
+  measure(10);
+  accum.TakeMilestones();
+  EXPECT_EQ(10, accum.GetMilestones()[1].GetSize());
+  EXPECT_EQ(5, accum.GetMilestones()[1].GetAvg());
+
+  accum.TakeMilestones();
+  EXPECT_FALSE(accum.HasMeasures());
+}
+
+TEST(Common_TimeMeasurement, MilestonesStatAccumReplacement) {
+  // Each new accumulator takes the slot of the destroyed accumulator, so the
+  // thread finds it in the thread cache by the slot and has to see that the
+  // record is left by another accumulator:
+  for (size_t i = 1; i <= 10; ++i) {
+    MilestonesStatAccum<1> accum;
+    for (size_t j = 0; j < i; ++j) {
+      accum.AddMeasurement(0, 1);
+    }
+    accum.TakeMilestones();
+    EXPECT_EQ(i, accum.GetMilestones()[0].GetSize());
+  }
+
+  // Slots of existing accumulators are unique:
+  std::vector<std::unique_ptr<MilestonesStatAccum<1>>> accums(10);
+  for (size_t i = 0; i < accums.size(); ++i) {
+    accums[i] = boost::make_unique<MilestonesStatAccum<1>>();
+    for (size_t j = 0; j <= i; ++j) {
+      accums[i]->AddMeasurement(0, 1);
+    }
+  }
+  for (size_t i = 0; i < accums.size(); ++i) {
+    accums[i]->TakeMilestones();
+    EXPECT_EQ(i + 1, accums[i]->GetMilestones()[0].GetSize());
+  }
+}
@@ -0,0 +1,373 @@
+/**************************************************************************
+ *   Created: 2026/10/17 02:14:36
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#pragma once
+
+#include "Assert.hpp"
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+#include <boost/unordered_map.hpp>
+#include <array>
+#include <vector>
+
+namespace trdk {
+namespace Lib {
+
+//! Hierarchical timing wheel.
+/**
+ * Items are scheduled for ticks and are cancelled by groups. Scheduling and
+ * cancelling of an item take constant time, the advance takes time
+ * proportional to the number of expired items and non-empty wheel levels.
+ *
+ * Four levels of 256 slots cover 2^32 ticks ahead of the current tick, items
+ * which are farther are kept in the overflow list and are redistributed each
+ * 2^32 ticks. Items of one level-0 slot have the same tick. Items are not
+ * sorted inside a slot, so expired items of the same tick are not guaranteed
+ * to keep the scheduling order.
+ *
+ * Not thread-safe. Item has to be default constructible and movable, item
+ * storage is reused, so the wheel doesn't allocate memory when the number of
+ * scheduled items doesn't grow.
+ */
+template <typename ItemT, typename GroupT>
+class TimingWheel : private boost::noncopyable {
+ public:
+  typedef ItemT Item;
+  typedef GroupT Group;
+  typedef uint64_t Tick;
+
+ private:
+  enum : size_t {
+    SLOT_BITS = 8,
+    NUMBER_OF_SLOTS = 1 << SLOT_BITS,
+    NUMBER_OF_LEVELS = 4,
+    OVERFLOW_LIST = NUMBER_OF_LEVELS * NUMBER_OF_SLOTS,
+    EXPIRED_LIST,
+    NUMBER_OF_LISTS
+  };
+  static const Tick SLOT_MASK = NUMBER_OF_SLOTS - 1;
+
+  typedef uint32_t Index;
+  static const Index NONE = static_cast<Index>(-1);
+
+  struct Link {
+    Index prev;
+    Index next;
+  };
+  struct List {
+    Index head;
+    Index tail;
+    List() : head(NONE), tail(NONE) {}
+  };
+
+  struct Node {
+    Item item;
+    Group group;
+    Tick tick;
+    Index list;
+    Link link;
+    Link groupLink;
+  };
+
+ public:
+  explicit TimingWheel(const Tick &currentTick = 0)
+      : m_currentTick(currentTick), m_freeHead(NONE), m_size(0) {
+    m_levelSizes.fill(0);
+  }
+
+ public:
+  //! All ticks up to this one (including) are processed.
+  const Tick &GetCurrentTick() const { return m_currentTick; }
+
+  //! Number of scheduled items, including expired but not popped.
+  size_t GetSize() const { return m_size; }
+  bool IsEmpty() const { return m_size == 0; }
+
+  //! Schedules item.
+  /**
+   * An item for the current or a past tick is expired at once.
+   */
+  void Add(const Tick &tick, const Group &group, Item &&item) {
+    const auto index = Allocate();
+    auto &node = m_nodes[index];
+    node.item = std::move(item);
+    node.group = group;
+    node.tick = tick;
+
+    auto &groupList = m_groups[group];
+    node.groupLink = {groupList.tail, NONE};
+    if (groupList.tail != NONE) {
+      m_nodes[groupList.tail].groupLink.next = index;
+    } else {
+      groupList.head = index;
+    }
+    groupList.tail = index;
+
+    Place(index);
+    ++m_size;
+  }
+
+  //! Removes all group items, including expired but not popped.
+  /**
+   * @param callback  Called for each removed item before removing.
+   * @return Number of removed items.
+   */
+  template <typename Callback>
+  size_t Cancel(const Group &group, const Callback &callback) {
+    const auto it = m_groups.find(group);
+    if (it == m_groups.cend()) {
+      return 0;
+    }
+    size_t result = 0;
+    for (auto index = it->second.head; index != NONE;) {
+      auto &node = m_nodes[index];
+      const auto next = node.groupLink.next;
+      callback(static_cast<const Item &>(node.item), node.tick);
+      Unlink(index);
+      Release(index);
+      ++result;
+      index = next;
+    }
+    m_groups.erase(it);
+    m_size -= result;
+    return result;
+  }
+  size_t Cancel(const Group &group) {
+    return Cancel(group, [](const Item &, const Tick &) {});
+  }
+
+  //! Expires all items with ticks up to the given tick (including).
+  void Advance(const Tick &tick) {
+    while (m_currentTick < tick) {
+      // Nothing happens before the next cascade from the lowest non-empty
+      // level, so empty ticks are skipped.
+      size_t level = 0;
+      while (level < NUMBER_OF_LEVELS && m_levelSizes[level] == 0) {
+        ++level;
+      }
+      if (level > 0) {
+        if (level == NUMBER_OF_LEVELS &&
+            m_lists[OVERFLOW_LIST].head == NONE) {
+          m_currentTick = tick;
+          break;
+        }
+        const Tick step = Tick(1) << (SLOT_BITS * level);
+        const Tick boundary = (m_currentTick | (step - 1)) + 1;
+        if (boundary == 0 || boundary > tick) {
+          m_currentTick = tick;
+          break;
+        }
+        m_currentTick = boundary - 1;
+      }
+      ++m_currentTick;
+      Cascade();
+      MoveList(m_currentTick & SLOT_MASK, EXPIRED_LIST);
+    }
+  }
+
+  //! Returns the nearest tick at which Advance changes the wheel.
+  /**
+   * It's the tick of the nearest item or the tick at which items of a higher
+   * level are redistributed, so it could be less than the nearest item tick.
+   */
+  boost::optional<Tick> GetNextTick() const {
+    if (m_lists[EXPIRED_LIST].head != NONE) {
+      return m_currentTick;
+    }
+    for (size_t level = 0; level < NUMBER_OF_LEVELS; ++level) {
+      if (m_levelSizes[level] == 0) {
+        continue;
+      }
+      const auto shift = SLOT_BITS * level;
+      const auto current = (m_currentTick >> shift) & SLOT_MASK;
+      for (auto slot = current + 1; slot < NUMBER_OF_SLOTS; ++slot) {
+        if (m_lists[level * NUMBER_OF_SLOTS + slot].head != NONE) {
+          return ((m_currentTick >> (shift + SLOT_BITS)) << (shift + SLOT_BITS)) |
+                 (slot << shift);
+        }
+      }
+      AssertFail("Level has items only after the current slot.");
+    }
+    if (m_lists[OVERFLOW_LIST].head != NONE) {
+      const Tick step = Tick(1) << (SLOT_BITS * NUMBER_OF_LEVELS);
+      return (m_currentTick | (step - 1)) + 1;
+    }
+    return boost::none;
+  }
+
+  bool HasExpired() const { return m_lists[EXPIRED_LIST].head != NONE; }
+
+  //! Takes the first expired item.
+  /**
+   * @return false if there are no expired items.
+   */
+  bool PopExpired(Item &result) {
+    const auto index = m_lists[EXPIRED_LIST].head;
+    if (index == NONE) {
+      return false;
+    }
+    auto &node = m_nodes[index];
+    result = std::move(node.item);
+
+    const auto group = m_groups.find(node.group);
+    Assert(group != m_groups.cend());
+    Unlink(index);
+    if (group->second.head == NONE) {
+      m_groups.erase(group);
+    }
+    Release(index);
+    --m_size;
+    return true;
+  }
+
+  //! Removes all items.
+  void Clear() {
+    m_lists.fill(List());
+    m_levelSizes.fill(0);
+    m_groups.clear();
+    m_nodes.clear();
+    m_freeHead = NONE;
+    m_size = 0;
+  }
+
+ private:
+  Index Allocate() {
+    if (m_freeHead != NONE) {
+      const auto result = m_freeHead;
+      m_freeHead = m_nodes[result].link.next;
+      return result;
+    }
+    m_nodes.emplace_back();
+    return static_cast<Index>(m_nodes.size() - 1);
+  }
+
+  void Release(const Index &index) {
+    auto &node = m_nodes[index];
+    node.item = Item();
+    node.list = NONE;
+    node.link.next = m_freeHead;
+    m_freeHead = index;
+  }
+
+  //! Puts node into the list by its tick relatively to the current tick.
+  void Place(const Index &index) {
+    const auto &tick = m_nodes[index].tick;
+    if (tick <= m_currentTick) {
+      Push(index, EXPIRED_LIST);
+      return;
+    }
+    for (size_t level = 0; level < NUMBER_OF_LEVELS; ++level) {
+      const auto shift = SLOT_BITS * (level + 1);
+      if ((tick >> shift) == (m_currentTick >> shift)) {
+        Push(index, level * NUMBER_OF_SLOTS +
+                        ((tick >> (SLOT_BITS * level)) & SLOT_MASK));
+        return;
+      }
+    }
+    Push(index, OVERFLOW_LIST);
+  }
+
+  //! Redistributes items of higher levels when lower level slots are passed.
+  void Cascade() {
+    if (m_currentTick & SLOT_MASK) {
+      return;
+    }
+    for (size_t level = 1; level < NUMBER_OF_LEVELS; ++level) {
+      const auto slot = (m_currentTick >> (SLOT_BITS * level)) & SLOT_MASK;
+      Redistribute(level * NUMBER_OF_SLOTS + slot);
+      if (slot) {
+        return;
+      }
+    }
+    Redistribute(OVERFLOW_LIST);
+  }
+
+  void Redistribute(const size_t &listIndex) {
+    auto index = m_lists[listIndex].head;
+    if (index == NONE) {
+      return;
+    }
+    m_lists[listIndex] = List();
+    while (index != NONE) {
+      const auto next = m_nodes[index].link.next;
+      if (listIndex < OVERFLOW_LIST) {
+        AssertLt(0, m_levelSizes[listIndex / NUMBER_OF_SLOTS]);
+        --m_levelSizes[listIndex / NUMBER_OF_SLOTS];
+      }
+      Place(index);
+      index = next;
+    }
+  }
+
+  void MoveList(const size_t &source, const size_t &destination) {
+    auto index = m_lists[source].head;
+    m_lists[source] = List();
+    while (index != NONE) {
+      const auto next = m_nodes[index].link.next;
+      AssertLt(0, m_levelSizes[source / NUMBER_OF_SLOTS]);
+      --m_levelSizes[source / NUMBER_OF_SLOTS];
+      Push(index, destination);
+      index = next;
+    }
+  }
+
+  void Push(const Index &index, const size_t &listIndex) {
+    auto &node = m_nodes[index];
+    auto &list = m_lists[listIndex];
+    node.list = static_cast<Index>(listIndex);
+    node.link = {list.tail, NONE};
+    if (list.tail != NONE) {
+      m_nodes[list.tail].link.next = index;
+    } else {
+      list.head = index;
+    }
+    list.tail = index;
+    if (listIndex < OVERFLOW_LIST) {
+      ++m_levelSizes[listIndex / NUMBER_OF_SLOTS];
+    }
+  }
+
+  //! Removes node from its list and from its group list.
+  void Unlink(const Index &index) {
+    auto &node = m_nodes[index];
+
+    {
+      auto &list = m_lists[node.list];
+      (node.link.prev != NONE ? m_nodes[node.link.prev].link.next
+                              : list.head) = node.link.next;
+      (node.link.next != NONE ? m_nodes[node.link.next].link.prev
+                              : list.tail) = node.link.prev;
+      if (node.list < OVERFLOW_LIST) {
+        AssertLt(0, m_levelSizes[node.list / NUMBER_OF_SLOTS]);
+        --m_levelSizes[node.list / NUMBER_OF_SLOTS];
+      }
+    }
+
+    {
+      auto &list = m_groups[node.group];
+      (node.groupLink.prev != NONE ? m_nodes[node.groupLink.prev].groupLink.next
+                                   : list.head) = node.groupLink.next;
+      (node.groupLink.next != NONE ? m_nodes[node.groupLink.next].groupLink.prev
+                                   : list.tail) = node.groupLink.prev;
+    }
+  }
+
+ private:
+  Tick m_currentTick;
+  std::vector<Node> m_nodes;
+  Index m_freeHead;
+  std::array<List, NUMBER_OF_LISTS> m_lists;
+  std::array<size_t, NUMBER_OF_LEVELS> m_levelSizes;
+  boost::unordered_map<Group, List> m_groups;
+  size_t m_size;
+};
+
+}  // namespace Lib
+}  // namespace trdk
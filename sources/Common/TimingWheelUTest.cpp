@@ -0,0 +1,142 @@
+/**************************************************************************
+ *   Created: 2026/10/17 02:58:03
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Common/TimingWheel.hpp"
+
+namespace lib = trdk::Lib;
+
+namespace {
+typedef lib::TimingWheel<size_t, size_t> Wheel;
+
+std::vector<size_t> PopAll(Wheel &wheel) {
+  std::vector<size_t> result;
+  for (size_t item; wheel.PopExpired(item);) {
+    result.emplace_back(item);
+  }
+  return result;
+}
+}  // namespace
+
+TEST(Lib_TimingWheel, Expiration) {
+  Wheel wheel(100);
+  EXPECT_FALSE(wheel.GetNextTick());
+
+  wheel.Add(105, 1, 1);
+  wheel.Add(100, 1, 2);
+  wheel.Add(400, 2, 3);
+  wheel.Add(105, 2, 4);
+  wheel.Add(100 + (uint64_t(1) << 40), 3, 5);
+  EXPECT_EQ(5, wheel.GetSize());
+
+  ASSERT_TRUE(wheel.HasExpired());
+  EXPECT_EQ(100, *wheel.GetNextTick());
+  EXPECT_EQ(std::vector<size_t>({2}), PopAll(wheel));
+  EXPECT_EQ(105, *wheel.GetNextTick());
+
+  wheel.Advance(104);
+  EXPECT_FALSE(wheel.HasExpired());
+  wheel.Advance(105);
+  EXPECT_EQ(std::vector<size_t>({1, 4}), PopAll(wheel));
+  // The next change is the level 1 redistribution.
+  EXPECT_EQ(256, *wheel.GetNextTick());
+
+  wheel.Advance(399);
+  EXPECT_FALSE(wheel.HasExpired());
+  EXPECT_EQ(400, *wheel.GetNextTick());
+  wheel.Advance(1000);
+  EXPECT_EQ(std::vector<size_t>({3}), PopAll(wheel));
+  EXPECT_EQ(1000, wheel.GetCurrentTick());
+
+  wheel.Advance(100 + (uint64_t(1) << 40) - 1);
+  EXPECT_FALSE(wheel.HasExpired());
+  wheel.Advance(100 + (uint64_t(1) << 40));
+  EXPECT_EQ(std::vector<size_t>({5}), PopAll(wheel));
+  EXPECT_TRUE(wheel.IsEmpty());
+  EXPECT_FALSE(wheel.GetNextTick());
+}
+
+TEST(Lib_TimingWheel, Cancel) {
+  Wheel wheel;
+  wheel.Add(10, 1, 1);
+  wheel.Add(100000, 1, 2);
+  wheel.Add(10, 2, 3);
+  wheel.Add(0, 1, 4);
+
+  std::vector<size_t> cancelled;
+  EXPECT_EQ(3, wheel.Cancel(1, [&cancelled](const size_t &item,
+                                            const Wheel::Tick &) {
+    cancelled.emplace_back(item);
+  }));
+  EXPECT_EQ(std::vector<size_t>({1, 2, 4}), cancelled);
+  EXPECT_EQ(0, wheel.Cancel(1));
+  EXPECT_EQ(1, wheel.GetSize());
+  EXPECT_FALSE(wheel.HasExpired());
+
+  wheel.Advance(100000);
+  EXPECT_EQ(std::vector<size_t>({3}), PopAll(wheel));
+  EXPECT_EQ(0, wheel.Cancel(2));
+}
+
+TEST(Lib_TimingWheel, Random) {
+  boost::mt19937 random(42);
+  Wheel wheel;
+  std::multimap<Wheel::Tick, size_t> expected;
+  boost::unordered_map<size_t, size_t> groups;
+  size_t nextItem = 0;
+
+  for (size_t step = 0; step < 2000; ++step) {
+    for (size_t i = random() % 10; i > 0; --i) {
+      const auto delay =
+          random() % 3 == 0 ? random() % 1000 : random() % 100000000;
+      const auto tick = wheel.GetCurrentTick() + delay;
+      const auto group = random() % 100;
+      wheel.Add(tick, group, size_t(nextItem));
+      expected.emplace(tick, nextItem);
+      groups[nextItem] = group;
+      ++nextItem;
+    }
+    if (random() % 5 == 0) {
+      const auto group = random() % 100;
+      const auto count = wheel.Cancel(group);
+      size_t expectedCount = 0;
+      for (auto it = expected.begin(); it != expected.end();) {
+        if (groups[it->second] == group) {
+          it = expected.erase(it);
+          ++expectedCount;
+        } else {
+          ++it;
+        }
+      }
+      ASSERT_EQ(expectedCount, count);
+    }
+
+    const auto nextTick = wheel.GetNextTick();
+    ASSERT_EQ(expected.empty(), !nextTick);
+    if (nextTick) {
+      ASSERT_LE(*nextTick, expected.cbegin()->first);
+    }
+
+    const auto target = wheel.GetCurrentTick() + random() % 5000000;
+    wheel.Advance(target);
+    ASSERT_EQ(target, wheel.GetCurrentTick());
+
+    std::vector<size_t> expectedItems;
+    while (!expected.empty() && expected.cbegin()->first <= target) {
+      expectedItems.emplace_back(expected.cbegin()->second);
+      expected.erase(expected.cbegin());
+    }
+    auto items = PopAll(wheel);
+    std::sort(items.begin(), items.end());
+    std::sort(expectedItems.begin(), expectedItems.end());
+    ASSERT_EQ(expectedItems, items);
+    ASSERT_EQ(expected.size(), wheel.GetSize());
+  }
+}
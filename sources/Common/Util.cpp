@@ -295,6 +295,29 @@ fs::path Lib::Normalize(const fs::path &path, const fs::path &workingDir) {
   return result;
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+void Lib::PinCurrentThreadToCpu(size_t cpu) {
+#ifdef BOOST_WINDOWS
+  if (cpu >= sizeof(DWORD_PTR) * 8 ||
+      !::SetThreadAffinityMask(::GetCurrentThread(), DWORD_PTR(1) << cpu)) {
+    const SysError error(::GetLastError());
+#else
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(cpu, &cpuSet);
+  const auto result =
+      pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+  if (result) {
+    const SysError error(result);
+#endif
+    boost::format message(
+        "Failed to pin thread to CPU %1% (system error: \"%2%\")");
+    message % cpu % error;
+    throw SystemException(message.str().c_str());
+  }
+}
+
   //////////////////////////////////////////////////////////////////////////
 
 #ifdef BOOST_WINDOWS
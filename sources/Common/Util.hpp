@@ -59,6 +59,14 @@ boost::filesystem::path Normalize(
 
 //////////////////////////////////////////////////////////////////////////
 
+//! Binds the current thread to the CPU with the given index.
+/**
+ * @throw trdk::Lib::SystemException if the operation failed.
+ */
+void PinCurrentThreadToCpu(size_t cpu);
+
+//////////////////////////////////////////////////////////////////////////
+
 //! UTC - Coordinated Universal Time.
 boost::posix_time::time_duration GetUtcTimeZoneDiff(
     const boost::local_time::time_zone_ptr &localTimeZone);
@@ -69,6 +69,7 @@ class WebSocketConnection::Implementation {
 
   void Run(const Events &events) {
     io::spawn(m_ioContext, [this, &events](const io::yield_context &yield) {
+      Json::Document document;
       for (io::streambuf buffer;;) {
         boost::system::error_code error;
         m_stream.async_read(buffer, yield[error]);
@@ -90,50 +91,37 @@ class WebSocketConnection::Implementation {
         }
         const auto data = buffer.data();
 
-        ptr::ptree message;
-        {
-          std::istream is(&buffer);
+        bool isSuccess;
+        if (events.jsonMessage) {
+          boost::optional<Json::Value> message;
           try {
-            message = m_self.ParseJson(is);
-            AssertEq(0, buffer.size());
-          } catch (const ptr::json_parser_error &ex) {
-            boost::format errorMessage(
-                R"(Failed to parse server response: "%1%". Message: %2%)");
-            errorMessage % ex.what()  // 1
-                % std::string(io::buffers_begin(data),
-                              io::buffers_end(data));  // 2
-            events.debug(errorMessage.str());
+            message = document.Parse(static_cast<const char *>(data.data()),
+                                     data.size());
+          } catch (const Json::ParseError &ex) {
+            ReportParseError(events, ex, data);
             return;
           }
+          isSuccess = Notify(events, data, [&events, &info, &message]() {
+            events.jsonMessage(std::move(info), *message);
+          });
+          buffer.consume(size);
+        } else {
+          ptr::ptree message;
+          {
+            std::istream is(&buffer);
+            try {
+              message = m_self.ParseJson(is);
+              AssertEq(0, buffer.size());
+            } catch (const ptr::json_parser_error &ex) {
+              ReportParseError(events, ex, data);
+              return;
+            }
+          }
+          isSuccess = Notify(events, data, [&events, &info, &message]() {
+            events.message(std::move(info), message);
+          });
         }
-
-        try {
-          events.message(std::move(info), message);
-        } catch (const Exception &ex) {
-          boost::format errorMessage(
-              "Application error occurred while reading server message: "
-              "\"%1%\". Message: %2%");
-          errorMessage % ex.what()  // 1
-              % std::string(io::buffers_begin(data),
-                            io::buffers_end(data));  // 2
-          events.error(errorMessage.str());
-        } catch (const std::exception &ex) {
-          boost::format errorMessage(
-              "System error occurred while reading server message: \"%1%\". "
-              "Message: %2%");
-          errorMessage % ex.what()  // 1
-              % std::string(io::buffers_begin(data),
-                            io::buffers_end(data));  // 2
-          events.error(errorMessage.str());
-          return;
-        } catch (...) {
-          boost::format errorMessage(
-              "Unknown error occurred while reading server message. "
-              "Message: %1%");
-          errorMessage % std::string(io::buffers_begin(data),
-                                     io::buffers_end(data));  // 1
-          events.error(errorMessage.str());
-          AssertFailNoException();
+        if (!isSuccess) {
           return;
         }
       }
@@ -142,6 +130,55 @@ class WebSocketConnection::Implementation {
     m_ioContext.run();
     events.disconnect();
   }
+
+ private:
+  template <typename Data>
+  static void ReportParseError(const Events &events,
+                               const std::exception &ex,
+                               const Data &data) {
+    boost::format errorMessage(
+        R"(Failed to parse server response: "%1%". Message: %2%)");
+    errorMessage % ex.what()  // 1
+        % std::string(io::buffers_begin(data), io::buffers_end(data));  // 2
+    events.debug(errorMessage.str());
+  }
+
+  //! Returns false if the connection has to be closed.
+  template <typename Data, typename Callback>
+  static bool Notify(const Events &events,
+                     const Data &data,
+                     const Callback &callback) {
+    try {
+      callback();
+    } catch (const Exception &ex) {
+      boost::format errorMessage(
+          "Application error occurred while reading server message: "
+          "\"%1%\". Message: %2%");
+      errorMessage % ex.what()  // 1
+          % std::string(io::buffers_begin(data),
+                        io::buffers_end(data));  // 2
+      events.error(errorMessage.str());
+    } catch (const std::exception &ex) {
+      boost::format errorMessage(
+          "System error occurred while reading server message: \"%1%\". "
+          "Message: %2%");
+      errorMessage % ex.what()  // 1
+          % std::string(io::buffers_begin(data),
+                        io::buffers_end(data));  // 2
+      events.error(errorMessage.str());
+      return false;
+    } catch (...) {
+      boost::format errorMessage(
+          "Unknown error occurred while reading server message. "
+          "Message: %1%");
+      errorMessage % std::string(io::buffers_begin(data),
+                                 io::buffers_end(data));  // 1
+      events.error(errorMessage.str());
+      AssertFailNoException();
+      return false;
+    }
+    return true;
+  }
 };
 
 WebSocketConnection::WebSocketConnection(std::string host)
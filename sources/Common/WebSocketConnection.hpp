@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "Json.hpp"
 #include "TimeMeasurement.hpp"
 
 namespace trdk {
@@ -27,6 +28,10 @@ class WebSocketConnection {
     const boost::function<void(EventInfo, const boost::property_tree::ptree&)>
         message;
     boost::function<void()> disconnect;
+    //! If set, messages are parsed in-situ and passed to this handler instead
+    //! of "message". The value refers to the receive buffer and is valid only
+    //! during the call. ParseJson is not used for such messages.
+    boost::function<void(EventInfo, const Json::Value&)> jsonMessage;
 
     boost::function<void(const std::string&)> debug;
     boost::function<void(const std::string&)> info;
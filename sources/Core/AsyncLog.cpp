@@ -13,6 +13,66 @@
 #include "Security.hpp"
 
 using namespace trdk;
+using namespace trdk::Lib::Concurrency;
+
+namespace {
+
+class OverflowBufferPool : private boost::noncopyable {
+ public:
+  typedef std::vector<char> Buffer;
+
+ private:
+  enum { MAX_SIZE = 64, BUFFER_CAPACITY = 1024 };
+
+ public:
+  OverflowBufferPool() { m_buffers.reserve(MAX_SIZE); }
+
+  Buffer *Take() {
+    {
+      const SpinScopedLock lock(m_mutex);
+      if (!m_buffers.empty()) {
+        auto *const result = m_buffers.back();
+        m_buffers.pop_back();
+        return result;
+      }
+    }
+    auto result = boost::make_unique<Buffer>();
+    result->reserve(BUFFER_CAPACITY);
+    return result.release();
+  }
+
+  void Return(Buffer *buffer) noexcept {
+    buffer->clear();
+    {
+      const SpinScopedLock lock(m_mutex);
+      if (m_buffers.size() < MAX_SIZE) {
+        // Capacity is reserved, so it doesn't throw.
+        m_buffers.emplace_back(buffer);
+        return;
+      }
+    }
+    delete buffer;
+  }
+
+ private:
+  SpinMutex m_mutex;
+  std::vector<Buffer *> m_buffers;
+};
+
+OverflowBufferPool &GetOverflowBufferPool() {
+  // Never destroyed as records may be destroyed by static objects at the exit.
+  static auto *const result = new OverflowBufferPool;
+  return *result;
+}
+}  // namespace
+
+AsyncLogRecord::OverflowBuffer *AsyncLogRecord::TakeOverflowBuffer() {
+  return GetOverflowBufferPool().Take();
+}
+
+void AsyncLogRecord::ReturnOverflowBuffer(OverflowBuffer *buffer) noexcept {
+  GetOverflowBufferPool().Return(buffer);
+}
 
 void AsyncLogRecord::WriteToDumpStream(const Security &security,
                                        boost::format &os) {
@@ -11,15 +11,23 @@
 #pragma once
 
 #include "Api.h"
+#include <boost/utility/string_ref.hpp>
+#include <array>
 
 namespace trdk {
 
 ////////////////////////////////////////////////////////////////////////////////
 
 //! Log record with delayed formatting.
+/** Parameters are stored in the inline buffer with the compact tagged encoding:
+ *  one byte of the parameter type and the value bytes, strings are stored as
+ *  length and characters. If the inline buffer is full, next parameters are
+ *  stored in the overflow buffer from the pool. So the record creation doesn't
+ *  allocate memory, all formatting is done by the writer thread.
+ */
 class TRDK_CORE_API AsyncLogRecord {
  private:
-  enum ParamType {
+  enum ParamType : char {
 
     PT_INT8,
     PT_UINT8,
@@ -66,16 +74,46 @@ class TRDK_CORE_API AsyncLogRecord {
 
   };
 
+  typedef trdk::Lib::BusinessNumeric<
+      double,
+      trdk::Lib::Detail::DoubleWithFixedPrecisionNumericPolicy<8>>
+      DoubleBusiness8;
+
+  typedef uint32_t StringSize;
+
+  typedef std::vector<char> OverflowBuffer;
+
+  enum { INLINE_BUFFER_SIZE = 256 };
+
  public:
   explicit AsyncLogRecord(const boost::posix_time::ptime &time,
                           const trdk::Log::ThreadId &threadId)
-      : m_time(time), m_threadId(threadId) {}
+      : m_time(time), m_threadId(threadId), m_size(0), m_overflow(nullptr) {}
+  AsyncLogRecord(AsyncLogRecord &&rhs) noexcept
+      : m_time(std::move(rhs.m_time)),
+        m_threadId(std::move(rhs.m_threadId)),
+        m_size(rhs.m_size),
+        m_overflow(rhs.m_overflow) {
+    std::memcpy(m_buffer.data(), rhs.m_buffer.data(), m_size);
+    rhs.m_size = 0;
+    rhs.m_overflow = nullptr;
+  }
+  ~AsyncLogRecord() {
+    if (m_overflow) {
+      ReturnOverflowBuffer(m_overflow);
+    }
+  }
+
+ private:
+  AsyncLogRecord(const AsyncLogRecord &);
+  const AsyncLogRecord &operator=(const AsyncLogRecord &);
 
  public:
   //! Schedules delayed formatting.
   /** Stores params for log record until it will be really written.
-   *  WARNING! Pointer to C-string and all other not POD types must be available
-   *  all time while module is active! Methods stores only pointers, not values.
+   *  WARNING! Pointer to C-string, references to strings and securities must
+   *  be available all time while module is active! Methods stores only
+   *  pointers for such params, other values are copied.
    *
    *  @sa trdk::AsyncLog::AsyncLogRecord::operator %
    *  @sa trdk::AsyncLog::WaitForFlush
@@ -87,8 +125,9 @@ class TRDK_CORE_API AsyncLogRecord {
 
   //! Schedules delayed formatting for one parameter.
   /** Stores params for log record until it will be really written.
-   *  WARNING! Pointer to C-string and all other not POD types must be available
-   *  all time while module is active! Methods stores only pointers, not values.
+   *  WARNING! Pointer to C-string, references to strings and securities must
+   *  be available all time while module is active! Methods stores only
+   *  pointers for such params, other values are copied.
    *
    *  @sa trdk::AsyncLog::AsyncLogRecord::Format
    *  @sa trdk::AsyncLog::WaitForFlush
@@ -111,153 +150,163 @@ class TRDK_CORE_API AsyncLogRecord {
 
   template <typename Os>
   void Dump(Os &os, const char *delimiter = nullptr) const {
-    const auto &begin = m_params.cbegin();
-    const auto &end = m_params.cend();
+    const ParamWriter<Os> writer(os);
+    const std::pair<const char *, const char *> segments[] = {
+        {m_buffer.data(), m_buffer.data() + m_size},
+        {m_overflow ? m_overflow->data() : nullptr,
+         m_overflow ? m_overflow->data() + m_overflow->size() : nullptr}};
 
+    bool isFirst = true;
     bool skipDelimiter = false;
 
-    for (auto i = begin; i != end; ++i) {
-      const ParamType &type = boost::get<0>(*i);
-      const boost::any &val = boost::get<1>(*i);
-
-      if (delimiter && i != begin) {
-        if (!skipDelimiter) {
-          if (type != PT_CHAR || (boost::any_cast<char>(val) != '\n' &&
-                                  boost::any_cast<char>(val) != 0)) {
-            WriteToDumpStream(delimiter, os);
-          } else {
-            skipDelimiter = true;
-            if (boost::any_cast<char>(val) == 0) {
-              continue;
+    for (const auto &segment : segments) {
+      for (auto param = segment.first; param != segment.second;) {
+        if (delimiter && !isFirst) {
+          if (!skipDelimiter) {
+            const char *const ch = param + 1;
+            if (*param != PT_CHAR || (*ch != '\n' && *ch != 0)) {
+              WriteToDumpStream(delimiter, os);
+            } else {
+              skipDelimiter = true;
+              if (*ch == 0) {
+                param = VisitParam(param, ParamSkipper());
+                continue;
+              }
             }
+          } else {
+            skipDelimiter = false;
           }
-        } else {
-          skipDelimiter = false;
         }
+        isFirst = false;
+        param = VisitParam(param, writer);
       }
+    }
+  }
 
-      static_assert(numberOfParamTypes == 26, "Parameter type list changed.");
-      switch (type) {
-        case PT_INT8:
-          WriteToDumpStream(boost::any_cast<int8_t>(val), os);
-          break;
-        case PT_UINT8:
-          WriteToDumpStream(boost::any_cast<uint8_t>(val), os);
-          break;
-
-        case PT_INT16:
-          WriteToDumpStream(boost::any_cast<int16_t>(val), os);
-          break;
-        case PT_UINT16:
-          WriteToDumpStream(boost::any_cast<uint16_t>(val), os);
-          break;
-
-        case PT_INT32:
-          WriteToDumpStream(boost::any_cast<int32_t>(val), os);
-          break;
-        case PT_UINT32:
-          WriteToDumpStream(boost::any_cast<uint32_t>(val), os);
-          break;
-
-        case PT_INT64:
-          WriteToDumpStream(boost::any_cast<int64_t>(val), os);
-          break;
-        case PT_UINT64:
-          WriteToDumpStream(boost::any_cast<uint64_t>(val), os);
-          break;
-
-        case PT_DOUBLE:
-          WriteToDumpStream(boost::any_cast<trdk::Lib::Double>(val), os);
-          break;
-        case PT_DOUBLE_BUSINESS_8:
-          WriteToDumpStream(
-              boost::any_cast<trdk::Lib::BusinessNumeric<
-                  double,
-                  trdk::Lib::Detail::DoubleWithFixedPrecisionNumericPolicy<8>>>(
-                  val),
-              os);
-          break;
-
-        case PT_CHAR: {
-          const auto &ch = boost::any_cast<char>(val);
-          if (ch != ' ') {
-            WriteToDumpStream(ch, os);
-          }
-        } break;
-        case PT_STRING:
-          WriteToDumpStream(boost::any_cast<const std::string &>(val), os);
-          break;
-        case PT_STRING_REF:
-          WriteToDumpStream(
-              static_cast<const std::string &>(
-                  boost::any_cast<const boost::reference_wrapper<std::string>>(
-                      val)),
-              os);
-          break;
-        case PT_PCHAR:
-          WriteToDumpStream(boost::any_cast<const char *>(val), os);
-          break;
-
-        case PT_TIME:
-          namespace pt
-          = boost::posix_time;
-          WriteToDumpStream(boost::any_cast<const pt::ptime &>(val), os);
-          break;
-        case PT_TIME_DURATION:
-          namespace pt
-          = boost::posix_time;
-          WriteToDumpStream(boost::any_cast<const pt::time_duration &>(val),
-                            os);
-          break;
-        case PT_DATE:
-          namespace gr
-          = boost::gregorian;
-          WriteToDumpStream(boost::any_cast<const gr::date &>(val), os);
-          break;
-
-        case PT_CURRENCY:
-          WriteToDumpStream(boost::any_cast<const Lib::Currency &>(val), os);
-          break;
-
-        case PT_SECURITY:
-          WriteToDumpStream(*boost::any_cast<const Security *>(val), os);
-          break;
-
-        case PT_TRADING_MODE:
-          WriteToDumpStream(boost::any_cast<const TradingMode &>(val), os);
-          break;
-
-        case PT_ORDER_STATUS:
-          WriteToDumpStream(boost::any_cast<const OrderStatus &>(val), os);
-          break;
-        case PT_ORDER_SIDE:
-          WriteToDumpStream(boost::any_cast<const OrderSide &>(val), os);
-          break;
-
-        case PT_UUID:
-          WriteToDumpStream(boost::any_cast<const boost::uuids::uuid &>(val),
-                            os);
-          break;
-
-        case PT_CLOSE_REASON:
-          WriteToDumpStream(boost::any_cast<const trdk::CloseReason &>(val),
-                            os);
-          break;
-
-        case PT_TIME_IN_FORCE:
-          WriteToDumpStream(boost::any_cast<const trdk::TimeInForce &>(val),
-                            os);
-          break;
-
-        case PT_POSITION_SIDE:
-          WriteToDumpStream(boost::any_cast<const trdk::PositionSide &>(val),
-                            os);
-          break;
-
-        default:
-          AssertEq(PT_UINT64, type);
+ private:
+  template <typename Os>
+  class ParamWriter {
+   public:
+    explicit ParamWriter(Os &os) : m_os(os) {}
+
+    template <typename Param>
+    void operator()(const Param &param) const {
+      WriteToDumpStream(param, m_os);
+    }
+    void operator()(char ch) const {
+      if (ch != ' ') {
+        WriteToDumpStream(ch, m_os);
       }
     }
+    void operator()(const std::string *string) const {
+      WriteToDumpStream(*string, m_os);
+    }
+    void operator()(const trdk::Security *security) const {
+      WriteToDumpStream(*security, m_os);
+    }
+
+   private:
+    Os &m_os;
+  };
+
+  struct ParamSkipper {
+    template <typename Param>
+    void operator()(const Param &) const {}
+  };
+
+  //! Calls visitor with the parameter value.
+  /** @return The next parameter.
+   */
+  template <typename Visitor>
+  static const char *VisitParam(const char *param, const Visitor &visitor) {
+    static_assert(numberOfParamTypes == 26, "Parameter type list changed.");
+    const auto type = static_cast<ParamType>(*param++);
+    switch (type) {
+      case PT_INT8:
+        return VisitValue<int8_t>(param, visitor);
+      case PT_UINT8:
+        return VisitValue<uint8_t>(param, visitor);
+
+      case PT_INT16:
+        return VisitValue<int16_t>(param, visitor);
+      case PT_UINT16:
+        return VisitValue<uint16_t>(param, visitor);
+
+      case PT_INT32:
+        return VisitValue<int32_t>(param, visitor);
+      case PT_UINT32:
+        return VisitValue<uint32_t>(param, visitor);
+
+      case PT_INT64:
+        return VisitValue<int64_t>(param, visitor);
+      case PT_UINT64:
+        return VisitValue<uint64_t>(param, visitor);
+
+      case PT_DOUBLE:
+        return VisitValue<trdk::Lib::Double>(param, visitor);
+      case PT_DOUBLE_BUSINESS_8:
+        return VisitValue<DoubleBusiness8>(param, visitor);
+
+      case PT_CHAR:
+        return VisitValue<char>(param, visitor);
+      case PT_STRING: {
+        StringSize size;
+        std::memcpy(&size, param, sizeof(size));
+        param += sizeof(size);
+        visitor(boost::string_ref(param, size));
+        return param + size;
+      }
+      case PT_STRING_REF:
+        return VisitValue<const std::string *>(param, visitor);
+      case PT_PCHAR:
+        return VisitValue<const char *>(param, visitor);
+
+      case PT_TIME:
+        return VisitValue<boost::posix_time::ptime>(param, visitor);
+      case PT_TIME_DURATION:
+        return VisitValue<boost::posix_time::time_duration>(param, visitor);
+      case PT_DATE:
+        return VisitValue<boost::gregorian::date>(param, visitor);
+
+      case PT_CURRENCY:
+        return VisitValue<Lib::Currency>(param, visitor);
+
+      case PT_SECURITY:
+        return VisitValue<const Security *>(param, visitor);
+
+      case PT_TRADING_MODE:
+        return VisitValue<TradingMode>(param, visitor);
+
+      case PT_ORDER_STATUS:
+        return VisitValue<OrderStatus>(param, visitor);
+      case PT_ORDER_SIDE:
+        return VisitValue<OrderSide>(param, visitor);
+
+      case PT_UUID:
+        return VisitValue<boost::uuids::uuid>(param, visitor);
+
+      case PT_CLOSE_REASON:
+        return VisitValue<trdk::CloseReason>(param, visitor);
+
+      case PT_TIME_IN_FORCE:
+        return VisitValue<trdk::TimeInForce>(param, visitor);
+
+      case PT_POSITION_SIDE:
+        return VisitValue<trdk::PositionSide>(param, visitor);
+
+      default:
+        AssertEq(PT_UINT64, type);
+        throw trdk::Lib::LogicError("Unknown log record parameter type");
+    }
+  }
+
+  template <typename Value, typename Visitor>
+  static const char *VisitValue(const char *param, const Visitor &visitor) {
+    // The buffer has no alignment, so the value is copied:
+    typename std::aligned_storage<sizeof(Value), alignof(Value)>::type value;
+    std::memcpy(&value, param, sizeof(Value));
+    visitor(reinterpret_cast<const Value &>(value));
+    return param + sizeof(Value);
   }
 
  private:
@@ -284,50 +333,28 @@ class TRDK_CORE_API AsyncLogRecord {
   void StoreParam(const trdk::Lib::Double &val) {
     StoreTypedParam(PT_DOUBLE, val);
   }
-  void StoreParam(trdk::Lib::Double &&val) {
-    StoreTypedParam(PT_DOUBLE, std::move(val));
-  }
-  void StoreParam(
-      const trdk::Lib::BusinessNumeric<
-          double,
-          trdk::Lib::Detail::DoubleWithFixedPrecisionNumericPolicy<8>> &val) {
+  void StoreParam(const DoubleBusiness8 &val) {
     StoreTypedParam(PT_DOUBLE_BUSINESS_8, val);
   }
-  void StoreParam(
-      trdk::Lib::BusinessNumeric<
-          double,
-          trdk::Lib::Detail::DoubleWithFixedPrecisionNumericPolicy<8>> &&val) {
-    StoreTypedParam(PT_DOUBLE_BUSINESS_8, std::move(val));
-  }
 
   void StoreParam(char val) { StoreTypedParam(PT_CHAR, val); }
-  void StoreParam(const std::string &val) { StoreTypedParam(PT_STRING, val); }
-  void StoreParam(std::string &&val) {
-    StoreTypedParam(PT_STRING, std::move(val));
+  void StoreParam(const std::string &val) {
+    StoreStringParam(val.c_str(), val.size());
   }
-  void StoreParam(boost::reference_wrapper<std::string> &&val) {
-    StoreTypedParam(PT_STRING_REF, val);
+  void StoreParam(const boost::reference_wrapper<std::string> &val) {
+    StoreTypedParam(PT_STRING_REF, val.get_pointer());
   }
   void StoreParam(const char *val) { StoreTypedParam(PT_PCHAR, val); }
 
   void StoreParam(const boost::posix_time::ptime &time) {
     StoreTypedParam(PT_TIME, time);
   }
-  void StoreParam(boost::posix_time::ptime &&time) {
-    StoreTypedParam(PT_TIME, std::move(time));
-  }
   void StoreParam(const boost::posix_time::time_duration &time) {
     StoreTypedParam(PT_TIME_DURATION, time);
   }
-  void StoreParam(boost::posix_time::time_duration &&time) {
-    StoreTypedParam(PT_TIME_DURATION, std::move(time));
-  }
   void StoreParam(const boost::gregorian::date &date) {
     StoreTypedParam(PT_DATE, date);
   }
-  void StoreParam(boost::gregorian::date &&date) {
-    StoreTypedParam(PT_DATE, std::move(date));
-  }
 
   void StoreParam(const trdk::Lib::Currency &currency) {
     StoreTypedParam(PT_CURRENCY, currency);
@@ -352,9 +379,6 @@ class TRDK_CORE_API AsyncLogRecord {
   void StoreParam(const boost::uuids::uuid &val) {
     StoreTypedParam(PT_UUID, val);
   }
-  void StoreParam(boost::uuids::uuid &&val) {
-    StoreTypedParam(PT_UUID, std::move(val));
-  }
 
   void StoreParam(const trdk::CloseReason &closeReason) {
     StoreTypedParam(PT_CLOSE_REASON, closeReason);
@@ -369,7 +393,7 @@ class TRDK_CORE_API AsyncLogRecord {
   }
 
   void StoreParam(const trdk::OrderId &orderId) {
-    StoreTypedParam(PT_STRING, orderId.GetValue());
+    StoreParam(orderId.GetValue());
   }
 
   template <typename T, typename Policy>
@@ -378,14 +402,43 @@ class TRDK_CORE_API AsyncLogRecord {
   }
 
   template <typename Param>
-  void StoreTypedParam(ParamType &&type, const Param &val) {
-    m_params.emplace_back(std::move(type), std::move(val));
+  void StoreTypedParam(const ParamType &type, const Param &val) {
+    static_assert(std::is_trivially_copyable<Param>::value,
+                  "Parameter can't be stored as bytes.");
+    auto *const buffer = Allocate(1 + sizeof(val));
+    buffer[0] = type;
+    std::memcpy(buffer + 1, &val, sizeof(val));
   }
-  template <typename Param>
-  void StoreTypedParam(ParamType &&type, Param &&val) {
-    m_params.emplace_back(std::move(type), std::move(val));
+
+  void StoreStringParam(const char *val, size_t size) {
+    const auto storedSize = static_cast<StringSize>(size);
+    auto *buffer = Allocate(1 + sizeof(storedSize) + storedSize);
+    *buffer++ = PT_STRING;
+    std::memcpy(buffer, &storedSize, sizeof(storedSize));
+    std::memcpy(buffer + sizeof(storedSize), val, storedSize);
   }
 
+  //! Returns memory for the next parameter.
+  /** If the parameter doesn't fit the inline buffer, it and all next
+   *  parameters are stored in the overflow buffer, so the order is kept.
+   */
+  char *Allocate(size_t size) {
+    if (!m_overflow) {
+      if (m_size + size <= m_buffer.size()) {
+        auto *const result = m_buffer.data() + m_size;
+        m_size += size;
+        return result;
+      }
+      m_overflow = TakeOverflowBuffer();
+    }
+    const auto offset = m_overflow->size();
+    m_overflow->resize(offset + size);
+    return m_overflow->data() + offset;
+  }
+
+  static OverflowBuffer *TakeOverflowBuffer();
+  static void ReturnOverflowBuffer(OverflowBuffer *) noexcept;
+
  private:
   template <typename Param>
   static void WriteToDumpStream(const Param &param, boost::format &os) {
@@ -405,7 +458,9 @@ class TRDK_CORE_API AsyncLogRecord {
   boost::posix_time::ptime m_time;
   trdk::Log::ThreadId m_threadId;
 
-  std::vector<boost::tuple<ParamType, boost::any>> m_params;
+  size_t m_size;
+  std::array<char, INLINE_BUFFER_SIZE> m_buffer;
+  OverflowBuffer *m_overflow;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,60 @@
+/**************************************************************************
+ *   Created: 2026/10/17 04:06:19
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Core/TradingLog.hpp"
+
+using namespace trdk;
+
+namespace pt = boost::posix_time;
+namespace gr = boost::gregorian;
+
+namespace {
+
+const char *const message =
+    "order\t%1%\t%2%\t%3%\t%4%\tqty=%5$.8f\tprice=%6$.8f\t%7%\t%8%";
+const std::string symbol = "BTC_USD";
+
+void StoreParams(TradingRecord &record, size_t i) {
+  record % "new" % symbol % uint64_t(i) % ORDER_SIDE_BUY % 0.12345678 %
+      (7654.321 + static_cast<double>(i & 0xF)) % ORDER_STATUS_OPENED %
+      pt::microseconds(i);
+}
+
+//! Costs of the record filling in the trading thread.
+void Core_AsyncLogRecord_Format(benchmark::State &state) {
+  const pt::ptime time(gr::date(2018, 1, 1));
+  size_t i = 0;
+  for (auto _ : state) {
+    TradingRecord record(time, 0, "Benchmark", message);
+    StoreParams(record, ++i);
+    benchmark::DoNotOptimize(record);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+//! Costs of the record formatting in the log thread.
+void Core_AsyncLogRecord_Dump(benchmark::State &state) {
+  TradingRecord record(pt::ptime(gr::date(2018, 1, 1)), 0, "Benchmark",
+                       message);
+  StoreParams(record, 1);
+  std::ostringstream os;
+  for (auto _ : state) {
+    os.str(std::string());
+    record >> os;
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(os.str().size()));
+}
+
+}  // namespace
+
+BENCHMARK(Core_AsyncLogRecord_Format);
+BENCHMARK(Core_AsyncLogRecord_Dump);
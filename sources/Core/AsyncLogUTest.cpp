@@ -0,0 +1,88 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 17:12:40
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Core/AsyncLog.hpp"
+
+using namespace trdk;
+namespace pt = boost::posix_time;
+
+namespace {
+AsyncLogRecord CreateRecord() {
+  return AsyncLogRecord(pt::not_a_date_time, 0);
+}
+}  // namespace
+
+TEST(Core_AsyncLogRecord, Dump) {
+  std::string referencedString = "ref";
+  auto record = CreateRecord();
+  {
+    std::string copiedString = "copy";
+    record % int32_t(-1) % uint64_t(2) % 'c' % copiedString
+        % boost::ref(referencedString) % "pchar" % pt::minutes(90);
+    copiedString = "changed";
+  }
+  // Referenced string is read only at the dump, so the caller has to keep it
+  // alive and the change made before the dump is visible:
+  referencedString = "changed ref";
+
+  std::ostringstream os;
+  record.Dump(os, ",");
+  EXPECT_EQ("-1,2,c,copy,changed ref,pchar,01:30:00", os.str());
+
+  boost::format format("%1% %2% %3% %4% %5% %6% %7%");
+  record >> format;
+  EXPECT_EQ("-1 2 c copy changed ref pchar 01:30:00", format.str());
+}
+
+TEST(Core_AsyncLogRecord, ConstReferenceIsCopied) {
+  // Only the reference to the non-const string is stored as the reference,
+  // the reference to the const string is stored as the copy.
+  std::string source = "source";
+  const auto &constSource = source;
+  auto record = CreateRecord();
+  record % boost::cref(constSource);
+  source = "changed";
+
+  std::ostringstream os;
+  record.Dump(os, ",");
+  EXPECT_EQ("source", os.str());
+}
+
+TEST(Core_AsyncLogRecord, Delimiters) {
+  auto record = CreateRecord();
+  record % 1 % '\n' % 2 % char(0) % 3 % ' ' % 4;
+  std::ostringstream os;
+  record.Dump(os, ",");
+  EXPECT_EQ("1\n23,,4", os.str());
+}
+
+TEST(Core_AsyncLogRecord, Overflow) {
+  auto record = CreateRecord();
+  std::string expected;
+  const std::string longString(100, 'x');
+  for (int32_t i = 0; i < 10; ++i) {
+    record % i % longString;
+    if (i) {
+      expected += ',';
+    }
+    expected += boost::lexical_cast<std::string>(i) + ',' + longString;
+  }
+
+  // Moved record keeps the inline and the overflow parts:
+  const auto movedRecord = std::move(record);
+  std::ostringstream os;
+  movedRecord.Dump(os, ",");
+  EXPECT_EQ(expected, os.str());
+
+  std::ostringstream emptyOs;
+  record.Dump(emptyOs, ",");
+  EXPECT_TRUE(emptyOs.str().empty());
+}
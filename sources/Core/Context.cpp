@@ -85,6 +85,10 @@ class StatReport : private boost::noncopyable {
 
     OpenStream("Latan", "latan.log", m_latanStream);
     TestTimings(m_latanStream);
+    m_latanStream << "Periods are in nanoseconds: number, number per second,"
+                     " avg, min, p50, p99, p99.9, max."
+                  << std::endl;
+    OpenCsvStream("latan.csv", m_latanCsvStream);
 
     OpenStream("Securities Stat", "sec_stat.log", m_securititesStatStream);
 
@@ -150,14 +154,33 @@ class StatReport : private boost::noncopyable {
            << ")." << std::endl;
   }
 
+  void OpenCsvStream(const std::string& file, std::ofstream& stream) const {
+    Assert(stream);
+
+    const auto& path = m_context.GetSettings().GetLogsDir() / file;
+    m_context.GetLog().Debug("Reporting latency percentiles to file %1%...",
+                             path);
+
+    create_directories(path.branch_path());
+
+    const bool isNew = !fs::exists(path) || fs::file_size(path) == 0;
+    stream.open(path.string().c_str(), std::ios::ate | std::ios::app);
+    if (!stream) {
+      throw Exception("Failed to open latency percentiles report file");
+    }
+    if (isNew) {
+      stream << "time,group,milestone,number,avg,min,p50,p90,p99,p99.9,max"
+             << std::endl;
+    }
+  }
+
   void TestTimings(std::ofstream& stream) const {
     using namespace TimeMeasurement;
-    typedef Milestones::Clock Clock;
     const auto& test = [&](size_t period) {
-      const auto start = Clock::now();
+      const auto start = Milestones::GetNow();
       boost::this_thread::sleep(pt::microseconds(period));
-      const auto now = Clock::now();
-      stream << period << " = " << (now - start).count() << " / "
+      const auto now = Milestones::GetNow();
+      stream << period << " = " << (now - start) << " / "
              << Milestones::CalcPeriod(start, now);
     };
     stream << "Test: ";
@@ -229,6 +252,7 @@ class StatReport : private boost::noncopyable {
                  const std::string& tag,
                  MilestonesStatAccum& accum,
                  std::ostream& destination) {
+    accum.TakeMilestones();
     if (!accum.HasMeasures()) {
       return;
     }
@@ -247,9 +271,15 @@ class StatReport : private boost::noncopyable {
                   << GetMilestoneName(id) << '\t';
       stat.Dump(destination, m_reportPeriod.total_seconds());
       destination << std::endl;
+      m_latanCsvStream << now << ',' << tag << ','
+                       << boost::trim_copy(GetMilestoneName(id)) << ','
+                       << stat.GetSize() << ',' << stat.GetAvg() << ','
+                       << stat.GetMin() << ',' << stat.GetPercentile(50) << ','
+                       << stat.GetPercentile(90) << ','
+                       << stat.GetPercentile(99) << ','
+                       << stat.GetPercentile(99.9) << ',' << stat.GetMax()
+                       << std::endl;
     }
-
-    accum.Reset();
   }
 
   bool DumpSecurity(const Security& security, std::ostream& destination) const {
@@ -270,6 +300,7 @@ class StatReport : private boost::noncopyable {
 
   std::ofstream m_securititesStatStream;
   std::ofstream m_latanStream;
+  std::ofstream m_latanCsvStream;
 
   size_t m_strategyIndex;
   size_t m_tsIndex;
@@ -323,6 +354,11 @@ class Context::Implementation : private boost::noncopyable {
 
   Settings m_settings;
 
+  const Clock m_clock;
+  //! Set if the time zone doesn't have DST, so the conversion doesn't depend
+  //! on the time.
+  const boost::optional<pt::time_duration> m_utcOffset;
+
   std::unique_ptr<StatReport> m_statReport;
 
   pt::ptime m_customCurrentTime;
@@ -334,7 +370,19 @@ class Context::Implementation : private boost::noncopyable {
   std::unique_ptr<Timer> m_timer;
 
   explicit Implementation(Log& log, TradingLog& tradingLog, Settings&& settings)
-      : m_log(log), m_tradingLog(tradingLog), m_settings(std::move(settings)) {}
+      : m_log(log),
+        m_tradingLog(tradingLog),
+        m_settings(std::move(settings)),
+        m_clock(m_settings.GetClockSource()),
+        m_utcOffset(GetUtcOffset(m_settings.GetTimeZone())) {}
+
+  static boost::optional<pt::time_duration> GetUtcOffset(
+      const lt::time_zone_ptr& timeZone) {
+    if (timeZone->has_dst()) {
+      return boost::none;
+    }
+    return timeZone->base_utc_offset();
+  }
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -427,7 +475,11 @@ pt::ptime Context::GetCurrentTime() const {
 
 pt::ptime Context::GetCurrentTime(const lt::time_zone_ptr& timeZone) const {
   if (!GetSettings().IsReplayMode()) {
-    return lt::local_microsec_clock::local_time(timeZone).local_time();
+    const auto& universalTime = m_pimpl->m_clock.GetUniversalTime();
+    if (m_pimpl->m_utcOffset && timeZone == m_pimpl->m_settings.GetTimeZone()) {
+      return universalTime + *m_pimpl->m_utcOffset;
+    }
+    return lt::local_date_time(universalTime, timeZone).local_time();
   }
   Assert(!m_pimpl->m_customCurrentTime.is_not_a_date_time());
   return m_pimpl->m_customCurrentTime;
@@ -26,6 +26,12 @@ const lt::time_zone_ptr timeZone =
     boost::make_shared<lt::posix_time_zone>("GMT");
 Context::Log contextLog(timeZone);
 Context::TradingLog tradingLog(timeZone);
+
+ptr::ptree CreateRiskControlSettings() {
+  ptr::ptree result;
+  result.add("riskControl.isEnabled", false);
+  return result;
+}
 }  // namespace
 
 Dummies::Context::Context()
@@ -42,8 +48,7 @@ Dummies::Context::SyncDispatching() const {
 }
 
 RiskControl &Dummies::Context::GetRiskControl(const TradingMode &) {
-  static RiskControl result(*this,
-                            ptr::ptree().add("RiskControl.isEnabled", false),
+  static RiskControl result(*this, CreateRiskControlSettings(),
                             numberOfTradingModes);
   return result;
 }
@@ -15,6 +15,8 @@ namespace trdk {
 class Context;
 
 class PriceBook;
+//! Immutable price book snapshot, one object is shared by all subscribers.
+typedef boost::shared_ptr<const PriceBook> PriceBookSnapshot;
 
 class Security;
 
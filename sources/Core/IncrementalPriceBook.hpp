@@ -0,0 +1,246 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 14:05:32
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#pragma once
+
+#include "PriceBook.hpp"
+#include <array>
+
+namespace trdk {
+
+//! Price book with configurable depth, which is maintained by price level
+//! diffs.
+/**
+ * Prices are stored as integer ticks, levels use the struct-of-arrays layout:
+ * search touches only the continuous array of prices, and level insertion or
+ * deletion moves two plain arrays without per-level time objects.
+ *
+ * Levels which are out of the depth are dropped, so such book should be
+ * restored by the full snapshot if the better levels were deleted.
+ *
+ * @tparam maxDepth Max number of levels for each side.
+ */
+template <size_t maxDepth>
+class IncrementalPriceBook {
+  static_assert(maxDepth > 0, "Price book depth should be not 0.");
+
+ public:
+  typedef int64_t Ticks;
+
+  //! Book side, levels are sorted from the best price.
+  template <bool isBid>
+  class Side {
+   public:
+    Side() : m_size(0) {}
+
+   public:
+    size_t GetSize() const { return m_size; }
+    bool IsEmpty() const { return m_size == 0; }
+
+    Ticks GetTicks(size_t levelIndex) const {
+      CheckLevelIndex(levelIndex);
+      return m_prices[levelIndex];
+    }
+    Qty GetQty(size_t levelIndex) const {
+      CheckLevelIndex(levelIndex);
+      return m_qtys[levelIndex];
+    }
+
+    //! Sets new level quantity, deletes the level if the quantity is zero.
+    /**
+     * @return true if the side is changed, false if the level is out of the
+     *         depth or if the deleted level doesn't exist.
+     */
+    bool Apply(const Ticks &price, const Qty &qty) {
+      bool isExisting;
+      const auto index = Find(price, isExisting);
+      if (isExisting) {
+        if (qty == 0) {
+          Erase(index);
+        } else {
+          m_qtys[index] = qty.Get();
+        }
+        return true;
+      }
+      if (qty == 0 || index >= maxDepth) {
+        return false;
+      }
+      Insert(index, price, qty.Get());
+      return true;
+    }
+
+    //! Adds quantity to the level, negative quantity reduces the level.
+    /**
+     * Deletes the level if the result quantity is zero or less. Useful for
+     * sources which report orders instead of levels, so a few orders are
+     * aggregated into one level.
+     * @return true if the side is changed.
+     */
+    bool Add(const Ticks &price, const Qty &qty) {
+      bool isExisting;
+      const auto index = Find(price, isExisting);
+      if (isExisting) {
+        const Qty result = m_qtys[index] + qty.Get();
+        if (result <= 0) {
+          Erase(index);
+        } else {
+          m_qtys[index] = result.Get();
+        }
+        return true;
+      }
+      if (qty <= 0 || index >= maxDepth) {
+        return false;
+      }
+      Insert(index, price, qty.Get());
+      return true;
+    }
+
+    void Clear() noexcept { m_size = 0; }
+
+   private:
+    size_t Find(const Ticks &price, bool &isExisting) const {
+      const auto &begin = m_prices.cbegin();
+      const auto &end = begin + m_size;
+      const auto &pos = std::lower_bound(
+          begin, end, price, [](const Ticks &lhs, const Ticks &rhs) {
+            return isBid ? lhs > rhs : lhs < rhs;
+          });
+      isExisting = pos != end && *pos == price;
+      return static_cast<size_t>(std::distance(begin, pos));
+    }
+
+    void CheckLevelIndex(size_t levelIndex) const {
+      if (levelIndex >= m_size) {
+        throw Lib::LogicError("Price book level index is out of range");
+      }
+    }
+
+    void Insert(size_t index, const Ticks &price, double qty) {
+      AssertGt(maxDepth, index);
+      // If the side is full, the worst level is dropped.
+      const auto last = std::min(m_size, maxDepth - 1);
+      AssertLe(index, last);
+      std::copy_backward(m_prices.begin() + index, m_prices.begin() + last,
+                         m_prices.begin() + last + 1);
+      std::copy_backward(m_qtys.begin() + index, m_qtys.begin() + last,
+                         m_qtys.begin() + last + 1);
+      m_prices[index] = price;
+      m_qtys[index] = qty;
+      if (m_size < maxDepth) {
+        ++m_size;
+      }
+    }
+
+    void Erase(size_t index) {
+      AssertGt(m_size, index);
+      std::copy(m_prices.begin() + index + 1, m_prices.begin() + m_size,
+                m_prices.begin() + index);
+      std::copy(m_qtys.begin() + index + 1, m_qtys.begin() + m_size,
+                m_qtys.begin() + index);
+      --m_size;
+    }
+
+   private:
+    size_t m_size;
+    std::array<Ticks, maxDepth> m_prices;
+    std::array<double, maxDepth> m_qtys;
+  };
+
+  typedef Side<true> Bid;
+  typedef Side<false> Ask;
+
+ public:
+  //! Creates empty book.
+  /**
+   * @param pricePrecisionPower Number of ticks in one price unit, for example,
+   *                            trdk::Security::GetPricePrecisionPower.
+   */
+  explicit IncrementalPriceBook(uintmax_t pricePrecisionPower)
+      : m_pricePrecisionPower(static_cast<double>(pricePrecisionPower)) {
+    AssertLt(0, pricePrecisionPower);
+  }
+
+ public:
+  static size_t GetMaxDepth() { return maxDepth; }
+
+ public:
+  Ticks ConvertToTicks(const Price &price) const {
+    return static_cast<Ticks>(
+        std::llround(price.Get() * m_pricePrecisionPower));
+  }
+  Price ConvertToPrice(const Ticks &ticks) const {
+    return static_cast<double>(ticks) / m_pricePrecisionPower;
+  }
+
+  const boost::posix_time::ptime &GetTime() const { return m_time; }
+  void SetTime(const boost::posix_time::ptime &time) { m_time = time; }
+
+  const Bid &GetBid() const { return m_bid; }
+  Bid &GetBid() { return m_bid; }
+
+  const Ask &GetAsk() const { return m_ask; }
+  Ask &GetAsk() { return m_ask; }
+
+  //! Applies price level diff.
+  /**
+   * Inserts new level, updates the quantity of the existing level or deletes
+   * the level if the quantity is zero.
+   * @return true if the book is changed.
+   */
+  bool ApplyDelta(const OrderSide &side, const Price &price, const Qty &qty) {
+    const auto &ticks = ConvertToTicks(price);
+    return side == ORDER_SIDE_BID ? m_bid.Apply(ticks, qty)
+                                  : m_ask.Apply(ticks, qty);
+  }
+
+  //! Adds quantity to the price level, negative quantity reduces the level.
+  /**
+   * @return true if the book is changed.
+   * @sa Side::Add
+   */
+  bool AddQty(const OrderSide &side, const Price &price, const Qty &qty) {
+    const auto &ticks = ConvertToTicks(price);
+    return side == ORDER_SIDE_BID ? m_bid.Add(ticks, qty)
+                                  : m_ask.Add(ticks, qty);
+  }
+
+  void Clear() noexcept {
+    m_bid.Clear();
+    m_ask.Clear();
+  }
+
+  //! Copies top levels into the price book which can be set to the security.
+  /**
+   * @sa trdk::Security::SetBook
+   */
+  PriceBook Export() const {
+    PriceBook result(m_time);
+    Export(m_bid, result.GetBid());
+    Export(m_ask, result.GetAsk());
+    return result;
+  }
+
+ private:
+  template <typename Source, typename Destination>
+  void Export(const Source &source, Destination &destination) const {
+    const auto size = std::min(source.GetSize(), PriceBook::GetSideMaxSize());
+    for (size_t i = 0; i < size; ++i) {
+      destination.Add(m_time, ConvertToPrice(source.GetTicks(i)),
+                      source.GetQty(i));
+    }
+  }
+
+ private:
+  const double m_pricePrecisionPower;
+  boost::posix_time::ptime m_time;
+  Bid m_bid;
+  Ask m_ask;
+};
+}  // namespace trdk
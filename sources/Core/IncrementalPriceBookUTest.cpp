@@ -0,0 +1,161 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 14:48:19
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Core/IncrementalPriceBook.hpp"
+
+namespace pt = boost::posix_time;
+
+namespace {
+
+typedef trdk::IncrementalPriceBook<4> Book;
+
+template <typename Side>
+std::vector<std::pair<Book::Ticks, double>> GetLevels(const Side &side) {
+  std::vector<std::pair<Book::Ticks, double>> result;
+  for (size_t i = 0; i < side.GetSize(); ++i) {
+    result.emplace_back(side.GetTicks(i), side.GetQty(i).Get());
+  }
+  return result;
+}
+}  // namespace
+
+TEST(Core_IncrementalPriceBook, Ticks) {
+  const Book book(100);
+  EXPECT_EQ(12345, book.ConvertToTicks(123.45));
+  EXPECT_EQ(12345, book.ConvertToTicks(123.449999999));
+  EXPECT_DOUBLE_EQ(123.45, book.ConvertToPrice(12345).Get());
+}
+
+TEST(Core_IncrementalPriceBook, Sorting) {
+  Book book(100);
+
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_BID, 10.01, 1));
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_BID, 10.03, 3));
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_BID, 10.02, 2));
+  EXPECT_EQ((std::vector<std::pair<Book::Ticks, double>>{
+                {1003, 3}, {1002, 2}, {1001, 1}}),
+            GetLevels(book.GetBid()));
+
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_ASK, 10.06, 6));
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_ASK, 10.04, 4));
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_ASK, 10.05, 5));
+  EXPECT_EQ((std::vector<std::pair<Book::Ticks, double>>{
+                {1004, 4}, {1005, 5}, {1006, 6}}),
+            GetLevels(book.GetAsk()));
+}
+
+TEST(Core_IncrementalPriceBook, UpdateAndDelete) {
+  Book book(100);
+
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_ASK, 1.01, 1));
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_ASK, 1.02, 2));
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_ASK, 1.03, 3));
+
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_ASK, 1.02, 22));
+  EXPECT_EQ((std::vector<std::pair<Book::Ticks, double>>{
+                {101, 1}, {102, 22}, {103, 3}}),
+            GetLevels(book.GetAsk()));
+
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_ASK, 1.01, 0));
+  EXPECT_EQ(
+      (std::vector<std::pair<Book::Ticks, double>>{{102, 22}, {103, 3}}),
+      GetLevels(book.GetAsk()));
+
+  EXPECT_FALSE(book.ApplyDelta(trdk::ORDER_SIDE_ASK, 1.05, 0));
+  EXPECT_EQ(2, book.GetAsk().GetSize());
+
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_ASK, 1.03, 0));
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_ASK, 1.02, 0));
+  EXPECT_TRUE(book.GetAsk().IsEmpty());
+  EXPECT_TRUE(book.GetBid().IsEmpty());
+
+  EXPECT_THROW(book.GetAsk().GetTicks(0), trdk::Lib::LogicError);
+  EXPECT_THROW(book.GetAsk().GetQty(0), trdk::Lib::LogicError);
+}
+
+TEST(Core_IncrementalPriceBook, AddQty) {
+  Book book(100);
+
+  EXPECT_TRUE(book.AddQty(trdk::ORDER_SIDE_BID, 1.01, 1));
+  EXPECT_TRUE(book.AddQty(trdk::ORDER_SIDE_BID, 1.01, 2));
+  EXPECT_TRUE(book.AddQty(trdk::ORDER_SIDE_BID, 1.02, 1.5));
+  EXPECT_EQ(
+      (std::vector<std::pair<Book::Ticks, double>>{{102, 1.5}, {101, 3}}),
+      GetLevels(book.GetBid()));
+
+  EXPECT_TRUE(book.AddQty(trdk::ORDER_SIDE_BID, 1.01, -1));
+  EXPECT_EQ(
+      (std::vector<std::pair<Book::Ticks, double>>{{102, 1.5}, {101, 2}}),
+      GetLevels(book.GetBid()));
+
+  // Reduced to zero with the rounding error:
+  EXPECT_TRUE(book.AddQty(trdk::ORDER_SIDE_BID, 1.02, -1.4999999999));
+  EXPECT_EQ((std::vector<std::pair<Book::Ticks, double>>{{101, 2}}),
+            GetLevels(book.GetBid()));
+
+  EXPECT_FALSE(book.AddQty(trdk::ORDER_SIDE_BID, 1.03, -1));
+  EXPECT_TRUE(book.AddQty(trdk::ORDER_SIDE_BID, 1.01, -3));
+  EXPECT_TRUE(book.GetBid().IsEmpty());
+  EXPECT_TRUE(book.GetAsk().IsEmpty());
+}
+
+TEST(Core_IncrementalPriceBook, Depth) {
+  Book book(100);
+  ASSERT_EQ(4, Book::GetMaxDepth());
+
+  for (int i = 1; i <= 4; ++i) {
+    EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_BID, i, i));
+  }
+  EXPECT_EQ(4, book.GetBid().GetSize());
+
+  // Worse than the worst level, out of the depth:
+  EXPECT_FALSE(book.ApplyDelta(trdk::ORDER_SIDE_BID, .5, 1));
+  // Better than the best level, the worst level is dropped:
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_BID, 5, 5));
+  EXPECT_EQ((std::vector<std::pair<Book::Ticks, double>>{
+                {500, 5}, {400, 4}, {300, 3}, {200, 2}}),
+            GetLevels(book.GetBid()));
+  // Inside, the worst level is dropped:
+  EXPECT_TRUE(book.ApplyDelta(trdk::ORDER_SIDE_BID, 2.5, 25));
+  EXPECT_EQ((std::vector<std::pair<Book::Ticks, double>>{
+                {500, 5}, {400, 4}, {300, 3}, {250, 25}}),
+            GetLevels(book.GetBid()));
+
+  book.Clear();
+  EXPECT_TRUE(book.GetBid().IsEmpty());
+  EXPECT_TRUE(book.GetAsk().IsEmpty());
+}
+
+TEST(Core_IncrementalPriceBook, Export) {
+  trdk::IncrementalPriceBook<50> book(100);
+  const auto &time = pt::microsec_clock::local_time();
+  book.SetTime(time);
+  for (size_t i = 1; i <= book.GetMaxDepth(); ++i) {
+    book.ApplyDelta(trdk::ORDER_SIDE_BID, 100 - double(i) / 100, i);
+    book.ApplyDelta(trdk::ORDER_SIDE_ASK, 100 + double(i) / 100, i);
+  }
+  ASSERT_EQ(50, book.GetBid().GetSize());
+  ASSERT_EQ(50, book.GetAsk().GetSize());
+
+  const auto &result = book.Export();
+  EXPECT_EQ(time, result.GetTime());
+  ASSERT_EQ(trdk::PriceBook::GetSideMaxSize(), result.GetBid().GetSize());
+  ASSERT_EQ(trdk::PriceBook::GetSideMaxSize(), result.GetAsk().GetSize());
+  for (size_t i = 0; i < trdk::PriceBook::GetSideMaxSize(); ++i) {
+    EXPECT_DOUBLE_EQ(100 - double(i + 1) / 100,
+                     result.GetBid().GetLevel(i).GetPrice());
+    EXPECT_DOUBLE_EQ(double(i + 1), result.GetBid().GetLevel(i).GetQty());
+    EXPECT_EQ(time, result.GetBid().GetLevel(i).GetTime());
+    EXPECT_DOUBLE_EQ(100 + double(i + 1) / 100,
+                     result.GetAsk().GetLevel(i).GetPrice());
+    EXPECT_DOUBLE_EQ(double(i + 1), result.GetAsk().GetLevel(i).GetQty());
+  }
+}
@@ -0,0 +1,529 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 17:38:05
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "MarketDataCapture.hpp"
+
+using namespace trdk;
+using namespace trdk::Lib;
+using namespace trdk::MarketDataCapture;
+
+namespace pt = boost::posix_time;
+namespace ios = boost::iostreams;
+namespace fs = boost::filesystem;
+
+namespace {
+
+const char signature[8] = {'T', 'R', 'D', 'K', 'M', 'D', 'C', 0};
+const uint16_t version = 1;
+
+typedef uint32_t RecordLength;
+typedef int64_t Time;
+
+//! Uncompressed block size after which the block is flushed.
+const size_t blockSize = 64 * 1024;
+
+const size_t recordHeaderSize = sizeof(uint8_t) + sizeof(Time) * 2 +
+                                sizeof(SymbolId);
+
+const size_t level1TickSize = sizeof(uint8_t) + sizeof(double);
+const size_t bookLevelSize = sizeof(double) * 2;
+
+Time ConvertToCaptureTime(const pt::ptime &time) {
+  return time.is_special() ? std::numeric_limits<Time>::min()
+                           : ConvertToMicroseconds(time);
+}
+
+pt::ptime ConvertFromCaptureTime(const Time &time) {
+  return time == std::numeric_limits<Time>::min()
+             ? pt::not_a_date_time
+             : ConvertToPTimeFromMicroseconds(time);
+}
+
+template <typename T>
+T Read(const char *source) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Value can't be restored from bytes.");
+  // The buffer has no alignment, so the value is copied:
+  T result;
+  std::memcpy(&result, source, sizeof(result));
+  return result;
+}
+
+template <typename T>
+void Append(const T &value, std::vector<char> &buffer) {
+  const auto *const bytes = reinterpret_cast<const char *>(&value);
+  buffer.insert(buffer.cend(), bytes, bytes + sizeof(value));
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+Record::Record(const pt::ptime &time, const Log::ThreadId &)
+    : m_time(time), m_size(0), m_numberOfTicksOffset(0) {}
+
+void Record::Start(const RecordType &type,
+                   const SymbolId &symbolId,
+                   const pt::ptime &dataTime) {
+  m_size = 0;
+  m_numberOfTicksOffset = 0;
+  // The length is set by each change, so the record is always complete:
+  Append(RecordLength(0));
+  Append(type);
+  Append(ConvertToCaptureTime(m_time));
+  Append(ConvertToCaptureTime(dataTime));
+  Append(symbolId);
+}
+
+void Record::StartLevel1Update(const SymbolId &symbolId,
+                               const pt::ptime &dataTime) {
+  Start(RECORD_TYPE_LEVEL1_UPDATE, symbolId, dataTime);
+  m_numberOfTicksOffset = m_size;
+  Append(uint8_t(0));
+  UpdateLength();
+}
+
+void Record::StartLevel1Tick(const SymbolId &symbolId,
+                             const pt::ptime &dataTime) {
+  Start(RECORD_TYPE_LEVEL1_TICK, symbolId, dataTime);
+  m_numberOfTicksOffset = m_size;
+  Append(uint8_t(0));
+  UpdateLength();
+}
+
+void Record::AddLevel1Tick(const Level1TickValue &tick) {
+  AssertLt(0, m_numberOfTicksOffset);
+  auto &numberOfTicks =
+      reinterpret_cast<uint8_t &>(m_buffer[m_numberOfTicksOffset]);
+  if (numberOfTicks == std::numeric_limits<uint8_t>::max()) {
+    throw LogicError("Market data capture record has too many ticks");
+  }
+  Append(static_cast<uint8_t>(tick.GetType()));
+  Append(tick.GetValue().Get());
+  ++numberOfTicks;
+  UpdateLength();
+}
+
+void Record::SetTrade(const SymbolId &symbolId,
+                      const pt::ptime &dataTime,
+                      const Price &price,
+                      const Qty &qty,
+                      bool useAsLastTrade) {
+  Start(RECORD_TYPE_TRADE, symbolId, dataTime);
+  Append(price.Get());
+  Append(qty.Get());
+  Append(static_cast<uint8_t>(useAsLastTrade));
+  UpdateLength();
+}
+
+void Record::SetBook(const SymbolId &symbolId, const PriceBook &book) {
+  Start(RECORD_TYPE_BOOK, symbolId, book.GetTime());
+  const auto &bids = book.GetBid();
+  const auto &asks = book.GetAsk();
+  Append(static_cast<uint8_t>(bids.GetSize()));
+  Append(static_cast<uint8_t>(asks.GetSize()));
+  for (size_t i = 0; i < bids.GetSize(); ++i) {
+    const auto &level = bids.GetLevel(i);
+    Append(level.GetPrice().Get());
+    Append(level.GetQty().Get());
+  }
+  for (size_t i = 0; i < asks.GetSize(); ++i) {
+    const auto &level = asks.GetLevel(i);
+    Append(level.GetPrice().Get());
+    Append(level.GetQty().Get());
+  }
+  UpdateLength();
+}
+
+void Record::UpdateLength() {
+  AssertLe(sizeof(RecordLength), m_size);
+  const auto length =
+      static_cast<RecordLength>(m_size - sizeof(RecordLength));
+  std::memcpy(m_buffer.data(), &length, sizeof(length));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Writer::Writer(std::ostream &os, bool isCompressionEnabled, bool isNewFile)
+    : m_os(os), m_isCompressionEnabled(isCompressionEnabled) {
+  if (isNewFile) {
+    m_os.write(signature, sizeof(signature));
+    m_os.write(reinterpret_cast<const char *>(&version), sizeof(version));
+  }
+  if (m_isCompressionEnabled) {
+    m_block.reserve(blockSize + Record::MAX_SIZE);
+  }
+}
+
+Writer::~Writer() {
+  try {
+    Flush();
+  } catch (...) {
+    AssertFailNoException();
+  }
+}
+
+void Writer::AddSymbol(const SymbolId &id,
+                       const std::string &symbol,
+                       size_t sourceIndex) {
+  if (symbol.size() > std::numeric_limits<uint16_t>::max()) {
+    throw LogicError("Market data capture symbol is too long");
+  }
+  std::vector<char> record;
+  Append(RecordLength(0), record);
+  Append(RECORD_TYPE_SYMBOL, record);
+  Append(id, record);
+  Append(static_cast<uint32_t>(sourceIndex), record);
+  Append(static_cast<uint16_t>(symbol.size()), record);
+  record.insert(record.cend(), symbol.cbegin(), symbol.cend());
+  const auto length =
+      static_cast<RecordLength>(record.size() - sizeof(RecordLength));
+  std::memcpy(record.data(), &length, sizeof(length));
+  Write(record.data(), record.size());
+}
+
+void Writer::Write(const Record &record) {
+  Write(record.GetData(), record.GetSize());
+}
+
+void Writer::Write(const char *data, size_t size) {
+  if (!m_isCompressionEnabled) {
+    m_os.write(data, size);
+    return;
+  }
+  m_block.insert(m_block.cend(), data, data + size);
+  if (m_block.size() >= blockSize) {
+    Flush();
+  }
+}
+
+void Writer::Flush() {
+  if (!m_block.empty()) {
+    TrdkAssert(m_isCompressionEnabled);
+    std::vector<char> compressed;
+    {
+      ios::filtering_ostream filter;
+      filter.push(ios::zlib_compressor());
+      filter.push(ios::back_inserter(compressed));
+      filter.write(m_block.data(), m_block.size());
+    }
+    const auto length = static_cast<RecordLength>(
+        sizeof(uint8_t) + sizeof(uint32_t) + compressed.size());
+    const auto uncompressedSize = static_cast<uint32_t>(m_block.size());
+    const auto type = RECORD_TYPE_BLOCK;
+    m_os.write(reinterpret_cast<const char *>(&length), sizeof(length));
+    m_os.write(reinterpret_cast<const char *>(&type), sizeof(type));
+    m_os.write(reinterpret_cast<const char *>(&uncompressedSize),
+               sizeof(uncompressedSize));
+    m_os.write(compressed.data(), compressed.size());
+    m_block.clear();
+  }
+  m_os.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Reader::Reader(const char *begin, const char *end)
+    : m_it(begin),
+      m_end(end),
+      m_blockIt(nullptr),
+      m_type(numberOfRecordTypes),
+      m_symbolId(0),
+      m_payload(nullptr),
+      m_payloadSize(0) {
+  AssertLe(begin, end);
+  if (size_t(std::distance(m_it, m_end)) <
+          sizeof(signature) + sizeof(version) ||
+      std::memcmp(m_it, signature, sizeof(signature))) {
+    throw Exception("Market data capture file has unknown format");
+  }
+  m_it += sizeof(signature);
+  if (Read<uint16_t>(m_it) != version) {
+    throw Exception("Market data capture file has unsupported version");
+  }
+  m_it += sizeof(version);
+}
+
+bool Reader::Next() {
+  for (;;) {
+    if (m_blockIt) {
+      const auto *const blockEnd = m_block.data() + m_block.size();
+      if (m_blockIt < blockEnd) {
+        if (ReadRecord(m_blockIt, blockEnd)) {
+          return true;
+        }
+        continue;
+      }
+      m_blockIt = nullptr;
+    }
+    if (m_it >= m_end) {
+      m_type = numberOfRecordTypes;
+      return false;
+    }
+    if (ReadRecord(m_it, m_end)) {
+      return true;
+    }
+  }
+}
+
+bool Reader::ReadRecord(const char *&it, const char *end) {
+  if (size_t(std::distance(it, end)) < sizeof(RecordLength)) {
+    // The last record of the file which is still written or which wasn't
+    // completed by a crash.
+    it = end;
+    return false;
+  }
+  const auto length = Read<RecordLength>(it);
+  const char *const record = it + sizeof(length);
+  if (length < sizeof(uint8_t) ||
+      size_t(std::distance(record, end)) < length) {
+    it = end;
+    return false;
+  }
+  it = record + length;
+
+  const auto type = static_cast<RecordType>(*record);
+  switch (type) {
+    case RECORD_TYPE_SYMBOL: {
+      const char *field = record + sizeof(uint8_t);
+      const size_t fixedSize = sizeof(SymbolId) + sizeof(uint32_t) +
+                               sizeof(uint16_t) + sizeof(uint8_t);
+      if (length < fixedSize) {
+        throw Exception("Market data capture symbol record is corrupted");
+      }
+      const auto id = Read<SymbolId>(field);
+      field += sizeof(id);
+      SymbolInfo info;
+      info.sourceIndex = Read<uint32_t>(field);
+      field += sizeof(uint32_t);
+      const auto size = Read<uint16_t>(field);
+      field += sizeof(size);
+      if (length != fixedSize + size) {
+        throw Exception("Market data capture symbol record is corrupted");
+      }
+      info.symbol.assign(field, size);
+      m_symbols[id] = std::move(info);
+      return false;
+    }
+
+    case RECORD_TYPE_BLOCK: {
+      if (m_blockIt) {
+        throw Exception("Market data capture block has nested block");
+      }
+      if (length < sizeof(uint8_t) + sizeof(uint32_t)) {
+        throw Exception("Market data capture block is corrupted");
+      }
+      const char *const data = record + sizeof(uint8_t) + sizeof(uint32_t);
+      m_block.clear();
+      m_block.reserve(Read<uint32_t>(record + sizeof(uint8_t)));
+      {
+        ios::filtering_ostream filter;
+        filter.push(ios::zlib_decompressor());
+        filter.push(ios::back_inserter(m_block));
+        filter.write(data, std::distance(data, it));
+      }
+      if (m_block.size() != Read<uint32_t>(record + sizeof(uint8_t))) {
+        throw Exception("Market data capture block is corrupted");
+      }
+      m_blockIt = m_block.data();
+      return false;
+    }
+
+    case RECORD_TYPE_LEVEL1_UPDATE:
+    case RECORD_TYPE_LEVEL1_TICK:
+    case RECORD_TYPE_TRADE:
+    case RECORD_TYPE_BOOK:
+      break;
+
+    default:
+      // Records from the next versions, which are unknown for this reader.
+      return false;
+  }
+
+  if (length < recordHeaderSize) {
+    throw Exception("Market data capture record is corrupted");
+  }
+  const char *field = record + sizeof(uint8_t);
+  const auto recordTime = ConvertFromCaptureTime(Read<Time>(field));
+  field += sizeof(Time);
+  const auto dataTime = ConvertFromCaptureTime(Read<Time>(field));
+  field += sizeof(Time);
+  const auto symbolId = Read<SymbolId>(field);
+  field += sizeof(SymbolId);
+  const size_t payloadSize = length - recordHeaderSize;
+
+  static_assert(numberOfRecordTypes == 7, "List changed.");
+  switch (type) {
+    case RECORD_TYPE_LEVEL1_UPDATE:
+    case RECORD_TYPE_LEVEL1_TICK:
+      if (payloadSize < sizeof(uint8_t) ||
+          payloadSize !=
+              sizeof(uint8_t) + Read<uint8_t>(field) * level1TickSize) {
+        throw Exception("Market data capture Level 1 record is corrupted");
+      }
+      break;
+    case RECORD_TYPE_TRADE:
+      if (payloadSize != sizeof(double) * 2 + sizeof(uint8_t)) {
+        throw Exception("Market data capture trade record is corrupted");
+      }
+      break;
+    case RECORD_TYPE_BOOK:
+      if (payloadSize < sizeof(uint8_t) * 2 ||
+          Read<uint8_t>(field) > PriceBook::GetSideMaxSize() ||
+          Read<uint8_t>(field + 1) > PriceBook::GetSideMaxSize() ||
+          payloadSize != sizeof(uint8_t) * 2 +
+                             (Read<uint8_t>(field) + Read<uint8_t>(field + 1)) *
+                                 bookLevelSize) {
+        throw Exception("Market data capture book record is corrupted");
+      }
+      break;
+  }
+
+  m_type = type;
+  m_recordTime = recordTime;
+  m_dataTime = dataTime;
+  m_symbolId = symbolId;
+  m_payload = field;
+  m_payloadSize = payloadSize;
+
+  return true;
+}
+
+void Reader::CheckType(const RecordType &type) const {
+  if (m_type != type) {
+    throw LogicError("Market data capture record has another type");
+  }
+}
+
+const SymbolInfo &Reader::GetSymbol() const {
+  const auto &it = m_symbols.find(m_symbolId);
+  if (it == m_symbols.cend()) {
+    throw Exception("Market data capture record has unknown symbol");
+  }
+  return it->second;
+}
+
+size_t Reader::GetNumberOfLevel1Ticks() const {
+  if (m_type != RECORD_TYPE_LEVEL1_UPDATE) {
+    CheckType(RECORD_TYPE_LEVEL1_TICK);
+  }
+  return Read<uint8_t>(m_payload);
+}
+
+Level1TickValue Reader::GetLevel1Tick(size_t index) const {
+  if (index >= GetNumberOfLevel1Ticks()) {
+    throw LogicError("Market data capture Level 1 tick index is out of range");
+  }
+  const char *const tick = m_payload + sizeof(uint8_t) + index * level1TickSize;
+  const auto type = Read<uint8_t>(tick);
+  if (type >= numberOfLevel1TickTypes) {
+    throw Exception("Market data capture record has unknown Level 1 tick");
+  }
+  return Level1TickValue(static_cast<Level1TickType>(type),
+                         Read<double>(tick + sizeof(uint8_t)));
+}
+
+Price Reader::GetTradePrice() const {
+  CheckType(RECORD_TYPE_TRADE);
+  return Read<double>(m_payload);
+}
+
+Qty Reader::GetTradeQty() const {
+  CheckType(RECORD_TYPE_TRADE);
+  return Read<double>(m_payload + sizeof(double));
+}
+
+bool Reader::IsLastTrade() const {
+  CheckType(RECORD_TYPE_TRADE);
+  return Read<uint8_t>(m_payload + sizeof(double) * 2) != 0;
+}
+
+PriceBook Reader::GetBook() const {
+  CheckType(RECORD_TYPE_BOOK);
+  PriceBook result(m_dataTime);
+  const size_t numberOfBids = Read<uint8_t>(m_payload);
+  const size_t numberOfAsks = Read<uint8_t>(m_payload + 1);
+  const char *level = m_payload + sizeof(uint8_t) * 2;
+  for (size_t i = 0; i < numberOfBids; ++i, level += bookLevelSize) {
+    result.GetBid().Add(m_dataTime, Read<double>(level),
+                        Read<double>(level + sizeof(double)));
+  }
+  for (size_t i = 0; i < numberOfAsks; ++i, level += bookLevelSize) {
+    result.GetAsk().Add(m_dataTime, Read<double>(level),
+                        Read<double>(level + sizeof(double)));
+  }
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MarketDataCapture::ConvertToCsv(Reader &reader, std::ostream &os) {
+  while (reader.Next()) {
+    os << reader.GetRecordTime() << ',' << reader.GetDataTime();
+    static_assert(numberOfRecordTypes == 7, "List changed.");
+    switch (reader.GetType()) {
+      case RECORD_TYPE_LEVEL1_UPDATE:
+      case RECORD_TYPE_LEVEL1_TICK:
+        os << (reader.GetType() == RECORD_TYPE_LEVEL1_UPDATE ? ",L1U"
+                                                             : ",L1T");
+        for (size_t i = 0; i < reader.GetNumberOfLevel1Ticks(); ++i) {
+          const auto &tick = reader.GetLevel1Tick(i);
+          os << ',' << ConvertToPch(tick.GetType()) << ',' << tick.GetValue();
+        }
+        break;
+      case RECORD_TYPE_TRADE:
+        os << ",T," << Double(reader.GetTradePrice().Get()) << ','
+           << Double(reader.GetTradeQty().Get()) << ','
+           << (reader.IsLastTrade() ? 1 : 0);
+        break;
+      case RECORD_TYPE_BOOK: {
+        os << ",B";
+        const auto &book = reader.GetBook();
+        for (size_t i = 0; i < book.GetBid().GetSize(); ++i) {
+          const auto &level = book.GetBid().GetLevel(i);
+          os << ",bid," << Double(level.GetPrice().Get()) << ','
+             << Double(level.GetQty().Get());
+        }
+        for (size_t i = 0; i < book.GetAsk().GetSize(); ++i) {
+          const auto &level = book.GetAsk().GetLevel(i);
+          os << ",ask," << Double(level.GetPrice().Get()) << ','
+             << Double(level.GetQty().Get());
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    os << '\n';
+  }
+  os.flush();
+}
+
+SharedFile MarketDataCapture::OpenSharedFile(const fs::path &path) {
+  static boost::mutex mutex;
+  static boost::unordered_map<std::string,
+                              boost::weak_ptr<const ios::mapped_file_source>>
+      files;
+
+  const auto key = fs::canonical(path).string();
+  const boost::mutex::scoped_lock lock(mutex);
+  {
+    const auto &it = files.find(key);
+    if (it != files.cend()) {
+      auto result = it->second.lock();
+      if (result) {
+        return result;
+      }
+    }
+  }
+  const auto result = boost::make_shared<ios::mapped_file_source>(key);
+  files[key] = result;
+  return result;
+}
@@ -0,0 +1,215 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 17:12:40
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#pragma once
+
+#include "Log.hpp"
+#include "PriceBook.hpp"
+#include "Types.hpp"
+#include "Api.h"
+
+namespace trdk {
+namespace MarketDataCapture {
+
+//! Binary market data capture format.
+/**
+ * The file starts with the header (signature and version) and then has only
+ * length-prefixed records: [uint32 length][uint8 type][payload], the length
+ * includes the type and the payload. Fields are fixed-width and have the host
+ * byte order (little-endian), times are microseconds since the epoch
+ * (INT64_MIN for not-a-date-time). Market data records have the header:
+ * [int64 record time][int64 data time][uint32 symbol ID].
+ *
+ * The symbol ID is the index in the per-file symbol dictionary, which is set
+ * by RECORD_TYPE_SYMBOL records: [uint32 ID][uint32 source index]
+ * [uint16 size][symbol]. Block records contain zlib-compressed sequence of
+ * other records: [uint32 uncompressed size][compressed data].
+ */
+enum RecordType : uint8_t {
+  RECORD_TYPE_SYMBOL = 1,
+  //! [uint8 number][(uint8 Level1TickType, double value)...].
+  RECORD_TYPE_LEVEL1_UPDATE,
+  //! [uint8 number][(uint8 Level1TickType, double value)...].
+  RECORD_TYPE_LEVEL1_TICK,
+  //! [double price][double qty][uint8 use as last trade].
+  RECORD_TYPE_TRADE,
+  //! [uint8 bids][uint8 asks][(double price, double qty)...], bids first.
+  RECORD_TYPE_BOOK,
+  RECORD_TYPE_BLOCK,
+  numberOfRecordTypes
+};
+
+typedef uint32_t SymbolId;
+
+struct SymbolInfo {
+  std::string symbol;
+  size_t sourceIndex;
+};
+
+//! Market data capture record.
+/**
+ * Record is serialized at the creation into the inline buffer, so it doesn't
+ * allocate memory and may be queued by trdk::AsyncLog as-is.
+ */
+class TRDK_CORE_API Record {
+ public:
+  enum { MAX_SIZE = 512 };
+
+ public:
+  explicit Record(const boost::posix_time::ptime &time,
+                  const Log::ThreadId & = Log::ThreadId());
+
+ public:
+  const boost::posix_time::ptime &GetTime() const { return m_time; }
+
+  //! Returns the serialized record, with the length prefix.
+  const char *GetData() const { return m_buffer.data(); }
+  size_t GetSize() const { return m_size; }
+
+ public:
+  void StartLevel1Update(const SymbolId &, const boost::posix_time::ptime &);
+  void StartLevel1Tick(const SymbolId &, const boost::posix_time::ptime &);
+  void AddLevel1Tick(const Level1TickValue &);
+
+  void SetTrade(const SymbolId &,
+                const boost::posix_time::ptime &,
+                const Price &,
+                const Qty &,
+                bool useAsLastTrade);
+
+  void SetBook(const SymbolId &, const PriceBook &);
+
+ private:
+  void Start(const RecordType &,
+             const SymbolId &,
+             const boost::posix_time::ptime &);
+  void UpdateLength();
+
+  template <typename T>
+  void Append(const T &value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Value can't be stored as bytes.");
+    if (m_size + sizeof(value) > m_buffer.size()) {
+      throw Lib::LogicError("Market data capture record is too large");
+    }
+    std::memcpy(m_buffer.data() + m_size, &value, sizeof(value));
+    m_size += sizeof(value);
+  }
+
+ private:
+  boost::posix_time::ptime m_time;
+  size_t m_size;
+  size_t m_numberOfTicksOffset;
+  std::array<char, MAX_SIZE> m_buffer;
+};
+
+//! Writes capture records into the stream.
+/**
+ * Not thread-safe. If the compression is enabled, records are collected into
+ * blocks, so the stream receives records only when the block is full, at
+ * Flush or at the destruction.
+ */
+class TRDK_CORE_API Writer : private boost::noncopyable {
+ public:
+  //! Starts writing.
+  /**
+   * @param isNewFile  Writes the file header if set. The stream position can't
+   *                   be used to detect a new file as streams opened for
+   *                   appending may report zero before the first write.
+   */
+  explicit Writer(std::ostream &, bool isCompressionEnabled, bool isNewFile);
+  ~Writer();
+
+ public:
+  void AddSymbol(const SymbolId &, const std::string &, size_t sourceIndex);
+  void Write(const Record &);
+  void Flush();
+
+ private:
+  void Write(const char *data, size_t size);
+
+ private:
+  std::ostream &m_os;
+  const bool m_isCompressionEnabled;
+  std::vector<char> m_block;
+};
+
+//! Reads capture records from the memory range.
+/**
+ * The range isn't copied, so it may be a memory-mapped file, which should be
+ * alive until the reader is used. Symbol and block records are handled
+ * internally and aren't returned by Next.
+ */
+class TRDK_CORE_API Reader : private boost::noncopyable {
+ public:
+  explicit Reader(const char *begin, const char *end);
+
+ public:
+  //! Moves to the next market data record, returns false at the end.
+  bool Next();
+
+ public:
+  const RecordType &GetType() const { return m_type; }
+  const boost::posix_time::ptime &GetRecordTime() const {
+    return m_recordTime;
+  }
+  const boost::posix_time::ptime &GetDataTime() const { return m_dataTime; }
+  const SymbolId &GetSymbolId() const { return m_symbolId; }
+  const SymbolInfo &GetSymbol() const;
+
+  size_t GetNumberOfLevel1Ticks() const;
+  Level1TickValue GetLevel1Tick(size_t index) const;
+
+  Price GetTradePrice() const;
+  Qty GetTradeQty() const;
+  bool IsLastTrade() const;
+
+  //! Returns price book, levels have the time of the record data.
+  PriceBook GetBook() const;
+
+ private:
+  bool ReadRecord(const char *&it, const char *end);
+  void CheckType(const RecordType &) const;
+
+ private:
+  const char *m_it;
+  const char *m_end;
+
+  std::vector<char> m_block;
+  const char *m_blockIt;
+
+  boost::unordered_map<SymbolId, SymbolInfo> m_symbols;
+
+  RecordType m_type;
+  boost::posix_time::ptime m_recordTime;
+  boost::posix_time::ptime m_dataTime;
+  SymbolId m_symbolId;
+  const char *m_payload;
+  size_t m_payloadSize;
+};
+
+//! Writes all records from the reader in the CSV format of the text market
+//! data log.
+TRDK_CORE_API void ConvertToCsv(Reader &, std::ostream &);
+
+//! Read-only memory-mapped capture file which is shared in the process.
+typedef boost::shared_ptr<const boost::iostreams::mapped_file_source>
+    SharedFile;
+
+//! Maps the capture file or returns the file which is already mapped.
+/**
+ * The file is unmapped when the last user releases it, so all contexts in the
+ * process, which replay the same file at the same time, read the same pages
+ * without copies. Thread-safe.
+ */
+TRDK_CORE_API SharedFile OpenSharedFile(const boost::filesystem::path &);
+
+}  // namespace MarketDataCapture
+}  // namespace trdk
@@ -0,0 +1,163 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 18:04:51
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Core/MarketDataCapture.hpp"
+
+using namespace trdk;
+using namespace trdk::MarketDataCapture;
+namespace pt = boost::posix_time;
+
+namespace {
+
+const pt::ptime recordTime(boost::gregorian::date(2018, 3, 4),
+                           pt::time_duration(10, 20, 30, 123456));
+const pt::ptime dataTime(boost::gregorian::date(2018, 3, 4),
+                         pt::time_duration(10, 20, 29, 654321));
+
+std::string WriteTestData(bool isCompressionEnabled, bool isNewFile = true) {
+  std::ostringstream os;
+  Writer writer(os, isCompressionEnabled, isNewFile);
+  writer.AddSymbol(0, "BTC_USD", 2);
+  {
+    Record record(recordTime);
+    record.StartLevel1Update(0, dataTime);
+    record.AddLevel1Tick(
+        Level1TickValue::Create<LEVEL1_TICK_BID_PRICE>(100.25));
+    record.AddLevel1Tick(Level1TickValue::Create<LEVEL1_TICK_BID_QTY>(3));
+    writer.Write(record);
+  }
+  {
+    Record record(recordTime);
+    record.SetTrade(0, pt::not_a_date_time, 100.5, 0.125, true);
+    writer.Write(record);
+  }
+  {
+    PriceBook book(dataTime);
+    book.GetBid().Add(dataTime, 100.25, 3);
+    book.GetBid().Add(dataTime, 100.5, 1);
+    book.GetAsk().Add(dataTime, 101, 2);
+    Record record(recordTime);
+    record.SetBook(0, book);
+    writer.Write(record);
+  }
+  writer.Flush();
+  return os.str();
+}
+
+void CheckTestData(const std::string &data) {
+  Reader reader(data.data(), data.data() + data.size());
+
+  ASSERT_TRUE(reader.Next());
+  EXPECT_EQ(RECORD_TYPE_LEVEL1_UPDATE, reader.GetType());
+  EXPECT_EQ(recordTime, reader.GetRecordTime());
+  EXPECT_EQ(dataTime, reader.GetDataTime());
+  EXPECT_EQ("BTC_USD", reader.GetSymbol().symbol);
+  EXPECT_EQ(2, reader.GetSymbol().sourceIndex);
+  ASSERT_EQ(2, reader.GetNumberOfLevel1Ticks());
+  EXPECT_EQ(LEVEL1_TICK_BID_PRICE, reader.GetLevel1Tick(0).GetType());
+  EXPECT_EQ(100.25, reader.GetLevel1Tick(0).GetValue());
+  EXPECT_EQ(LEVEL1_TICK_BID_QTY, reader.GetLevel1Tick(1).GetType());
+  EXPECT_EQ(3, reader.GetLevel1Tick(1).GetValue());
+  EXPECT_THROW(reader.GetTradePrice(), Lib::LogicError);
+
+  ASSERT_TRUE(reader.Next());
+  EXPECT_EQ(RECORD_TYPE_TRADE, reader.GetType());
+  EXPECT_EQ(pt::not_a_date_time, reader.GetDataTime());
+  EXPECT_EQ(100.5, reader.GetTradePrice());
+  EXPECT_EQ(0.125, reader.GetTradeQty());
+  EXPECT_TRUE(reader.IsLastTrade());
+
+  ASSERT_TRUE(reader.Next());
+  EXPECT_EQ(RECORD_TYPE_BOOK, reader.GetType());
+  const auto &book = reader.GetBook();
+  EXPECT_EQ(dataTime, book.GetTime());
+  ASSERT_EQ(2, book.GetBid().GetSize());
+  EXPECT_EQ(100.5, book.GetBid().GetLevel(0).GetPrice());
+  EXPECT_EQ(1, book.GetBid().GetLevel(0).GetQty());
+  EXPECT_EQ(100.25, book.GetBid().GetLevel(1).GetPrice());
+  ASSERT_EQ(1, book.GetAsk().GetSize());
+  EXPECT_EQ(101, book.GetAsk().GetTop().GetPrice());
+  EXPECT_EQ(2, book.GetAsk().GetTop().GetQty());
+
+  EXPECT_FALSE(reader.Next());
+}
+}  // namespace
+
+TEST(Core_MarketDataCapture, Raw) { CheckTestData(WriteTestData(false)); }
+
+TEST(Core_MarketDataCapture, Compressed) {
+  CheckTestData(WriteTestData(true));
+}
+
+TEST(Core_MarketDataCapture, Append) {
+  const auto &head = WriteTestData(false);
+  const auto &tail = WriteTestData(false, false);
+  // Only the header is skipped:
+  ASSERT_LT(tail.size(), head.size());
+  EXPECT_EQ(head.substr(head.size() - tail.size()), tail);
+
+  const auto &data = head + tail;
+  Reader reader(data.data(), data.data() + data.size());
+  for (size_t i = 0; i < 6; ++i) {
+    EXPECT_TRUE(reader.Next());
+    EXPECT_EQ("BTC_USD", reader.GetSymbol().symbol);
+  }
+  EXPECT_FALSE(reader.Next());
+}
+
+TEST(Core_MarketDataCapture, TruncatedRecord) {
+  auto data = WriteTestData(false);
+  data.resize(data.size() - 1);
+  Reader reader(data.data(), data.data() + data.size());
+  EXPECT_TRUE(reader.Next());
+  EXPECT_TRUE(reader.Next());
+  EXPECT_FALSE(reader.Next());
+}
+
+TEST(Core_MarketDataCapture, WrongFormat) {
+  const std::string data = "2018-Mar-04 10:20:30,L1U";
+  EXPECT_THROW(Reader(data.data(), data.data() + data.size()),
+               Lib::Exception);
+}
+
+TEST(Core_MarketDataCapture, Csv) {
+  const auto &data = WriteTestData(true);
+  Reader reader(data.data(), data.data() + data.size());
+  std::ostringstream os;
+  ConvertToCsv(reader, os);
+  std::vector<std::string> lines;
+  boost::split(lines, os.str(), boost::is_any_of("\n"));
+  ASSERT_EQ(4, lines.size());
+  EXPECT_EQ(0, lines[0].find("2018-Mar-04 10:20:30.123456,"
+                             "2018-Mar-04 10:20:29.654321,L1U,bid price,"));
+  EXPECT_EQ(0, lines[1].find("2018-Mar-04 10:20:30.123456,not-a-date-time,T,"));
+  EXPECT_EQ(0, lines[2].find("2018-Mar-04 10:20:30.123456,"
+                             "2018-Mar-04 10:20:29.654321,B,bid,"));
+  EXPECT_TRUE(lines[3].empty());
+}
+
+TEST(Core_MarketDataCapture, SharedFile) {
+  const auto &path = boost::filesystem::temp_directory_path() /
+                     boost::filesystem::unique_path("%%%%%%%%.trdkmd");
+  {
+    const auto &data = WriteTestData(false);
+    std::ofstream file(path.string().c_str(),
+                       std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(data.data(), data.size());
+  }
+  {
+    const auto &file = OpenSharedFile(path);
+    EXPECT_EQ(file, OpenSharedFile(path));
+    CheckTestData(std::string(file->data(), file->size()));
+  }
+  boost::filesystem::remove(path);
+}
+
@@ -0,0 +1,55 @@
+/**************************************************************************
+ *   Created: 2026/10/17 03:52:04
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Core/PriceBook.hpp"
+
+using namespace trdk;
+
+namespace pt = boost::posix_time;
+namespace gr = boost::gregorian;
+
+namespace {
+
+//! Updates side by random prices from the set of the given size, the set
+//! larger than the side makes the side to shift and drop levels.
+template <typename Side>
+void UpdateSide(benchmark::State &state) {
+  const auto numberOfPrices = static_cast<size_t>(state.range(0));
+  boost::mt19937 random(42);
+  std::vector<std::pair<double, Qty>> updates(1024);
+  for (auto &update : updates) {
+    update.first = 100 + .01 * static_cast<double>(random() % numberOfPrices);
+    update.second = .1 * static_cast<double>(1 + random() % 10);
+  }
+
+  const pt::ptime time(gr::date(2018, 1, 1));
+  Side side;
+  auto update = updates.cbegin();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(side.Update(time, update->first, update->second));
+    if (++update == updates.cend()) {
+      update = updates.cbegin();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void Core_PriceBook_BidUpdate(benchmark::State &state) {
+  UpdateSide<PriceBook::Bid>(state);
+}
+void Core_PriceBook_AskUpdate(benchmark::State &state) {
+  UpdateSide<PriceBook::Ask>(state);
+}
+
+}  // namespace
+
+BENCHMARK(Core_PriceBook_BidUpdate)->Arg(1)->Arg(10)->Arg(20);
+BENCHMARK(Core_PriceBook_AskUpdate)->Arg(1)->Arg(10)->Arg(20);
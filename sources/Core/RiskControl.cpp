@@ -14,9 +14,11 @@
 #include "Security.hpp"
 #include "Trade.hpp"
 #include "TradingLog.hpp"
+#include "Common/SlidingWindowLimiter.hpp"
 
 using namespace trdk;
 using namespace Lib;
+using Lib::Concurrency::SlidingWindowLimiter;
 namespace pt = boost::posix_time;
 namespace ptr = boost::property_tree;
 
@@ -51,6 +53,9 @@ class RiskControlSymbolContext::Position : private boost::noncopyable {
 
   Volume position;
 
+  //! Guards the position in the sharded mode.
+  ConcurrencyPolicyT<TRDK_CONCURRENCY_PROFILE>::Mutex mutex;
+
  public:
   explicit Position(const Lib::Currency &currency,
                     const Volume &shortLimit,
@@ -166,47 +171,76 @@ class StandardRiskControlScope : public RiskControlScope {
  private:
   typedef boost::circular_buffer<pt::ptime> FloodControlBuffer;
 
+  //! Locks funds of the order currencies.
+  /**
+   * In the sharded mode only positions of the order currencies are locked, in
+   * the address order, so operations with other currencies are not blocked
+   * and operations with the same currencies can't deadlock. Otherwise, the
+   * whole scope is locked.
+   */
+  class FundsLock : private boost::noncopyable {
+   public:
+    explicit FundsLock(bool isSharded,
+                       Mutex &scopeMutex,
+                       RiskControlSymbolContext::Position &position1,
+                       RiskControlSymbolContext::Position &position2)
+        : m_first(!isSharded ? scopeMutex
+                             : *std::min(&position1.mutex, &position2.mutex,
+                                         std::less<Mutex *>())),
+          m_second(!isSharded || &position1 == &position2
+                       ? nullptr
+                       : std::max(&position1.mutex, &position2.mutex,
+                                  std::less<Mutex *>())) {
+      m_first.lock();
+      if (m_second) {
+        m_second->lock();
+      }
+    }
+    ~FundsLock() {
+      if (m_second) {
+        m_second->unlock();
+      }
+      m_first.unlock();
+    }
+
+   private:
+    Mutex &m_first;
+    Mutex *const m_second;
+  };
+
  public:
   explicit StandardRiskControlScope(Context &context,
                                     const std::string &name,
                                     size_t index,
                                     const TradingMode &tradingMode,
+                                    bool isSharded,
                                     const Settings &settings,
                                     size_t maxOrdersNumber)
       : RiskControlScope(tradingMode),
         m_context(context),
         m_name(ConvertToString(GetTradingMode()) + "." + name),
         m_index(index),
+        m_isSharded(isSharded),
         m_log(logPrefix, m_context.GetLog()),
         m_tradingLog(logPrefix, m_context.GetTradingLog()),
-        m_settings(settings),
-        m_orderTimePoints(maxOrdersNumber) {
+        m_settings(nullptr),
+        m_orderTimePoints(maxOrdersNumber),
+        m_ordersWindowStartTime(
+            ConvertToMicroseconds(m_context.GetCurrentTime())),
+        m_ordersWindow(nullptr) {
     m_log.Info(
         "Orders flood control for scope \"%1%\":"
-        " not more than %2% orders per %3%.",
-        m_name, m_orderTimePoints.capacity(),
-        m_settings.ordersFloodControlPeriod);
+        " not more than %2% orders per %3% (%4%).",
+        m_name, maxOrdersNumber, settings.ordersFloodControlPeriod,
+        m_isSharded ? "lock-free sliding window" : "sliding window");
     m_log.Info("Max profit for scope \"%1%\": %2$f; max loss: %3$f.", m_name,
-               m_settings.pnl.second, fabs(m_settings.pnl.first));
+               settings.pnl.second, fabs(settings.pnl.first));
     m_log.Info(
         "Min win-ratio for scope \"%1%\": %2%%%"
         " (skip first %3% operations).",
-        m_name, m_settings.winRatioMinValue,
-        m_settings.winRatioFirstOperationsToSkip);
-
-    if (m_orderTimePoints.capacity() <= 0 ||
-        m_settings.ordersFloodControlPeriod.total_nanoseconds() <= 0) {
-      throw WrongSettingsException("Wrong Order Flood Control settings");
-    }
-
-    if (m_settings.pnl.first == 0 || m_settings.pnl.second == 0 ||
-        m_settings.pnl.first > .1 || m_settings.pnl.second > .1) {
-      throw WrongSettingsException("Wrong P&L available range set");
-    }
-
-    if (m_settings.winRatioMinValue < 0 || m_settings.winRatioMinValue > 100) {
-      throw WrongSettingsException("Wrong Min win-ratio set");
-    }
+        m_name, settings.winRatioMinValue,
+        settings.winRatioFirstOperationsToSkip);
+    SetSettings(settings, maxOrdersNumber);
   }
 
   virtual ~StandardRiskControlScope() {}
@@ -267,24 +301,25 @@ class StandardRiskControlScope : public RiskControlScope {
 
  public:
   virtual void CheckTotalPnl(const Volume &pnl) const {
+    const auto &settings = GetSettings();
     if (pnl < 0) {
-      if (pnl < m_settings.pnl.first) {
+      if (pnl < settings.pnl.first) {
         m_tradingLog.Write(
             "Total loss is out of allowed PnL range for scope \"%1%\":"
             " %2$f, but can't be more than %3$f.",
             [&](TradingRecord &record) {
-              record % GetName() % fabs(pnl) % fabs(m_settings.pnl.first);
+              record % GetName() % fabs(pnl) % fabs(settings.pnl.first);
             });
         throw PnlIsOutOfRangeException(
             "Total loss is out of allowed PnL range");
       }
 
-    } else if (pnl > m_settings.pnl.second) {
+    } else if (pnl > settings.pnl.second) {
       m_tradingLog.Write(
           "Total profit is out of allowed PnL range for scope \"%1%\":"
           " %2$f, but can't be more than %3$f.",
           [&](TradingRecord &record) {
-            record % GetName() % pnl % m_settings.pnl.second;
+            record % GetName() % pnl % settings.pnl.second;
           });
       throw PnlIsOutOfRangeException(
           "Total profit is out of allowed PnL range");
@@ -294,13 +329,14 @@ class StandardRiskControlScope : public RiskControlScope {
   virtual void CheckTotalWinRatio(size_t totalWinRatio,
                                   size_t operationsCount) const {
     AssertGe(100, totalWinRatio);
-    if (operationsCount >= m_settings.winRatioFirstOperationsToSkip &&
-        totalWinRatio < m_settings.winRatioMinValue) {
+    const auto &settings = GetSettings();
+    if (operationsCount >= settings.winRatioFirstOperationsToSkip &&
+        totalWinRatio < settings.winRatioMinValue) {
       m_tradingLog.Write(
           "Total win-ratio is too small for scope \"%1%\":"
           " %2%%%, but can't be less than %3%%%.",
           [&](TradingRecord &record) {
-            record % GetName() % totalWinRatio % m_settings.winRatioMinValue;
+            record % GetName() % totalWinRatio % settings.winRatioMinValue;
           });
       throw WinRatioIsOutOfRangeException("Total win-ratio is too small");
     }
@@ -309,9 +345,48 @@ class StandardRiskControlScope : public RiskControlScope {
  protected:
   ModuleTradingLog &GetTradingLog() const { return m_tradingLog; }
 
+  //! Replaces settings, they are immutable for readers.
+  /**
+   * Replaced objects are kept until the scope destruction, so readers load
+   * the current object without locking and don't lose it at the update.
+   */
   void SetSettings(const Settings &newSettings, size_t maxOrdersNumber) {
-    m_settings = newSettings;
+    if (maxOrdersNumber <= 0 ||
+        newSettings.ordersFloodControlPeriod.total_microseconds() <= 0) {
+      throw WrongSettingsException("Wrong Order Flood Control settings");
+    }
+    if (newSettings.pnl.first == 0 || newSettings.pnl.second == 0 ||
+        newSettings.pnl.first > .1 || newSettings.pnl.second > .1) {
+      throw WrongSettingsException("Wrong P&L available range set");
+    }
+    if (newSettings.winRatioMinValue < 0 ||
+        newSettings.winRatioMinValue > 100) {
+      throw WrongSettingsException("Wrong Min win-ratio set");
+    }
+
+    const Lock lock(m_mutex);
+
+    m_settingsHistory.emplace_back(boost::make_unique<Settings>(newSettings));
+    m_settings.store(m_settingsHistory.back().get(),
+                     boost::memory_order_release);
+
     m_orderTimePoints.set_capacity(maxOrdersNumber);
+    if (m_isSharded) {
+      const auto period =
+          newSettings.ordersFloodControlPeriod.total_microseconds();
+      m_ordersWindows.emplace_back(
+          m_ordersWindows.empty()
+              ? boost::make_unique<SlidingWindowLimiter>(maxOrdersNumber,
+                                                         period)
+              : boost::make_unique<SlidingWindowLimiter>(
+                    maxOrdersNumber, period, *m_ordersWindows.back()));
+      m_ordersWindow.store(m_ordersWindows.back().get(),
+                           boost::memory_order_release);
+    }
+  }
+
+  const Settings &GetSettings() const {
+    return *m_settings.load(boost::memory_order_acquire);
   }
 
   virtual void OnSettingsUpdate(const ptr::ptree &) {
@@ -325,7 +400,7 @@ class StandardRiskControlScope : public RiskControlScope {
                      const Qty &qty,
                      const Price &price,
                      RiskControlSymbolContext::Side &side) {
-    CheckOrdersFloodLevel();
+    m_isSharded ? CheckOrdersFloodLevelLockFree() : CheckOrdersFloodLevel();
     BlockFunds(operationId, security, currency, qty, price, side);
   }
 
@@ -343,7 +418,8 @@ class StandardRiskControlScope : public RiskControlScope {
 
   void CheckOrdersFloodLevel() {
     const auto &now = m_context.GetCurrentTime();
-    const auto &oldestTime = now - m_settings.ordersFloodControlPeriod;
+    const auto &settings = GetSettings();
+    const auto &oldestTime = now - settings.ordersFloodControlPeriod;
 
     const Lock lock(m_mutex);
 
@@ -361,7 +437,7 @@ class StandardRiskControlScope : public RiskControlScope {
           ", but allowed not more than %6%.",
           [&](TradingRecord &record) {
             record % GetName() % (m_orderTimePoints.size() + 1) %
-                m_settings.ordersFloodControlPeriod %
+                settings.ordersFloodControlPeriod %
                 m_orderTimePoints.front() % m_orderTimePoints.back() %
                 m_orderTimePoints.capacity();
           });
@@ -376,7 +452,7 @@ class StandardRiskControlScope : public RiskControlScope {
           ", allowed not more than %6%.",
           [&](TradingRecord &record) {
             record % GetName() % (m_orderTimePoints.size() + 1) %
-                m_settings.ordersFloodControlPeriod %
+                settings.ordersFloodControlPeriod %
                 m_orderTimePoints.front() % m_orderTimePoints.back() %
                 m_orderTimePoints.capacity();
           });
@@ -385,6 +461,42 @@ class StandardRiskControlScope : public RiskControlScope {
     m_orderTimePoints.push_back(now);
   }
 
+  //! Lock-free flood control for the sharded mode.
+  /**
+   * Works as the sliding window of the default mode: not more than the max
+   * number of orders in any period.
+   */
+  void CheckOrdersFloodLevelLockFree() {
+    auto &window = *m_ordersWindow.load(boost::memory_order_acquire);
+    const auto now = std::max<int64_t>(
+        0, ConvertToMicroseconds(m_context.GetCurrentTime()) -
+               m_ordersWindowStartTime);
+    switch (window.Add(now)) {
+      case SlidingWindowLimiter::RESULT_REJECTED:
+        m_tradingLog.Write(
+            "Number of orders for period limit is reached for scope \"%1%\""
+            ", allowed not more than %2% orders per %3%.",
+            [&](TradingRecord &record) {
+              record % GetName() % window.GetMaxNumberOfEvents() %
+                  pt::microseconds(window.GetPeriod());
+            });
+        throw NumberOfOrdersLimitException(
+            "Number of orders for period limit is reached");
+      case SlidingWindowLimiter::RESULT_ADDED_LAST:
+        m_tradingLog.Write(
+            "Number of orders for period limit"
+            " will be reached with next order for scope \"%1%\""
+            ", allowed not more than %2% orders per %3%.",
+            [&](TradingRecord &record) {
+              record % GetName() % window.GetMaxNumberOfEvents() %
+                  pt::microseconds(window.GetPeriod());
+            });
+        break;
+      case SlidingWindowLimiter::RESULT_ADDED:
+        break;
+    }
+  }
+
  private:
   //! Calculates order volumes.
   /** @return First value - order subject (base currency, security and so on),
@@ -442,6 +554,7 @@ class StandardRiskControlScope : public RiskControlScope {
         *context.baseCurrencyPosition;
     RiskControlSymbolContext::Position &quoteCurrency =
         *context.quoteCurrencyPosition;
+    const FundsLock lock(m_isSharded, m_mutex, baseCurrency, quoteCurrency);
 
     const auto &blocked =
         CalcOrderVolumes(security, currency, qty, orderPrice, side);
@@ -528,6 +641,7 @@ class StandardRiskControlScope : public RiskControlScope {
         *context.baseCurrencyPosition;
     RiskControlSymbolContext::Position &quoteCurrency =
         *context.quoteCurrencyPosition;
+    const FundsLock lock(m_isSharded, m_mutex, baseCurrency, quoteCurrency);
 
     const auto &blocked =
         CalcOrderVolumes(security, currency, trade.qty, orderPrice, side);
@@ -576,6 +690,7 @@ class StandardRiskControlScope : public RiskControlScope {
         *context.baseCurrencyPosition;
     RiskControlSymbolContext::Position &quoteCurrency =
         *context.quoteCurrencyPosition;
+    const FundsLock lock(m_isSharded, m_mutex, baseCurrency, quoteCurrency);
 
     const auto &blocked =
         CalcOrderVolumes(security, currency, remainingQty, orderPrice, side);
@@ -617,14 +732,25 @@ class StandardRiskControlScope : public RiskControlScope {
   const std::string m_name;
   size_t m_index;
 
-  Mutex m_mutex;
+  const bool m_isSharded;
+
+  mutable Mutex m_mutex;
 
   ModuleEventsLog m_log;
   mutable ModuleTradingLog m_tradingLog;
 
-  Settings m_settings;
+  //! All settings objects, the last is the current, guarded by m_mutex.
+  std::vector<std::unique_ptr<const Settings>> m_settingsHistory;
+  boost::atomic<const Settings *> m_settings;
 
+  //! Orders flood control for the default mode, guarded by m_mutex.
   FloodControlBuffer m_orderTimePoints;
+
+  //! Orders flood control for the sharded mode. Each settings update creates
+  //! new window with the history of the previous, guarded by m_mutex.
+  const int64_t m_ordersWindowStartTime;
+  std::vector<std::unique_ptr<SlidingWindowLimiter>> m_ordersWindows;
+  boost::atomic<SlidingWindowLimiter *> m_ordersWindow;
 };
 
 class GlobalRiskControlScope : public StandardRiskControlScope {
@@ -636,11 +762,13 @@ class GlobalRiskControlScope : public StandardRiskControlScope {
                                   const ptr::ptree &conf,
                                   const std::string &name,
                                   size_t index,
-                                  const TradingMode &tradingMode)
+                                  const TradingMode &tradingMode,
+                                  bool isSharded)
       : Base(context,
              name,
              index,
              tradingMode,
+             isSharded,
              ReadSettings(conf),
              conf.get<size_t>("floodControlOrders.maxNumber")) {}
 
@@ -679,11 +807,13 @@ class LocalRiskControlScope : public StandardRiskControlScope {
                                  const ptr::ptree &conf,
                                  const std::string &name,
                                  const size_t index,
-                                 const TradingMode &tradingMode)
+                                 const TradingMode &tradingMode,
+                                 bool isSharded)
       : Base(context,
              name,
              index,
              tradingMode,
+             isSharded,
              ReadSettings(conf),
              conf.get<size_t>("riskControl.floodControl.orders.maxNumber")) {}
 
@@ -833,6 +963,10 @@ class RiskControl::Implementation : boost::noncopyable {
 
   const TradingMode m_tradingMode;
 
+  //! Locks positions by currencies instead of whole scopes and uses lock-free
+  //! flood control.
+  const bool m_isSharded;
+
   PositionsCache m_globalScopePositionsCache;
   std::vector<boost::shared_ptr<RiskControlSymbolContext>> m_symbols;
 
@@ -852,11 +986,13 @@ class RiskControl::Implementation : boost::noncopyable {
         m_tradingLog(logPrefix, m_context.GetTradingLog()),
         m_conf(conf),
         m_tradingMode(tradingMode),
+        m_isSharded(m_conf.get<bool>("isSharded", false)),
         m_lastOperationId(0) {
     if (m_conf.get<bool>("isEnabled")) {
+      m_log.Info("Using %1% mode.", m_isSharded ? "sharded" : "scope lock");
       m_globalScope.reset(new GlobalRiskControlScope(
           m_context, m_conf, "Global", m_additionalScopesInfo.size(),
-          m_tradingMode));
+          m_tradingMode, m_isSharded));
     }
   }
 
@@ -967,7 +1103,8 @@ std::unique_ptr<RiskControlScope> RiskControl::CreateScope(
   }
 
   auto result = boost::make_unique<LocalRiskControlScope>(
-      m_pimpl->m_context, conf, name, scopeIndex, GetTradingMode());
+      m_pimpl->m_context, conf, name, scopeIndex, GetTradingMode(),
+      m_pimpl->m_isSharded);
 
   additionalScopesInfo.swap(m_pimpl->m_additionalScopesInfo);
 
@@ -0,0 +1,51 @@
+/**************************************************************************
+ *   Created: 2026/10/17 04:14:55
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Core/RiskControl.hpp"
+#include "Benchmarks/BenchmarkContext.hpp"
+
+using namespace trdk;
+
+namespace ptr = boost::property_tree;
+
+namespace {
+
+ptr::ptree CreateSettings() {
+  ptr::ptree result;
+  result.add("riskControl.isEnabled", true);
+  result.add("riskControl.floodControlOrders.maxNumber", 100);
+  result.add("riskControl.floodControl.orders.maxNumber", 100);
+  result.add("riskControl.floodControl.orders.periodMs", 1000);
+  result.add("riskControl.pnl.loss", .05);
+  result.add("riskControl.pnl.profit", .05);
+  result.add("riskControl.winRatio.firstOperationsToSkip", 10);
+  result.add("riskControl.winRatio.min", 20);
+  return result;
+}
+
+//! Checks of the strategy scope and the global scope at each position closing.
+void Core_RiskControl_CheckTotals(benchmark::State &state) {
+  const auto &settings = CreateSettings();
+  RiskControl riskControl(Benchmarks::Context::GetInstance(), settings,
+                          TRADING_MODE_LIVE);
+  const auto scope = riskControl.CreateScope("Benchmark", settings);
+  size_t i = 0;
+  for (auto _ : state) {
+    ++i;
+    riskControl.CheckTotalPnl(*scope, .0001 * static_cast<double>(i % 100));
+    riskControl.CheckTotalWinRatio(*scope, 50 + i % 50, i);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(Core_RiskControl_CheckTotals);
@@ -13,6 +13,7 @@
 #include "Bar.hpp"
 #include "Context.hpp"
 #include "DropCopy.hpp"
+#include "MarketDataCapture.hpp"
 #include "MarketDataSource.hpp"
 #include "PriceBook.hpp"
 #include "RiskControl.hpp"
@@ -23,7 +24,6 @@
 namespace fs = boost::filesystem;
 namespace lt = boost::local_time;
 namespace pt = boost::posix_time;
-namespace sig = boost::signals2;
 
 using namespace trdk;
 using namespace Lib;
@@ -46,6 +46,17 @@ typedef boost::unordered_map<pt::time_duration,
                              StartedBarsHash>
     StartedBars;
 
+//! Allocator for price book snapshots.
+/**
+ * Snapshots are released by dispatcher threads and allocated by market data
+ * threads, so the pool is synchronized, but memory is never returned to the
+ * system and reused for next snapshots.
+ */
+typedef boost::fast_pool_allocator<PriceBook,
+                                   boost::default_user_allocator_new_delete,
+                                   Concurrency::SpinMutex>
+    PriceBookSnapshotAllocator;
+
 //! Level 1 data.
 /** Should be native double to use NaN value as marker.
  */
@@ -218,34 +229,36 @@ Qty GetLotSizeBySymbol(const Symbol& symbol) {
 namespace {
 namespace MarketDataLog {
 
-class Record : public AsyncLogRecord {
- public:
-  explicit Record(const pt::ptime& time, const Log::ThreadId& threadId)
-      : AsyncLogRecord(time, threadId) {}
+typedef MarketDataCapture::Record Record;
 
- public:
-  const Record& operator>>(std::ostream& os) const {
-    Dump(os, ",");
-    return *this;
-  }
-};
-
-std::ostream& operator<<(std::ostream& os, const Record& record) {
-  record >> os;
-  return os;
-}
+//! Each security has its own log file, so the file has only one symbol.
+const MarketDataCapture::SymbolId symbolId = 0;
 
 class OutStream : private boost::noncopyable {
  public:
-  explicit OutStream(const lt::time_zone_ptr& timeZone) : m_log(timeZone) {}
-  void Write(const Record& record) { m_log.Write(record); }
-  bool IsEnabled() const { return m_log.IsEnabled(); }
-  void EnableStream(std::ostream& os) { m_log.EnableStream(os, false); }
-  pt::ptime GetTime() const { return m_log.GetTime(); }
+  explicit OutStream(const Context& context)
+      : m_timeZone(context.GetSettings().GetTimeZone()),
+        m_isCompressionEnabled(
+            context.GetSettings().IsMarketDataLogCompressionEnabled()) {}
+  void Write(const Record& record) { m_writer->Write(record); }
+  bool IsEnabled() const { return m_writer != nullptr; }
+  void EnableStream(std::ostream& os,
+                    bool isNewFile,
+                    const Symbol& symbol,
+                    size_t sourceIndex) {
+    m_writer = boost::make_unique<MarketDataCapture::Writer>(
+        os, m_isCompressionEnabled, isNewFile);
+    m_writer->AddSymbol(symbolId, symbol.GetAsString(), sourceIndex);
+  }
+  pt::ptime GetTime() const {
+    return lt::local_microsec_clock::local_time(m_timeZone).local_time();
+  }
   Log::ThreadId GetThreadId() const { return 0; }
 
  private:
-  Log m_log;
+  const lt::time_zone_ptr m_timeZone;
+  const bool m_isCompressionEnabled;
+  std::unique_ptr<MarketDataCapture::Writer> m_writer;
 };
 
 typedef AsyncLog<Record, OutStream, TRDK_CONCURRENCY_PROFILE> LogBase;
@@ -258,13 +271,12 @@ class Log : private LogBase {
   using Base::EnableStream;
   using Base::IsEnabled;
 
-  explicit Log(const Context& context)
-      : Base(context.GetSettings().GetTimeZone()) {}
+  explicit Log(const Context& context) : Base(context) {}
 
   template <typename... Params>
   void WriteLevel1Update(const pt::ptime& time, const Params&... params) {
     FormatAndWrite([&](Record& record) {
-      record % record.GetTime() % time % "L1U";
+      record.StartLevel1Update(symbolId, time);
       InsertFirstLevel1Update(record, params...);
     });
   }
@@ -272,9 +284,9 @@ class Log : private LogBase {
   void WriteLevel1Update(const pt::ptime& time,
                          const std::vector<Level1TickValue>& ticks) {
     FormatAndWrite([&](Record& record) {
-      record % record.GetTime() % time % "L1U";
+      record.StartLevel1Update(symbolId, time);
       for (const auto& tick : ticks) {
-        WriteValue(record, tick);
+        record.AddLevel1Tick(tick);
       }
     });
   }
@@ -282,7 +294,7 @@ class Log : private LogBase {
   template <typename... Params>
   void WriteLevel1Tick(const pt::ptime& time, const Params&... params) {
     FormatAndWrite([&](Record& record) {
-      record % record.GetTime() % time % "L1T";
+      record.StartLevel1Tick(symbolId, time);
       InsertFirstLevel1Update(record, params...);
     });
   }
@@ -290,9 +302,9 @@ class Log : private LogBase {
   void WriteLevel1Tick(const pt::ptime& time,
                        const std::vector<Level1TickValue>& ticks) {
     FormatAndWrite([&](Record& record) {
-      record % record.GetTime() % time % "L1T";
+      record.StartLevel1Tick(symbolId, time);
       for (const auto& tick : ticks) {
-        WriteValue(record, tick);
+        record.AddLevel1Tick(tick);
       }
     });
   }
@@ -302,24 +314,24 @@ class Log : private LogBase {
                   const Qty& qty,
                   bool useAsLastTrade) {
     FormatAndWrite([&](Record& record) {
-      record % record.GetTime() % time % "T" % price % qty % useAsLastTrade;
+      record.SetTrade(symbolId, time, price, qty, useAsLastTrade);
     });
   }
 
+  void WriteBook(const PriceBook& book) {
+    FormatAndWrite([&](Record& record) { record.SetBook(symbolId, book); });
+  }
+
  private:
   template <typename... OtherParams>
   void InsertFirstLevel1Update(Record& record,
                                const Level1TickValue& tick,
                                const OtherParams&... otherParams) {
-    WriteValue(record, tick);
+    record.AddLevel1Tick(tick);
     InsertFirstLevel1Update(record, otherParams...);
   }
 
   static void InsertFirstLevel1Update(const Record&) {}
-
-  void WriteValue(Record& record, const Level1TickValue& tick) {
-    record % ConvertToPch(tick.GetType()) % tick.GetValue();
-  }
 };
 }  // namespace MarketDataLog
 }  // namespace
@@ -388,22 +400,6 @@ Security::MarketDataValueDoesNotExist::MarketDataValueDoesNotExist(
 
 class Security::Implementation : private boost::noncopyable {
  public:
-  template <typename SlotSignature>
-  struct SignalTrait {
-    typedef sig::signal<
-        SlotSignature,
-        sig::optional_last_value<
-            typename boost::function_traits<SlotSignature>::result_type>,
-        int,
-        std::less<int>,
-        boost::function<SlotSignature>,
-        typename sig::detail::extended_signature<
-            boost::function_traits<SlotSignature>::arity,
-            SlotSignature>::function_type,
-        sig::dummy_mutex>
-        Signal;
-  };
-
   Security& m_self;
 
   static boost::atomic<InstanceId> m_nextInstanceId;
@@ -420,20 +416,22 @@ class Security::Implementation : private boost::noncopyable {
   const size_t m_numberOfItemsPerQty;
   const Qty m_lotSize;
 
-  mutable SignalTrait<Level1UpdateSlotSignature>::Signal m_level1UpdateSignal;
-  mutable SignalTrait<Level1TickSlotSignature>::Signal m_level1TickSignal;
-  mutable SignalTrait<NewTradeSlotSignature>::Signal m_tradeSignal;
-  mutable SignalTrait<BrokerPositionUpdateSlotSignature>::Signal
+  mutable SlotList<Level1UpdateSlotSignature> m_level1UpdateSignal;
+  mutable SlotList<Level1TickSlotSignature> m_level1TickSignal;
+  mutable SlotList<NewTradeSlotSignature> m_tradeSignal;
+  mutable SlotList<BrokerPositionUpdateSlotSignature>
       m_brokerPositionUpdateSignal;
-  mutable SignalTrait<NewBarSlotSignature>::Signal m_barSignal;
-  mutable SignalTrait<BookUpdateTickSlotSignature>::Signal
-      m_bookUpdateTickSignal;
-  mutable SignalTrait<ServiceEventSlotSignature>::Signal m_serviceEventSignal;
-  mutable SignalTrait<ContractSwitchingSlotSignature>::Signal
-      m_contractSwitchedSignal;
+  mutable SlotList<NewBarSlotSignature> m_barSignal;
+  mutable SlotList<BookUpdateTickSlotSignature> m_bookUpdateTickSignal;
+  mutable SlotList<ServiceEventSlotSignature> m_serviceEventSignal;
+  mutable SlotList<ContractSwitchingSlotSignature> m_contractSwitchedSignal;
 
   Level1 m_level1;
   boost::atomic_int64_t m_marketDataTime;
+  //! Seqlock version of the published Level 1 copy, odd while it's written.
+  boost::atomic_uint32_t m_level1Version;
+  Level1 m_publishedLevel1;
+  boost::atomic_int64_t m_publishedMarketDataTime;
   boost::atomic_size_t m_numberOfMarketDataUpdates;
   mutable boost::atomic_bool m_isLevel1Started;
   const SupportedLevel1Types m_supportedLevel1Types;
@@ -464,6 +462,8 @@ class Security::Implementation : private boost::noncopyable {
         m_numberOfItemsPerQty(GetNumberOfItemsPerQtyBySymbol(symbol)),
         m_lotSize(GetLotSizeBySymbol(symbol)),
         m_marketDataTime(0),
+        m_level1Version(0),
+        m_publishedMarketDataTime(0),
         m_numberOfMarketDataUpdates(0),
         m_isLevel1Started(false),
         m_supportedLevel1Types(supportedLevel1Types),
@@ -482,6 +482,9 @@ class Security::Implementation : private boost::noncopyable {
     for (auto& item : m_level1) {
       Unset(item);
     }
+    for (auto& item : m_publishedLevel1) {
+      Unset(item);
+    }
   }
 
   void CheckMarketDataUpdate(const pt::ptime& time) {
@@ -550,11 +553,66 @@ class Security::Implementation : private boost::noncopyable {
       return;
     }
     CheckMarketDataUpdate(time);
+    PublishLevel1();
     if (CheckLevel1Start()) {
       m_level1UpdateSignal(delayMeasurement);
     }
   }
 
+  //! Copies the current Level 1 for GetLevel1Snapshot.
+  /**
+   * Called after the update is completed, so readers see all update values
+   * or none of them. The copy is written only between version changes and
+   * never waits for readers, so a subscriber which reads the snapshot from
+   * the update notification doesn't block.
+   */
+  void PublishLevel1() {
+    auto version = m_level1Version.load(boost::memory_order_relaxed);
+    while ((version & 1) ||
+           !m_level1Version.compare_exchange_weak(
+               version, version + 1, boost::memory_order_relaxed)) {
+      version = m_level1Version.load(boost::memory_order_relaxed);
+    }
+    boost::atomic_thread_fence(boost::memory_order_release);
+    for (size_t i = 0; i < m_level1.size(); ++i) {
+      m_publishedLevel1[i].store(m_level1[i].load(boost::memory_order_relaxed),
+                                 boost::memory_order_relaxed);
+    }
+    m_publishedMarketDataTime.store(
+        m_marketDataTime.load(boost::memory_order_relaxed),
+        boost::memory_order_relaxed);
+    m_level1Version.store(version + 2, boost::memory_order_release);
+  }
+
+  Level1Snapshot GetLevel1Snapshot() const {
+    for (;;) {
+      const auto version = m_level1Version.load(boost::memory_order_acquire);
+      if (version & 1) {
+        continue;
+      }
+      const auto& load = [this](const Level1TickType& tick) {
+        return m_publishedLevel1[tick].load(boost::memory_order_relaxed);
+      };
+      const auto time =
+          m_publishedMarketDataTime.load(boost::memory_order_relaxed);
+      Level1Snapshot result = {pt::not_a_date_time,
+                               load(LEVEL1_TICK_BID_PRICE),
+                               load(LEVEL1_TICK_BID_QTY),
+                               load(LEVEL1_TICK_ASK_PRICE),
+                               load(LEVEL1_TICK_ASK_QTY),
+                               load(LEVEL1_TICK_LAST_PRICE),
+                               load(LEVEL1_TICK_LAST_QTY)};
+      boost::atomic_thread_fence(boost::memory_order_acquire);
+      if (m_level1Version.load(boost::memory_order_relaxed) != version) {
+        continue;
+      }
+      if (time) {
+        result.time = ConvertToPTimeFromMicroseconds(time);
+      }
+      return result;
+    }
+  }
+
   bool CheckLevel1Start() const {
     if (m_isLevel1Started) {
       return true;
@@ -599,18 +657,23 @@ class Security::Implementation : private boost::noncopyable {
     fileName % m_self.GetSymbol()                                 // 1
         % sourceIndex                                             // 2
         % ConvertToFileName(m_self.GetContext().GetStartTime());  // 3
-    path /= SymbolToFileName(fileName.str(), "csv");
+    path /= SymbolToFileName(fileName.str(), "trdkmd");
 
     fs::create_directories(path.branch_path());
-    m_marketDataLogFile.open(path.string(),
-                             std::ios::out | std::ios::ate | std::ios::app);
+    // The header is written only into a new file, an existing file already has
+    // it and receives new records at the end:
+    const bool isNewFile = !fs::exists(path) || fs::file_size(path) == 0;
+    m_marketDataLogFile.open(
+        path.string(),
+        std::ios::out | std::ios::ate | std::ios::app | std::ios::binary);
     if (!m_marketDataLogFile.is_open()) {
       m_self.GetContext().GetLog().Error(
           "Failed to open market data log file %1%", path);
       throw Exception("Failed to open market data log file");
     }
 
-    m_marketDataLog.EnableStream(m_marketDataLogFile);
+    m_marketDataLog.EnableStream(m_marketDataLogFile, isNewFile,
+                                 m_self.GetSymbol(), sourceIndex);
 
     m_self.GetContext().GetLog().Debug("Market data log for \"%1%\": %2%.",
                                        m_self, path);
@@ -801,45 +864,49 @@ Qty Security::GetBidQtyValue() const {
   return m_pimpl->m_level1[LEVEL1_TICK_BID_QTY];
 }
 
+Security::Level1Snapshot Security::GetLevel1Snapshot() const {
+  return m_pimpl->GetLevel1Snapshot();
+}
+
 Security::ContractSwitchingSlotConnection
 Security::SubscribeToContractSwitching(
     const ContractSwitchingSlot& slot) const {
-  return m_pimpl->m_contractSwitchedSignal.connect(slot);
+  return m_pimpl->m_contractSwitchedSignal.Connect(slot);
 }
 
 Security::Level1UpdateSlotConnection Security::SubscribeToLevel1Updates(
     const Level1UpdateSlot& slot) const {
-  return m_pimpl->m_level1UpdateSignal.connect(slot);
+  return m_pimpl->m_level1UpdateSignal.Connect(slot);
 }
 
 Security::Level1UpdateSlotConnection Security::SubscribeToLevel1Ticks(
     const Level1TickSlot& slot) const {
-  return m_pimpl->m_level1TickSignal.connect(slot);
+  return m_pimpl->m_level1TickSignal.Connect(slot);
 }
 
 Security::NewTradeSlotConnection Security::SubscribeToTrades(
     const NewTradeSlot& slot) const {
-  return m_pimpl->m_tradeSignal.connect(slot);
+  return m_pimpl->m_tradeSignal.Connect(slot);
 }
 
 Security::NewTradeSlotConnection Security::SubscribeToBrokerPositionUpdates(
     const BrokerPositionUpdateSlot& slot) const {
-  return m_pimpl->m_brokerPositionUpdateSignal.connect(slot);
+  return m_pimpl->m_brokerPositionUpdateSignal.Connect(slot);
 }
 
 Security::NewBarSlotConnection Security::SubscribeToBars(
     const NewBarSlot& slot) const {
-  return m_pimpl->m_barSignal.connect(slot);
+  return m_pimpl->m_barSignal.Connect(slot);
 }
 
 Security::BookUpdateTickSlotConnection Security::SubscribeToBookUpdateTicks(
     const BookUpdateTickSlot& slot) const {
-  return m_pimpl->m_bookUpdateTickSignal.connect(slot);
+  return m_pimpl->m_bookUpdateTickSignal.Connect(slot);
 }
 
 Security::ServiceEventSlotConnection Security::SubscribeToServiceEvents(
     const ServiceEventSlot& slot) const {
-  return m_pimpl->m_serviceEventSignal.connect(slot);
+  return m_pimpl->m_serviceEventSignal.Connect(slot);
 }
 
 bool Security::IsLevel1Required() const {
@@ -847,22 +914,24 @@ bool Security::IsLevel1Required() const {
 }
 
 bool Security::IsLevel1UpdatesRequired() const {
-  return !m_pimpl->m_level1UpdateSignal.empty();
+  return !m_pimpl->m_level1UpdateSignal.IsEmpty();
 }
 
 bool Security::IsLevel1TicksRequired() const {
-  return !m_pimpl->m_level1TickSignal.empty();
+  return !m_pimpl->m_level1TickSignal.IsEmpty();
 }
 
 bool Security::IsTradesRequired() const {
-  return !m_pimpl->m_tradeSignal.empty();
+  return !m_pimpl->m_tradeSignal.IsEmpty();
 }
 
 bool Security::IsBrokerPositionRequired() const {
-  return !m_pimpl->m_brokerPositionUpdateSignal.empty();
+  return !m_pimpl->m_brokerPositionUpdateSignal.IsEmpty();
 }
 
-bool Security::IsBarsRequired() const { return !m_pimpl->m_barSignal.empty(); }
+bool Security::IsBarsRequired() const {
+  return !m_pimpl->m_barSignal.IsEmpty();
+}
 
 void Security::SetLevel1(const pt::ptime& time,
                          const Level1TickValue& tick,
@@ -1124,6 +1193,7 @@ void Security::SetBook(PriceBook& book, const Milestones& delayMeasurement) {
 
   GetContext().InvokeDropCopy(
       [this, &book](DropCopy& dropCopy) { dropCopy.CopyBook(*this, book); });
+  m_pimpl->m_marketDataLog.WriteBook(book);
 
   // Adjusting:
   while (!book.GetBid().IsEmpty() && !book.GetAsk().IsEmpty() &&
@@ -1147,7 +1217,14 @@ void Security::SetBook(PriceBook& book, const Milestones& delayMeasurement) {
       delayMeasurement);
   m_pimpl->CheckMarketDataUpdate(book.GetTime());
 
-  m_pimpl->m_bookUpdateTickSignal(book, delayMeasurement);
+  if (m_pimpl->m_bookUpdateTickSignal.IsEmpty()) {
+    return;
+  }
+  // One copy for all subscribers, a subscriber gets a reference to the
+  // snapshot, not a copy of the book.
+  const PriceBookSnapshot snapshot =
+      boost::allocate_shared<PriceBook>(PriceBookSnapshotAllocator(), book);
+  m_pimpl->m_bookUpdateTickSignal(snapshot, delayMeasurement);
 }
 
 const ContractExpiration& Security::GetExpiration() const {
@@ -1211,6 +1288,7 @@ bool Security::SetExpiration(const pt::ptime& time,
       Unset(item);
     }
     m_pimpl->m_marketDataTime = 0;
+    m_pimpl->PublishLevel1();
 
     if (request.IsEarlier(m_pimpl->m_request)) {
       m_pimpl->m_request.Merge(request);
@@ -50,21 +50,37 @@ class TRDK_CORE_API Security : public Instrument {
       const Lib::TimeMeasurement::Milestones&);
   //! Update one of more from following values: best bid, best ask, last trade.
   typedef boost::function<Level1UpdateSlotSignature> Level1UpdateSlot;
-  typedef boost::signals2::connection Level1UpdateSlotConnection;
+  typedef Lib::SlotConnection Level1UpdateSlotConnection;
 
   typedef void(Level1TickSlotSignature)(const boost::posix_time::ptime&,
                                         const Level1TickValue&,
                                         const Lib::TimeMeasurement::Milestones&,
                                         bool flush);
   typedef boost::function<Level1TickSlotSignature> Level1TickSlot;
-  typedef boost::signals2::connection Level1TickSlotConnection;
+  typedef Lib::SlotConnection Level1TickSlotConnection;
+
+  //! Level 1 values set by one update.
+  /**
+   * Values which are not set are NaN, the time is not_a_date_time if there was
+   * no market data yet.
+   * @sa GetLevel1Snapshot
+   */
+  struct Level1Snapshot {
+    boost::posix_time::ptime time;
+    Price bidPrice;
+    Qty bidQty;
+    Price askPrice;
+    Qty askQty;
+    Price lastPrice;
+    Qty lastQty;
+  };
 
   typedef void(NewTradeSlotSignature)(const boost::posix_time::ptime&,
                                       const Price&,
                                       const Qty&,
                                       const Lib::TimeMeasurement::Milestones&);
   typedef boost::function<NewTradeSlotSignature> NewTradeSlot;
-  typedef boost::signals2::connection NewTradeSlotConnection;
+  typedef Lib::SlotConnection NewTradeSlotConnection;
 
   //! Security broker position info.
   /** Information from broker, not relevant to trdk::Position.
@@ -75,18 +91,18 @@ class TRDK_CORE_API Security : public Instrument {
                                                   bool isInitial);
   typedef boost::function<BrokerPositionUpdateSlotSignature>
       BrokerPositionUpdateSlot;
-  typedef boost::signals2::connection BrokerPositionUpdateSlotConnection;
+  typedef Lib::SlotConnection BrokerPositionUpdateSlotConnection;
 
   typedef void(NewBarSlotSignature)(const Bar&);
   typedef boost::function<NewBarSlotSignature> NewBarSlot;
-  typedef boost::signals2::connection NewBarSlotConnection;
+  typedef Lib::SlotConnection NewBarSlotConnection;
 
   ////////////////////////////////////////////////////////////////////////////////
 
   typedef void(BookUpdateTickSlotSignature)(
-      const PriceBook&, const Lib::TimeMeasurement::Milestones&);
+      const PriceBookSnapshot&, const Lib::TimeMeasurement::Milestones&);
   typedef boost::function<BookUpdateTickSlotSignature> BookUpdateTickSlot;
-  typedef boost::signals2::connection BookUpdateTickSlotConnection;
+  typedef Lib::SlotConnection BookUpdateTickSlotConnection;
 
   ////////////////////////////////////////////////////////////////////////////////
 
@@ -134,7 +150,7 @@ class TRDK_CORE_API Security : public Instrument {
   typedef void(ServiceEventSlotSignature)(const boost::posix_time::ptime&,
                                           const ServiceEvent&);
   typedef boost::function<ServiceEventSlotSignature> ServiceEventSlot;
-  typedef boost::signals2::connection ServiceEventSlotConnection;
+  typedef Lib::SlotConnection ServiceEventSlotConnection;
 
   ////////////////////////////////////////////////////////////////////////////////
 
@@ -142,7 +158,7 @@ class TRDK_CORE_API Security : public Instrument {
                                                const Request&,
                                                bool& isSwitched);
   typedef boost::function<ContractSwitchingSlotSignature> ContractSwitchingSlot;
-  typedef boost::signals2::connection ContractSwitchingSlotConnection;
+  typedef Lib::SlotConnection ContractSwitchingSlotConnection;
 
   ////////////////////////////////////////////////////////////////////////////////
 
@@ -203,6 +219,14 @@ class TRDK_CORE_API Security : public Instrument {
 
   Qty GetTradedVolume() const;
 
+  //! Returns Level 1 values without mixing different updates.
+  /**
+   * Separate getters could return bid price from one update and ask price from
+   * the next one. The snapshot is taken without locks, the writer doesn't wait
+   * for readers.
+   */
+  Level1Snapshot GetLevel1Snapshot() const;
+
   //! Returns next expiration time.
   /**
    * Throws exception if expiration is not provided.
@@ -0,0 +1,114 @@
+/**************************************************************************
+ *   Created: 2026/10/17 03:58:41
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Core/PriceBook.hpp"
+#include "Core/Security.hpp"
+#include "Benchmarks/BenchmarkContext.hpp"
+
+using namespace trdk;
+using namespace trdk::Lib;
+using namespace trdk::Lib::TimeMeasurement;
+
+namespace pt = boost::posix_time;
+namespace gr = boost::gregorian;
+
+namespace {
+
+//! Each update changes values, so each update is delivered to subscribers.
+void Core_Security_SetLevel1(benchmark::State &state) {
+  const auto security = Benchmarks::CreateSecurity();
+  size_t numberOfCalls = 0;
+  for (auto i = state.range(0); i > 0; --i) {
+    security->SubscribeToLevel1Updates(
+        [&numberOfCalls](const Milestones &) { ++numberOfCalls; });
+  }
+
+  const Milestones milestones;
+  pt::ptime time(gr::date(2018, 1, 1));
+  size_t i = 0;
+  for (auto _ : state) {
+    const auto shift = static_cast<double>(++i & 1);
+    time += pt::microseconds(1);
+    security->SetLevel1(
+        time, Level1TickValue::Create<LEVEL1_TICK_BID_PRICE>(100 + shift),
+        Level1TickValue::Create<LEVEL1_TICK_ASK_PRICE>(101 + shift),
+        milestones);
+  }
+  benchmark::DoNotOptimize(numberOfCalls);
+  state.SetItemsProcessed(state.iterations());
+}
+
+void Core_Security_SetBook(benchmark::State &state) {
+  const auto security = Benchmarks::CreateSecurity();
+  size_t numberOfCalls = 0;
+  for (auto i = state.range(0); i > 0; --i) {
+    security->SubscribeToBookUpdateTicks(
+        [&numberOfCalls](const PriceBookSnapshot &, const Milestones &) {
+          ++numberOfCalls;
+        });
+  }
+
+  pt::ptime time(gr::date(2018, 1, 1));
+  PriceBook book(time);
+  for (size_t i = 0; i < PriceBook::GetSideMaxSize(); ++i) {
+    book.GetBid().Add(time, 100 - .01 * static_cast<double>(i), 1);
+    book.GetAsk().Add(time, 101 + .01 * static_cast<double>(i), 1);
+  }
+
+  const Milestones milestones;
+  for (auto _ : state) {
+    time += pt::microseconds(1);
+    book.SetTime(time);
+    // The book is not crossed, so it's not changed by the call and could be
+    // used again.
+    security->SetBook(book, milestones);
+  }
+  benchmark::DoNotOptimize(numberOfCalls);
+  state.SetItemsProcessed(state.iterations());
+}
+
+//! Strategy reads quotes while the market data thread updates them.
+void Core_Security_GetLevel1Snapshot(benchmark::State &state) {
+  static std::unique_ptr<Benchmarks::Security> security;
+  static boost::atomic_bool isStopped;
+  static boost::thread writer;
+  if (state.thread_index == 0) {
+    security = Benchmarks::CreateSecurity();
+    isStopped = false;
+    writer = boost::thread([]() {
+      const Milestones milestones;
+      pt::ptime time(gr::date(2018, 1, 1));
+      for (size_t i = 0; !isStopped; ++i) {
+        const auto shift = static_cast<double>(i & 1);
+        time += pt::microseconds(1);
+        security->SetLevel1(
+            time, Level1TickValue::Create<LEVEL1_TICK_BID_PRICE>(100 + shift),
+            Level1TickValue::Create<LEVEL1_TICK_ASK_PRICE>(101 + shift),
+            milestones);
+      }
+    });
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(security->GetLevel1Snapshot());
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index == 0) {
+    isStopped = true;
+    writer.join();
+    security.reset();
+  }
+}
+
+}  // namespace
+
+BENCHMARK(Core_Security_SetLevel1)->Arg(0)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(Core_Security_SetBook)->Arg(0)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(Core_Security_GetLevel1Snapshot)->ThreadRange(1, 4);
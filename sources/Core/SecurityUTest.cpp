@@ -11,6 +11,8 @@
 #pragma once
 
 #include "Prec.hpp"
+#include "Core/ContextDummy.hpp"
+#include "Core/MarketDataSourceDummy.hpp"
 #include "Core/Security.hpp"
 
 using namespace testing;
@@ -18,6 +20,26 @@ using namespace testing;
 namespace pt = boost::posix_time;
 namespace gr = boost::gregorian;
 
+namespace {
+//! Dummy context without drop copy, so market data could be set.
+class Context : public trdk::Tests::Dummies::Context {
+ protected:
+  trdk::DropCopy *GetDropCopy() const override { return nullptr; }
+};
+
+class Security : public trdk::Security {
+ public:
+  explicit Security(Context &context)
+      : trdk::Security(context,
+                       trdk::Lib::Symbol("BTC_USD::CRYPTO"),
+                       trdk::Tests::Dummies::MarketDataSource::GetInstance(),
+                       SupportedLevel1Types()) {}
+  ~Security() override = default;
+
+  using trdk::Security::SetLevel1;
+};
+}  // namespace
+
 TEST(Core_SecurityTest, Request) {
   using Request = trdk::Security::Request;
 
@@ -159,3 +181,72 @@ TEST(Core_SecurityTest, Request) {
     EXPECT_TRUE(request4.IsEarlier(request3));
   }
 }
+
+TEST(Core_SecurityTest, Level1Snapshot) {
+  using trdk::Level1TickValue;
+
+  Context context;
+  Security security(context);
+  {
+    const auto &snapshot = security.GetLevel1Snapshot();
+    EXPECT_EQ(pt::not_a_date_time, snapshot.time);
+    EXPECT_TRUE(snapshot.bidPrice.IsNan());
+    EXPECT_TRUE(snapshot.askPrice.IsNan());
+  }
+
+  // Each update sets ask price as bid price + 1 and both quantities as bid
+  // price, so a snapshot with values from different updates breaks it:
+  const size_t numberOfUpdates = 100000;
+  const size_t numberOfReaders = 4;
+  boost::atomic_bool isStopped(false);
+  boost::atomic_size_t numberOfSnapshots(0);
+  boost::atomic_size_t numberOfTornSnapshots(0);
+  boost::barrier startBarrier(numberOfReaders + 1);
+
+  boost::thread_group readers;
+  for (size_t i = 0; i < numberOfReaders; ++i) {
+    readers.create_thread([&]() {
+      startBarrier.wait();
+      while (!isStopped) {
+        const auto &snapshot = security.GetLevel1Snapshot();
+        if (snapshot.bidPrice.IsNan()) {
+          continue;
+        }
+        ++numberOfSnapshots;
+        if (snapshot.askPrice != snapshot.bidPrice + 1 ||
+            snapshot.bidQty != snapshot.bidPrice ||
+            snapshot.askQty != snapshot.bidPrice ||
+            snapshot.time == pt::not_a_date_time) {
+          ++numberOfTornSnapshots;
+        }
+      }
+    });
+  }
+
+  {
+    const trdk::Lib::TimeMeasurement::Milestones milestones;
+    pt::ptime time(gr::date(2018, 1, 1));
+    startBarrier.wait();
+    for (size_t i = 0; i < numberOfUpdates; ++i) {
+      const auto bid = static_cast<double>(1000 + i % 1000);
+      time += pt::microseconds(1);
+      security.SetLevel1(
+          time, Level1TickValue::Create<trdk::LEVEL1_TICK_BID_PRICE>(bid),
+          Level1TickValue::Create<trdk::LEVEL1_TICK_BID_QTY>(bid),
+          Level1TickValue::Create<trdk::LEVEL1_TICK_ASK_PRICE>(bid + 1),
+          Level1TickValue::Create<trdk::LEVEL1_TICK_ASK_QTY>(bid), milestones);
+    }
+    isStopped = true;
+  }
+  readers.join_all();
+
+  EXPECT_LT(0, numberOfSnapshots);
+  EXPECT_EQ(0, numberOfTornSnapshots);
+
+  const auto &snapshot = security.GetLevel1Snapshot();
+  EXPECT_EQ(pt::ptime(gr::date(2018, 1, 1)) +
+                pt::microseconds(static_cast<int64_t>(numberOfUpdates)),
+            snapshot.time);
+  EXPECT_EQ(1999, snapshot.bidPrice);
+  EXPECT_EQ(2000, snapshot.askPrice);
+}
@@ -43,6 +43,9 @@ class Settings::Implementation {
   Currency m_defaultCurrency;
   bool m_isReplayMode;
   bool m_isMarketDataLogEnabled;
+  bool m_isMarketDataLogCompressionEnabled;
+  bool m_isInlineDispatchingEnabled;
+  Clock::Source m_clockSource;
   pt::ptime m_startTime;
   fs::path m_logsDir;
   lt::time_zone_ptr m_timeZone;
@@ -55,6 +58,9 @@ class Settings::Implementation {
         m_defaultCurrency(numberOfCurrencies),
         m_isReplayMode(false),
         m_isMarketDataLogEnabled(false),
+        m_isMarketDataLogCompressionEnabled(false),
+        m_isInlineDispatchingEnabled(false),
+        m_clockSource(Clock::SOURCE_SYSTEM),
         m_timeZone(boost::make_shared<lt::posix_time_zone>("GMT")) {}
 
   Implementation(const fs::path &confFile,
@@ -64,6 +70,9 @@ class Settings::Implementation {
         m_defaultCurrency(numberOfCurrencies),
         m_isReplayMode(false),
         m_isMarketDataLogEnabled(false),
+        m_isMarketDataLogCompressionEnabled(false),
+        m_isInlineDispatchingEnabled(false),
+        m_clockSource(Clock::SOURCE_SYSTEM),
         m_logsDir(std::move(logsDir)) {
     LoadConfig(confFile);
 
@@ -86,15 +95,22 @@ class Settings::Implementation {
   void Log(Context::Log &log) const {
     if (m_isReplayMode) {
       log.Info("======================= REPLAY MODE =======================");
+      if (m_isInlineDispatchingEnabled) {
+        log.Info("Events are dispatched inline, by the replay thread.");
+      }
     }
     log.Debug(
         "Timezone: %1%. Default currency: %2%. Default security type: %3%."
-        " Market data log: %4%. Contract switching before: %5%.",
-        m_timeZone->to_posix_string(),                      // 1
-        m_defaultCurrency,                                  // 2
-        m_defaultSecurityType,                              // 3
-        m_isMarketDataLogEnabled ? "enabled" : "disabled",  // 4
-        m_periodBeforeExpiryDayToSwitchContract);           // 5
+        " Market data log: %4%. Contract switching before: %5%. Clock: %6%.",
+        m_timeZone->to_posix_string(),  // 1
+        m_defaultCurrency,              // 2
+        m_defaultSecurityType,          // 3
+        !m_isMarketDataLogEnabled
+            ? "disabled"
+            : m_isMarketDataLogCompressionEnabled ? "compressed"
+                                                  : "enabled",  // 4
+        m_periodBeforeExpiryDayToSwitchContract,                // 5
+        ConvertToPch(m_clockSource));                           // 6
   }
 
  private:
@@ -114,6 +130,19 @@ class Settings::Implementation {
       m_isReplayMode = commonConf.get<bool>("isReplayMode");
       m_isMarketDataLogEnabled =
           commonConf.get<bool>("marketDataLog.isEnabled");
+      m_isMarketDataLogCompressionEnabled = commonConf.get<bool>(
+          "marketDataLog.isCompressionEnabled", false);
+      m_isInlineDispatchingEnabled =
+          commonConf.get<bool>("isInlineDispatchingEnabled", false);
+      if (m_isInlineDispatchingEnabled && !m_isReplayMode) {
+        throw Exception("Inline dispatching is allowed only in replay mode");
+      }
+      {
+        const auto &clock = commonConf.get_optional<std::string>("clock");
+        if (clock) {
+          m_clockSource = ConvertClockSourceFromString(*clock);
+        }
+      }
 
       {
         std::string timeZone;
@@ -229,6 +258,18 @@ bool Settings::IsMarketDataLogEnabled() const {
   return m_pimpl->m_isMarketDataLogEnabled;
 }
 
+bool Settings::IsMarketDataLogCompressionEnabled() const {
+  return m_pimpl->m_isMarketDataLogCompressionEnabled;
+}
+
+bool Settings::IsInlineDispatchingEnabled() const {
+  return m_pimpl->m_isInlineDispatchingEnabled;
+}
+
+const Clock::Source &Settings::GetClockSource() const {
+  return m_pimpl->m_clockSource;
+}
+
 const fs::path &Settings::GetLogsDir() const { return m_pimpl->m_logsDir; }
 
 const Currency &Settings::GetDefaultCurrency() const {
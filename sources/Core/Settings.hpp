@@ -36,6 +36,33 @@ class TRDK_CORE_API Settings {
   bool IsReplayMode() const noexcept;
 
   bool IsMarketDataLogEnabled() const;
+  //! Market data log writes records by compressed blocks.
+  /**
+   * Path: General::marketDataLog::isCompressionEnabled
+   * Optional, disabled by default.
+   */
+  bool IsMarketDataLogCompressionEnabled() const;
+
+  //! Replay mode delivers events in the thread that produces them.
+  /**
+   * Market data sources, timers and strategies work in one thread, events are
+   * raised in the order they occur, without notification threads, so replay
+   * results are reproducible.
+   * Path: General::isInlineDispatchingEnabled
+   * Optional, disabled by default, allowed only in the replay mode with one
+   * market data source.
+   */
+  bool IsInlineDispatchingEnabled() const;
+
+  //! Source of the current time for the real-time mode.
+  /**
+   * Path: General::clock
+   * Values: "system", "monotonic", "tsc".
+   * Optional, "system" by default. "tsc" and "monotonic" don't read the
+   * system time after the start, so they are much cheaper, but don't follow
+   * system time corrections.
+   */
+  const Lib::Clock::Source& GetClockSource() const;
 
   const boost::filesystem::path& GetLogsDir() const;
 
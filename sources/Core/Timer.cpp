@@ -13,6 +13,7 @@
 #include "Context.hpp"
 #include "Settings.hpp"
 #include "TradingLog.hpp"
+#include "Common/TimingWheel.hpp"
 
 using namespace trdk;
 using namespace Lib;
@@ -28,33 +29,13 @@ struct Task {
 };
 struct TimedTask : public Task {
   pt::ptime time;
+  TimedTask() = default;
   explicit TimedTask(const Timer::Scope::Id &scope,
-                     const boost::function<void()> &callback,
+                     boost::function<void()> callback,
                      const pt::ptime &time)
-      : Task({scope, callback}), time(time) {}
+      : Task({scope, std::move(callback)}), time(time) {}
 };
 
-size_t Erase(std::list<TimedTask> &list,
-             const Timer::Scope::Id &scope,
-             const Context &context) {
-  size_t result = 0;
-  for (auto it = list.begin(); it != list.cend();) {
-    if (it->scope != scope) {
-      ++it;
-      continue;
-    }
-    ++result;
-    context.GetTradingLog().Write(
-        "Timer", "{'timer': {'cancel': {'time': '%1%', 'scope': %2%}}}",
-        [&it](TradingRecord &record) {
-          record % it->time  // 1
-              % it->scope;   // 2
-        });
-    list.erase(std::prev(++it));
-  }
-  return result;
-}
-
 size_t Erase(std::vector<Task> &list, const Timer::Scope::Id &scope) {
   size_t result = 0;
   for (size_t i = 0; i < list.size();) {
@@ -71,6 +52,9 @@ size_t Erase(std::vector<Task> &list, const Timer::Scope::Id &scope) {
 
 class Timer::Implementation : private boost::noncopyable {
  public:
+  //! Timed tasks by microseconds since the start time.
+  typedef TimingWheel<TimedTask, Scope::Id> TimedTasks;
+
   const Context &m_context;
 
   Mutex m_mutex;
@@ -79,18 +63,24 @@ class Timer::Implementation : private boost::noncopyable {
 
   std::vector<Task> m_immediateTasks;
   std::vector<Task> m_newImmediateTasks;
-  std::list<TimedTask> m_newTimedTasks;
-  std::vector<Scope::Id> m_removedTimedTasks;
-  std::list<TimedTask> m_timedTasks;
-  pt::ptime m_nearestEvent;
+  TimedTasks m_timedTasks;
+  //! Time of the wheel tick 0, it's set at the first timed task.
+  pt::ptime m_startTime;
 
   const pt::time_duration m_utcDiff;
 
+  //! Tasks are executed by the replay thread at the current time change,
+  //! instead of the timer thread.
+  const bool m_isInline;
+  Context::CurrentTimeChangeSlotConnection m_currentTimeChangeConnection;
+
   bool m_isStopped;
 
   explicit Implementation(const Context &context)
       : m_context(context),
         m_utcDiff(m_context.GetSettings().GetTimeZone()->base_utc_offset()),
+        m_isInline(m_context.GetSettings().IsReplayMode() &&
+                   m_context.GetSettings().IsInlineDispatchingEnabled()),
         m_isStopped(false) {}
 
   ~Implementation() {
@@ -103,6 +93,7 @@ class Timer::Implementation : private boost::noncopyable {
   }
 
   void Stop() {
+    m_currentTimeChangeConnection.disconnect();
     boost::optional<boost::thread> thread;
     {
       const Lock lock(m_mutex);
@@ -114,6 +105,19 @@ class Timer::Implementation : private boost::noncopyable {
     }
   }
 
+  //! Converts time to the wheel tick, the time of tick 0 is "expired".
+  TimedTasks::Tick ConvertToTick(const pt::ptime &time) const {
+    Assert(m_startTime != pt::not_a_date_time);
+    if (time <= m_startTime) {
+      return 0;
+    }
+    return (time - m_startTime).total_microseconds();
+  }
+  pt::ptime ConvertToTime(const TimedTasks::Tick &tick) const {
+    Assert(m_startTime != pt::not_a_date_time);
+    return m_startTime + pt::microseconds(tick);
+  }
+
   void Schedule(const pt::time_duration &time,
                 boost::function<void()> callback,
                 Scope &scope) {
@@ -123,13 +127,19 @@ class Timer::Implementation : private boost::noncopyable {
         return;
       }
       if (time != pt::not_a_date_time) {
-        m_newTimedTasks.emplace_back(scope.m_id, std::move(callback),
-                                     m_context.GetCurrentTime() + time);
+        const auto &now = m_context.GetCurrentTime();
+        if (m_startTime == pt::not_a_date_time) {
+          // Tick 0 is already passed, so the start is a bit before.
+          m_startTime = now - pt::microseconds(1);
+        }
+        const auto &taskTime = now + time;
+        m_timedTasks.Add(ConvertToTick(taskTime), scope.m_id,
+                         TimedTask(scope.m_id, std::move(callback), taskTime));
         m_context.GetTradingLog().Write(
             "Timer", "{'timer': {'scheduled': {'time': '%1%', 'scope': %2%}}}",
-            [this](TradingRecord &record) {
-              record % m_newTimedTasks.back().time  // 1
-                  % m_newTimedTasks.back().scope;   // 2
+            [&taskTime, &scope](TradingRecord &record) {
+              record % taskTime  // 1
+                  % scope.m_id;  // 2
             });
       } else {
         m_newImmediateTasks.emplace_back(Task{scope.m_id, std::move(callback)});
@@ -139,6 +149,14 @@ class Timer::Implementation : private boost::noncopyable {
               record % m_newImmediateTasks.back().scope;
             });
       }
+      if (m_isInline) {
+        if (!m_currentTimeChangeConnection.connected()) {
+          m_currentTimeChangeConnection =
+              m_context.SubscribeToCurrentTimeChange(boost::bind(
+                  &Implementation::OnCurrentTimeChanged, this, _1));
+        }
+        return;
+      }
       if (!m_thread) {
         m_thread = boost::thread(
             boost::bind(&Implementation::ExecuteScheduling, this));
@@ -148,23 +166,104 @@ class Timer::Implementation : private boost::noncopyable {
     m_condition.notify_all();
   }
 
-  void SetNewTasks() {
-    for (const auto &removedId : m_removedTimedTasks) {
-      Erase(m_timedTasks, removedId, m_context);
-    }
-    m_removedTimedTasks.clear();
+  size_t Cancel(const Scope::Id &scope) {
+    const Lock lock(m_mutex);
+    return m_timedTasks.Cancel(
+               scope,
+               [this](const TimedTask &task, const TimedTasks::Tick &) {
+                 m_context.GetTradingLog().Write(
+                     "Timer",
+                     "{'timer': {'cancel': {'time': '%1%', 'scope': %2%}}}",
+                     [&task](TradingRecord &record) {
+                       record % task.time  // 1
+                           % task.scope;   // 2
+                     });
+               }) +
+           Erase(m_newImmediateTasks, scope);
+  }
 
-    for (auto &&task : m_newTimedTasks) {
-      m_timedTasks.emplace_back(std::move(task));
-      if (m_nearestEvent == pt::not_a_date_time ||
-          m_timedTasks.back().time < m_nearestEvent) {
-        m_nearestEvent = m_timedTasks.back().time;
+  //! Moves timed tasks which time has come to the expired tasks.
+  /**
+   * @param[in] isBefore  If set, expires only tasks which time is less than
+   *                      the given time.
+   */
+  void Advance(const pt::ptime &now, bool isBefore) {
+    if (m_startTime == pt::not_a_date_time) {
+      return;
+    }
+    auto tick = ConvertToTick(now);
+    if (isBefore) {
+      if (tick == 0) {
+        return;
       }
+      --tick;
     }
-    m_newTimedTasks.clear();
+    m_timedTasks.Advance(tick);
+  }
 
+  bool HasTasks() const {
+    return !m_newImmediateTasks.empty() || m_timedTasks.HasExpired();
+  }
+
+  //! Executes immediate tasks and expired timed tasks.
+  /**
+   * The lock is released while a task is executed, so tasks could be
+   * scheduled and cancelled from callbacks.
+   */
+  void ExecuteTasks(Lock &lock) {
     m_immediateTasks.clear();
     m_immediateTasks.swap(m_newImmediateTasks);
+    if (!m_immediateTasks.empty()) {
+      lock.unlock();
+      for (const auto &task : m_immediateTasks) {
+        m_context.GetTradingLog().Write(
+            "Timer", "{'async': {'exec': {'scope': %1%}}}",
+            [&task](TradingRecord &record) { record % task.scope; });
+        Execute(task);
+      }
+      lock.lock();
+    }
+
+    for (TimedTask task; m_timedTasks.PopExpired(task);) {
+      lock.unlock();
+      m_context.GetTradingLog().Write(
+          "Timer", "{'timer': {'exec': {'time': '%1%', 'scope': %2%}}}",
+          [&task](TradingRecord &record) {
+            record % task.time  // 1
+                % task.scope;   // 2
+          });
+      Execute(task);
+      task = TimedTask();
+      lock.lock();
+    }
+  }
+
+  void Execute(const Task &task) {
+    try {
+      task.callback();
+    } catch (const std::exception &ex) {
+      m_context.GetLog().Error("Scheduled task error: \"%1%\".", ex.what());
+    } catch (...) {
+      AssertFailNoException();
+    }
+  }
+
+  //! Executes tasks in the inline dispatching mode.
+  /**
+   * Market data for the new time will be set after this event, so only tasks
+   * which time is less than the new time are executed, as Test Trading System
+   * executes orders.
+   */
+  void OnCurrentTimeChanged(const pt::ptime &newTime) {
+    Lock tasksLock(m_mutex);
+    if (m_isStopped) {
+      return;
+    }
+    Advance(newTime, true);
+    while (HasTasks()) {
+      ExecuteTasks(tasksLock);
+      Advance(newTime, true);
+    }
   }
 
   void ExecuteScheduling() {
@@ -174,86 +273,30 @@ class Timer::Implementation : private boost::noncopyable {
     try {
       Lock tasksLock(m_mutex);
       while (m_thread) {
-        SetNewTasks();
-
         do {
-          tasksLock.unlock();
-
-          for (const auto &task : m_immediateTasks) {
-            m_context.GetTradingLog().Write(
-                "Timer", "{'async': {'exec': {'scope': %1%}}}",
-                [&task](TradingRecord &record) { record % task.scope; });
-            try {
-              task.callback();
-            } catch (const std::exception &ex) {
-              m_context.GetLog().Error("Scheduled task error: \"%1%\".",
-                                       ex.what());
-            } catch (...) {
-              AssertFailNoException();
-            }
-          }
-
-          if (m_nearestEvent != pt::not_a_date_time &&
-              m_nearestEvent <= m_context.GetCurrentTime()) {
-            m_nearestEvent = pt::not_a_date_time;
-
-            for (auto it = m_timedTasks.begin(); it != m_timedTasks.cend();) {
-              Assert(it->time != pt::not_a_date_time);
-
-              if (m_context.GetCurrentTime() < it->time) {
-                if (m_nearestEvent == pt::not_a_date_time ||
-                    it->time < m_nearestEvent) {
-                  m_nearestEvent = it->time;
-                }
-                ++it;
-                continue;
-              }
-
-              m_context.GetTradingLog().Write(
-                  "Timer", "{'timer': {'exec': {'time': '%1%', 'scope': %2%}}}",
-                  [&it](TradingRecord &record) {
-                    record % it->time  // 1
-                        % it->scope;   // 2
-                  });
-
-              try {
-                it->callback();
-              } catch (const std::exception &ex) {
-                m_context.GetLog().Error("Scheduled task error: \"%1%\".",
-                                         ex.what());
-              } catch (...) {
-                AssertFailNoException();
-              }
-              m_timedTasks.erase(std::prev(++it));
-            }
-            AssertEq(m_nearestEvent == pt::not_a_date_time,
-                     m_timedTasks.empty());
-          }
-
-          tasksLock.lock();
-          SetNewTasks();
-        } while (!m_immediateTasks.empty());
-
-        m_nearestEvent != pt::not_a_date_time
-            ? m_condition.timed_wait(tasksLock, m_nearestEvent - m_utcDiff)
-            : m_condition.wait(tasksLock);
+          Advance(m_context.GetCurrentTime(), false);
+          ExecuteTasks(tasksLock);
+        } while (HasTasks());
+
+        const auto &nextTick = m_timedTasks.GetNextTick();
+        nextTick ? m_condition.timed_wait(
+                       tasksLock, ConvertToTime(*nextTick) - m_utcDiff)
+                 : m_condition.wait(tasksLock);
       }
 
-      if (!m_timedTasks.empty() || !m_newTimedTasks.empty() ||
-          !m_immediateTasks.empty() || !m_newImmediateTasks.empty()) {
+      if (!m_timedTasks.IsEmpty() || !m_newImmediateTasks.empty()) {
+        const auto &nextTick = m_timedTasks.GetNextTick();
         m_context.GetLog().Debug(
             "Timer has %1% uncompleted tasks, nearest at %2%.",
-            m_timedTasks.size() + m_newTimedTasks.empty() +
-                m_immediateTasks.size() + m_newImmediateTasks.empty(),
-            m_immediateTasks.empty()
-                ? boost::lexical_cast<std::string>(m_nearestEvent).c_str()
-                : "\"immediately\"");
+            m_timedTasks.GetSize() + m_newImmediateTasks.size(),
+            !m_newImmediateTasks.empty() || !nextTick
+                ? "\"immediately\""
+                : boost::lexical_cast<std::string>(ConvertToTime(*nextTick))
+                      .c_str());
         Assert(m_isStopped);
         m_immediateTasks.clear();
         m_newImmediateTasks.clear();
-        m_newTimedTasks.clear();
-        m_removedTimedTasks.clear();
-        m_timedTasks.clear();
+        m_timedTasks.Clear();
       }
     } catch (...) {
       AssertFailNoException();
@@ -278,11 +321,7 @@ size_t TimerScope::Cancel() noexcept {
   try {
     //! @todo Add ability to set scope mode "blocked cancel" (for tasks in
     //! execution too).
-    const Lock tasksLock(m_timer->m_pimpl->m_mutex);
-    m_timer->m_pimpl->m_removedTimedTasks.emplace_back(m_id);
-    return Erase(m_timer->m_pimpl->m_newTimedTasks, m_id,
-                 m_timer->m_pimpl->m_context) +
-           Erase(m_timer->m_pimpl->m_newImmediateTasks, m_id);
+    return m_timer->m_pimpl->Cancel(m_id);
   } catch (...) {
     AssertFailNoException();
     terminate();
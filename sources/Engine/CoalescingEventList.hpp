@@ -0,0 +1,151 @@
+/**************************************************************************
+ *   Created: 2026/10/16 12:24:05
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#pragma once
+
+#include <boost/functional/hash.hpp>
+#include <vector>
+
+namespace trdk {
+namespace Engine {
+
+//! Event list which merges events with the same key in constant time.
+/**
+ * Keeps the order in which the keys were added first time. The index is an
+ * open addressing hash table with generation marks: clearing the list only
+ * increments the generation, so the table is never scanned or freed at
+ * flush and grows only when the list grows.
+ */
+template <typename EventT,
+          typename KeyT,
+          typename KeyHashT = boost::hash<KeyT>>
+class CoalescingEventList {
+ public:
+  typedef EventT value_type;
+  typedef KeyT Key;
+  typedef KeyHashT KeyHash;
+
+ private:
+  typedef std::vector<value_type> Events;
+
+  struct Slot {
+    Key key;
+    size_t generation;
+    size_t event;
+  };
+
+ public:
+  typedef typename Events::iterator iterator;
+  typedef typename Events::const_iterator const_iterator;
+
+ public:
+  CoalescingEventList() : m_generation(1), m_index(16, Slot{Key(), 0, 0}) {}
+  CoalescingEventList(CoalescingEventList &&) = default;
+  CoalescingEventList(const CoalescingEventList &) = delete;
+  CoalescingEventList &operator=(CoalescingEventList &&) = delete;
+  CoalescingEventList &operator=(const CoalescingEventList &) = delete;
+  ~CoalescingEventList() = default;
+
+ public:
+  bool empty() const { return m_events.empty(); }
+  size_t size() const { return m_events.size(); }
+
+  iterator begin() { return m_events.begin(); }
+  iterator end() { return m_events.end(); }
+  const_iterator begin() const { return m_events.begin(); }
+  const_iterator end() const { return m_events.end(); }
+
+  value_type &back() { return m_events.back(); }
+  const value_type &back() const { return m_events.back(); }
+
+  void clear() {
+    m_events.clear();
+    if (!++m_generation) {
+      // Overflow, marks from the first generation are not unique anymore.
+      for (auto &slot : m_index) {
+        slot.generation = 0;
+      }
+      m_generation = 1;
+    }
+  }
+
+  //! Adds event if the list doesn't have an event with the same key.
+  /**
+   * @return true if the event is added, false if the event is dropped as the
+   *         list already has the event with the same key.
+   */
+  bool Insert(const Key &key, value_type &&event) {
+    auto &slot = FindSlotToInsert(key);
+    if (slot.generation == m_generation) {
+      return false;
+    }
+    Add(slot, key, std::move(event));
+    return true;
+  }
+
+  //! Adds event or replaces the event with the same key by the new one.
+  /**
+   * The new event takes the position of the replaced event.
+   * @return true if the event is added, false if the event replaced the
+   *         previous event with the same key.
+   */
+  bool Replace(const Key &key, value_type &&event) {
+    auto &slot = FindSlotToInsert(key);
+    if (slot.generation == m_generation) {
+      m_events[slot.event] = std::move(event);
+      return false;
+    }
+    Add(slot, key, std::move(event));
+    return true;
+  }
+
+ private:
+  Slot &FindSlotToInsert(const Key &key) {
+    if ((m_events.size() + 1) * 2 > m_index.size()) {
+      GrowIndex();
+    }
+    return FindSlot(key);
+  }
+
+  void Add(Slot &slot, const Key &key, value_type &&event) {
+    m_events.emplace_back(std::move(event));
+    slot.key = key;
+    slot.generation = m_generation;
+    slot.event = m_events.size() - 1;
+  }
+
+  Slot &FindSlot(const Key &key) {
+    // Index size is always a power of 2.
+    const size_t mask = m_index.size() - 1;
+    for (size_t i = KeyHash()(key) & mask;; i = (i + 1) & mask) {
+      auto &slot = m_index[i];
+      if (slot.generation != m_generation || slot.key == key) {
+        return slot;
+      }
+    }
+  }
+
+  void GrowIndex() {
+    std::vector<Slot> index(m_index.size() * 2, Slot{Key(), 0, 0});
+    index.swap(m_index);
+    for (const auto &slot : index) {
+      if (slot.generation == m_generation) {
+        FindSlot(slot.key) = slot;
+      }
+    }
+  }
+
+ private:
+  Events m_events;
+  size_t m_generation;
+  std::vector<Slot> m_index;
+};
+}  // namespace Engine
+}  // namespace trdk
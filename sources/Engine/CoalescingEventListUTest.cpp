@@ -0,0 +1,117 @@
+/**************************************************************************
+ *   Created: 2026/10/18 14:21:36
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Engine/CoalescingEventList.hpp"
+
+using namespace trdk::Engine;
+
+namespace {
+
+typedef std::pair<size_t, std::string> Event;
+
+//! Puts many keys into the same bucket to make collisions.
+struct CollidingHash {
+  size_t operator()(size_t key) const { return key % 4; }
+};
+
+template <typename List>
+std::vector<Event> Get(const List &list) {
+  return std::vector<Event>(list.begin(), list.end());
+}
+}  // namespace
+
+TEST(Engine_CoalescingEventList, FirstInsertionOrder) {
+  CoalescingEventList<Event, size_t> list;
+  EXPECT_TRUE(list.empty());
+  EXPECT_TRUE(list.Insert(3, Event(3, "a")));
+  EXPECT_TRUE(list.Insert(1, Event(1, "b")));
+  EXPECT_TRUE(list.Insert(2, Event(2, "c")));
+  EXPECT_FALSE(list.Insert(1, Event(1, "d")));
+  EXPECT_FALSE(list.Insert(3, Event(3, "e")));
+
+  EXPECT_FALSE(list.empty());
+  ASSERT_EQ(3, list.size());
+  EXPECT_EQ(std::vector<Event>({{3, "a"}, {1, "b"}, {2, "c"}}), Get(list));
+  EXPECT_EQ(Event(2, "c"), list.back());
+}
+
+TEST(Engine_CoalescingEventList, ReplaceInPlace) {
+  CoalescingEventList<Event, size_t> list;
+  EXPECT_TRUE(list.Replace(3, Event(3, "a")));
+  EXPECT_TRUE(list.Replace(1, Event(1, "b")));
+  EXPECT_TRUE(list.Replace(2, Event(2, "c")));
+  // The replaced event keeps the position of the first event with this key:
+  EXPECT_FALSE(list.Replace(3, Event(3, "d")));
+  EXPECT_FALSE(list.Replace(1, Event(1, "e")));
+  EXPECT_FALSE(list.Replace(3, Event(3, "f")));
+
+  ASSERT_EQ(3, list.size());
+  EXPECT_EQ(std::vector<Event>({{3, "f"}, {1, "e"}, {2, "c"}}), Get(list));
+}
+
+TEST(Engine_CoalescingEventList, IndexGrowth) {
+  // Many more keys than the initial index size, with collisions, so the index
+  // is grown several times and each growth rehashes collided keys:
+  CoalescingEventList<Event, size_t, CollidingHash> list;
+  const size_t numberOfKeys = 1000;
+  for (size_t i = 0; i < numberOfKeys; ++i) {
+    ASSERT_TRUE(list.Insert(i, Event(i, "a")));
+  }
+  ASSERT_EQ(numberOfKeys, list.size());
+
+  for (size_t i = numberOfKeys; i > 0; --i) {
+    ASSERT_FALSE(list.Replace(i - 1, Event(i - 1, "b")));
+    ASSERT_FALSE(list.Insert(i - 1, Event(i - 1, "c")));
+  }
+  ASSERT_EQ(numberOfKeys, list.size());
+
+  size_t expectedKey = 0;
+  for (const auto &event : list) {
+    EXPECT_EQ(Event(expectedKey++, "b"), event);
+  }
+}
+
+TEST(Engine_CoalescingEventList, Clear) {
+  CoalescingEventList<Event, size_t> list;
+  EXPECT_TRUE(list.Insert(1, Event(1, "a")));
+  EXPECT_TRUE(list.Insert(2, Event(2, "b")));
+  list.clear();
+  EXPECT_TRUE(list.empty());
+  EXPECT_EQ(0, list.size());
+
+  // Keys from the previous generation are not in the list anymore:
+  EXPECT_TRUE(list.Insert(2, Event(2, "c")));
+  EXPECT_TRUE(list.Replace(1, Event(1, "d")));
+  EXPECT_FALSE(list.Insert(2, Event(2, "e")));
+  EXPECT_EQ(std::vector<Event>({{2, "c"}, {1, "d"}}), Get(list));
+}
+
+TEST(Engine_CoalescingEventList, ReuseAfterManyFlushes) {
+  CoalescingEventList<Event, size_t, CollidingHash> list;
+  for (size_t flush = 0; flush < 10000; ++flush) {
+    // Each flush has another set of keys, so marks from many previous
+    // generations are left in the index:
+    const size_t numberOfKeys = 1 + flush % 50;
+    for (size_t i = 0; i < numberOfKeys; ++i) {
+      ASSERT_TRUE(list.Insert(flush + i, Event(i, "a")));
+    }
+    for (size_t i = 0; i < numberOfKeys; ++i) {
+      ASSERT_FALSE(list.Replace(flush + i, Event(i, "b")));
+    }
+    ASSERT_EQ(numberOfKeys, list.size());
+    size_t expected = 0;
+    for (const auto &event : list) {
+      ASSERT_EQ(Event(expected++, "b"), event);
+    }
+    list.clear();
+    ASSERT_TRUE(list.empty());
+  }
+}
@@ -294,6 +294,16 @@ void Engine::Context::Start(
     for (size_t i = 0; i < m_pimpl->m_marketDataSources.size(); ++i) {
       m_pimpl->m_marketDataSources[i]->AssignIndex(i);
     }
+    if (GetSettings().IsInlineDispatchingEnabled() &&
+        m_pimpl->m_marketDataSources.size() > 1) {
+      // Each source replays market data by its own thread, so events from
+      // different sources can't be dispatched inline in the time order.
+      GetLog().Error(
+          "Inline dispatching can't be used with %1% market data sources, "
+          "only one source is supported.",
+          m_pimpl->m_marketDataSources.size());
+      throw Exception("Failed to init engine context");
+    }
     {
       size_t index = 0;
       for (auto &tradingSystem : m_pimpl->m_tradingSystems) {
@@ -11,7 +11,6 @@
 #include "Prec.hpp"
 #include "Dispatcher.hpp"
 #include "Core/Strategy.hpp"
-#include "Context.hpp"
 
 namespace pt = boost::posix_time;
 
@@ -77,37 +76,178 @@ struct SyncVisitor : public boost::static_visitor<> {
   }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GetQueueName(const char *queue, const std::string &group) {
+  if (group.empty()) {
+    return queue;
+  }
+  return (boost::format("%1% (%2%)") % queue % group).str();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 }  // namespace
 
 ////////////////////////////////////////////////////////////////////////////////
 
-Dispatcher::Dispatcher(Engine::Context &context)
+Dispatcher::EventQueueSettings::EventQueueSettings(const trdk::Context &context)
+    : isRingBufferEnabled(false),
+      ringBufferSize(4096),
+      numberOfRingBufferProducers(8) {
+  const auto &conf =
+      context.GetSettings().GetConfig().get_child_optional("dispatcher");
+  if (!conf) {
+    return;
+  }
+  const auto &ringBufferConf = conf->get_child_optional("ringBuffer");
+  if (!ringBufferConf) {
+    return;
+  }
+  isRingBufferEnabled = ringBufferConf->get<bool>("isEnabled");
+  ringBufferSize = ringBufferConf->get<size_t>("size", ringBufferSize);
+  numberOfRingBufferProducers =
+      ringBufferConf->get<size_t>("producers", numberOfRingBufferProducers);
+  if (!ringBufferSize || !numberOfRingBufferProducers) {
+    throw Exception("Dispatcher ring buffer size or number of producers is 0");
+  }
+  if (isRingBufferEnabled) {
+    context.GetLog().Info(
+        "Dispatcher uses lock-free ring buffers: %1% events for each of %2% "
+        "producers.",
+        ringBufferSize,                // 1
+        numberOfRingBufferProducers);  // 2
+  }
+}
+
+Dispatcher::EventQueueGroup::EventQueueGroup(
+    const std::string &name,
+    const trdk::Context &context,
+    const EventQueueSettings &settings)
+    : name(name),
+      level1Updates(GetQueueName("Level 1 updates", name), context, settings),
+      level1Ticks(GetQueueName("Level 1 ticks", name), context, settings),
+      newTrades(GetQueueName("Trades", name), context, settings),
+      positionsUpdates(GetQueueName("Positions", name), context, settings),
+      brokerPositionsUpdates(
+          GetQueueName("Broker positions", name), context, settings),
+      newBars(GetQueueName("System bars", name), context, settings),
+      bookUpdateTicks(
+          GetQueueName("Book update ticks", name), context, settings) {}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<Dispatcher::NotificationThreadSettings>
+Dispatcher::LoadNotificationThreadSettings(const trdk::Context &context) {
+  std::vector<NotificationThreadSettings> result;
+  const auto &conf =
+      context.GetSettings().GetConfig().get_child_optional("dispatcher");
+  if (!conf) {
+    return result;
+  }
+  const auto &threadsConf = conf->get_child_optional("threads");
+  if (!threadsConf) {
+    return result;
+  }
+  for (const auto &node : *threadsConf) {
+    NotificationThreadSettings settings;
+    settings.name = node.first;
+    for (const auto &strategy : node.second.get_child("strategies")) {
+      settings.strategies.emplace_back(
+          strategy.second.get_value<std::string>());
+    }
+    if (settings.name.empty() || settings.strategies.empty()) {
+      throw Exception(
+          "Dispatcher thread has no name or has no one strategy to dispatch");
+    }
+    settings.cpu = node.second.get_optional<size_t>("cpu");
+    const auto &cpu = settings.cpu
+                          ? boost::lexical_cast<std::string>(*settings.cpu)
+                          : std::string("not pinned");
+    context.GetLog().Info(
+        R"(Dispatcher thread "%1%" for strategies: %2% (CPU: %3%).)",
+        settings.name,                           // 1
+        boost::join(settings.strategies, ", "),  // 2
+        cpu);                                    // 3
+    result.emplace_back(std::move(settings));
+  }
+  return result;
+}
+
+Dispatcher::Dispatcher(trdk::Context &context)
     : m_context(context),
-      m_level1Updates("Level 1 updates", m_context),
-      m_level1Ticks("Level 1 ticks", m_context),
-      m_newTrades("Trades", m_context),
-      m_positionsUpdates("Positions", m_context),
-      m_brokerPositionsUpdates("Broker positions", m_context),
-      m_newBars("System bars", m_context),
-      m_bookUpdateTicks("Book update ticks", m_context) {
-  m_queues.emplace_back(&m_level1Updates);
-  m_queues.emplace_back(&m_level1Ticks);
-  m_queues.emplace_back(&m_newTrades);
-  m_queues.emplace_back(&m_positionsUpdates);
-  m_queues.emplace_back(&m_brokerPositionsUpdates);
-  m_queues.emplace_back(&m_newBars);
-  m_queues.emplace_back(&m_bookUpdateTicks);
+      m_eventQueueSettings(m_context),
+      m_isInline(m_context.GetSettings().IsInlineDispatchingEnabled()),
+      m_isInlineDispatching(false) {
+  if (m_isInline && m_eventQueueSettings.isRingBufferEnabled) {
+    throw Exception(
+        "Dispatcher ring buffers can't be used with inline dispatching");
+  }
+
+  m_queueGroups.emplace_back(boost::make_unique<EventQueueGroup>(
+      std::string(), m_context, m_eventQueueSettings));
+  const auto &threadsSettings = LoadNotificationThreadSettings(m_context);
+  for (const auto &threadSettings : threadsSettings) {
+    m_queueGroups.emplace_back(boost::make_unique<EventQueueGroup>(
+        threadSettings.name, m_context, m_eventQueueSettings));
+    for (const auto &strategy : threadSettings.strategies) {
+      if (!m_strategyQueueGroups.emplace(strategy, m_queueGroups.back().get())
+               .second) {
+        boost::format error(
+            R"(Strategy "%1%" is set for several dispatcher threads)");
+        error % strategy;
+        throw Exception(error.str().c_str());
+      }
+    }
+  }
+
+  for (auto &group : m_queueGroups) {
+    m_queues.emplace_back(&group->level1Updates);
+    m_queues.emplace_back(&group->level1Ticks);
+    m_queues.emplace_back(&group->newTrades);
+    m_queues.emplace_back(&group->positionsUpdates);
+    m_queues.emplace_back(&group->brokerPositionsUpdates);
+    m_queues.emplace_back(&group->newBars);
+    m_queues.emplace_back(&group->bookUpdateTicks);
+  }
   m_queues.shrink_to_fit();
 
-  unsigned int threadsCount = 2;
+  if (m_isInline) {
+    m_inlineSync = boost::make_shared<EventListsSyncObjects>(m_syncMutex);
+    for (auto &group : m_queueGroups) {
+      AssignEventListsSyncObjects(
+          m_inlineSync,
+          boost::make_tuple(boost::ref(group->level1Updates),
+                            boost::ref(group->level1Ticks),
+                            boost::ref(group->bookUpdateTicks),
+                            boost::ref(group->newTrades),
+                            boost::ref(group->newBars),
+                            boost::ref(group->positionsUpdates),
+                            boost::ref(group->brokerPositionsUpdates)));
+    }
+    m_context.GetLog().Info(
+        "Dispatcher raises events inline, without notification threads.");
+    return;
+  }
+
+  unsigned int threadsCount =
+      2 + static_cast<unsigned int>(threadsSettings.size());
   boost::shared_ptr<boost::barrier> startBarrier(
       new boost::barrier(threadsCount + 1));
-  StartNotificationTask<DispatchingTimeMeasurementPolicy>(
-      startBarrier, m_level1Updates, m_level1Ticks, m_bookUpdateTicks,
-      m_newTrades, m_newBars, threadsCount);
-  StartNotificationTask<DispatchingTimeMeasurementPolicy>(
-      startBarrier, m_positionsUpdates, m_brokerPositionsUpdates, threadsCount);
+  {
+    auto &queues = *m_queueGroups.front();
+    StartNotificationTask<DispatchingTimeMeasurementPolicy>(
+        startBarrier, queues.level1Updates, queues.level1Ticks,
+        queues.bookUpdateTicks, queues.newTrades, queues.newBars,
+        threadsCount);
+    StartNotificationTask<DispatchingTimeMeasurementPolicy>(
+        startBarrier, queues.positionsUpdates, queues.brokerPositionsUpdates,
+        threadsCount);
+  }
+  for (size_t i = 0; i < threadsSettings.size(); ++i) {
+    StartNotificationTask<DispatchingTimeMeasurementPolicy>(
+        startBarrier, *m_queueGroups[i + 1], threadsSettings[i].cpu,
+        threadsCount);
+  }
   AssertEq(0, threadsCount);
   startBarrier->wait();
 }
@@ -132,6 +272,9 @@ void Dispatcher::Activate() {
     boost::apply_visitor(ActivateVisitor(), queue);
   }
   m_context.GetLog().Debug("Events dispatching started.");
+  if (m_isInline) {
+    FlushInline();
+  }
 }
 
 void Dispatcher::Suspend() {
@@ -143,6 +286,11 @@ void Dispatcher::Suspend() {
 }
 
 Dispatcher::UniqueSyncLock Dispatcher::SyncDispatching() const {
+  if (m_isInline) {
+    // Level 1 ticks could be queued without flushing.
+    FlushInline();
+    return UniqueSyncLock(m_syncMutex);
+  }
   UniqueSyncLock lock(m_syncMutex);
   for (auto &queue : m_queues) {
     boost::apply_visitor(SyncVisitor(), queue);
@@ -150,6 +298,52 @@ Dispatcher::UniqueSyncLock Dispatcher::SyncDispatching() const {
   return lock;
 }
 
+void Dispatcher::FlushInline() const {
+  Assert(m_isInline);
+  Assert(m_inlineSync);
+  const boost::recursive_mutex::scoped_lock dispatchingLock(
+      m_inlineDispatchingMutex);
+  if (m_isInlineDispatching) {
+    // Called by an event handler from the dispatching thread.
+    return;
+  }
+  m_isInlineDispatching = true;
+  try {
+    EventQueueLock lock(m_inlineSync->queueMutex);
+    for (bool hasEvents = true; hasEvents;) {
+      const TimeMeasurement::Milestones timeMeasurement =
+          DispatchingTimeMeasurementPolicy::StartDispatchingTimeMeasurement(
+              m_context);
+      hasEvents = false;
+      for (const auto &group : m_queueGroups) {
+        // The same priorities as notification task has.
+        hasEvents |= FlushEvents(group->level1Updates, lock, timeMeasurement);
+        hasEvents |= FlushEvents(group->level1Ticks, lock, timeMeasurement);
+        hasEvents |=
+            FlushEvents(group->bookUpdateTicks, lock, timeMeasurement);
+        hasEvents |= FlushEvents(group->newTrades, lock, timeMeasurement);
+        hasEvents |= FlushEvents(group->newBars, lock, timeMeasurement);
+        hasEvents |=
+            FlushEvents(group->positionsUpdates, lock, timeMeasurement);
+        hasEvents |=
+            FlushEvents(group->brokerPositionsUpdates, lock, timeMeasurement);
+      }
+      timeMeasurement.Measure(TimeMeasurement::DM_COMPLETE_ALL);
+    }
+  } catch (...) {
+    m_isInlineDispatching = false;
+    throw;
+  }
+  m_isInlineDispatching = false;
+}
+
+Dispatcher::EventQueueGroup &Dispatcher::GetEventQueueGroup(
+    const Module &subscriber) {
+  const auto &it = m_strategyQueueGroups.find(subscriber.GetInstanceName());
+  return it != m_strategyQueueGroups.cend() ? *it->second
+                                            : *m_queueGroups.front();
+}
+
 bool Dispatcher::IsActive() const {
   for (auto &queue : m_queues) {
     if (!boost::apply_visitor(IsActiveVisitor(), queue)) {
@@ -160,6 +354,7 @@ bool Dispatcher::IsActive() const {
 }
 
 void Dispatcher::SignalLevel1Update(
+    EventQueueGroup &queues,
     SubscriberPtrWrapper &subscriber,
     Security &security,
     const TimeMeasurement::Milestones &delayMeasurement) {
@@ -167,7 +362,7 @@ void Dispatcher::SignalLevel1Update(
     if (subscriber.IsBlocked()) {
       return;
     }
-    m_level1Updates.Queue(
+    queues.level1Updates.Queue(
         boost::make_tuple(&security, subscriber, delayMeasurement), true);
   } catch (...) {
     AssertFailNoException();
@@ -175,9 +370,13 @@ void Dispatcher::SignalLevel1Update(
     subscriber.Block();
     throw;
   }
+  if (m_isInline) {
+    FlushInline();
+  }
 }
 
 void Dispatcher::SignalLevel1Tick(
+    EventQueueGroup &queues,
     SubscriberPtrWrapper &subscriber,
     Security &security,
     const boost::posix_time::ptime &time,
@@ -188,7 +387,7 @@ void Dispatcher::SignalLevel1Tick(
     if (subscriber.IsBlocked()) {
       return;
     }
-    m_level1Ticks.Queue(
+    queues.level1Ticks.Queue(
         boost::make_tuple(
             SubscriberPtrWrapper::Level1Tick{&security, time, value},
             subscriber, delayMeasurement),
@@ -199,9 +398,13 @@ void Dispatcher::SignalLevel1Tick(
     subscriber.Block();
     throw;
   }
+  if (m_isInline && flush) {
+    FlushInline();
+  }
 }
 
 void Dispatcher::SignalNewTrade(
+    EventQueueGroup &queues,
     SubscriberPtrWrapper &subscriber,
     Security &security,
     const pt::ptime &time,
@@ -212,7 +415,7 @@ void Dispatcher::SignalNewTrade(
     if (subscriber.IsBlocked()) {
       return;
     }
-    m_newTrades.Queue(
+    queues.newTrades.Queue(
         boost::make_tuple(
             SubscriberPtrWrapper::Trade{&security, time, price, qty},
             subscriber, delayMeasurement),
@@ -223,15 +426,19 @@ void Dispatcher::SignalNewTrade(
     subscriber.Block();
     throw;
   }
+  if (m_isInline) {
+    FlushInline();
+  }
 }
 
-void Dispatcher::SignalPositionUpdate(SubscriberPtrWrapper &subscriber,
+void Dispatcher::SignalPositionUpdate(EventQueueGroup &queues,
+                                      SubscriberPtrWrapper &subscriber,
                                       Position &position) {
   try {
     if (subscriber.IsBlocked()) {
       return;
     }
-    m_positionsUpdates.Queue(
+    queues.positionsUpdates.Queue(
         boost::make_tuple(position.shared_from_this(), subscriber), true);
   } catch (...) {
     AssertFailNoException();
@@ -239,9 +446,13 @@ void Dispatcher::SignalPositionUpdate(SubscriberPtrWrapper &subscriber,
     subscriber.Block();
     throw;
   }
+  if (m_isInline) {
+    FlushInline();
+  }
 }
 
-void Dispatcher::SignalBrokerPositionUpdate(SubscriberPtrWrapper &subscriber,
+void Dispatcher::SignalBrokerPositionUpdate(EventQueueGroup &queues,
+                                            SubscriberPtrWrapper &subscriber,
                                             Security &security,
                                             bool isLong,
                                             const Qty &qty,
@@ -251,7 +462,7 @@ void Dispatcher::SignalBrokerPositionUpdate(SubscriberPtrWrapper &subscriber,
     if (subscriber.IsBlocked()) {
       return;
     }
-    m_brokerPositionsUpdates.Queue(
+    queues.brokerPositionsUpdates.Queue(
         boost::make_tuple(
             SubscriberPtrWrapper::BrokerPosition{&security, isLong, qty, volume,
                                                  isInitial},
@@ -263,34 +474,42 @@ void Dispatcher::SignalBrokerPositionUpdate(SubscriberPtrWrapper &subscriber,
     subscriber.Block();
     throw;
   }
+  if (m_isInline) {
+    FlushInline();
+  }
 }
 
-void Dispatcher::SignalNewBar(SubscriberPtrWrapper &subscriber,
+void Dispatcher::SignalNewBar(EventQueueGroup &queues,
+                              SubscriberPtrWrapper &subscriber,
                               Security &security,
                               const Bar &bar) {
   try {
     if (subscriber.IsBlocked()) {
       return;
     }
-    m_newBars.Queue(boost::make_tuple(&security, bar, subscriber), true);
+    queues.newBars.Queue(boost::make_tuple(&security, bar, subscriber), true);
   } catch (...) {
     AssertFailNoException();
     //! Blocking as irreversible error, data loss.
     subscriber.Block();
     throw;
   }
+  if (m_isInline) {
+    FlushInline();
+  }
 }
 
 void Dispatcher::SignalBookUpdateTick(
+    EventQueueGroup &queues,
     SubscriberPtrWrapper &subscriber,
     Security &security,
-    const PriceBook &book,
+    const PriceBookSnapshot &book,
     const TimeMeasurement::Milestones &timeMeasurement) {
   try {
     if (subscriber.IsBlocked()) {
       return;
     }
-    m_bookUpdateTicks.Queue(
+    queues.bookUpdateTicks.Queue(
         boost::make_tuple(&security, book, timeMeasurement, subscriber), true);
   } catch (...) {
     AssertFailNoException();
@@ -298,6 +517,9 @@ void Dispatcher::SignalBookUpdateTick(
     subscriber.Block();
     throw;
   }
+  if (m_isInline) {
+    FlushInline();
+  }
 }
 
 void Dispatcher::SignalSecurityServiceEvents(
@@ -13,7 +13,9 @@
 #include "Core/Bar.hpp"
 #include "Core/PriceBook.hpp"
 #include "Core/Settings.hpp"
-#include "Context.hpp"
+#include "Common/MultiProducerRingBuffer.hpp"
+#include "CoalescingEventList.hpp"
+#include "Core/Context.hpp"
 #include "SubscriberPtrWrapper.hpp"
 
 namespace trdk {
@@ -42,6 +44,10 @@ struct DispatcherConcurrencyPolicyT<Lib::Concurrency::PROFILE_HFT> {
   typedef Lib::Concurrency::SpinMutex QueueMutex;
   typedef QueueMutex::ScopedLock QueueLock;
   typedef Lib::Concurrency::SpinCondition QueueCondition;
+
+  typedef boost::shared_mutex SyncMutex;
+  typedef boost::shared_lock<SyncMutex> SharedSyncLock;
+  typedef boost::unique_lock<SyncMutex> UniqueSyncLock;
 };
 
 typedef DispatcherConcurrencyPolicyT<TRDK_CONCURRENCY_PROFILE>
@@ -54,6 +60,10 @@ class Dispatcher {
  public:
   typedef Details::DispatcherConcurrencyPolicy::UniqueSyncLock UniqueSyncLock;
 
+  //! Set of event queues which are dispatched by the same notification
+  //! threads.
+  struct EventQueueGroup;
+
  private:
   typedef Details::DispatcherConcurrencyPolicy::SharedSyncLock SharedSyncLock;
   typedef Details::DispatcherConcurrencyPolicy::SyncMutex SyncMutex;
@@ -70,20 +80,58 @@ class Dispatcher {
     EventQueueCondition newDataCondition;
     EventQueueCondition syncCondition;
     bool isSyncRequired;
+    //! Set by notification task before it goes to sleep, ring buffer
+    //! producers use it to wake up the task only when it is required.
+    boost::atomic_bool isWaiting;
 
     explicit EventListsSyncObjects(SyncMutex &syncMutex)
-        : syncMutex(syncMutex), isSyncRequired(false) {}
+        : syncMutex(syncMutex), isSyncRequired(false), isWaiting(false) {}
+  };
+
+  //! Event queue settings.
+  /**
+   * Path: dispatcher::ringBuffer
+   * Ex.: "ringBuffer": {"isEnabled": true, "size": 4096, "producers": 8}
+   */
+  struct EventQueueSettings {
+    //! If set, producers use lock-free ring buffers instead of shared lists.
+    bool isRingBufferEnabled;
+    //! Number of events in one producer ring buffer.
+    size_t ringBufferSize;
+    //! Number of threads which get own ring buffer in one queue, other
+    //! threads use the shared locked queue.
+    size_t numberOfRingBufferProducers;
+
+    explicit EventQueueSettings(const trdk::Context &);
+  };
+
+  //! Settings of the separated notification thread for a set of strategies.
+  /**
+   * Path: dispatcher::threads
+   * Ex.: "threads": {"fast": {"strategies": ["Scalper"], "cpu": 2}}
+   * Strategies which are not set for any thread are dispatched by the default
+   * notification threads.
+   */
+  struct NotificationThreadSettings {
+    std::string name;
+    //! Strategy instance names.
+    std::vector<std::string> strategies;
+    //! Index of CPU to pin the thread, if set.
+    boost::optional<size_t> cpu;
   };
 
   template <typename ListT>
   class EventQueue {
    public:
     typedef ListT List;
+    typedef typename List::value_type Event;
 
     typedef EventQueueMutex Mutex;
     typedef EventQueueLock Lock;
     typedef EventQueueCondition Condition;
 
+    typedef Lib::Concurrency::MultiProducerRingBuffer<Event> RingBuffer;
+
    private:
     enum TaskState {
       TASK_STATE_INACTIVE,
@@ -92,10 +140,17 @@ class Dispatcher {
     };
 
    public:
-    explicit EventQueue(const char *name, const Context &context)
+    explicit EventQueue(const std::string &name,
+                        const trdk::Context &context,
+                        const EventQueueSettings &settings)
         : m_context(context),
           m_name(name),
           m_current(&m_lists.first),
+          m_ringBuffer(settings.isRingBufferEnabled
+                           ? boost::make_unique<RingBuffer>(
+                                 settings.numberOfRingBufferProducers,
+                                 settings.ringBufferSize)
+                           : nullptr),
           m_taksState(TASK_STATE_INACTIVE),
           m_queueSizeConstrolLevel(
               !m_context.GetSettings().IsReplayMode() ? 200 : 10000) {}
@@ -119,7 +174,7 @@ class Dispatcher {
       Assert(!m_sync->isSyncRequired);
     }
 
-    const char *GetName() const { return m_name; }
+    const std::string &GetName() const { return m_name; }
 
     bool IsActive() const { return m_taksState == TASK_STATE_ACTIVE; }
 
@@ -152,9 +207,22 @@ class Dispatcher {
       return m_taksState == TASK_STATE_STOPPED;
     }
 
-    template <typename Event>
+    //! Returns true if the queue has events which are not taken by the
+    //! notification task yet.
+    /**
+     * Has sense only for ring buffer mode, could be called only from
+     * notification task.
+     */
+    bool HasNewEvents() const {
+      return m_ringBuffer && !m_ringBuffer->IsEmpty();
+    }
+
     void Queue(Event &&event, bool flush) {
       Assert(m_sync);
+      if (m_ringBuffer) {
+        QueueToRingBuffer(std::move(event), flush);
+        return;
+      }
       const SharedSyncLock syncLock(m_sync->syncMutex);
       {
         const Lock queueLock(m_sync->queueMutex);
@@ -162,23 +230,13 @@ class Dispatcher {
           return;
         }
         Assert(m_current == &m_lists.first || m_current == &m_lists.second);
-        if (!Dispatcher::QueueEvent(std::forward<Event>(event), *m_current)) {
+        if (!Dispatcher::QueueEvent(std::move(event), *m_current)) {
           flush = false;
         }
         if (flush) {
           flush = !m_context.GetSettings().IsReplayMode();
         }
-        if (!(m_current->size() % m_queueSizeConstrolLevel)) {
-          const auto message =
-              "Dispatcher queue \"%1%\" is too long (%2% events)!";
-          if (m_current->size() <= 100) {
-            m_context.GetLog().Info(message, m_name, m_current->size());
-          } else if (m_current->size() <= 200) {
-            m_context.GetLog().Warn(message, m_name, m_current->size());
-          } else {
-            m_context.GetLog().Error(message, m_name, m_current->size());
-          }
-        }
+        CheckSize();
       }
       if (flush) {
         m_sync->newDataCondition.notify_one();
@@ -191,6 +249,8 @@ class Dispatcher {
       Assert(&m_sync->queueMutex == lock.mutex());
       Assert(m_current == &m_lists.first || m_current == &m_lists.second);
 
+      TakeRingBufferEvents();
+
       size_t heavyLoadsCount = 0;
       while (!m_current->empty() && m_taksState == TASK_STATE_ACTIVE) {
         if (!(++heavyLoadsCount % 500)) {
@@ -211,6 +271,7 @@ class Dispatcher {
         listToRead->clear();
         lock.lock();
         timeMeasurement.Measure(Lib::TimeMeasurement::DM_COMPLETE_LIST);
+        TakeRingBufferEvents();
       }
 
       if (m_sync->isSyncRequired) {
@@ -222,24 +283,101 @@ class Dispatcher {
     }
 
    private:
-    const Context &m_context;
+    //! Queues event without locking, only for ring buffer mode.
+    /**
+     * Doesn't wait for the dispatching sync-lock, so the sync doesn't block
+     * market data threads, but guaranties only that events which were queued
+     * before the sync started will be raised before it is finished.
+     */
+    void QueueToRingBuffer(Event &&event, bool flush) {
+      Assert(m_ringBuffer);
+      for (size_t attempt = 1; !m_ringBuffer->Push(std::move(event));
+           ++attempt) {
+        if (m_taksState == TASK_STATE_STOPPED) {
+          return;
+        }
+        // Consumer could sleep while the buffer is full if previous events
+        // were added without flushing.
+        NotifyRingBufferConsumer();
+        if (!(attempt % 100000)) {
+          m_context.GetLog().Warn(
+              "Dispatcher queue \"%1%\" ring buffer is full (%2% attempts to "
+              "add new event)!",
+              m_name, attempt);
+        }
+        boost::this_thread::yield();
+      }
+      if (flush && !m_context.GetSettings().IsReplayMode()) {
+        NotifyRingBufferConsumer();
+      }
+    }
+
+    void NotifyRingBufferConsumer() {
+      // Pairs with the fence in the notification task before it checks ring
+      // buffers at last time before sleeping.
+      boost::atomic_thread_fence(boost::memory_order_seq_cst);
+      if (!m_sync->isWaiting.load(boost::memory_order_relaxed)) {
+        return;
+      }
+      const Lock lock(m_sync->queueMutex);
+      m_sync->newDataCondition.notify_one();
+    }
+
+    //! Moves events from ring buffers into the current list.
+    /**
+     * Called from the notification task, with locked queue mutex. Events are
+     * merged by the same rules as if they were queued into the list directly.
+     */
+    void TakeRingBufferEvents() {
+      if (!m_ringBuffer) {
+        return;
+      }
+      m_ringBuffer->ConsumeAll([this](Event &event) {
+        Dispatcher::QueueEvent(std::move(event), *m_current);
+        CheckSize();
+      });
+    }
 
-    const char *const m_name;
+    void CheckSize() const {
+      if (m_current->size() % m_queueSizeConstrolLevel) {
+        return;
+      }
+      const auto message = "Dispatcher queue \"%1%\" is too long (%2% events)!";
+      if (m_current->size() <= 100) {
+        m_context.GetLog().Info(message, m_name, m_current->size());
+      } else if (m_current->size() <= 200) {
+        m_context.GetLog().Warn(message, m_name, m_current->size());
+      } else {
+        m_context.GetLog().Error(message, m_name, m_current->size());
+      }
+    }
+
+   private:
+    const trdk::Context &m_context;
+
+    const std::string m_name;
 
     std::pair<List, List> m_lists;
     List *m_current;
 
+    std::unique_ptr<RingBuffer> m_ringBuffer;
+
     boost::shared_ptr<EventListsSyncObjects> m_sync;
 
-    TaskState m_taksState;
+    boost::atomic<TaskState> m_taksState;
 
     const size_t m_queueSizeConstrolLevel;
   };
 
+  //! Key to merge events for the same subject and the same subscriber.
+  typedef std::pair<const void *, const Module *> EventMergeKey;
+
   typedef boost::
       tuple<Security *, SubscriberPtrWrapper, Lib::TimeMeasurement::Milestones>
           Level1UpdateEvent;
-  typedef EventQueue<std::vector<Level1UpdateEvent>> Level1UpdateEventQueue;
+  typedef CoalescingEventList<Level1UpdateEvent, EventMergeKey>
+      Level1UpdateEventList;
+  typedef EventQueue<Level1UpdateEventList> Level1UpdateEventQueue;
 
   typedef boost::tuple<SubscriberPtrWrapper::Level1Tick,
                        SubscriberPtrWrapper,
@@ -257,9 +395,9 @@ class Dispatcher {
   //! can lost owning references at event handling).
   typedef boost::tuple<boost::shared_ptr<Position>, SubscriberPtrWrapper>
       PositionUpdateEvent;
-  //! @todo: Check performance: set or list
-  typedef EventQueue<std::vector<PositionUpdateEvent>>
-      PositionsUpdateEventQueue;
+  typedef CoalescingEventList<PositionUpdateEvent, EventMergeKey>
+      PositionUpdateEventList;
+  typedef EventQueue<PositionUpdateEventList> PositionsUpdateEventQueue;
 
   typedef boost::tuple<SubscriberPtrWrapper::BrokerPosition,
                        SubscriberPtrWrapper>
@@ -273,12 +411,13 @@ class Dispatcher {
   typedef EventQueue<std::vector<NewBarEvent>> NewBarEventQueue;
 
   typedef boost::tuple<Security *,
-                       PriceBook,
+                       PriceBookSnapshot,
                        Lib::TimeMeasurement::Milestones,
                        SubscriberPtrWrapper>
       BookUpdateTickEvent;
-  //! @todo HAVY OPTIMIZATION!!! Use preallocated buffer here instead std::list.
-  typedef EventQueue<std::vector<BookUpdateTickEvent>> BookUpdateTickEventQueue;
+  typedef CoalescingEventList<BookUpdateTickEvent, EventMergeKey>
+      BookUpdateTickEventList;
+  typedef EventQueue<BookUpdateTickEventList> BookUpdateTickEventQueue;
 
   typedef boost::variant<Level1UpdateEventQueue *,
                          Level1TicksEventQueue *,
@@ -290,7 +429,29 @@ class Dispatcher {
       QueueList;
 
  public:
-  explicit Dispatcher(Context &);
+  struct EventQueueGroup {
+    //! Empty for the default group.
+    const std::string name;
+
+    Level1UpdateEventQueue level1Updates;
+    Level1TicksEventQueue level1Ticks;
+    NewTradeEventQueue newTrades;
+    PositionsUpdateEventQueue positionsUpdates;
+    BrokerPositionsUpdateEventQueue brokerPositionsUpdates;
+    NewBarEventQueue newBars;
+    BookUpdateTickEventQueue bookUpdateTicks;
+
+    explicit EventQueueGroup(const std::string &name,
+                             const trdk::Context &,
+                             const EventQueueSettings &);
+    EventQueueGroup(EventQueueGroup &&) = delete;
+    EventQueueGroup(const EventQueueGroup &) = delete;
+    EventQueueGroup &operator=(EventQueueGroup &&) = delete;
+    EventQueueGroup &operator=(const EventQueueGroup &) = delete;
+  };
+
+ public:
+  explicit Dispatcher(trdk::Context &);
   Dispatcher(Dispatcher &&) = default;
   Dispatcher(const Dispatcher &) = delete;
   Dispatcher &operator=(Dispatcher &&) = delete;
@@ -302,39 +463,60 @@ class Dispatcher {
   void Activate();
   void Suspend();
 
+  //! Waits until all queued events are raised and blocks dispatching.
+  /**
+   * In the inline mode raises queued events by the calling thread as there
+   * are no notification threads.
+   */
   UniqueSyncLock SyncDispatching() const;
 
+  //! Returns queues which dispatch events for the subscriber.
+  /**
+   * Should be resolved at subscribing, not for each event.
+   */
+  EventQueueGroup &GetEventQueueGroup(const Module &subscriber);
+
   void SignalSecurityContractSwitched(SubscriberPtrWrapper &,
                                       const boost::posix_time::ptime &,
                                       Security &,
                                       Security::Request &,
                                       bool &isSwitched);
-  void SignalLevel1Update(SubscriberPtrWrapper &,
+  void SignalLevel1Update(EventQueueGroup &,
+                          SubscriberPtrWrapper &,
                           Security &,
                           const Lib::TimeMeasurement::Milestones &);
-  void SignalLevel1Tick(SubscriberPtrWrapper &,
+  void SignalLevel1Tick(EventQueueGroup &,
+                        SubscriberPtrWrapper &,
                         Security &,
                         const boost::posix_time::ptime &,
                         const trdk::Level1TickValue &,
                         const trdk::Lib::TimeMeasurement::Milestones &,
                         bool flush);
-  void SignalNewTrade(SubscriberPtrWrapper &,
+  void SignalNewTrade(EventQueueGroup &,
+                      SubscriberPtrWrapper &,
                       Security &,
                       const boost::posix_time::ptime &,
                       const Price &,
                       const Qty &,
                       const trdk::Lib::TimeMeasurement::Milestones &);
-  void SignalPositionUpdate(SubscriberPtrWrapper &, Position &);
-  void SignalBrokerPositionUpdate(SubscriberPtrWrapper &,
+  void SignalPositionUpdate(EventQueueGroup &,
+                            SubscriberPtrWrapper &,
+                            Position &);
+  void SignalBrokerPositionUpdate(EventQueueGroup &,
+                                  SubscriberPtrWrapper &,
                                   Security &,
                                   bool isLong,
                                   const Qty &,
                                   const Volume &,
                                   bool isInitial);
-  void SignalNewBar(SubscriberPtrWrapper &, Security &, const Bar &);
-  void SignalBookUpdateTick(SubscriberPtrWrapper &,
+  void SignalNewBar(EventQueueGroup &,
+                    SubscriberPtrWrapper &,
+                    Security &,
+                    const Bar &);
+  void SignalBookUpdateTick(EventQueueGroup &,
+                            SubscriberPtrWrapper &,
                             Security &,
-                            const PriceBook &,
+                            const PriceBookSnapshot &,
                             const Lib::TimeMeasurement::Milestones &);
   void SignalSecurityServiceEvents(SubscriberPtrWrapper &,
                                    const boost::posix_time::ptime &,
@@ -342,6 +524,18 @@ class Dispatcher {
                                    const Security::ServiceEvent &);
 
  private:
+  static std::vector<NotificationThreadSettings> LoadNotificationThreadSettings(
+      const trdk::Context &);
+
+  //! Raises all queued events by the current thread, only for inline mode.
+  /**
+   * Events which are signaled by event handlers are not raised recursively,
+   * they are raised by the outer call after the handler returns, so a module
+   * is never called while it handles another event. Other threads wait until
+   * the current dispatching is completed.
+   */
+  void FlushInline() const;
+
   template <typename Event>
   static void RaiseEvent(Event &) {
 #if !defined(__GNUG__)
@@ -361,17 +555,15 @@ class Dispatcher {
     return false;
   }
 
-  template <typename EventList>
   static bool QueueEvent(Level1UpdateEvent &&updateEvent,
-                         EventList &eventList) {
-    //! @todo place for optimization
-    for (const auto &it : boost::adaptors::reverse(eventList)) {
-      if (boost::get<0>(updateEvent) == boost::get<0>(it) &&
-          boost::get<1>(updateEvent) == boost::get<1>(it)) {
-        return false;
-      }
+                         Level1UpdateEventList &eventList) {
+    // Level 1 is read from the security at event raising, so it's enough to
+    // have one event for each subscriber and security in the list.
+    const EventMergeKey key(boost::get<0>(updateEvent),
+                            &*boost::get<1>(updateEvent));
+    if (!eventList.Insert(key, std::move(updateEvent))) {
+      return false;
     }
-    eventList.emplace_back(std::move(updateEvent));
     boost::get<2>(eventList.back())
         .Measure(Lib::TimeMeasurement::SM_DISPATCHING_DATA_ENQUEUE);
     return true;
@@ -390,17 +582,11 @@ class Dispatcher {
         .Measure(Lib::TimeMeasurement::SM_DISPATCHING_DATA_ENQUEUE);
     return true;
   }
-  template <typename EventList>
   static bool QueueEvent(PositionUpdateEvent &&positionUpdateEvent,
-                         EventList &eventList) {
-    //! @todo place for optimization
-    const auto &end = eventList.cend();
-    const auto &pos = std::find(eventList.cbegin(), end, positionUpdateEvent);
-    if (pos != end) {
-      return false;
-    }
-    eventList.emplace_back(std::move(positionUpdateEvent));
-    return true;
+                         PositionUpdateEventList &eventList) {
+    const EventMergeKey key(boost::get<0>(positionUpdateEvent).get(),
+                            &*boost::get<1>(positionUpdateEvent));
+    return eventList.Insert(key, std::move(positionUpdateEvent));
   }
   template <typename EventList>
   static bool QueueEvent(BrokerPositionUpdateEvent &&positionUpdateEvent,
@@ -413,13 +599,15 @@ class Dispatcher {
     eventList.emplace_back(newBarEvent);
     return true;
   }
-  template <typename EventList>
   static bool QueueEvent(BookUpdateTickEvent &&bookUpdateTickEvent,
-                         EventList &eventList) {
-    eventList.emplace_back(bookUpdateTickEvent);
-    boost::get<2>(eventList.back())
+                         BookUpdateTickEventList &eventList) {
+    boost::get<2>(bookUpdateTickEvent)
         .Measure(Lib::TimeMeasurement::SM_DISPATCHING_DATA_ENQUEUE);
-    return true;
+    // Only the newest book is required if the subscriber didn't get previous
+    // books yet, the newest book replaces previous one.
+    const EventMergeKey key(boost::get<0>(bookUpdateTickEvent),
+                            &*boost::get<3>(bookUpdateTickEvent));
+    return eventList.Replace(key, std::move(bookUpdateTickEvent));
   }
 
  private:
@@ -1041,6 +1229,35 @@ class Dispatcher {
 
   ////////////////////////////////////////////////////////////////////////////////
 
+  //! Starts one notification task for all queues of the group.
+  template <typename DispatchingTimeMeasurementPolicy>
+  void StartNotificationTask(boost::shared_ptr<boost::barrier> startBarrier,
+                             EventQueueGroup &queues,
+                             const boost::optional<size_t> &cpu,
+                             unsigned int &threadsCounter) {
+    Lib::UseUnused(threadsCounter);
+    const auto lists = boost::make_tuple(
+        boost::ref(queues.level1Updates), boost::ref(queues.level1Ticks),
+        boost::ref(queues.bookUpdateTicks), boost::ref(queues.newTrades),
+        boost::ref(queues.newBars), boost::ref(queues.positionsUpdates),
+        boost::ref(queues.brokerPositionsUpdates));
+    m_threads.create_thread(boost::bind(
+        &Dispatcher::PinnedNotificationTask<decltype(lists),
+                                            DispatchingTimeMeasurementPolicy>,
+        this, cpu, startBarrier, lists));
+    Assert(1 <= threadsCounter--);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
+  static bool HasNewEvents(const boost::tuples::null_type &) { return false; }
+  template <typename Head, typename Tail>
+  static bool HasNewEvents(const boost::tuples::cons<Head, Tail> &lists) {
+    return lists.get_head().HasNewEvents() || HasNewEvents(lists.get_tail());
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+
   template <typename EventLists, typename DispatchingTimeMeasurementPolicy>
   void NotificationTask(boost::shared_ptr<boost::barrier> startBarrier,
                         EventLists &lists) const {
@@ -1066,7 +1283,13 @@ class Dispatcher {
         if (deactivationMask.all()) {
           break;
         }
-        sync->newDataCondition.wait(lock);
+        sync->isWaiting = true;
+        // Ring buffer producers do not lock queue mutex, so the last check is
+        // required after the waiting flag is set.
+        if (!HasNewEvents(lists)) {
+          sync->newDataCondition.wait(lock);
+        }
+        sync->isWaiting = false;
         timeMeasurement.Measure(Lib::TimeMeasurement::DM_NEW_DATA);
       }
 
@@ -1082,9 +1305,9 @@ class Dispatcher {
     try {
       if (error.empty()) {
         m_context.RaiseStateUpdate(
-            Context::STATE_DISPATCHER_TASK_STOPPED_GRACEFULLY);
+            trdk::Context::STATE_DISPATCHER_TASK_STOPPED_GRACEFULLY);
       } else {
-        m_context.RaiseStateUpdate(Context::STATE_DISPATCHER_TASK_STOPPED_ERROR,
+        m_context.RaiseStateUpdate(trdk::Context::STATE_DISPATCHER_TASK_STOPPED_ERROR,
                                    error);
       }
     } catch (const trdk::Lib::Exception &ex) {
@@ -1103,22 +1326,54 @@ class Dispatcher {
     }
   }
 
+  template <typename EventLists, typename DispatchingTimeMeasurementPolicy>
+  void PinnedNotificationTask(const boost::optional<size_t> &cpu,
+                              boost::shared_ptr<boost::barrier> startBarrier,
+                              EventLists &lists) const {
+    if (cpu) {
+      try {
+        Lib::PinCurrentThreadToCpu(*cpu);
+        m_context.GetLog().Info(
+            "Dispatcher notification task \"%1%\" is pinned to CPU %2%.",
+            GetEventListsName(lists),  // 1
+            *cpu);                     // 2
+      } catch (const Lib::Exception &ex) {
+        m_context.GetLog().Error(
+            "Failed to pin dispatcher notification task \"%1%\": \"%2%\".",
+            GetEventListsName(lists),  // 1
+            ex);                       // 2
+      }
+    }
+    NotificationTask<EventLists, DispatchingTimeMeasurementPolicy>(
+        std::move(startBarrier), lists);
+  }
+
  private:
-  Engine::Context &m_context;
+  trdk::Context &m_context;
 
   mutable SyncMutex m_syncMutex;
 
   boost::thread_group m_threads;
 
-  Level1UpdateEventQueue m_level1Updates;
-  Level1TicksEventQueue m_level1Ticks;
-  NewTradeEventQueue m_newTrades;
-  PositionsUpdateEventQueue m_positionsUpdates;
-  BrokerPositionsUpdateEventQueue m_brokerPositionsUpdates;
-  NewBarEventQueue m_newBars;
-  BookUpdateTickEventQueue m_bookUpdateTicks;
+  const EventQueueSettings m_eventQueueSettings;
+
+  //! The first group is the default group.
+  std::vector<std::unique_ptr<EventQueueGroup>> m_queueGroups;
+  //! Groups of separated notification threads by strategy instance name.
+  std::map<std::string, EventQueueGroup *> m_strategyQueueGroups;
 
   std::vector<QueueList> m_queues;
+
+  //! Events are raised by the thread which signals them, without
+  //! notification threads.
+  const bool m_isInline;
+  boost::shared_ptr<EventListsSyncObjects> m_inlineSync;
+  //! Serializes inline dispatching between threads, so strategies are never
+  //! called concurrently, and lets the dispatching thread to detect the
+  //! recursive call from an event handler.
+  mutable boost::recursive_mutex m_inlineDispatchingMutex;
+  //! Guarded by m_inlineDispatchingMutex.
+  mutable bool m_isInlineDispatching;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1166,7 +1421,7 @@ inline void Dispatcher::RaiseEvent(BookUpdateTickEvent &bookUpdateTickEvent) {
   timeMeasurement.Measure(Lib::TimeMeasurement::SM_DISPATCHING_DATA_DEQUEUE);
   boost::get<3>(bookUpdateTickEvent)
       .RaiseBookUpdateTickEvent(*boost::get<0>(bookUpdateTickEvent),
-                                boost::get<1>(bookUpdateTickEvent),
+                                *boost::get<1>(bookUpdateTickEvent),
                                 timeMeasurement);
 }
 
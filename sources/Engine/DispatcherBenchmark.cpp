@@ -0,0 +1,154 @@
+/**************************************************************************
+ *   Created: 2026/10/18 10:14:27
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ **************************************************************************/
+
+#include "Prec.hpp"
+#include "Core/Strategy.hpp"
+#include "Benchmarks/BenchmarkContext.hpp"
+#include "Dispatcher.hpp"
+
+using namespace trdk;
+using namespace trdk::Lib;
+using namespace trdk::Lib::TimeMeasurement;
+using namespace trdk::Engine;
+
+namespace pt = boost::posix_time;
+namespace gr = boost::gregorian;
+namespace ptr = boost::property_tree;
+
+namespace {
+
+ptr::ptree CreateStrategySettings() {
+  ptr::ptree result;
+  result.add("id", "{2D6C3A7E-3E4B-4C59-9B55-0C7D2C6F1A10}");
+  result.add("module", "Benchmark");
+  result.add("tradingMode", "live");
+  result.add("isEnabled", true);
+  return result;
+}
+
+//! Counts trades which are delivered by the dispatcher notification thread.
+class Subscriber : public Strategy {
+ public:
+  explicit Subscriber(trdk::Context &context)
+      : Strategy(context,
+                 "{2D6C3A7E-3E4B-4C59-9B55-0C7D2C6F1A10}",
+                 "Benchmark",
+                 "Benchmark",
+                 CreateStrategySettings()),
+        m_numberOfTrades(0) {}
+  ~Subscriber() override = default;
+
+  size_t GetNumberOfTrades() const { return m_numberOfTrades; }
+
+  void OnPostionsCloseRequest() override {}
+
+ protected:
+  void OnNewTrade(trdk::Security &,
+                  const pt::ptime &,
+                  const Price &,
+                  const Qty &) override {
+    ++m_numberOfTrades;
+  }
+
+ private:
+  boost::atomic_size_t m_numberOfTrades;
+};
+
+//! Dispatcher with one subscriber and one security, as market data source
+//! threads see it.
+class Environment : private boost::noncopyable {
+ public:
+  Environment()
+      : m_subscriber(Benchmarks::Context::GetInstance()),
+        m_subscriberPtr(static_cast<Strategy &>(m_subscriber)),
+        m_security(Benchmarks::CreateSecurity()),
+        m_dispatcher(Benchmarks::Context::GetInstance()),
+        m_queues(m_dispatcher.GetEventQueueGroup(m_subscriber)),
+        m_time(gr::date(2018, 1, 1)) {
+    m_dispatcher.Activate();
+  }
+
+  void SignalNewTrade() {
+    m_dispatcher.SignalNewTrade(m_queues, m_subscriberPtr, *m_security,
+                                m_time, 100, 1, m_milestones);
+  }
+
+  //! Waits until the notification thread raises all queued events.
+  void WaitForTrades(size_t numberOfTrades) const {
+    while (m_subscriber.GetNumberOfTrades() < numberOfTrades) {
+      boost::this_thread::yield();
+    }
+  }
+
+ private:
+  Subscriber m_subscriber;
+  SubscriberPtrWrapper m_subscriberPtr;
+  const std::unique_ptr<Benchmarks::Security> m_security;
+  Dispatcher m_dispatcher;
+  Dispatcher::EventQueueGroup &m_queues;
+  const pt::ptime m_time;
+  const Milestones m_milestones;
+};
+
+//! Market data source threads signal trades while the notification thread
+//! raises them, the time is measured only for producers. Events which are not
+//! raised at the end are dropped by the dispatcher stopping.
+void Engine_Dispatcher_Enqueue(benchmark::State &state) {
+  static std::unique_ptr<Environment> environment;
+  if (state.thread_index == 0) {
+    environment = boost::make_unique<Environment>();
+  }
+
+  for (auto _ : state) {
+    environment->SignalNewTrade();
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index == 0) {
+    environment.reset();
+  }
+}
+
+//! Each iteration is finished only when all signaled trades are raised, so
+//! the time includes flushes.
+void Engine_Dispatcher_EnqueueAndFlush(benchmark::State &state) {
+  const auto numberOfProducers = static_cast<size_t>(state.range(0));
+  const size_t numberOfTradesPerProducer = 10000;
+
+  Environment environment;
+  size_t numberOfTrades = 0;
+  for (auto _ : state) {
+    boost::thread_group producers;
+    for (size_t producer = 0; producer < numberOfProducers; ++producer) {
+      producers.create_thread([&environment, numberOfTradesPerProducer]() {
+        for (size_t i = 0; i < numberOfTradesPerProducer; ++i) {
+          environment.SignalNewTrade();
+        }
+      });
+    }
+    producers.join_all();
+    numberOfTrades += numberOfProducers * numberOfTradesPerProducer;
+    environment.WaitForTrades(numberOfTrades);
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(numberOfTrades));
+}
+
+}  // namespace
+
+BENCHMARK(Engine_Dispatcher_Enqueue)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(Engine_Dispatcher_EnqueueAndFlush)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
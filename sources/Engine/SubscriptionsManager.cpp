@@ -12,9 +12,9 @@
 #include "SubscriptionsManager.hpp"
 #include "Core/MarketDataSource.hpp"
 #include "Core/Strategy.hpp"
+#include "Context.hpp"
 
 namespace pt = boost::posix_time;
-namespace sig = boost::signals2;
 
 using namespace trdk;
 using namespace trdk::Lib;
@@ -41,7 +41,7 @@ SubscriptionsManager::SubscriptionsManager(trdk::Engine::Context &context)
 SubscriptionsManager::~SubscriptionsManager() {
   try {
     for (const auto &connection : m_slotConnections) {
-      connection.disconnect();
+      connection.Disconnect();
     }
   } catch (...) {
     AssertFailNoException();
@@ -62,16 +62,17 @@ void SubscriptionsManager::Suspend() { m_dispatcher.Suspend(); }
 void SubscriptionsManager::SubscribeToLevel1Updates(
     Security &security,
     const SubscriberPtrWrapper &subscriber,
-    std::list<sig::connection> &slotConnections) {
+    std::list<SlotConnection> &slotConnections) {
   const auto slot = Security::Level1UpdateSlot(
-      boost::bind(&Dispatcher::SignalLevel1Update, &m_dispatcher, subscriber,
-                  boost::ref(security), _1));
+      boost::bind(&Dispatcher::SignalLevel1Update, &m_dispatcher,
+                  boost::ref(m_dispatcher.GetEventQueueGroup(*subscriber)),
+                  subscriber, boost::ref(security), _1));
   const auto connection = security.SubscribeToLevel1Updates(slot);
   try {
     slotConnections.emplace_back(connection);
   } catch (...) {
     try {
-      connection.disconnect();
+      connection.Disconnect();
     } catch (...) {
       AssertFailNoException();
       throw;
@@ -84,16 +85,17 @@ void SubscriptionsManager::SubscribeToLevel1Updates(
 void SubscriptionsManager::SubscribeToLevel1Ticks(
     Security &security,
     const SubscriberPtrWrapper &subscriber,
-    std::list<sig::connection> &slotConnections) {
+    std::list<SlotConnection> &slotConnections) {
   const auto slot = Security::Level1TickSlot(
-      boost::bind(&Dispatcher::SignalLevel1Tick, &m_dispatcher, subscriber,
-                  boost::ref(security), _1, _2, _3, _4));
+      boost::bind(&Dispatcher::SignalLevel1Tick, &m_dispatcher,
+                  boost::ref(m_dispatcher.GetEventQueueGroup(*subscriber)),
+                  subscriber, boost::ref(security), _1, _2, _3, _4));
   const auto &connection = security.SubscribeToLevel1Ticks(slot);
   try {
     slotConnections.emplace_back(connection);
   } catch (...) {
     try {
-      connection.disconnect();
+      connection.Disconnect();
     } catch (...) {
       AssertFailNoException();
       throw;
@@ -106,16 +108,17 @@ void SubscriptionsManager::SubscribeToLevel1Ticks(
 void SubscriptionsManager::SubscribeToTrades(
     Security &security,
     const SubscriberPtrWrapper &subscriber,
-    std::list<sig::connection> &slotConnections) {
+    std::list<SlotConnection> &slotConnections) {
   const auto slot = Security::NewTradeSlot(
-      boost::bind(&Dispatcher::SignalNewTrade, &m_dispatcher, subscriber,
-                  boost::ref(security), _1, _2, _3, _4));
+      boost::bind(&Dispatcher::SignalNewTrade, &m_dispatcher,
+                  boost::ref(m_dispatcher.GetEventQueueGroup(*subscriber)),
+                  subscriber, boost::ref(security), _1, _2, _3, _4));
   const auto &connection = security.SubscribeToTrades(slot);
   try {
     slotConnections.emplace_back(connection);
   } catch (...) {
     try {
-      connection.disconnect();
+      connection.Disconnect();
     } catch (...) {
       AssertFailNoException();
       throw;
@@ -128,16 +131,17 @@ void SubscriptionsManager::SubscribeToTrades(
 void SubscriptionsManager::SubscribeToBrokerPositionUpdates(
     Security &security,
     const SubscriberPtrWrapper &subscriber,
-    std::list<sig::connection> &slotConnections) {
+    std::list<SlotConnection> &slotConnections) {
   const auto slot = Security::BrokerPositionUpdateSlot(
       boost::bind(&Dispatcher::SignalBrokerPositionUpdate, &m_dispatcher,
+                  boost::ref(m_dispatcher.GetEventQueueGroup(*subscriber)),
                   subscriber, boost::ref(security), _1, _2, _3, _4));
   const auto &connection = security.SubscribeToBrokerPositionUpdates(slot);
   try {
     slotConnections.emplace_back(connection);
   } catch (...) {
     try {
-      connection.disconnect();
+      connection.Disconnect();
     } catch (...) {
       AssertFailNoException();
       throw;
@@ -150,16 +154,17 @@ void SubscriptionsManager::SubscribeToBrokerPositionUpdates(
 void SubscriptionsManager::SubscribeToBars(
     Security &security,
     const SubscriberPtrWrapper &subscriber,
-    std::list<sig::connection> &slotConnections) {
-  const auto slot =
-      Security::NewBarSlot(boost::bind(&Dispatcher::SignalNewBar, &m_dispatcher,
-                                       subscriber, boost::ref(security), _1));
+    std::list<SlotConnection> &slotConnections) {
+  const auto slot = Security::NewBarSlot(
+      boost::bind(&Dispatcher::SignalNewBar, &m_dispatcher,
+                  boost::ref(m_dispatcher.GetEventQueueGroup(*subscriber)),
+                  subscriber, boost::ref(security), _1));
   const auto &connection = security.SubscribeToBars(slot);
   try {
     slotConnections.emplace_back(connection);
   } catch (...) {
     try {
-      connection.disconnect();
+      connection.Disconnect();
     } catch (...) {
       AssertFailNoException();
       throw;
@@ -172,16 +177,17 @@ void SubscriptionsManager::SubscribeToBars(
 void SubscriptionsManager::SubscribeToBookUpdateTicks(
     Security &security,
     const SubscriberPtrWrapper &subscriber,
-    std::list<sig::connection> &slotConnections) {
+    std::list<SlotConnection> &slotConnections) {
   const auto slot = Security::BookUpdateTickSlot(
-      boost::bind(&Dispatcher::SignalBookUpdateTick, &m_dispatcher, subscriber,
-                  boost::ref(security), _1, _2));
+      boost::bind(&Dispatcher::SignalBookUpdateTick, &m_dispatcher,
+                  boost::ref(m_dispatcher.GetEventQueueGroup(*subscriber)),
+                  subscriber, boost::ref(security), _1, _2));
   const auto &connection = security.SubscribeToBookUpdateTicks(slot);
   try {
     slotConnections.emplace_back(connection);
   } catch (...) {
     try {
-      connection.disconnect();
+      connection.Disconnect();
     } catch (...) {
       AssertFailNoException();
       throw;
@@ -194,7 +200,7 @@ void SubscriptionsManager::SubscribeToBookUpdateTicks(
 void SubscriptionsManager::SubscribeToSecurityContractSwitching(
     Security &security,
     const SubscriberPtrWrapper &subscriber,
-    std::list<sig::connection> &slotConnections) {
+    std::list<SlotConnection> &slotConnections) {
   typedef void(CallbackProto)(SubscriberPtrWrapper &, const pt::ptime &,
                               const Security::Request &, const bool &);
   const boost::function<CallbackProto> &callback =
@@ -216,7 +222,7 @@ void SubscriptionsManager::SubscribeToSecurityContractSwitching(
     slotConnections.emplace_back(connection);
   } catch (...) {
     try {
-      connection.disconnect();
+      connection.Disconnect();
     } catch (...) {
       AssertFailNoException();
       throw;
@@ -230,7 +236,7 @@ void SubscriptionsManager::SubscribeToSecurityContractSwitching(
 void SubscriptionsManager::SubscribeToSecurityServiceEvents(
     Security &security,
     const SubscriberPtrWrapper &subscriber,
-    std::list<sig::connection> &slotConnections) {
+    std::list<SlotConnection> &slotConnections) {
   const auto slot = Security::ServiceEventSlot(
       boost::bind(&Dispatcher::SignalSecurityServiceEvents, &m_dispatcher,
                   subscriber, _1, boost::ref(security), _2));
@@ -239,7 +245,7 @@ void SubscriptionsManager::SubscribeToSecurityServiceEvents(
     slotConnections.emplace_back(connection);
   } catch (...) {
     try {
-      connection.disconnect();
+      connection.Disconnect();
     } catch (...) {
       AssertFailNoException();
       throw;
@@ -254,7 +260,7 @@ void SubscriptionsManager::SubscribeToLevel1Updates(Security &security,
   Assert(!IsActive());
   Subscribe(security, strategy,
             [this](Security &security, const SubscriberPtrWrapper &subscriber,
-                   std::list<sig::connection> &slotConnections) {
+                   std::list<SlotConnection> &slotConnections) {
               SubscribeToLevel1Updates(security, subscriber, slotConnections);
             });
 }
@@ -264,7 +270,7 @@ void SubscriptionsManager::SubscribeToLevel1Ticks(Security &security,
   Assert(!IsActive());
   Subscribe(security, strategy,
             [this](Security &security, const SubscriberPtrWrapper &subscriber,
-                   std::list<sig::connection> &slotConnections) {
+                   std::list<SlotConnection> &slotConnections) {
               SubscribeToLevel1Ticks(security, subscriber, slotConnections);
             });
 }
@@ -274,7 +280,7 @@ void SubscriptionsManager::SubscribeToTrades(Security &security,
   Assert(!IsActive());
   Subscribe(security, subscriber,
             [this](Security &security, const SubscriberPtrWrapper &subscriber,
-                   std::list<sig::connection> &slotConnections) {
+                   std::list<SlotConnection> &slotConnections) {
               SubscribeToTrades(security, subscriber, slotConnections);
             });
 }
@@ -284,7 +290,7 @@ void SubscriptionsManager::SubscribeToBrokerPositionUpdates(
   Assert(!IsActive());
   Subscribe(security, subscriber,
             [this](Security &security, const SubscriberPtrWrapper &subscriber,
-                   std::list<sig::connection> &slotConnections) {
+                   std::list<SlotConnection> &slotConnections) {
               SubscribeToBrokerPositionUpdates(security, subscriber,
                                                slotConnections);
             });
@@ -295,7 +301,7 @@ void SubscriptionsManager::SubscribeToBars(Security &security,
   Assert(!IsActive());
   Subscribe(security, subscriber,
             [this](Security &security, const SubscriberPtrWrapper &subscriber,
-                   std::list<sig::connection> &slotConnections) {
+                   std::list<SlotConnection> &slotConnections) {
               SubscribeToBars(security, subscriber, slotConnections);
             });
 }
@@ -305,7 +311,7 @@ void SubscriptionsManager::SubscribeToBookUpdateTicks(Security &security,
   Assert(!IsActive());
   Subscribe(security, subscriber,
             [this](Security &security, const SubscriberPtrWrapper &subscriber,
-                   std::list<sig::connection> &slotConnections) {
+                   std::list<SlotConnection> &slotConnections) {
               SubscribeToBookUpdateTicks(security, subscriber, slotConnections);
             });
 }
@@ -315,7 +321,7 @@ void SubscriptionsManager::SubscribeToSecurityContractSwitching(
   Assert(!IsActive());
   Subscribe(security, subscriber,
             [this](Security &security, const SubscriberPtrWrapper &subscriber,
-                   std::list<sig::connection> &slotConnections) {
+                   std::list<SlotConnection> &slotConnections) {
               SubscribeToSecurityContractSwitching(security, subscriber,
                                                    slotConnections);
             });
@@ -326,7 +332,7 @@ void SubscriptionsManager::SubscribeToSecurityServiceEvents(
   Assert(!IsActive());
   Subscribe(security, subscriber,
             [this](Security &security, const SubscriberPtrWrapper &subscriber,
-                   std::list<sig::connection> &slotConnections) {
+                   std::list<SlotConnection> &slotConnections) {
               SubscribeToSecurityServiceEvents(security, subscriber,
                                                slotConnections);
             });
@@ -344,6 +350,7 @@ void SubscriptionsManager::Subscribe(Security &security,
     auto slotConnections = m_slotConnections;
     const auto positionUpdateConnection = strategy.SubscribeToPositionsUpdates(
         boost::bind(&Dispatcher::SignalPositionUpdate, &m_dispatcher,
+                    boost::ref(m_dispatcher.GetEventQueueGroup(strategy)),
                     SubscriberPtrWrapper(strategy), _1));
 
     try {
@@ -20,7 +20,7 @@ class SubscriptionsManager : private boost::noncopyable {
  private:
   typedef std::function<void(Security &,
                              const SubscriberPtrWrapper &,
-                             std::list<boost::signals2::connection> &)>
+                             std::list<Lib::SlotConnection> &)>
       SubscribeImpl;
 
  public:
@@ -57,35 +57,35 @@ class SubscriptionsManager : private boost::noncopyable {
   void SubscribeToSecurityContractSwitching(
       Security &,
       const SubscriberPtrWrapper &,
-      std::list<boost::signals2::connection> &);
+      std::list<Lib::SlotConnection> &);
   void SubscribeToLevel1Updates(Security &,
                                 const SubscriberPtrWrapper &,
-                                std::list<boost::signals2::connection> &);
+                                std::list<Lib::SlotConnection> &);
   void SubscribeToLevel1Ticks(Security &,
                               const SubscriberPtrWrapper &,
-                              std::list<boost::signals2::connection> &);
+                              std::list<Lib::SlotConnection> &);
   void SubscribeToTrades(Security &,
                          const SubscriberPtrWrapper &,
-                         std::list<boost::signals2::connection> &);
+                         std::list<Lib::SlotConnection> &);
   void SubscribeToBrokerPositionUpdates(
       Security &,
       const SubscriberPtrWrapper &,
-      std::list<boost::signals2::connection> &);
+      std::list<Lib::SlotConnection> &);
   void SubscribeToBars(Security &,
                        const SubscriberPtrWrapper &,
-                       std::list<boost::signals2::connection> &);
+                       std::list<Lib::SlotConnection> &);
   void SubscribeToBookUpdateTicks(Security &,
                                   const SubscriberPtrWrapper &,
-                                  std::list<boost::signals2::connection> &);
+                                  std::list<Lib::SlotConnection> &);
   void SubscribeToSecurityServiceEvents(
       Security &,
       const SubscriberPtrWrapper &,
-      std::list<boost::signals2::connection> &);
+      std::list<Lib::SlotConnection> &);
 
   void Subscribe(Security &, Strategy &, const SubscribeImpl &);
 
   Dispatcher m_dispatcher;
-  std::list<boost::signals2::connection> m_slotConnections;
+  std::list<Lib::SlotConnection> m_slotConnections;
 
   std::set<const Strategy *> m_subscribedStrategies;
 };
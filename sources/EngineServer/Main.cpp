@@ -10,6 +10,8 @@
 
 #include "Prec.hpp"
 #include "Engine/Engine.hpp"
+#include "Core/MarketDataCapture.hpp"
+#include "ParameterSweep.hpp"
 
 using namespace trdk::Lib;
 using namespace trdk::EngineServer;
@@ -32,6 +34,12 @@ const char *const debugShort = "d";
 const char *const standalone = "standalone";
 const char *const standaloneShort = "s";
 
+const char *const convertMarketData = "convert_md";
+const char *const convertMarketDataShort = "c";
+
+const char *const sweep = "sweep";
+const char *const sweepShort = "w";
+
 const char *const version = "version";
 const char *const versionShort = "v";
 
@@ -144,6 +152,57 @@ bool DebugStrategy(int argc, const char *argv[]) {
   return result;
 }
 
+bool ConvertMarketData(int argc, const char *argv[]) {
+  if (argc < 3 || !strlen(argv[2])) {
+    std::cerr << "No market data log file specified." << std::endl;
+    return false;
+  }
+  const fs::path source = Normalize(GetExeWorkingDir() / argv[2]);
+  fs::path destination;
+  if (argc > 3 && strlen(argv[3])) {
+    destination = Normalize(GetExeWorkingDir() / argv[3]);
+  } else {
+    destination = source;
+    destination.replace_extension("csv");
+  }
+
+  try {
+    const boost::iostreams::mapped_file_source file(source.string());
+    trdk::MarketDataCapture::Reader reader(file.data(),
+                                           file.data() + file.size());
+    std::ofstream csv(destination.string().c_str(),
+                      std::ios::out | std::ios::trunc);
+    if (!csv) {
+      std::cerr << "Failed to open " << destination << "." << std::endl;
+      return false;
+    }
+    trdk::MarketDataCapture::ConvertToCsv(reader, csv);
+  } catch (const std::exception &ex) {
+    std::cerr << "Failed to convert market data log " << source << ": \""
+              << ex.what() << "\"." << std::endl;
+    return false;
+  }
+
+  std::cout << source << " converted to " << destination << "." << std::endl;
+  return true;
+}
+
+bool RunParameterSweep(int argc, const char *argv[]) {
+  if (argc < 3 || !strlen(argv[2])) {
+    std::cerr << "No parameter sweep specification file specified."
+              << std::endl;
+    return false;
+  }
+  try {
+    ParameterSweep sweep(Normalize(GetExeWorkingDir() / argv[2]));
+    return sweep.Run();
+  } catch (const std::exception &ex) {
+    std::cerr << "Failed to run parameter sweep: \"" << ex.what() << "\"."
+              << std::endl;
+    return false;
+  }
+}
+
 bool ShowVersion(int /*argc*/, const char * /*argv*/ []) {
   std::cout << TRDK_NAME " " TRDK_BUILD_IDENTITY << std::endl;
   return true;
@@ -175,6 +234,15 @@ bool ShowHelp(int argc, const char *argv[]) {
       << " \"path to configuration file or path to config.json directory\""
       << std::endl
       << std::endl
+      << "    " << convertMarketData << " (or " << convertMarketDataShort
+      << ")"
+         " \"path to binary market data log\""
+         " [\"path to CSV file, the log path with .csv by default\"]"
+      << std::endl
+      << std::endl
+      << "    " << sweep << " (or " << sweepShort << ")"
+      << " \"path to parameter sweep specification file\"" << std::endl
+      << std::endl
       << "    " << help << " (or " << helpShort << ")" << std::endl
       << std::endl
       << "Options:" << std::endl
@@ -276,6 +344,20 @@ int main(int argc, const char *argv[]) {
       Verify(
           commands.emplace(std::make_pair(debugShort, &DebugStrategy)).second);
 
+      Verify(commands
+                 .emplace(std::make_pair(convertMarketData,
+                                         &ConvertMarketData))
+                 .second);
+      Verify(commands
+                 .emplace(std::make_pair(convertMarketDataShort,
+                                         &ConvertMarketData))
+                 .second);
+
+      Verify(
+          commands.emplace(std::make_pair(sweep, &RunParameterSweep)).second);
+      Verify(commands.emplace(std::make_pair(sweepShort, &RunParameterSweep))
+                 .second);
+
       Verify(commands.emplace(std::make_pair(version, &ShowVersion)).second);
       Verify(
           commands.emplace(std::make_pair(versionShort, &ShowVersion)).second);
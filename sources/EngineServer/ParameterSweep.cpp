@@ -0,0 +1,460 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 21:15:02
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "ParameterSweep.hpp"
+#include "Core/DropCopy.hpp"
+#include "Core/MarketDataCapture.hpp"
+#include "Engine/Engine.hpp"
+
+using namespace trdk;
+using namespace trdk::Lib;
+using namespace trdk::EngineServer;
+
+namespace fs = boost::filesystem;
+namespace pt = boost::posix_time;
+namespace ptr = boost::property_tree;
+namespace mdc = trdk::MarketDataCapture;
+
+namespace {
+
+struct Statistics {
+  size_t numberOfOperations;
+  std::array<size_t, Pnl::numberOfResults> numberOfResults;
+  size_t numberOfOrders;
+  size_t numberOfOrderErrors;
+  size_t numberOfTrades;
+  std::map<std::string, Pnl::SymbolData> pnl;
+
+  Statistics()
+      : numberOfOperations(0),
+        numberOfOrders(0),
+        numberOfOrderErrors(0),
+        numberOfTrades(0) {
+    numberOfResults.fill(0);
+  }
+};
+
+//! Collects replay statistics from the Drop Copy stream.
+class StatisticsDropCopy : public DropCopy {
+ public:
+  ~StatisticsDropCopy() override = default;
+
+ public:
+  Statistics GetStatistics() const {
+    const boost::mutex::scoped_lock lock(m_mutex);
+    return m_statistics;
+  }
+
+ public:
+  void Flush() override {}
+  void Dump() override {}
+
+  void CopySubmittedOrder(const OrderId &,
+                          const pt::ptime &,
+                          const Security &,
+                          const Currency &,
+                          const TradingSystem &,
+                          const OrderSide &,
+                          const Qty &,
+                          const boost::optional<Price> &,
+                          const TimeInForce &) override {
+    const boost::mutex::scoped_lock lock(m_mutex);
+    ++m_statistics.numberOfOrders;
+  }
+  void CopySubmittedOrder(const OrderId &,
+                          const pt::ptime &,
+                          const Position &,
+                          const OrderSide &,
+                          const Qty &,
+                          const boost::optional<Price> &,
+                          const TimeInForce &) override {
+    const boost::mutex::scoped_lock lock(m_mutex);
+    ++m_statistics.numberOfOrders;
+  }
+  void CopyOrderSubmitError(const pt::ptime &,
+                            const Security &,
+                            const Currency &,
+                            const TradingSystem &,
+                            const OrderSide &,
+                            const Qty &,
+                            const boost::optional<Price> &,
+                            const TimeInForce &,
+                            const std::string &) override {
+    const boost::mutex::scoped_lock lock(m_mutex);
+    ++m_statistics.numberOfOrderErrors;
+  }
+  void CopyOrderSubmitError(const pt::ptime &,
+                            const Position &,
+                            const OrderSide &,
+                            const Qty &,
+                            const boost::optional<Price> &,
+                            const TimeInForce &,
+                            const std::string &) override {
+    const boost::mutex::scoped_lock lock(m_mutex);
+    ++m_statistics.numberOfOrderErrors;
+  }
+  void CopyOrderStatus(const OrderId &,
+                       const TradingSystem &,
+                       const pt::ptime &,
+                       const OrderStatus &,
+                       const Qty &) override {}
+  void CopyOrder(const OrderId &,
+                 const TradingSystem &,
+                 const std::string &,
+                 const OrderStatus &,
+                 const Qty &,
+                 const Qty &,
+                 const boost::optional<Price> &,
+                 const OrderSide &,
+                 const TimeInForce &,
+                 const pt::ptime &,
+                 const pt::ptime &) override {}
+
+  void CopyTrade(const pt::ptime &,
+                 const boost::optional<std::string> &,
+                 const OrderId &,
+                 const TradingSystem &,
+                 const Price &,
+                 const Qty &) override {
+    const boost::mutex::scoped_lock lock(m_mutex);
+    ++m_statistics.numberOfTrades;
+  }
+
+  void CopyOperationStart(const boost::uuids::uuid &,
+                          const pt::ptime &,
+                          const Strategy &) override {
+    const boost::mutex::scoped_lock lock(m_mutex);
+    ++m_statistics.numberOfOperations;
+  }
+  void CopyOperationUpdate(const boost::uuids::uuid &,
+                           const Pnl::Data &) override {}
+  void CopyOperationEnd(const boost::uuids::uuid &,
+                        const pt::ptime &,
+                        std::unique_ptr<Pnl> &&pnl) override {
+    const boost::mutex::scoped_lock lock(m_mutex);
+    ++m_statistics.numberOfResults[pnl->GetResult()];
+    for (const auto &symbol : pnl->GetData()) {
+      auto &result = m_statistics.pnl[symbol.first];
+      result.financialResult += symbol.second.financialResult;
+      result.commission += symbol.second.commission;
+    }
+  }
+
+  void CopyBook(const Security &, const PriceBook &) override {}
+
+  void CopyBar(const Security &, const Bar &) override {}
+
+  void CopyLevel1(const Security &,
+                  const pt::ptime &,
+                  const Level1TickValue &) override {}
+  void CopyLevel1(const Security &,
+                  const pt::ptime &,
+                  const Level1TickValue &,
+                  const Level1TickValue &) override {}
+  void CopyLevel1(const Security &,
+                  const pt::ptime &,
+                  const Level1TickValue &,
+                  const Level1TickValue &,
+                  const Level1TickValue &) override {}
+  void CopyLevel1(const Security &,
+                  const pt::ptime &,
+                  const Level1TickValue &,
+                  const Level1TickValue &,
+                  const Level1TickValue &,
+                  const Level1TickValue &) override {}
+  void CopyLevel1(const Security &,
+                  const pt::ptime &,
+                  const std::vector<Level1TickValue> &) override {}
+
+  void CopyBalance(const TradingSystem &,
+                   const std::string &,
+                   const Volume &,
+                   const Volume &) override {}
+
+ private:
+  mutable boost::mutex m_mutex;
+  Statistics m_statistics;
+};
+
+struct Parameter {
+  std::string path;
+  std::vector<std::string> values;
+};
+
+struct Replay {
+  size_t index;
+  //! Value indexes, in the order of parameters.
+  std::vector<size_t> values;
+  fs::path dir;
+  pt::time_duration duration;
+  std::string error;
+  Statistics statistics;
+};
+
+fs::path ResolvePath(const fs::path &base, const std::string &path) {
+  return Normalize(fs::path(path), base);
+}
+}  // namespace
+
+class ParameterSweep::Implementation : private boost::noncopyable {
+ public:
+  fs::path m_config;
+  fs::path m_output;
+  size_t m_numberOfThreads;
+  std::vector<mdc::SharedFile> m_marketData;
+  std::vector<Parameter> m_parameters;
+  std::vector<Replay> m_replays;
+
+  boost::atomic_size_t m_nextReplay;
+  size_t m_numberOfCompleted;
+  boost::mutex m_outputMutex;
+
+  explicit Implementation(const fs::path &specFile)
+      : m_nextReplay(0), m_numberOfCompleted(0) {
+    ptr::ptree spec;
+    try {
+      ptr::read_json(specFile.string(), spec);
+      const auto &base = specFile.parent_path();
+
+      m_config = ResolvePath(base, spec.get<std::string>("config"));
+      {
+        const auto &output = spec.get_optional<std::string>("output");
+        m_output = output ? ResolvePath(base, *output)
+                          : base / specFile.stem();
+      }
+      m_numberOfThreads = spec.get<size_t>(
+          "threads", std::max(1u, boost::thread::hardware_concurrency()));
+      if (!m_numberOfThreads) {
+        throw Exception("Number of parameter sweep threads is 0");
+      }
+
+      {
+        const auto &marketData = spec.get_child_optional("marketData");
+        if (marketData) {
+          for (const auto &node : *marketData) {
+            LoadMarketData(
+                ResolvePath(base, node.second.get_value<std::string>()));
+          }
+        }
+      }
+
+      for (const auto &node : spec.get_child("parameters")) {
+        Parameter parameter{node.first};
+        for (const auto &value : node.second) {
+          parameter.values.emplace_back(value.second.get_value<std::string>());
+        }
+        if (parameter.path.empty() || parameter.values.empty()) {
+          throw Exception(
+              "Parameter sweep parameter has no path or has no values");
+        }
+        m_parameters.emplace_back(std::move(parameter));
+      }
+    } catch (const ptr::ptree_error &ex) {
+      boost::format error(
+          R"(Failed to read parameter sweep specification: "%1%")");
+      error % ex.what();
+      throw Exception(error.str().c_str());
+    }
+
+    CreateReplays();
+  }
+
+  void LoadMarketData(const fs::path &path) {
+    if (!fs::is_directory(path)) {
+      m_marketData.emplace_back(mdc::OpenSharedFile(path));
+      return;
+    }
+    for (fs::directory_iterator it(path), end; it != end; ++it) {
+      if (fs::is_regular_file(it->status()) &&
+          it->path().extension() == ".trdkmd") {
+        m_marketData.emplace_back(mdc::OpenSharedFile(it->path()));
+      }
+    }
+  }
+
+  void CreateReplays() {
+    std::vector<size_t> values(m_parameters.size(), 0);
+    for (;;) {
+      m_replays.emplace_back();
+      auto &replay = m_replays.back();
+      replay.index = m_replays.size();
+      replay.values = values;
+      replay.dir = m_output / boost::lexical_cast<std::string>(replay.index);
+
+      // Next combination, the last parameter changes first:
+      size_t i = values.size();
+      for (; i > 0; --i) {
+        if (++values[i - 1] < m_parameters[i - 1].values.size()) {
+          break;
+        }
+        values[i - 1] = 0;
+      }
+      if (!i) {
+        break;
+      }
+    }
+  }
+
+  void RunReplays() {
+    for (;;) {
+      const size_t index = m_nextReplay++;
+      if (index >= m_replays.size()) {
+        break;
+      }
+      auto &replay = m_replays[index];
+      const auto &startTime = pt::microsec_clock::universal_time();
+      try {
+        replay.statistics = RunReplay(replay);
+      } catch (const std::exception &ex) {
+        replay.error = ex.what();
+      }
+      replay.duration = pt::microsec_clock::universal_time() - startTime;
+
+      const boost::mutex::scoped_lock lock(m_outputMutex);
+      ++m_numberOfCompleted;
+      std::cout << "Replay " << replay.index << " (" << m_numberOfCompleted
+                << "/" << m_replays.size() << ") ";
+      if (replay.error.empty()) {
+        std::cout << "completed in " << replay.duration << ": "
+                  << replay.statistics.numberOfOperations << " operation(s).";
+      } else {
+        std::cout << "failed: \"" << replay.error << "\".";
+      }
+      std::cout << std::endl;
+    }
+  }
+
+  Statistics RunReplay(const Replay &replay) const {
+    fs::create_directories(replay.dir);
+
+    const auto &configFile = replay.dir / "config.json";
+    {
+      ptr::ptree config;
+      ptr::read_json(m_config.string(), config);
+      config.put("general.isReplayMode", true);
+      config.put("general.isInlineDispatchingEnabled", true);
+      for (size_t i = 0; i < m_parameters.size(); ++i) {
+        const auto &parameter = m_parameters[i];
+        config.put(ptr::ptree::path_type(parameter.path, '.'),
+                   parameter.values[replay.values[i]]);
+      }
+      ptr::write_json(configFile.string(), config);
+    }
+
+    StatisticsDropCopy dropCopy;
+    boost::mutex stateMutex;
+    boost::condition_variable stateCondition;
+    boost::optional<Context::State> state;
+    std::string error;
+    {
+      Engine::Engine engine(
+          configFile, replay.dir / "logs",
+          [&](const Context::State &newState, const std::string *message) {
+            {
+              const boost::mutex::scoped_lock lock(stateMutex);
+              state = newState;
+              if (newState == Context::STATE_DISPATCHER_TASK_STOPPED_ERROR ||
+                  newState == Context::STATE_STRATEGY_BLOCKED) {
+                error = message ? *message : "Unknown error";
+              }
+            }
+            stateCondition.notify_all();
+          },
+          dropCopy, [](const std::string &) {},
+          [](const std::string &) { return false; },
+          [](Engine::Context::Log &) {});
+
+      boost::mutex::scoped_lock lock(stateMutex);
+      stateCondition.wait(lock, [&]() {
+        static_assert(Context::numberOfStates == 4, "List changed.");
+        return state && *state != Context::STATE_ENGINE_STARTED;
+      });
+    }
+    if (!error.empty()) {
+      throw Exception(error.c_str());
+    }
+    return dropCopy.GetStatistics();
+  }
+
+  void WriteReport() const {
+    const auto &path = m_output / "report.csv";
+    std::ofstream report(path.string().c_str(),
+                         std::ios::out | std::ios::trunc);
+    if (!report) {
+      boost::format error("Failed to open parameter sweep report %1%");
+      error % path;
+      throw Exception(error.str().c_str());
+    }
+
+    report << "replay";
+    for (const auto &parameter : m_parameters) {
+      report << ',' << parameter.path;
+    }
+    report << ",duration,error,operations,completed,profit,loss,failed,orders"
+              ",order errors,trades,PnL"
+           << std::endl;
+
+    for (const auto &replay : m_replays) {
+      report << replay.index;
+      for (size_t i = 0; i < m_parameters.size(); ++i) {
+        report << ',' << m_parameters[i].values[replay.values[i]];
+      }
+      const auto &statistics = replay.statistics;
+      report << ',' << replay.duration << ",\"" << replay.error << "\","
+             << statistics.numberOfOperations << ','
+             << statistics.numberOfResults[Pnl::RESULT_COMPLETED] << ','
+             << statistics.numberOfResults[Pnl::RESULT_PROFIT] << ','
+             << statistics.numberOfResults[Pnl::RESULT_LOSS] << ','
+             << statistics.numberOfResults[Pnl::RESULT_ERROR] << ','
+             << statistics.numberOfOrders << ','
+             << statistics.numberOfOrderErrors << ','
+             << statistics.numberOfTrades << ",\"";
+      // Symbol, financial result and commission:
+      for (const auto &symbol : statistics.pnl) {
+        report << symbol.first << ' ' << symbol.second.financialResult << ' '
+               << symbol.second.commission << ';';
+      }
+      report << '"' << std::endl;
+    }
+
+    std::cout << "Report: " << path << "." << std::endl;
+  }
+};
+
+ParameterSweep::ParameterSweep(const fs::path &specFile)
+    : m_pimpl(boost::make_unique<Implementation>(specFile)) {}
+
+ParameterSweep::~ParameterSweep() = default;
+
+bool ParameterSweep::Run() {
+  const auto numberOfThreads =
+      std::min(m_pimpl->m_numberOfThreads, m_pimpl->m_replays.size());
+  std::cout << "Running " << m_pimpl->m_replays.size() << " replay(s) by "
+            << numberOfThreads << " thread(s), " << m_pimpl->m_marketData.size()
+            << " market data file(s) preloaded..." << std::endl;
+
+  fs::create_directories(m_pimpl->m_output);
+  {
+    boost::thread_group threads;
+    for (size_t i = 0; i < numberOfThreads; ++i) {
+      threads.create_thread([this]() { m_pimpl->RunReplays(); });
+    }
+    threads.join_all();
+  }
+  m_pimpl->WriteReport();
+
+  for (const auto &replay : m_pimpl->m_replays) {
+    if (!replay.error.empty()) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,56 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 21:14:37
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#pragma once
+
+namespace trdk {
+namespace EngineServer {
+
+//! Replays the same market data with a grid of strategy parameters.
+/**
+ * The grid specification is a JSON file:
+ * {
+ *   "config": "path to the engine configuration file",
+ *   "output": "path to the output directory, spec. file name by default",
+ *   "threads": 4,
+ *   "marketData": ["capture file or directory with capture files", ...],
+ *   "parameters": {
+ *     "strategies.{ID}.config.ma.numberOfFastPeriods": [5, 10, 20],
+ *     "strategies.{ID}.config.ma.numberOfSlowPeriods": [50, 100]
+ *   }
+ * }
+ * Each parameter is a configuration path with the list of values, the sweep
+ * runs one replay for each combination of values. Replays are independent
+ * contexts in replay mode with inline dispatching, "threads" of them work at
+ * the same time (number of cores by default). Capture files from "marketData"
+ * are mapped once and are shared by all replays.
+ *
+ * Each replay has its own directory in the output directory with the
+ * configuration and logs, operations statistics and PnL of all replays are
+ * written into "report.csv".
+ */
+class ParameterSweep : private boost::noncopyable {
+ public:
+  explicit ParameterSweep(const boost::filesystem::path &specFile);
+  ~ParameterSweep();
+
+ public:
+  //! Runs all replays and writes the report.
+  /**
+   * @return false if one or more replays failed.
+   */
+  bool Run();
+
+ private:
+  class Implementation;
+  std::unique_ptr<Implementation> m_pimpl;
+};
+}  // namespace EngineServer
+}  // namespace trdk
@@ -13,4 +13,6 @@
 #include "Common/Common.hpp"
 #include "Engine/Fwd.hpp"
 #include "Fwd.hpp"
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/property_tree/json_parser.hpp>
 #include <boost/regex.hpp>
@@ -19,8 +19,8 @@ MarketDataConnection::MarketDataConnection()
     : WebSocketConnection("stream.binance.com") {}
 
 void MarketDataConnection::Start(
-    const boost::unordered_map<ProductId, boost::shared_ptr<Rest::Security>>
-        &list,
+    const boost::unordered_map<ProductId, SecuritySubscription> &list,
+    const bool isFullBook,
     const Events &events) {
   if (list.empty()) {
     return;
@@ -30,7 +30,8 @@ void MarketDataConnection::Start(
     if (!request.empty()) {
       request += '/';
     }
-    request += boost::to_lower_copy(security.first) + "@depth5";
+    request += boost::to_lower_copy(security.first) +
+               (isFullBook ? "@depth@100ms" : "@depth5");
   }
   Handshake("/stream?streams=" + request);
   WebSocketConnection::Start(events);
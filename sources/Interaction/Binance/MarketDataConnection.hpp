@@ -20,8 +20,13 @@ class MarketDataConnection : public Lib::WebSocketConnection {
  public:
   MarketDataConnection();
   void Connect();
-  void Start(const boost::unordered_map<ProductId,
-                                        boost::shared_ptr<Rest::Security>> &,
+  //! Starts price book streams.
+  /**
+   * @param isFullBook If true - diff depth streams will be used, partial
+   *                   depth streams with top levels otherwise.
+   */
+  void Start(const boost::unordered_map<ProductId, SecuritySubscription> &,
+             bool isFullBook,
              const Events &);
 };
 }  // namespace Binance
@@ -11,6 +11,7 @@
 #include "Prec.hpp"
 #include "MarketDataSource.hpp"
 #include "MarketDataConnection.hpp"
+#include "Request.hpp"
 #include "Session.hpp"
 
 using namespace trdk;
@@ -29,9 +30,23 @@ b::MarketDataSource::MarketDataSource(const App &,
                                       std::string title,
                                       const ptr::ptree &conf)
     : Base(context, std::move(instanceName), std::move(title)),
-      m_settings(conf, GetLog()) {}
+      m_settings(conf, GetLog()),
+      m_isFullBookEnabled(conf.get<bool>("config.isFullBookEnabled", false)),
+      m_pollingTask(m_isFullBookEnabled
+                        ? boost::make_unique<PollingTask>(
+                              m_settings.pollingSettings, GetLog())
+                        : nullptr) {
+  GetLog().Info("Full price book: %1%.",
+                m_isFullBookEnabled ? "enabled" : "disabled");
+}
 
 b::MarketDataSource::~MarketDataSource() {
+  try {
+    m_pollingTask.reset();
+  } catch (...) {
+    AssertFailNoException();
+    terminate();
+  }
   {
     boost::mutex::scoped_lock lock(m_connectionMutex);
     auto connection = std::move(m_connection);
@@ -102,15 +117,17 @@ trdk::Security &b::MarketDataSource::CreateNewSecurityObject(
   }
   const auto &result = m_securities.emplace(
       product->second.id,
-      boost::make_shared<Rest::Security>(GetContext(), symbol, *this,
-                                         Rest::Security::SupportedLevel1Types()
-                                             .set(LEVEL1_TICK_BID_PRICE)
-                                             .set(LEVEL1_TICK_BID_QTY)
-                                             .set(LEVEL1_TICK_ASK_PRICE)
-                                             .set(LEVEL1_TICK_BID_QTY)));
+      SecuritySubscription(boost::make_shared<Rest::Security>(
+          GetContext(), symbol, *this,
+          Rest::Security::SupportedLevel1Types()
+              .set(LEVEL1_TICK_BID_PRICE)
+              .set(LEVEL1_TICK_BID_QTY)
+              .set(LEVEL1_TICK_ASK_PRICE)
+              .set(LEVEL1_TICK_BID_QTY))));
   Assert(result.second);
-  result.first->second->SetTradingSessionState(pt::not_a_date_time, true);
-  return *result.first->second;
+  result.first->second.security->SetTradingSessionState(pt::not_a_date_time,
+                                                        true);
+  return *result.first->second.security;
 }
 
 const boost::unordered_set<std::string>
@@ -120,44 +137,36 @@ const boost::unordered_set<std::string>
 
 namespace {
 
-#pragma warning(push)
-#pragma warning(disable : 4702)  // Warning	C4702	unreachable code
-template <Level1TickType priceType, Level1TickType qtyType, typename Source>
+template <Level1TickType priceType, Level1TickType qtyType>
 boost::optional<std::pair<Level1TickValue, Level1TickValue>> ReadTopPrice(
-    const Source &source) {
-  if (!source) {
+    const boost::optional<Json::Value> &source) {
+  if (!source || !source->GetSize()) {
     return boost::none;
   }
-  boost::optional<Level1TickValue> price;
-  boost::optional<Level1TickValue> qty;
-  for (const auto &level : *source) {
-    for (const auto &node : level.second) {
-      const auto &value = node.second.template get_value<Double>();
-      Assert(!qty);
-      if (!price) {
-        price = Level1TickValue::Create<priceType>(value);
-      } else {
-        qty = Level1TickValue::Create<qtyType>(value);
-        break;
-      }
-    }
-    break;
-  }
-  if (!qty) {
-    Assert(!price);
-    return boost::none;
+  const auto &level = (*source)[0];
+  return std::make_pair(
+      Level1TickValue::Create<priceType>(level[0].GetDouble()),
+      Level1TickValue::Create<qtyType>(level[1].GetDouble()));
+}
+
+void ReadBook(const OrderSide &side,
+              const Json::Value &source,
+              PriceBookBuilder &book) {
+  for (const auto &level : source) {
+    book.Update(side, level[0].GetDouble(), level[1].GetDouble());
   }
-  Assert(price);
-  return std::make_pair(*price, *qty);
 }
-#pragma warning(pop)
+
+//! Older diffs are dropped if the snapshot is not received for a long time,
+//! the snapshot will have them.
+const size_t maxNumberOfPendingBookDiffs = 1000;
 }  // namespace
 
 void b::MarketDataSource::UpdatePrices(const pt::ptime &time,
-                                       const ptr::ptree &message,
+                                       const Json::Value &message,
                                        const Milestones &delayMeasurement) {
-  auto symbol = message.get<std::string>("stream");
-  symbol.resize(symbol.find('@'));
+  const auto &stream = message["stream"].GetRawString();
+  auto symbol = stream.substr(0, stream.find('@')).to_string();
   boost::to_upper(symbol);
   const auto &securityIt = m_securities.find(symbol);
   if (securityIt == m_securities.cend()) {
@@ -166,69 +175,175 @@ void b::MarketDataSource::UpdatePrices(const pt::ptime &time,
     throw Exception(error.str().c_str());
   }
 
-  auto &security = *securityIt->second;
-
-  const auto &data = message.get_child("data");
+  const auto &data = message["data"];
   try {
-    const auto &bid = ReadTopPrice<LEVEL1_TICK_BID_PRICE, LEVEL1_TICK_BID_QTY>(
-        data.get_child_optional("bids"));
-    const auto &ask = ReadTopPrice<LEVEL1_TICK_ASK_PRICE, LEVEL1_TICK_ASK_QTY>(
-        data.get_child_optional("asks"));
-
-    if (bid && ask) {
-      security.SetLevel1(time, bid->first, bid->second, ask->first, ask->second,
-                         delayMeasurement);
-      security.SetOnline(pt::not_a_date_time, true);
+    if (m_isFullBookEnabled) {
+      UpdateBook(time, data, securityIt->second, delayMeasurement);
     } else {
-      security.SetOnline(pt::not_a_date_time, false);
-      if (bid) {
-        security.SetLevel1(time, bid->first, bid->second, delayMeasurement);
-      } else if (ask) {
-        security.SetLevel1(time, ask->first, ask->second, delayMeasurement);
-      }
+      UpdateTopPrices(time, data, *securityIt->second.security,
+                      delayMeasurement);
     }
-
   } catch (const std::exception &ex) {
     boost::format error(R"(Failed to read order book: "%1%" ("%2%").)");
-    error % ex.what()                            // 1
-        % Lib::ConvertToString(message, false);  // 2
+    error % ex.what()              // 1
+        % message.GetRawString();  // 2
     throw Exception(error.str().c_str());
   }
 }
 
+void b::MarketDataSource::UpdateTopPrices(const pt::ptime &time,
+                                          const Json::Value &data,
+                                          Rest::Security &security,
+                                          const Milestones &delayMeasurement) {
+  const auto &bid = ReadTopPrice<LEVEL1_TICK_BID_PRICE, LEVEL1_TICK_BID_QTY>(
+      data.Find("bids"));
+  const auto &ask = ReadTopPrice<LEVEL1_TICK_ASK_PRICE, LEVEL1_TICK_ASK_QTY>(
+      data.Find("asks"));
+
+  if (bid && ask) {
+    security.SetLevel1(time, bid->first, bid->second, ask->first, ask->second,
+                       delayMeasurement);
+    security.SetOnline(pt::not_a_date_time, true);
+  } else {
+    security.SetOnline(pt::not_a_date_time, false);
+    if (bid) {
+      security.SetLevel1(time, bid->first, bid->second, delayMeasurement);
+    } else if (ask) {
+      security.SetLevel1(time, ask->first, ask->second, delayMeasurement);
+    }
+  }
+}
+
+void b::MarketDataSource::UpdateBook(const pt::ptime &time,
+                                     const Json::Value &data,
+                                     SecuritySubscription &subscription,
+                                     const Milestones &delayMeasurement) {
+  auto &book = subscription.book;
+  if (!book.IsSynchronized()) {
+    if (!subscription.snapshot) {
+      RequestBookSnapshot(data["s"].GetString(), subscription);
+    }
+    if (!subscription.snapshot->isReady.load(boost::memory_order_acquire)) {
+      // The snapshot is requested by the polling task to not block the stream,
+      // diffs are applied after the snapshot.
+      if (subscription.pendingDiffs.size() >= maxNumberOfPendingBookDiffs) {
+        subscription.pendingDiffs.pop_front();
+      }
+      subscription.pendingDiffs.emplace_back(data.GetRawString().to_string());
+      return;
+    }
+    ApplyBookSnapshot(subscription);
+  }
+  ApplyBookDiff(data, subscription);
+  book.Flush(time, delayMeasurement);
+}
+
+void b::MarketDataSource::ApplyBookDiff(const Json::Value &data,
+                                        SecuritySubscription &subscription) {
+  auto &book = subscription.book;
+  const PriceBookBuilder::SequenceNumber firstUpdateId = data["U"].GetUInt();
+  const PriceBookBuilder::SequenceNumber lastUpdateId = data["u"].GetUInt();
+  switch (book.CheckSequenceNumber(firstUpdateId, lastUpdateId)) {
+    case PriceBookBuilder::DIFF_CHECK_RESULT_ACTUAL:
+      ReadBook(ORDER_SIDE_BID, data["b"], book);
+      ReadBook(ORDER_SIDE_ASK, data["a"], book);
+      break;
+    case PriceBookBuilder::DIFF_CHECK_RESULT_SKIP:
+      break;
+    case PriceBookBuilder::DIFF_CHECK_RESULT_GAP:
+      GetLog().Warn(
+          "Price book update for %1% is lost (received %2%-%3%, expected "
+          "%4%), new snapshot will be requested.",
+          *subscription.security,          // 1
+          firstUpdateId,                   // 2
+          lastUpdateId,                    // 3
+          *book.GetSequenceNumber() + 1);  // 4
+      break;
+  }
+}
+
+void b::MarketDataSource::ApplyBookSnapshot(
+    SecuritySubscription &subscription) {
+  const auto snapshot = std::move(subscription.snapshot);
+  Assert(snapshot);
+  Assert(snapshot->isReady);
+  std::deque<std::string> pendingDiffs;
+  pendingDiffs.swap(subscription.pendingDiffs);
+
+  auto &book = subscription.book;
+  {
+    const auto &response = m_bookDocument.Parse(snapshot->response);
+    book.StartSnapshot(response["lastUpdateId"].GetUInt());
+    ReadBook(ORDER_SIDE_BID, response["bids"], book);
+    ReadBook(ORDER_SIDE_ASK, response["asks"], book);
+  }
+  // Diffs which are already in the snapshot are skipped by sequence numbers:
+  for (const auto &diff : pendingDiffs) {
+    ApplyBookDiff(m_bookDocument.Parse(diff), subscription);
+  }
+}
+
+void b::MarketDataSource::RequestBookSnapshot(
+    const ProductId &product, SecuritySubscription &subscription) {
+  Assert(m_pollingTask);
+  Assert(!subscription.snapshot);
+  const auto snapshot = boost::make_shared<BookSnapshot>();
+  subscription.snapshot = snapshot;
+
+  boost::format params("symbol=%1%&limit=%2%");
+  params % product                              // 1
+      % PriceBookBuilder::Book::GetMaxDepth();  // 2
+  const auto &request = params.str();
+
+  m_pollingTask->ReplaceTask(
+      "Book snapshot " + product, 1,
+      [this, snapshot, request]() {
+        if (!m_bookSnapshotSession) {
+          m_bookSnapshotSession = CreateSession(m_settings, false);
+        }
+        PublicRequest("v1/depth", request, GetContext(), GetLog())
+            .SendRaw(m_bookSnapshotSession, snapshot->response);
+        snapshot->isReady.store(true, boost::memory_order_release);
+        // The task is completed, an error repeats it at the next polling.
+        return false;
+      },
+      1, false);
+  m_pollingTask->AccelerateNextPolling();
+}
+
 void b::MarketDataSource::StartConnection(MarketDataConnection &connection) {
-  connection.Start(
-      m_securities,
-      MarketDataConnection::Events{
-          [this]() -> MarketDataConnection::EventInfo {
-            const auto &context = GetContext();
-            return {context.GetCurrentTime(),
-                    context.StartStrategyTimeMeasurement()};
-          },
-          [this](const MarketDataConnection::EventInfo &info,
-                 const ptr::ptree &message) {
-            UpdatePrices(info.readTime, message, info.delayMeasurement);
-          },
-          [this]() {
-            const boost::mutex::scoped_lock lock(m_connectionMutex);
-            if (!m_connection) {
-              GetLog().Debug("Disconnected.");
-              return;
-            }
-            const boost::shared_ptr<MarketDataConnection> connection(
-                std::move(m_connection));
-            GetLog().Warn("Connection lost.");
-            GetContext().GetTimer().Schedule(
-                [this, connection]() {
-                  { const boost::mutex::scoped_lock lock(m_connectionMutex); }
-                  ScheduleReconnect();
-                },
-                m_timerScope);
-          },
-          [this](const std::string &event) { GetLog().Debug(event.c_str()); },
-          [this](const std::string &event) { GetLog().Info(event.c_str()); },
-          [this](const std::string &event) { GetLog().Warn(event.c_str()); },
-          [this](const std::string &event) { GetLog().Error(event.c_str()); }});
+  MarketDataConnection::Events events{
+      [this]() -> MarketDataConnection::EventInfo {
+        const auto &context = GetContext();
+        return {context.GetCurrentTime(),
+                context.StartStrategyTimeMeasurement()};
+      },
+      {},
+      [this]() {
+        const boost::mutex::scoped_lock lock(m_connectionMutex);
+        if (!m_connection) {
+          GetLog().Debug("Disconnected.");
+          return;
+        }
+        const boost::shared_ptr<MarketDataConnection> connection(
+            std::move(m_connection));
+        GetLog().Warn("Connection lost.");
+        GetContext().GetTimer().Schedule(
+            [this, connection]() {
+              { const boost::mutex::scoped_lock lock(m_connectionMutex); }
+              ScheduleReconnect();
+            },
+            m_timerScope);
+      },
+      [this](const std::string &event) { GetLog().Debug(event.c_str()); },
+      [this](const std::string &event) { GetLog().Info(event.c_str()); },
+      [this](const std::string &event) { GetLog().Warn(event.c_str()); },
+      [this](const std::string &event) { GetLog().Error(event.c_str()); }};
+  events.jsonMessage = [this](const MarketDataConnection::EventInfo &info,
+                              const Json::Value &message) {
+    UpdatePrices(info.readTime, message, info.delayMeasurement);
+  };
+  connection.Start(m_securities, m_isFullBookEnabled, events);
 }
 
 void b::MarketDataSource::ScheduleReconnect() {
@@ -42,17 +42,33 @@ class MarketDataSource : public trdk::MarketDataSource {
 
  private:
   void UpdatePrices(const boost::posix_time::ptime &,
-                    const boost::property_tree::ptree &,
+                    const Lib::Json::Value &,
                     const Lib::TimeMeasurement::Milestones &);
+  void UpdateTopPrices(const boost::posix_time::ptime &,
+                       const Lib::Json::Value &,
+                       Rest::Security &,
+                       const Lib::TimeMeasurement::Milestones &);
+  void UpdateBook(const boost::posix_time::ptime &,
+                  const Lib::Json::Value &,
+                  SecuritySubscription &,
+                  const Lib::TimeMeasurement::Milestones &);
+  void RequestBookSnapshot(const ProductId &, SecuritySubscription &);
+  void ApplyBookSnapshot(SecuritySubscription &);
+  void ApplyBookDiff(const Lib::Json::Value &, SecuritySubscription &);
   void StartConnection(MarketDataConnection &);
   void ScheduleReconnect();
 
   const Rest::Settings m_settings;
+  const bool m_isFullBookEnabled;
 
   const boost::unordered_map<std::string, Product> *m_products = nullptr;
   boost::unordered_set<std::string> m_symbolListHint;
-  boost::unordered_map<ProductId, boost::shared_ptr<Rest::Security>>
-      m_securities;
+  boost::unordered_map<ProductId, SecuritySubscription> m_securities;
+  //! Used only by the polling task thread.
+  std::unique_ptr<Poco::Net::HTTPSClientSession> m_bookSnapshotSession;
+  //! Parses snapshots and pending diffs in the stream thread.
+  Lib::Json::Document m_bookDocument;
+  std::unique_ptr<Rest::PollingTask> m_pollingTask;
 
   boost::mutex m_connectionMutex;
   bool m_isStarted = false;
@@ -13,6 +13,7 @@
 #include "Common/Common.hpp"
 #include "Interaction/Rest/Common.hpp"
 #include "TradingLib/BalancesContainer.hpp"
+#include "TradingLib/PriceBookBuilder.hpp"
 #include "Core/Context.hpp"
 #include "Core/EventsLog.hpp"
 #include "Core/MarketDataSource.hpp"
@@ -33,3 +34,4 @@
 #include "Common/Crypto.hpp"
 #include "Common/WebSocketConnection.hpp"
 #include <Poco/URI.h>
+#include <deque>
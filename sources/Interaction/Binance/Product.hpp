@@ -15,6 +15,7 @@ namespace Interaction {
 namespace Binance {
 
 typedef std::string ProductId;
+typedef TradingLib::PriceBookBuilder<Rest::Security> PriceBookBuilder;
 
 struct Product {
   struct Filter {
@@ -29,6 +30,28 @@ struct Product {
   boost::optional<Qty> minVolume;
 };
 
+//! Price book snapshot which is requested by the polling thread.
+struct BookSnapshot {
+  //! Raw response, it's set by the polling thread before the ready flag.
+  std::string response;
+  boost::atomic_bool isReady;
+
+  BookSnapshot() : isReady(false) {}
+};
+
+struct SecuritySubscription {
+  boost::shared_ptr<Rest::Security> security;
+  PriceBookBuilder book;
+  //! Requested snapshot which the book waits for.
+  boost::shared_ptr<BookSnapshot> snapshot;
+  //! Diffs which are received while the book waits for the snapshot, as raw
+  //! JSON.
+  std::deque<std::string> pendingDiffs;
+
+  explicit SecuritySubscription(boost::shared_ptr<Rest::Security> source)
+      : security(std::move(source)), book(*security) {}
+};
+
 std::string ResolveSymbol(const std::string &);
 
 const boost::unordered_map<std::string, Product> &GetProductList(
@@ -49,28 +49,20 @@ struct Settings : Rest::Settings {
   }
 };
 
-template <Level1TickType priceType, Level1TickType qtyType>
-std::map<Price, std::pair<Level1TickValue, Level1TickValue>> ReadBook(
-    const ptr::ptree& source) {
-  std::map<Price, std::pair<Level1TickValue, Level1TickValue>> result;
+void ReadBook(const OrderSide& side,
+              const ptr::ptree& source,
+              PriceBookBuilder& book) {
   for (const auto& lines : source) {
     boost::optional<Price> price;
     for (const auto& val : lines.second) {
       if (!price) {
         price.emplace(val.second.get_value<Price>());
       } else {
-        const auto& qty = val.second.get_value<Qty>();
-        auto it = result.emplace(
-            *price, std::make_pair(Level1TickValue::Create<priceType>(*price),
-                                   Level1TickValue::Create<qtyType>(qty)));
-        if (!it.second) {
-          it.first->second.second = Level1TickValue::Create<qtyType>(
-              it.first->second.second.GetValue() + qty);
-        }
+        book.Update(side, *price, val.second.get_value<Qty>());
+        break;
       }
     }
   }
-  return result;
 }
 
 Volume ParseFee(const ptr::ptree& order) {
@@ -665,12 +657,10 @@ class Exchange : public TradingSystem, public MarketDataSource {
                               SecuritySubscription& security,
                               const ptr::ptree& message,
                               const Milestones& delayMeasurement) {
-    auto bids = ReadBook<LEVEL1_TICK_BID_PRICE, LEVEL1_TICK_BID_QTY>(
-        message.get_child("bids"));
-    security.asks = ReadBook<LEVEL1_TICK_ASK_PRICE, LEVEL1_TICK_ASK_QTY>(
-        message.get_child("asks"));
-    security.bids = std::move(bids);
-    FlushPrices(time, security, delayMeasurement);
+    security.book.StartSnapshot();
+    ReadBook(ORDER_SIDE_BID, message.get_child("bids"), security.book);
+    ReadBook(ORDER_SIDE_ASK, message.get_child("asks"), security.book);
+    security.book.Flush(time, delayMeasurement);
   }
 
   void UpdatePricesIncrementally(const pt::ptime& time,
@@ -678,15 +668,15 @@ class Exchange : public TradingSystem, public MarketDataSource {
                                  const ptr::ptree& message,
                                  const Milestones& delayMeasurement) {
     for (const auto& line : message.get_child("changes")) {
-      boost::optional<bool> isBid;
+      boost::optional<OrderSide> side;
       boost::optional<Price> price;
       for (const auto& item : line.second) {
-        if (!isBid) {
+        if (!side) {
           const auto& type = item.second.get_value<std::string>();
           if (type == "buy") {
-            isBid = true;
+            side = ORDER_SIDE_BID;
           } else if (type == "sell") {
-            isBid = false;
+            side = ORDER_SIDE_ASK;
           } else {
             boost::format error(
                 "Received depth-update with unknown side \"%1%\"");
@@ -696,51 +686,11 @@ class Exchange : public TradingSystem, public MarketDataSource {
         } else if (!price) {
           price.emplace(item.second.get_value<Price>());
         } else {
-          const auto& qty = item.second.get_value<Qty>();
-          auto& storage = *isBid ? security.bids : security.asks;
-          auto it = storage.find(*price);
-          if (it == storage.cend()) {
-            if (qty != 0) {
-              storage.emplace(
-                  *price,
-                  *isBid
-                      ? std::make_pair(
-                            Level1TickValue::Create<LEVEL1_TICK_BID_PRICE>(
-                                *price),
-                            Level1TickValue::Create<LEVEL1_TICK_BID_QTY>(qty))
-                      : std::make_pair(
-                            Level1TickValue::Create<LEVEL1_TICK_ASK_PRICE>(
-                                *price),
-                            Level1TickValue::Create<LEVEL1_TICK_ASK_QTY>(qty)));
-            }
-            continue;
-          }
-          if (qty == 0) {
-            storage.erase(it);
-          } else {
-            it->second.second =
-                *isBid ? Level1TickValue::Create<LEVEL1_TICK_BID_QTY>(qty)
-                       : Level1TickValue::Create<LEVEL1_TICK_ASK_QTY>(qty);
-          }
+          security.book.Update(*side, *price, item.second.get_value<Qty>());
         }
       }
     }
-    FlushPrices(time, security, delayMeasurement);
-  }
-
-  void FlushPrices(const pt::ptime& time,
-                   SecuritySubscription& security,
-                   const Milestones& delayMeasurement) {
-    if (security.bids.empty() || security.asks.empty()) {
-      security.security->SetOnline(pt::not_a_date_time, false);
-      return;
-    }
-    const auto& bestBid = security.bids.crbegin()->second;
-    const auto& bestAsk = security.asks.cbegin()->second;
-    security.security->SetLevel1(time, bestBid.first, bestBid.second,
-                                 bestAsk.first, bestAsk.second,
-                                 delayMeasurement);
-    security.security->SetOnline(pt::not_a_date_time, true);
+    security.book.Flush(time, delayMeasurement);
   }
 
 #if 0
@@ -13,6 +13,7 @@
 #include "Common/Common.hpp"
 #include "Interaction/Rest/Common.hpp"
 #include "TradingLib/BalancesContainer.hpp"
+#include "TradingLib/PriceBookBuilder.hpp"
 #include "TradingLib/Util.hpp"
 #include "Core/Bar.hpp"
 #include "Core/MarketDataSource.hpp"
@@ -15,6 +15,7 @@ namespace Interaction {
 namespace Coinbase {
 
 typedef std::string ProductId;
+typedef TradingLib::PriceBookBuilder<Rest::Security> PriceBookBuilder;
 
 struct Product {
   ProductId id;
@@ -25,8 +26,10 @@ struct Product {
 
 struct SecuritySubscription {
   boost::shared_ptr<Rest::Security> security;
-  std::map<Price, std::pair<Level1TickValue, Level1TickValue>> bids;
-  std::map<Price, std::pair<Level1TickValue, Level1TickValue>> asks;
+  PriceBookBuilder book;
+
+  explicit SecuritySubscription(boost::shared_ptr<Rest::Security> source)
+      : security(std::move(source)), book(*security) {}
 };
 
 }  // namespace Coinbase
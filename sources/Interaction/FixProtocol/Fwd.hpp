@@ -21,6 +21,7 @@ class Policy;
 class Handler;
 
 namespace Incoming {
+struct MdEntry;
 class Logon;
 class Logout;
 class Heartbeat;
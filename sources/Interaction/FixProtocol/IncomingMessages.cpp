@@ -27,73 +27,6 @@ namespace gr = boost::gregorian;
 namespace fix = trdk::Interaction::FixProtocol;
 
 namespace {
-typedef NetworkStreamClient::ProtocolError ProtocolError;
-
-template <typename Result, typename It>
-Result ReadIntValue(It &source) {
-  if (*source == SOH) {
-    throw ProtocolError("Integer field is empty", &*source, SOH);
-  }
-  Result result = 0;
-  do {
-    result = result * 10 + (*source++ - '0');
-  } while (*source != SOH);
-  return result;
-}
-template <typename Result, typename It>
-Result ReadIntValue(It &source, char delimiter) {
-  if (*source == SOH || *source == delimiter) {
-    throw ProtocolError("Unsigned integer field is empty", &*source, delimiter);
-  }
-  Result result = 0;
-  do {
-    result = result * 10 + (*source++ - '0');
-  } while (*source != SOH && *source != delimiter);
-  return result;
-}
-template <typename Result, typename It>
-Result ReadDoubleValue(It &source) {
-  if (*source == SOH) {
-    throw ProtocolError("Double field is empty", &*source, SOH);
-  }
-  Result result = .0;
-
-  // https://tinodidriksen.com/2011/05/cpp-convert-string-to-double-speed/
-  // https://tinodidriksen.com/uploads/code/cpp/speed-string-to-double.cpp
-  // (native)
-
-  bool isNegative = false;
-  if (*source == '-') {
-    isNegative = true;
-    ++source;
-  }
-
-  while (*source >= '0' && *source <= '9') {
-    result = (result * 10.0) + (*source - '0');
-    ++source;
-  }
-  if (*source == '.') {
-    double f = 0.0;
-    int n = 0;
-    ++source;
-    while (*source >= '0' && *source <= '9') {
-      f = (f * 10.0) + (*source - '0');
-      ++source;
-      ++n;
-    }
-    if (*source != SOH) {
-      throw ProtocolError("Double has wrong format", &*source, SOH);
-    }
-    result += f / std::pow(10.0, n);
-  }
-
-  if (isNegative) {
-    result = -result;
-  }
-
-  return result;
-}
-
 template <typename Result, typename It, typename TagMatch>
 Result ReadIntTag(const TagMatch &tagMatch, It &source, const It &messageEnd) {
   Assert(source <= messageEnd);
@@ -192,24 +125,6 @@ std::string ReadStringTag(const TagMatch &tagMatch,
   return ReadStringTagFromSoh(tagMatch, source, messageEnd);
 }
 
-template <typename Result, typename It, typename TagMatch>
-Result FindAndReadIntTag(const TagMatch &tagMatch, It &source, const It &end) {
-  const auto begin = source;
-  for (; source + sizeof(tagMatch) < end;) {
-    if (reinterpret_cast<const decltype(tagMatch) &>(*source) == tagMatch) {
-      source += sizeof(tagMatch);
-      const auto &result = ReadIntValue<Result>(source);
-      ++source;
-      return result;
-    }
-    source = std::find(source + sizeof(tagMatch), end, SOH);
-    if (source != end) {
-      ++source;
-    }
-  }
-  throw ProtocolError("Message doesn't have required tag with integer value",
-                      &*begin, 0);
-}
 template <typename Result, typename It, typename TagMatch>
 Result FindAndReadIntTagFromSoh(const TagMatch &tagMatch,
                                 It &source,
@@ -944,12 +859,44 @@ void MarketDataSnapshotFullRefresh::ReadEachMdEntry(
   }
 }
 
+void MarketDataSnapshotFullRefresh::ReadEachBookMdEntry(
+    const boost::function<void(MdEntry &&, bool isLast)> &callback) const {
+  try {
+    ReadMdEntryGroup(269, GetUnreadBeginRef(), GetEnd(), callback);
+  } catch (const ProtocolError &ex) {
+    boost::format error("Failed to read Market Data Entries: \"%1%\"");
+    error % ex.what();
+    throw ProtocolError(error.str().c_str(), ex.GetBufferAddress(),
+                        ex.GetExpectedByte());
+  } catch (const std::exception &ex) {
+    boost::format error("Failed to read Market Data Entries: \"%1%\"");
+    error % ex.what();
+    throw ProtocolError(error.str().c_str(), &*GetUnreadBegin(), 0);
+  }
+}
+
 void MarketDataSnapshotFullRefresh::Handle(Handler &handler,
                                            NetworkStreamClient &client,
                                            const Milestones &delayMeasurement) {
   handler.OnMarketDataSnapshotFullRefresh(*this, client, delayMeasurement);
 }
 
+void MarketDataIncrementalRefresh::ReadEachMdEntry(
+    const boost::function<void(MdEntry &&, bool isLast)> &callback) const {
+  try {
+    ReadMdEntryGroup(279, GetUnreadBeginRef(), GetEnd(), callback);
+  } catch (const ProtocolError &ex) {
+    boost::format error("Failed to read Market Data Entries: \"%1%\"");
+    error % ex.what();
+    throw ProtocolError(error.str().c_str(), ex.GetBufferAddress(),
+                        ex.GetExpectedByte());
+  } catch (const std::exception &ex) {
+    boost::format error("Failed to read Market Data Entries: \"%1%\"");
+    error % ex.what();
+    throw ProtocolError(error.str().c_str(), &*GetUnreadBegin(), 0);
+  }
+}
+
 void MarketDataIncrementalRefresh::Handle(Handler &handler,
                                           NetworkStreamClient &client,
                                           const Milestones &delayMeasurement) {
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "MdEntry.hpp"
 #include "Message.hpp"
 
 namespace trdk {
@@ -159,6 +160,9 @@ class MarketDataSnapshotFullRefresh : public SecurityMessage {
  public:
   void ReadEachMdEntry(
       const boost::function<void(Level1TickValue &&, bool isLast)> &) const;
+  //! Reads entries of the depth snapshot with sizes and entry IDs.
+  void ReadEachBookMdEntry(
+      const boost::function<void(MdEntry &&, bool isLast)> &) const;
 
  public:
   virtual void Handle(Handler &,
@@ -175,6 +179,11 @@ class MarketDataIncrementalRefresh : public SecurityMessage {
       : Base(std::move(params)) {}
   virtual ~MarketDataIncrementalRefresh() override = default;
 
+ public:
+  //! Reads each entry, entries may have different symbols.
+  void ReadEachMdEntry(
+      const boost::function<void(MdEntry &&, bool isLast)> &) const;
+
  public:
   virtual void Handle(Handler &,
                       Lib::NetworkStreamClient &,
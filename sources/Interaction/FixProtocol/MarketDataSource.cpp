@@ -13,6 +13,7 @@
 #include "IncomingMessages.hpp"
 #include "OutgoingMessages.hpp"
 #include "Security.hpp"
+#include "Settings.hpp"
 
 using namespace trdk;
 using namespace Lib;
@@ -25,6 +26,10 @@ namespace gr = boost::gregorian;
 namespace pt = boost::posix_time;
 namespace ptr = boost::property_tree;
 
+fix::MarketDataSource::SecuritySubscription::SecuritySubscription(
+    boost::shared_ptr<Security> source)
+    : security(std::move(source)), book(*security) {}
+
 fix::MarketDataSource::MarketDataSource(Context& context,
                                         std::string instanceName,
                                         std::string title,
@@ -32,7 +37,8 @@ fix::MarketDataSource::MarketDataSource(Context& context,
     : trdk::MarketDataSource(
           context, std::move(instanceName), std::move(title)),
       Handler(context, conf, trdk::MarketDataSource::GetLog()),
-      m_client("Prices", *this) {}
+      m_client("Prices", *this),
+      m_isUnexpectedIncrementalRefreshReported(false) {}
 
 fix::MarketDataSource::~MarketDataSource() {
   try {
@@ -67,14 +73,16 @@ void fix::MarketDataSource::Connect() {
 void fix::MarketDataSource::SubscribeToSecurities() {
   GetLog().Debug("Sending market data request for %1% securities...",
                  m_securities.size());
+  m_isUnexpectedIncrementalRefreshReported = false;
 
   try {
     for (const auto& it : m_securities) {
-      auto& security = *it.second;
+      auto& security = *it.second.security;
       if (!security.GetRequest()) {
         security.SetOnline(security.GetLastMarketDataTime(), true);
       }
       const out::MarketDataRequest message(security,
+                                           GetSettings().isFullBookEnabled,
                                            GetStandardOutgoingHeader());
       GetLog().Info("Sending Market Data Request for \"%1%\" (%2%)...",
                     security,                // 1
@@ -89,14 +97,31 @@ void fix::MarketDataSource::SubscribeToSecurities() {
   GetLog().Debug("Market data request sent.");
 }
 
+void fix::MarketDataSource::ResubscribeToSecurities() {
+  GetLog().Info("Resubscribing to %1% securities...", m_securities.size());
+  if (GetSettings().isFullBookEnabled) {
+    // Diffs from the previous session are lost, books will be restored by new
+    // snapshots:
+    for (auto& it : m_securities) {
+      it.second.book.Stop();
+      it.second.entries.clear();
+    }
+  }
+  SubscribeToSecurities();
+}
+
 trdk::Security& fix::MarketDataSource::CreateNewSecurityObject(
     const Symbol& symbol) {
-  const auto& result =
-      boost::make_shared<Security>(GetContext(), symbol, *this,
-                                   Security::SupportedLevel1Types()
-                                       .set(LEVEL1_TICK_BID_PRICE)
-                                       .set(LEVEL1_TICK_ASK_PRICE));
-  Verify(m_securities.emplace(result->GetFixId(), result).second);
+  auto supportedLevel1Types = Security::SupportedLevel1Types()
+                                  .set(LEVEL1_TICK_BID_PRICE)
+                                  .set(LEVEL1_TICK_ASK_PRICE);
+  if (GetSettings().isFullBookEnabled) {
+    supportedLevel1Types.set(LEVEL1_TICK_BID_QTY).set(LEVEL1_TICK_ASK_QTY);
+  }
+  const auto& result = boost::make_shared<Security>(
+      GetContext(), symbol, *this, std::move(supportedLevel1Types));
+  Verify(m_securities.emplace(result->GetFixId(), SecuritySubscription(result))
+             .second);
   return *result;
 }
 
@@ -106,18 +131,22 @@ const fix::Security& fix::MarketDataSource::GetSecurityByFixId(
 }
 
 fix::Security& fix::MarketDataSource::GetSecurityByFixId(size_t id) {
-  const auto& result = m_securities.find(id);
+  return *GetSubscription(id).security;
+}
+
+fix::MarketDataSource::SecuritySubscription&
+fix::MarketDataSource::GetSubscription(size_t fixId) {
+  const auto& result = m_securities.find(fixId);
   if (result == m_securities.cend()) {
     boost::format error("Failed to resolve security with FIX Symbol ID %1%");
-    error % id;
+    error % fixId;
     throw Exception(error.str().c_str());
   }
-  return *result->second;
+  return result->second;
 }
 
 void fix::MarketDataSource::OnConnectionRestored() {
-  throw MethodIsNotImplementedException(
-      "fix::MarketDataSource::OnConnectionRestored is not implemented");
+  ResubscribeToSecurities();
 }
 
 void fix::MarketDataSource::OnMarketDataSnapshotFullRefresh(
@@ -125,6 +154,21 @@ void fix::MarketDataSource::OnMarketDataSnapshotFullRefresh(
     NetworkStreamClient&,
     const Milestones& delayMeasurement) {
   auto& security = snapshot.ReadSymbol(*this);
+
+  if (GetSettings().isFullBookEnabled) {
+    auto& subscription = GetSubscription(security.GetFixId());
+    subscription.book.StartSnapshot();
+    subscription.entries.clear();
+    snapshot.ReadEachBookMdEntry([&](in::MdEntry&& entry, bool) {
+      AddBookEntry(subscription, std::move(entry));
+    });
+    subscription.book.Flush(snapshot.GetTime(), delayMeasurement);
+    if (!security.IsTradingSessionOpened()) {
+      security.SetTradingSessionState(snapshot.GetTime(), true);
+    }
+    return;
+  }
+
   bool isPreviouslyChanged = false;
   snapshot.ReadEachMdEntry([&](Level1TickValue&& value, bool isLast) {
     security.AddLevel1Tick(snapshot.GetTime(), std::move(value), isLast,
@@ -135,6 +179,146 @@ void fix::MarketDataSource::OnMarketDataSnapshotFullRefresh(
   });
 }
 
+void fix::MarketDataSource::OnMarketDataIncrementalRefresh(
+    const in::MarketDataIncrementalRefresh& message,
+    NetworkStreamClient&,
+    const Milestones& delayMeasurement) {
+  if (!GetSettings().isFullBookEnabled) {
+    // Spot subscription provides the best prices by snapshots only.
+    if (!m_isUnexpectedIncrementalRefreshReported.exchange(true)) {
+      GetLog().Warn(
+          "Market Data Incremental Refresh is received, but full book is not "
+          "enabled. Next such messages will be ignored without reporting.");
+    }
+    return;
+  }
+
+  // One message may have entries for different securities, each book is
+  // flushed after the last entry for it.
+  SecuritySubscription* subscription = nullptr;
+  message.ReadEachMdEntry([&](in::MdEntry&& entry, bool isLast) {
+    if (entry.symbol) {
+      auto& entrySubscription = GetSubscription(*entry.symbol);
+      if (subscription && subscription != &entrySubscription) {
+        subscription->book.Flush(message.GetTime(), delayMeasurement);
+      }
+      subscription = &entrySubscription;
+    } else if (!subscription) {
+      throw Exception("Market Data Entry doesn't have symbol");
+    }
+
+    switch (entry.action) {
+      case MD_UPDATE_ACTION_NEW:
+        AddBookEntry(*subscription, std::move(entry));
+        break;
+      case MD_UPDATE_ACTION_CHANGE:
+        ChangeBookEntry(*subscription, std::move(entry));
+        break;
+      case MD_UPDATE_ACTION_DELETE:
+        DeleteBookEntry(*subscription, entry);
+        break;
+      default: {
+        boost::format error("Unknown Market Data Update Action \"%1%\"");
+        error % static_cast<char>(entry.action);
+        throw Exception(error.str().c_str());
+      }
+    }
+
+    if (isLast) {
+      subscription->book.Flush(message.GetTime(), delayMeasurement);
+    }
+  });
+}
+
+void fix::MarketDataSource::AddBookEntry(SecuritySubscription& subscription,
+                                         in::MdEntry&& entry) {
+  if (!entry.type || !entry.price) {
+    throw Exception("Market Data Entry doesn't have type or price");
+  }
+  OrderSide side;
+  switch (*entry.type) {
+    case MD_ENTRY_TYPE_BID:
+      side = ORDER_SIDE_BID;
+      break;
+    case MD_ENTRY_TYPE_OFFER:
+      side = ORDER_SIDE_ASK;
+      break;
+    default:
+      // Trades and statistics are not a part of the book.
+      return;
+  }
+  const auto& qty = entry.qty ? *entry.qty : Qty(0);
+
+  if (entry.id.empty()) {
+    // Entry is a price level.
+    subscription.book.Update(side, *entry.price, qty);
+    return;
+  }
+
+  // Entry is an order, a few orders may have the same price.
+  const auto& result = subscription.entries.emplace(
+      std::move(entry.id), BookEntry{side, *entry.price, qty});
+  if (!result.second) {
+    // Repeated entry replaces the previous one.
+    auto& prevEntry = result.first->second;
+    subscription.book.AddQty(prevEntry.side, prevEntry.price,
+                             -prevEntry.qty.Get());
+    prevEntry = BookEntry{side, *entry.price, qty};
+  }
+  subscription.book.AddQty(side, *entry.price, qty);
+}
+
+void fix::MarketDataSource::ChangeBookEntry(SecuritySubscription& subscription,
+                                            in::MdEntry&& entry) {
+  if (!entry.id.empty()) {
+    const auto& it = subscription.entries.find(entry.id);
+    if (it != subscription.entries.cend()) {
+      // Change may have only changed fields.
+      const auto& prevEntry = it->second;
+      if (!entry.type) {
+        entry.type = static_cast<char>(prevEntry.side == ORDER_SIDE_BID
+                                           ? MD_ENTRY_TYPE_BID
+                                           : MD_ENTRY_TYPE_OFFER);
+      }
+      if (!entry.price) {
+        entry.price = prevEntry.price;
+      }
+      if (!entry.qty) {
+        entry.qty = prevEntry.qty;
+      }
+    }
+  }
+  AddBookEntry(subscription, std::move(entry));
+}
+
+void fix::MarketDataSource::DeleteBookEntry(SecuritySubscription& subscription,
+                                            const in::MdEntry& entry) {
+  if (entry.id.empty()) {
+    if (!entry.type || !entry.price) {
+      throw Exception("Market Data Entry doesn't have type or price");
+    }
+    switch (*entry.type) {
+      case MD_ENTRY_TYPE_BID:
+        subscription.book.Update(ORDER_SIDE_BID, *entry.price, 0);
+        break;
+      case MD_ENTRY_TYPE_OFFER:
+        subscription.book.Update(ORDER_SIDE_ASK, *entry.price, 0);
+        break;
+    }
+    return;
+  }
+
+  // Venue may delete an order by ID only, without price.
+  const auto& it = subscription.entries.find(entry.id);
+  if (it == subscription.entries.cend()) {
+    return;
+  }
+  const auto& prevEntry = it->second;
+  subscription.book.AddQty(prevEntry.side, prevEntry.price,
+                           -prevEntry.qty.Get());
+  subscription.entries.erase(it);
+}
+
 const boost::unordered_set<std::string>&
 fix::MarketDataSource::GetSymbolListHint() const {
   static boost::unordered_set<std::string> result;
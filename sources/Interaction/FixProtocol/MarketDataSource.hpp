@@ -43,15 +43,48 @@ class MarketDataSource : public trdk::MarketDataSource, public Handler {
       const Incoming::MarketDataSnapshotFullRefresh&,
       Lib::NetworkStreamClient&,
       const Lib::TimeMeasurement::Milestones&) override;
+  void OnMarketDataIncrementalRefresh(
+      const Incoming::MarketDataIncrementalRefresh&,
+      Lib::NetworkStreamClient&,
+      const Lib::TimeMeasurement::Milestones&) override;
 
   const boost::unordered_set<std::string>& GetSymbolListHint() const override;
 
  protected:
   trdk::Security& CreateNewSecurityObject(const Lib::Symbol&) override;
 
+ private:
+  struct BookEntry {
+    OrderSide side;
+    Price price;
+    Qty qty;
+  };
+
+  struct SecuritySubscription {
+    boost::shared_ptr<Security> security;
+    TradingLib::PriceBookBuilder<Security> book;
+    //! Entries by MDEntryID, each entry adds its quantity to the price level.
+    /**
+     * The book builder keeps levels which are out of its flat depth, so the
+     * quantity of each stored entry is always in the book and can be removed
+     * by the entry change or deletion.
+     */
+    boost::unordered_map<std::string, BookEntry> entries;
+
+    explicit SecuritySubscription(boost::shared_ptr<Security>);
+  };
+
+  SecuritySubscription& GetSubscription(size_t fixId);
+  void AddBookEntry(SecuritySubscription&, Incoming::MdEntry&&);
+  void ChangeBookEntry(SecuritySubscription&, Incoming::MdEntry&&);
+  void DeleteBookEntry(SecuritySubscription&, const Incoming::MdEntry&);
+
  private:
   Client m_client;
-  boost::unordered_map<size_t, boost::shared_ptr<Security>> m_securities;
+  boost::unordered_map<size_t, SecuritySubscription> m_securities;
+  //! Set after the first unexpected incremental refresh since the last market
+  //! data request, to not report each message.
+  boost::atomic_bool m_isUnexpectedIncrementalRefreshReported;
 };
 }  // namespace FixProtocol
 }  // namespace Interaction
@@ -0,0 +1,224 @@
+/*******************************************************************************
+ *   Created: 2026/10/17 10:41:26
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#pragma once
+
+#include "Message.hpp"
+#include "Common/NetworkStreamClient.hpp"
+
+namespace trdk {
+namespace Interaction {
+namespace FixProtocol {
+namespace Incoming {
+
+//! Market Data Entry from the repeating group NoMDEntries.
+/**
+ * Fields which are absent in the entry are not set.
+ */
+struct MdEntry {
+  //! MDUpdateAction, snapshot entries always have MD_UPDATE_ACTION_NEW.
+  MdUpdateAction action;
+  //! MDEntryType.
+  boost::optional<char> type;
+  //! MDEntryID, empty if the entry doesn't have ID.
+  std::string id;
+  //! Symbol.
+  boost::optional<size_t> symbol;
+  //! MDEntryPx.
+  boost::optional<Price> price;
+  //! MDEntrySize.
+  boost::optional<Qty> qty;
+
+  MdEntry() : action(MD_UPDATE_ACTION_NEW) {}
+};
+
+namespace Detail {
+
+typedef Lib::NetworkStreamClient::ProtocolError ProtocolError;
+
+template <typename Result, typename It>
+Result ReadIntValue(It &source) {
+  if (*source == SOH) {
+    throw ProtocolError("Integer field is empty", &*source, SOH);
+  }
+  Result result = 0;
+  do {
+    result = result * 10 + (*source++ - '0');
+  } while (*source != SOH);
+  return result;
+}
+template <typename Result, typename It>
+Result ReadIntValue(It &source, char delimiter) {
+  if (*source == SOH || *source == delimiter) {
+    throw ProtocolError("Unsigned integer field is empty", &*source, delimiter);
+  }
+  Result result = 0;
+  do {
+    result = result * 10 + (*source++ - '0');
+  } while (*source != SOH && *source != delimiter);
+  return result;
+}
+template <typename Result, typename It>
+Result ReadDoubleValue(It &source) {
+  if (*source == SOH) {
+    throw ProtocolError("Double field is empty", &*source, SOH);
+  }
+  Result result = .0;
+
+  // https://tinodidriksen.com/2011/05/cpp-convert-string-to-double-speed/
+  // https://tinodidriksen.com/uploads/code/cpp/speed-string-to-double.cpp
+  // (native)
+
+  bool isNegative = false;
+  if (*source == '-') {
+    isNegative = true;
+    ++source;
+  }
+
+  while (*source >= '0' && *source <= '9') {
+    result = (result * 10.0) + (*source - '0');
+    ++source;
+  }
+  if (*source == '.') {
+    double f = 0.0;
+    int n = 0;
+    ++source;
+    while (*source >= '0' && *source <= '9') {
+      f = (f * 10.0) + (*source - '0');
+      ++source;
+      ++n;
+    }
+    if (*source != SOH) {
+      throw ProtocolError("Double has wrong format", &*source, SOH);
+    }
+    result += f / std::pow(10.0, n);
+  }
+
+  if (isNegative) {
+    result = -result;
+  }
+
+  return result;
+}
+
+template <typename Result, typename It, typename TagMatch>
+Result FindAndReadIntTag(const TagMatch &tagMatch, It &source, const It &end) {
+  const auto begin = source;
+  for (; source + sizeof(tagMatch) < end;) {
+    if (reinterpret_cast<const decltype(tagMatch) &>(*source) == tagMatch) {
+      source += sizeof(tagMatch);
+      const auto &result = ReadIntValue<Result>(source);
+      ++source;
+      return result;
+    }
+    source = std::find(source + sizeof(tagMatch), end, SOH);
+    if (source != end) {
+      ++source;
+    }
+  }
+  throw ProtocolError("Message doesn't have required tag with integer value",
+                      &*begin, 0);
+}
+
+//! Reads repeating group NoMDEntries.
+/**
+ * Each entry starts from the tag entryStartTag, the order of other fields is
+ * not fixed, unknown fields are skipped.
+ */
+template <typename It>
+void ReadMdEntryGroup(
+    unsigned int entryStartTag,
+    It &source,
+    const It &end,
+    const boost::function<void(MdEntry &&, bool isLast)> &callback) {
+  const auto numberOfEntries = FindAndReadIntTag<size_t>(
+      reinterpret_cast<const int32_t &>("268="), source, end);
+  if (numberOfEntries == 0) {
+    return;
+  }
+
+  size_t numberOfReadEntries = 0;
+  boost::optional<MdEntry> entry;
+  while (source < end) {
+    const auto tag = ReadIntValue<unsigned int>(source, '=');
+    if (*source != '=') {
+      throw ProtocolError("Field doesn't have value", &*source, '=');
+    }
+    const auto value = ++source;
+    source = std::find(source, end, SOH);
+    if (source == end) {
+      throw ProtocolError("Field value doesn't have end", &*std::prev(source),
+                          SOH);
+    } else if (source == value) {
+      throw ProtocolError("Field value is empty", &*source, 0);
+    }
+
+    if (tag == entryStartTag) {
+      if (entry) {
+        if (++numberOfReadEntries >= numberOfEntries) {
+          throw ProtocolError("Market Data Entry list has too many entries",
+                              &*value, 0);
+        }
+        callback(std::move(*entry), false);
+      }
+      entry = MdEntry();
+    } else if (!entry) {
+      throw ProtocolError("Market Data Entry has wrong first field", &*value,
+                          0);
+    }
+
+    switch (tag) {
+      case 279:  // MDUpdateAction
+      case 269:  // MDEntryType
+        if (source - value != 1) {
+          throw ProtocolError("Char value tag buffer has wrong length",
+                              &*source, SOH);
+        }
+        if (tag == 279) {
+          entry->action = static_cast<MdUpdateAction>(*value);
+        } else {
+          entry->type = *value;
+        }
+        break;
+      case 278:  // MDEntryID
+        entry->id.assign(value, source);
+        break;
+      case 55: {  // Symbol
+        auto it = value;
+        entry->symbol = ReadIntValue<size_t>(it);
+        break;
+      }
+      case 270: {  // MDEntryPx
+        auto it = value;
+        entry->price = ReadDoubleValue<double>(it);
+        break;
+      }
+      case 271: {  // MDEntrySize
+        auto it = value;
+        entry->qty = ReadDoubleValue<double>(it);
+        break;
+      }
+    }
+
+    ++source;
+  }
+
+  if (!entry || ++numberOfReadEntries != numberOfEntries) {
+    throw ProtocolError("Market Data Entry list has wrong number of entries",
+                        &*std::prev(end), 0);
+  }
+  callback(std::move(*entry), true);
+}
+
+}
+}
+}
+}
+}
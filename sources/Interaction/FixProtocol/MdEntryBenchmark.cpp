@@ -0,0 +1,64 @@
+/*******************************************************************************
+ *   Created: 2026/10/18 11:02:39
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Core/Types.hpp"
+#include "Interaction/FixProtocol/Fwd.hpp"
+#include "Interaction/FixProtocol/MdEntry.hpp"
+
+using namespace trdk;
+using namespace trdk::Interaction::FixProtocol;
+using namespace trdk::Interaction::FixProtocol::Incoming;
+
+namespace {
+
+//! Incremental refresh group with the given number of entries, bids and asks
+//! are interleaved.
+std::vector<char> CreateIncrementalRefreshGroup(size_t numberOfEntries) {
+  std::ostringstream result;
+  result << "262=1|268=" << numberOfEntries << '|';
+  for (size_t i = 0; i < numberOfEntries; ++i) {
+    result << "279=" << (i % 3 ? '1' : '0')  // MDUpdateAction
+           << "|269=" << (i % 2)             // MDEntryType
+           << "|278=" << 876316403 + i       // MDEntryID
+           << "|55=1"                        // Symbol
+           << "|270=1.1" << 2345 + i         // MDEntryPx
+           << "|271=" << 100000 + i * 1000   // MDEntrySize
+           << '|';
+  }
+  const auto &source = result.str();
+  std::vector<char> buffer(source.cbegin(), source.cend());
+  std::replace(buffer.begin(), buffer.end(), '|', static_cast<char>(SOH));
+  return buffer;
+}
+
+void Interaction_FixProtocol_ReadMdEntryGroup(benchmark::State &state) {
+  const auto numberOfEntries = static_cast<size_t>(state.range(0));
+  const auto &buffer = CreateIncrementalRefreshGroup(numberOfEntries);
+
+  double sum = 0;
+  for (auto _ : state) {
+    auto it = buffer.cbegin();
+    Detail::ReadMdEntryGroup(279, it, buffer.cend(),
+                             [&sum](MdEntry &&entry, bool) {
+                               sum += entry.price->Get() * entry.qty->Get();
+                             });
+  }
+  benchmark::DoNotOptimize(sum);
+
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(numberOfEntries));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(buffer.size()));
+}
+
+}  // namespace
+
+BENCHMARK(Interaction_FixProtocol_ReadMdEntryGroup)->Arg(1)->Arg(10)->Arg(50);
@@ -0,0 +1,134 @@
+/*******************************************************************************
+ *   Created: 2026/10/17 11:05:48
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Core/Types.hpp"
+#include "Interaction/FixProtocol/Fwd.hpp"
+#include "Interaction/FixProtocol/MdEntry.hpp"
+
+using namespace trdk;
+using namespace trdk::Interaction::FixProtocol;
+using namespace trdk::Interaction::FixProtocol::Incoming;
+namespace lib = trdk::Lib;
+
+namespace {
+
+typedef std::vector<char> Buffer;
+typedef lib::NetworkStreamClient::ProtocolError ProtocolError;
+
+//! Builds message fields from the string with '|' as the field delimiter.
+Buffer CreateBuffer(const std::string &source) {
+  Buffer result(source.cbegin(), source.cend());
+  std::replace(result.begin(), result.end(), '|', static_cast<char>(SOH));
+  return result;
+}
+
+std::vector<std::pair<MdEntry, bool>> ReadGroup(unsigned int entryStartTag,
+                                                const std::string &source) {
+  const auto &buffer = CreateBuffer(source);
+  auto it = buffer.cbegin();
+  std::vector<std::pair<MdEntry, bool>> result;
+  Detail::ReadMdEntryGroup(entryStartTag, it, buffer.cend(),
+                           [&result](MdEntry &&entry, bool isLast) {
+                             result.emplace_back(std::move(entry), isLast);
+                           });
+  return result;
+}
+}  // namespace
+
+TEST(FixProtocol_MdEntry, IncrementalRefreshGroup) {
+  const auto &entries = ReadGroup(
+      279,
+      "262=1|268=3|"
+      "279=0|269=0|278=a1|55=7|270=1.25|271=3|"
+      "279=1|278=a2|271=0.5|"
+      "279=2|269=1|278=b3|55=8|");
+  ASSERT_EQ(3, entries.size());
+
+  {
+    const auto &entry = entries[0].first;
+    EXPECT_FALSE(entries[0].second);
+    EXPECT_EQ(MD_UPDATE_ACTION_NEW, entry.action);
+    ASSERT_TRUE(entry.type);
+    EXPECT_EQ(MD_ENTRY_TYPE_BID, *entry.type);
+    EXPECT_EQ("a1", entry.id);
+    ASSERT_TRUE(entry.symbol);
+    EXPECT_EQ(7, *entry.symbol);
+    ASSERT_TRUE(entry.price);
+    EXPECT_EQ(1.25, *entry.price);
+    ASSERT_TRUE(entry.qty);
+    EXPECT_EQ(3, *entry.qty);
+  }
+  {
+    // Change has only changed fields:
+    const auto &entry = entries[1].first;
+    EXPECT_FALSE(entries[1].second);
+    EXPECT_EQ(MD_UPDATE_ACTION_CHANGE, entry.action);
+    EXPECT_FALSE(entry.type);
+    EXPECT_EQ("a2", entry.id);
+    EXPECT_FALSE(entry.symbol);
+    EXPECT_FALSE(entry.price);
+    ASSERT_TRUE(entry.qty);
+    EXPECT_EQ(0.5, *entry.qty);
+  }
+  {
+    const auto &entry = entries[2].first;
+    EXPECT_TRUE(entries[2].second);
+    EXPECT_EQ(MD_UPDATE_ACTION_DELETE, entry.action);
+    ASSERT_TRUE(entry.type);
+    EXPECT_EQ(MD_ENTRY_TYPE_OFFER, *entry.type);
+    EXPECT_EQ("b3", entry.id);
+    ASSERT_TRUE(entry.symbol);
+    EXPECT_EQ(8, *entry.symbol);
+    EXPECT_FALSE(entry.price);
+    EXPECT_FALSE(entry.qty);
+  }
+}
+
+TEST(FixProtocol_MdEntry, SnapshotGroup) {
+  // Fields order is not fixed, unknown fields are skipped:
+  const auto &entries = ReadGroup(269,
+                                  "55=7|268=2|"
+                                  "269=1|271=10|290=1|270=1.5|"
+                                  "269=0|270=1.4|278=x|271=20|");
+  ASSERT_EQ(2, entries.size());
+
+  EXPECT_FALSE(entries[0].second);
+  EXPECT_EQ(MD_UPDATE_ACTION_NEW, entries[0].first.action);
+  EXPECT_EQ(MD_ENTRY_TYPE_OFFER, *entries[0].first.type);
+  EXPECT_TRUE(entries[0].first.id.empty());
+  EXPECT_EQ(1.5, *entries[0].first.price);
+  EXPECT_EQ(10, *entries[0].first.qty);
+
+  EXPECT_TRUE(entries[1].second);
+  EXPECT_EQ(MD_ENTRY_TYPE_BID, *entries[1].first.type);
+  EXPECT_EQ("x", entries[1].first.id);
+  EXPECT_EQ(1.4, *entries[1].first.price);
+  EXPECT_EQ(20, *entries[1].first.qty);
+}
+
+TEST(FixProtocol_MdEntry, EmptyGroup) {
+  EXPECT_TRUE(ReadGroup(279, "268=0|").empty());
+}
+
+TEST(FixProtocol_MdEntry, WrongGroup) {
+  // Less entries than declared:
+  EXPECT_THROW(ReadGroup(279, "268=3|279=0|269=0|279=2|269=1|"),
+               ProtocolError);
+  // More entries than declared:
+  EXPECT_THROW(ReadGroup(279, "268=1|279=0|269=0|279=2|269=1|"),
+               ProtocolError);
+  // Entry doesn't start from the start tag:
+  EXPECT_THROW(ReadGroup(279, "268=1|269=0|279=0|"), ProtocolError);
+  // Char field has more than one char:
+  EXPECT_THROW(ReadGroup(279, "268=1|279=00|"), ProtocolError);
+  // Group counter is absent:
+  EXPECT_THROW(ReadGroup(279, "279=0|269=0|"), ProtocolError);
+}
@@ -61,6 +61,14 @@ enum ExecType {
   EXEC_TYPE_ORDER_STATUS = 'I'
 };
 
+enum MdUpdateAction {
+  MD_UPDATE_ACTION_NEW = '0',
+  MD_UPDATE_ACTION_CHANGE = '1',
+  MD_UPDATE_ACTION_DELETE = '2'
+};
+
+enum MdEntryType { MD_ENTRY_TYPE_BID = '0', MD_ENTRY_TYPE_OFFER = '1' };
+
 ////////////////////////////////////////////////////////////////////////////////
 
 class Message : private boost::noncopyable {
@@ -257,9 +257,9 @@ std::vector<char> MarketDataRequest::Export(unsigned char soh) const {
   }
   // MarketDepth
   {
-    // Full book will be provided, 0 = Depth subscription; 1 = Spot
+    // 0 = Depth subscription, full book will be provided; 1 = Spot
     // subscription.
-    const std::string sub("264=1");
+    const std::string sub(m_isFullBook ? "264=0" : "264=1");
     std::copy(sub.cbegin(), sub.cend(), std::back_inserter(result));
     result.emplace_back(soh);
   }
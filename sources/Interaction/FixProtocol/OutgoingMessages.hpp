@@ -124,8 +124,9 @@ class MarketDataRequest : public MarketDataMessage {
 
  public:
   explicit MarketDataRequest(const FixProtocol::Security &security,
+                             bool isFullBook,
                              StandardHeader &standardHeader)
-      : Base(security, standardHeader) {}
+      : Base(security, standardHeader), m_isFullBook(isFullBook) {}
   virtual ~MarketDataRequest() override = default;
 
  public:
@@ -133,6 +134,9 @@ class MarketDataRequest : public MarketDataMessage {
 
  protected:
   using Base::Export;
+
+ private:
+  const bool m_isFullBook;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
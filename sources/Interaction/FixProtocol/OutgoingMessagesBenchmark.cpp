@@ -0,0 +1,106 @@
+/*******************************************************************************
+ *   Created: 2026/10/18 11:27:03
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Interaction/FixProtocol/MarketDataSource.hpp"
+#include "Interaction/FixProtocol/OutgoingMessages.hpp"
+#include "Interaction/FixProtocol/Settings.hpp"
+#include "Benchmarks/BenchmarkContext.hpp"
+
+using namespace trdk;
+using namespace trdk::Lib;
+using namespace trdk::Interaction::FixProtocol;
+
+namespace fix = trdk::Interaction::FixProtocol;
+namespace out = trdk::Interaction::FixProtocol::Outgoing;
+namespace ptr = boost::property_tree;
+
+namespace {
+
+ptr::ptree CreateSettings() {
+  ptr::ptree result;
+  result.add("config.host", "localhost");
+  result.add("config.port", 5201);
+  result.add("config.secure", false);
+  result.add("config.username", "3152581");
+  result.add("config.password", "passw0rd!");
+  result.add("config.senderCompId", "theBroker.3152581");
+  result.add("config.targetCompId", "CSERVER");
+  result.add("config.senderSubId", "TRADE");
+  result.add("config.targetSubId", "TRADE");
+  return result;
+}
+
+//! FIX security is required for orders, so it's created by the FIX market
+//! data source which is never connected.
+class Environment : private boost::noncopyable {
+ public:
+  Environment()
+      : m_settings(CreateSettings(),
+                   Benchmarks::Context::GetInstance().GetSettings()),
+        m_standardHeader(m_settings),
+        m_source(Benchmarks::Context::GetInstance(),
+                 "Benchmark",
+                 "Benchmark",
+                 CreateSettings()),
+        m_security(m_source.GetSecurity(Symbol("EURUSD/USD::FOR"))) {}
+
+  out::StandardHeader &GetStandardHeader() { return m_standardHeader; }
+  const trdk::Security &GetSecurity() const { return m_security; }
+
+ private:
+  const fix::Settings m_settings;
+  out::StandardHeader m_standardHeader;
+  fix::MarketDataSource m_source;
+  trdk::Security &m_security;
+};
+
+void Interaction_FixProtocol_NewOrderSingle_Export(benchmark::State &state) {
+  Environment environment;
+  size_t size = 0;
+  for (auto _ : state) {
+    const out::NewOrderSingle message(
+        environment.GetSecurity(), ORDER_SIDE_BUY, 100000.0, 1.12345,
+        environment.GetStandardHeader());
+    size += message.Export(SOH).size();
+  }
+  benchmark::DoNotOptimize(size);
+  state.SetItemsProcessed(state.iterations());
+}
+
+void Interaction_FixProtocol_OrderCancelRequest_Export(
+    benchmark::State &state) {
+  Environment environment;
+  size_t size = 0;
+  for (auto _ : state) {
+    const out::OrderCancelRequest message(876316397,
+                                          environment.GetStandardHeader());
+    size += message.Export(SOH).size();
+  }
+  benchmark::DoNotOptimize(size);
+  state.SetItemsProcessed(state.iterations());
+}
+
+void Interaction_FixProtocol_Heartbeat_Export(benchmark::State &state) {
+  Environment environment;
+  size_t size = 0;
+  for (auto _ : state) {
+    const out::Heartbeat message(environment.GetStandardHeader());
+    size += message.Export(SOH).size();
+  }
+  benchmark::DoNotOptimize(size);
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(Interaction_FixProtocol_NewOrderSingle_Export);
+BENCHMARK(Interaction_FixProtocol_OrderCancelRequest_Export);
+BENCHMARK(Interaction_FixProtocol_Heartbeat_Export);
@@ -19,6 +19,7 @@
 #include "Core/TradingLog.hpp"
 #include "Core/TradingSystem.hpp"
 #include "Core/TransactionContext.hpp"
+#include "TradingLib/PriceBookBuilder.hpp"
 #include "Api.h"
 #include "Fwd.hpp"
 #include "Common/NetworkStreamClient.hpp"
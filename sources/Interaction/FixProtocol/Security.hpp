@@ -30,6 +30,7 @@ class Security : public trdk::Security {
 
  public:
   using Base::AddLevel1Tick;
+  using Base::SetBook;
   using Base::SetOnline;
   using Base::SetTradingSessionState;
 
@@ -19,7 +19,7 @@ namespace fix = Interaction::FixProtocol;
 namespace ptr = boost::property_tree;
 
 fix::Settings::Settings(const ptr::ptree &conf, const trdk::Settings &settings)
-    : host(conf.get<std::string>("conf.host")),
+    : host(conf.get<std::string>("config.host")),
       port(conf.get<size_t>("config.port")),
       isSecure(conf.get<bool>("config.secure")),
       username(conf.get<std::string>("config.username")),
@@ -28,6 +28,7 @@ fix::Settings::Settings(const ptr::ptree &conf, const trdk::Settings &settings)
       targetCompId(conf.get<std::string>("config.targetCompId")),
       senderSubId(conf.get<std::string>("config.senderSubId")),
       targetSubId(conf.get<std::string>("config.targetSubId")),
+      isFullBookEnabled(conf.get<bool>("config.isFullBookEnabled", false)),
       policy(boost::make_unique<Policy>(settings)) {}
 
 fix::Settings::Settings(Settings &&rhs) = default;
@@ -38,7 +39,7 @@ void fix::Settings::Log(Module::Log &log) const {
   log.Info(
       "Server address: %1%:%2% (%9%). Username: \"%3%\" %4%. SenderCompID: "
       "\"%5%\". TargetCompID: \"%6%\". SenderSubID: \"%7%\". TargetSubID: "
-      "\"%8%\"",
+      "\"%8%\". Book: %10%.",
       host,                                                      // 1
       port,                                                      // 2
       username,                                                  // 3
@@ -47,7 +48,8 @@ void fix::Settings::Log(Module::Log &log) const {
       targetCompId,                                              // 6
       senderSubId,                                               // 7
       targetSubId,                                               // 8
-      isSecure ? "secure" : "not secure");                       // 9
+      isSecure ? "secure" : "not secure",                        // 9
+      isFullBookEnabled ? "full depth" : "top of book");         // 10
 }
 
 void fix::Settings::Validate() const {}
@@ -23,6 +23,8 @@ struct Settings {
   std::string targetCompId;
   std::string senderSubId;
   std::string targetSubId;
+  //! Subscribes to the full depth instead of the best prices only.
+  bool isFullBookEnabled;
   std::unique_ptr<Policy> policy;
 
   Settings(const boost::property_tree::ptree &, const trdk::Settings &);
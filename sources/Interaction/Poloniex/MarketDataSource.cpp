@@ -60,15 +60,13 @@ trdk::Security &p::MarketDataSource::CreateNewSecurityObject(
   }
   const auto &result = m_securities.emplace(
       product->second.id,
-      SecuritySubscription{
+      SecuritySubscription(
           boost::make_shared<Rest::Security>(GetContext(), symbol, *this,
                                              Security::SupportedLevel1Types()
                                                  .set(LEVEL1_TICK_BID_PRICE)
                                                  .set(LEVEL1_TICK_BID_QTY)
                                                  .set(LEVEL1_TICK_ASK_PRICE)
-                                                 .set(LEVEL1_TICK_BID_QTY)),
-          {},
-          {}});
+                                                 .set(LEVEL1_TICK_BID_QTY))));
   Assert(result.second);
   result.first->second.security->SetTradingSessionState(pt::not_a_date_time,
                                                         true);
@@ -89,7 +87,7 @@ void p::MarketDataSource::HandleMessage(const pt::ptime &time,
                                         const ptr::ptree &message,
                                         const Milestones &delayMeasurement) {
   SecuritySubscription *security = nullptr;
-  auto hasSequenceNumber = false;
+  boost::optional<PriceBookBuilder::SequenceNumber> sequenceNumber;
   for (const auto &node : message) {
     if (!security) {
       const auto &product = node.second.get_value<ProductId>();
@@ -104,47 +102,71 @@ void p::MarketDataSource::HandleMessage(const pt::ptime &time,
         throw Exception(error.str().c_str());
       }
       security = &it->second;
-    } else if (!hasSequenceNumber) {
-      hasSequenceNumber = true;
+    } else if (!sequenceNumber) {
+      sequenceNumber =
+          node.second.get_value<PriceBookBuilder::SequenceNumber>();
     } else {
-      UpdatePrices(time, node.second, *security, delayMeasurement);
+      UpdatePrices(time, *sequenceNumber, node.second, *security,
+                   delayMeasurement);
     }
   }
 }
 
 namespace {
 
-template <Level1TickType priceType, Level1TickType qtyType>
-std::map<Price, std::pair<Level1TickValue, Level1TickValue>> ReadBook(
-    const ptr::ptree &source) {
-  std::map<Price, std::pair<Level1TickValue, Level1TickValue>> result;
+void ReadBook(const OrderSide &side,
+              const ptr::ptree &source,
+              PriceBookBuilder &book) {
   for (const auto &line : source) {
-    const auto &price = boost::lexical_cast<Price>(line.first);
-    const auto &qty = line.second.get_value<Qty>();
-    auto it = result.emplace(
-        price, std::make_pair(Level1TickValue::Create<priceType>(price),
-                              Level1TickValue::Create<qtyType>(qty)));
-    if (!it.second) {
-      it.first->second.second = Level1TickValue::Create<qtyType>(
-          it.first->second.second.GetValue() + qty);
+    book.Update(side, boost::lexical_cast<Price>(line.first),
+                line.second.get_value<Qty>());
+  }
+}
+
+bool IsSnapshot(const ptr::ptree &message) {
+  for (const auto &node : message) {
+    if (!node.second.empty() &&
+        node.second.front().second.get_value<char>() == 'i') {
+      return true;
     }
   }
-  return result;
+  return false;
 }
 }  // namespace
 
-void p::MarketDataSource::UpdatePrices(const pt::ptime &time,
-                                       const ptr::ptree &message,
-                                       SecuritySubscription &security,
-                                       const Milestones &delayMeasurement) {
+void p::MarketDataSource::UpdatePrices(
+    const pt::ptime &time,
+    const PriceBookBuilder::SequenceNumber &sequenceNumber,
+    const ptr::ptree &message,
+    SecuritySubscription &security,
+    const Milestones &delayMeasurement) {
+  auto &book = security.book;
+  if (!IsSnapshot(message)) {
+    switch (book.CheckSequenceNumber(sequenceNumber)) {
+      case PriceBookBuilder::DIFF_CHECK_RESULT_ACTUAL:
+        break;
+      case PriceBookBuilder::DIFF_CHECK_RESULT_SKIP:
+        return;
+      case PriceBookBuilder::DIFF_CHECK_RESULT_GAP:
+        GetLog().Warn(
+            "Price book update for %1% is lost (received %2%, expected %3%), "
+            "reconnecting to get new snapshot...",
+            *security.security,              // 1
+            sequenceNumber,                  // 2
+            *book.GetSequenceNumber() + 1);  // 3
+        Reconnect();
+        return;
+    }
+  }
+
   for (const auto &node : message) {
     boost::optional<char> type;
-    boost::optional<bool> isBid;
+    boost::optional<OrderSide> side;
     boost::optional<Price> price;
     auto hasQty = false;
     for (const auto &line : node.second) {
       if (hasQty) {
-        security.security->SetOnline(pt::not_a_date_time, false);
+        book.Stop();
         throw Exception("Book line has wrong format");
       }
       if (!type) {
@@ -152,66 +174,33 @@ void p::MarketDataSource::UpdatePrices(const pt::ptime &time,
       } else {
         switch (*type) {
           case 'i': {
+            book.StartSnapshot(sequenceNumber);
             auto hasAsks = false;
-            for (const auto &side : line.second.get_child("orderBook")) {
-              if (!hasAsks) {
-                security.asks =
-                    ReadBook<LEVEL1_TICK_ASK_PRICE, LEVEL1_TICK_ASK_QTY>(
-                        side.second);
-                hasAsks = true;
-              } else {
-                security.bids =
-                    ReadBook<LEVEL1_TICK_BID_PRICE, LEVEL1_TICK_BID_QTY>(
-                        side.second);
-              }
+            for (const auto &bookSide : line.second.get_child("orderBook")) {
+              ReadBook(hasAsks ? ORDER_SIDE_BID : ORDER_SIDE_ASK,
+                       bookSide.second, book);
+              hasAsks = true;
             }
             break;
           }
           case 'o':
-            if (!isBid) {
+            if (!side) {
               switch (line.second.get_value<int>()) {
                 case 0:
-                  isBid.emplace(false);
+                  side.emplace(ORDER_SIDE_ASK);
                   break;
                 case 1:
-                  isBid.emplace(true);
+                  side.emplace(ORDER_SIDE_BID);
                   break;
                 default:
-                  security.security->SetOnline(pt::not_a_date_time, false);
+                  book.Stop();
                   throw Exception("Unknown book line side");
               }
             } else if (!price) {
               price.emplace(line.second.get_value<Price>());
             } else {
               hasQty = true;
-              const auto &qty = line.second.get_value<Qty>();
-              auto &storage = *isBid ? security.bids : security.asks;
-              auto it = storage.find(*price);
-              if (it == storage.cend()) {
-                if (qty == 0) {
-                  break;
-                }
-                storage.emplace(
-                    *price,
-                    *isBid
-                        ? std::make_pair(
-                              Level1TickValue::Create<LEVEL1_TICK_BID_PRICE>(
-                                  *price),
-                              Level1TickValue::Create<LEVEL1_TICK_BID_QTY>(qty))
-                        : std::make_pair(
-                              Level1TickValue::Create<LEVEL1_TICK_ASK_PRICE>(
-                                  *price),
-                              Level1TickValue::Create<LEVEL1_TICK_ASK_QTY>(
-                                  qty)));
-                break;
-              }
-              if (qty == 0) {
-                storage.erase(it);
-              } else {
-                it->second.second =
-                    *isBid ? Level1TickValue::Create<LEVEL1_TICK_BID_QTY>(qty)
-                           : Level1TickValue::Create<LEVEL1_TICK_ASK_QTY>(qty);
-              }
+              book.Update(*side, *price, line.second.get_value<Qty>());
             }
             break;
           default:
@@ -220,14 +209,6 @@ void p::MarketDataSource::UpdatePrices(const pt::ptime &time,
       }
     }
   }
-  if (security.bids.empty() || security.asks.empty()) {
-    security.security->SetOnline(pt::not_a_date_time, false);
-    return;
-  }
 
-  const auto &bestBid = security.bids.crbegin()->second;
-  const auto &bestAsk = security.asks.cbegin()->second;
-  security.security->SetLevel1(time, bestBid.first, bestBid.second,
-                               bestAsk.first, bestAsk.second, delayMeasurement);
-  security.security->SetOnline(pt::not_a_date_time, true);
+  book.Flush(time, delayMeasurement);
 }
@@ -45,6 +45,7 @@ class MarketDataSource : public TradingLib::WebSocketMarketDataSource {
                      const boost::property_tree::ptree &,
                      const Lib::TimeMeasurement::Milestones &) override;
   void UpdatePrices(const boost::posix_time::ptime &,
+                    const PriceBookBuilder::SequenceNumber &,
                     const boost::property_tree::ptree &,
                     SecuritySubscription &,
                     const Lib::TimeMeasurement::Milestones &);
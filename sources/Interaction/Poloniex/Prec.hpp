@@ -13,6 +13,7 @@
 #include "Common/Common.hpp"
 #include "Interaction/Rest/Common.hpp"
 #include "TradingLib/BalancesContainer.hpp"
+#include "TradingLib/PriceBookBuilder.hpp"
 #include "TradingLib/WebSocketConnection.hpp"
 #include "TradingLib/WebSocketMarketDataSource.hpp"
 #include "Core/Context.hpp"
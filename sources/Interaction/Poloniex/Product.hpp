@@ -15,6 +15,7 @@ namespace Interaction {
 namespace Poloniex {
 
 typedef uintmax_t ProductId;
+typedef TradingLib::PriceBookBuilder<Rest::Security> PriceBookBuilder;
 
 struct Product {
   ProductId id;
@@ -22,8 +23,10 @@ struct Product {
 
 struct SecuritySubscription {
   boost::shared_ptr<Rest::Security> security;
-  std::map<Price, std::pair<Level1TickValue, Level1TickValue>> bids;
-  std::map<Price, std::pair<Level1TickValue, Level1TickValue>> asks;
+  PriceBookBuilder book;
+
+  explicit SecuritySubscription(boost::shared_ptr<Rest::Security> source)
+      : security(std::move(source)), book(*security) {}
 };
 
 const boost::unordered_map<std::string, Product> &GetProductList();
@@ -32,8 +32,8 @@ CexioRequest::CexioRequest(const std::string &name,
            tradingLog) {}
 
 FloodControl &CexioRequest::GetFloodControl() const {
-  static auto result = CreateFloodControlWithMaxRequestsPerPeriod(
-      600, pt::minutes(10), pt::seconds(2));
+  static auto result =
+      CreateAdaptiveFloodControl(600, pt::minutes(10), pt::seconds(2));
   return *result;
 }
 
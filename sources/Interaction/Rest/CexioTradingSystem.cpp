@@ -42,13 +42,13 @@ CexioTradingSystem::PrivateRequest::PrivateRequest(
     const std::string &params,
     const Settings &settings,
     NonceStorage::TakenValue &&nonce,
-    bool isPriority,
+    const RequestClass &requestClass,
     const Context &context,
     ModuleEventsLog &log,
     ModuleTradingLog *tradingLog)
     : Base(name, net::HTTPRequest::HTTP_POST, params, context, log, tradingLog),
       m_settings(settings),
-      m_isPriority(isPriority),
+      m_requestClass(requestClass),
       m_nonce(std::move(nonce)) {}
 
 CexioTradingSystem::PrivateRequest::Response
@@ -83,11 +83,17 @@ CexioTradingSystem::BalancesRequest::BalancesRequest(
     NonceStorage::TakenValue &&nonce,
     const Context &context,
     ModuleEventsLog &log)
-    : PrivateRequest(
-          "balance", "", settings, std::move(nonce), false, context, log) {}
+    : PrivateRequest("balance",
+                     "",
+                     settings,
+                     std::move(nonce),
+                     REQUEST_CLASS_BALANCES,
+                     context,
+                     log) {}
 
 CexioTradingSystem::OrderRequest::OrderRequest(const std::string &name,
                                                const std::string &params,
+                                               const RequestClass &requestClass,
                                                const Settings &settings,
                                                NonceStorage::TakenValue &&nonce,
                                                const Context &context,
@@ -97,7 +103,7 @@ CexioTradingSystem::OrderRequest::OrderRequest(const std::string &name,
                      params,
                      settings,
                      std::move(nonce),
-                     true,
+                     requestClass,
                      context,
                      log,
                      &tradingLog) {}
@@ -182,8 +188,9 @@ void CexioTradingSystem::UpdateOrders() {
     const auto &orderId = context->GetOrderId();
     PrivateRequest request("get_order",
                            "id=" + boost::lexical_cast<std::string>(orderId),
-                           m_settings, m_nonces.TakeNonce(), false,
-                           GetContext(), GetLog(), &GetTradingLog());
+                           m_settings, m_nonces.TakeNonce(),
+                           REQUEST_CLASS_ORDER_STATUS, GetContext(), GetLog(),
+                           &GetTradingLog());
     const auto response = boost::get<1>(request.Send(m_tradingSession));
     UpdateOrder(orderId, response);
   }
@@ -291,7 +298,8 @@ CexioTradingSystem::SendOrderTransaction(trdk::Security &security,
       % price->Get();                                        // 3
 
   OrderRequest request("place_order/" + product.id, requestParams.str(),
-                       m_settings, m_nonces.TakeNonce(), GetContext(), GetLog(),
+                       REQUEST_CLASS_ORDER_PLACEMENT, m_settings,
+                       m_nonces.TakeNonce(), GetContext(), GetLog(),
                        GetTradingLog());
 
   const auto response = boost::get<1>(request.Send(m_tradingSession));
@@ -314,8 +322,8 @@ void CexioTradingSystem::SendCancelOrderTransaction(
   OrderRequest request(
       "cancel_order",
       "id=" + boost::lexical_cast<std::string>(transaction.GetOrderId()),
-      m_settings, m_nonces.TakeNonce(), GetContext(), GetLog(),
-      GetTradingLog());
+      REQUEST_CLASS_ORDER_CANCEL, m_settings, m_nonces.TakeNonce(),
+      GetContext(), GetLog(), GetTradingLog());
   request.Send(m_tradingSession);
 }
 
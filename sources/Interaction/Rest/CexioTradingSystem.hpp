@@ -42,7 +42,7 @@ class CexioTradingSystem : public TradingSystem {
                             const std::string &params,
                             const Settings &,
                             NonceStorage::TakenValue &&,
-                            bool isPriority,
+                            const RequestClass &,
                             const Context &,
                             ModuleEventsLog &,
                             ModuleTradingLog * = nullptr);
@@ -52,13 +52,18 @@ class CexioTradingSystem : public TradingSystem {
     virtual Response Send(std::unique_ptr<Poco::Net::HTTPSClientSession> &);
 
    protected:
-    virtual bool IsPriority() const override { return m_isPriority; }
+    virtual bool IsPriority() const override {
+      return m_requestClass <= REQUEST_CLASS_ORDER_CANCEL;
+    }
+    virtual RequestClass GetRequestClass() const override {
+      return m_requestClass;
+    }
     virtual void CreateBody(const Poco::Net::HTTPClientSession &,
                             std::string &result) const override;
 
    private:
     const Settings &m_settings;
-    const bool m_isPriority;
+    const RequestClass m_requestClass;
     NonceStorage::TakenValue m_nonce;
   };
 
@@ -74,6 +79,7 @@ class CexioTradingSystem : public TradingSystem {
    public:
     explicit OrderRequest(const std::string &name,
                           const std::string &params,
+                          const RequestClass &,
                           const Settings &settings,
                           NonceStorage::TakenValue &&,
                           const Context &context,
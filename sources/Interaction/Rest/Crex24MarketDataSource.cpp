@@ -31,7 +31,8 @@ Crex24MarketDataSource::Crex24MarketDataSource(const App &,
                                                const ptr::ptree &conf)
     : Base(context, std::move(instanceName), std::move(title)),
       m_settings(conf, GetLog()),
-      m_session(CreateCrex24Session(m_settings, false)),
+      m_sessions([this]() { return CreateCrex24Session(m_settings, false); },
+                 m_settings.pollingSettings.GetNumberOfThreads()),
       m_pollingTask(boost::make_unique<PollingTask>(m_settings.pollingSettings,
                                                     GetLog())) {}
 
@@ -52,7 +53,8 @@ void Crex24MarketDataSource::Connect() {
 
   boost::unordered_map<std::string, Crex24Product> products;
   try {
-    products = RequestCrex24ProductList(m_session, GetContext(), GetLog());
+    products =
+        RequestCrex24ProductList(*m_sessions.Take(), GetContext(), GetLog());
   } catch (const std::exception &ex) {
     throw ConnectError(ex.what());
   }
@@ -75,26 +77,25 @@ const boost::unordered_set<std::string>
 }
 
 void Crex24MarketDataSource::SubscribeToSecurities() {
-  std::vector<
-      std::pair<boost::shared_ptr<Security>, boost::shared_ptr<Request>>>
-      subscribtion;
+  // Each security has its own request, so one slow request doesn't delay
+  // prices of other securities.
   for (const auto &security : m_securities) {
     if (!security.second.second) {
       continue;
     }
-    auto request = boost::make_shared<Crex24PublicRequestV1>(
+    const auto request = boost::make_shared<Crex24PublicRequestV1>(
         "ReturnOrderBook",
         "request=[PairName=" + security.second.first.id + "]", GetContext(),
         GetLog());
-    subscribtion.emplace_back(std::make_pair(security.second.second, request));
+    const auto &subscribedSecurity = security.second.second;
+    m_pollingTask->ReplaceTask(
+        "Prices " + security.second.first.id, 1,
+        [this, subscribedSecurity, request]() {
+          UpdatePrices(*subscribedSecurity, *request);
+          return true;
+        },
+        m_settings.pollingSettings.GetPricesRequestFrequency(), false, true);
   }
-  m_pollingTask->ReplaceTask(
-      "Prices", 1,
-      [this, subscribtion]() {
-        UpdatePrices(subscribtion);
-        return true;
-      },
-      m_settings.pollingSettings.GetPricesRequestFrequency(), false);
 }
 
 trdk::Security &Crex24MarketDataSource::CreateNewSecurityObject(
@@ -119,34 +120,6 @@ trdk::Security &Crex24MarketDataSource::CreateNewSecurityObject(
   return *security->second.second;
 }
 
-void Crex24MarketDataSource::UpdatePrices(
-    const std::vector<std::pair<boost::shared_ptr<r::Security>,
-                                boost::shared_ptr<Request>>> &subscribtion) {
-  for (const auto &security : subscribtion) {
-    try {
-      UpdatePrices(*security.first, *security.second);
-    } catch (const std::exception &ex) {
-      for (auto &offlineSecurity : subscribtion) {
-        try {
-          offlineSecurity.first->SetOnline(pt::not_a_date_time, false);
-        } catch (...) {
-          AssertFailNoException();
-          throw;
-        }
-      }
-      boost::format error("Failed to read \"depth\": \"%1%\"");
-      error % ex.what();
-      try {
-        throw;
-      } catch (const CommunicationError &) {
-        throw CommunicationError(error.str().c_str());
-      } catch (...) {
-        throw Exception(error.str().c_str());
-      }
-    }
-  }
-}
-
 namespace {
 #pragma warning(push)
 #pragma warning(disable : 4702)  // Warning	C4702	unreachable code
@@ -169,28 +142,46 @@ boost::optional<std::pair<Level1TickValue, Level1TickValue>> ReadTopOfBook(
 
 void Crex24MarketDataSource::UpdatePrices(r::Security &security,
                                           Request &request) {
-  const auto &response = request.Send(m_session);
-  const auto &time = boost::get<0>(response);
-  const auto &data = boost::get<1>(response);
-  const auto &delayMeasurement = boost::get<2>(response);
-  const auto &bestAsk =
-      ReadTopOfBook<LEVEL1_TICK_BID_PRICE, LEVEL1_TICK_BID_QTY>(
-          data.get_child_optional("BuyOrders"));
-  const auto &bestBid =
-      ReadTopOfBook<LEVEL1_TICK_ASK_PRICE, LEVEL1_TICK_ASK_QTY>(
-          data.get_child_optional("SellOrders"));
-  if (bestAsk && bestBid) {
-    security.SetLevel1(time, bestBid->first, bestBid->second, bestAsk->first,
-                       bestAsk->second, delayMeasurement);
-    security.SetOnline(pt::not_a_date_time, true);
-  } else {
-    security.SetOnline(pt::not_a_date_time, false);
-    if (bestBid) {
-      security.SetLevel1(time, bestBid->first, bestBid->second,
-                         delayMeasurement);
-    } else if (bestAsk) {
-      security.SetLevel1(time, bestAsk->first, bestAsk->second,
-                         delayMeasurement);
+  try {
+    const auto &response = request.Send(*m_sessions.Take());
+    const auto &time = boost::get<0>(response);
+    const auto &data = boost::get<1>(response);
+    const auto &delayMeasurement = boost::get<2>(response);
+    const auto &bestAsk =
+        ReadTopOfBook<LEVEL1_TICK_BID_PRICE, LEVEL1_TICK_BID_QTY>(
+            data.get_child_optional("BuyOrders"));
+    const auto &bestBid =
+        ReadTopOfBook<LEVEL1_TICK_ASK_PRICE, LEVEL1_TICK_ASK_QTY>(
+            data.get_child_optional("SellOrders"));
+    if (bestAsk && bestBid) {
+      security.SetLevel1(time, bestBid->first, bestBid->second, bestAsk->first,
+                         bestAsk->second, delayMeasurement);
+      security.SetOnline(pt::not_a_date_time, true);
+    } else {
+      security.SetOnline(pt::not_a_date_time, false);
+      if (bestBid) {
+        security.SetLevel1(time, bestBid->first, bestBid->second,
+                           delayMeasurement);
+      } else if (bestAsk) {
+        security.SetLevel1(time, bestAsk->first, bestAsk->second,
+                           delayMeasurement);
+      }
+    }
+  } catch (const std::exception &ex) {
+    try {
+      security.SetOnline(pt::not_a_date_time, false);
+    } catch (...) {
+      AssertFailNoException();
+      throw;
+    }
+    boost::format error("Failed to read \"depth\": \"%1%\"");
+    error % ex.what();
+    try {
+      throw;
+    } catch (const CommunicationError &) {
+      throw CommunicationError(error.str().c_str());
+    } catch (...) {
+      throw Exception(error.str().c_str());
     }
   }
 }
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "Crex24Util.hpp"
+#include "SessionPool.hpp"
 #include "Settings.hpp"
 
 namespace trdk {
@@ -38,13 +39,11 @@ class Crex24MarketDataSource : public MarketDataSource {
   trdk::Security &CreateNewSecurityObject(const Lib::Symbol &) override;
 
  private:
-  void UpdatePrices(const std::vector<std::pair<boost::shared_ptr<Security>,
-                                                boost::shared_ptr<Request>>> &);
   void UpdatePrices(Security &, Request &);
 
   const Settings m_settings;
 
-  std::unique_ptr<Poco::Net::HTTPSClientSession> m_session;
+  SessionPool m_sessions;
 
   boost::unordered_map<std::string,
                        std::pair<Crex24Product, boost::shared_ptr<Security>>>
@@ -52,8 +52,15 @@ void ReportDelay(const pt::ptime &startTime,
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void FloodControl::Check(const RequestClass &requestClass,
+                         ModuleEventsLog &log) {
+  Check(requestClass <= REQUEST_CLASS_ORDER_CANCEL, log);
+}
+
 void FloodControl::OnRateLimitExceeded() {}
 
+void FloodControl::OnRemainingNumberOfRequests(size_t) {}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 std::unique_ptr<FloodControl> r::CreateDisabledFloodControl() {
@@ -218,3 +225,177 @@ std::unique_ptr<FloodControl> r::CreateFloodControlWithMaxRequestsPerPeriod(
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<FloodControl> r::CreateAdaptiveFloodControl(
+    size_t maxNumberOfRequest,
+    const pt::time_duration &period,
+    const pt::time_duration &criticalWaitTimeToReport) {
+  return CreateAdaptiveFloodControl(
+      maxNumberOfRequest, period, criticalWaitTimeToReport,
+      []() { return pt::microsec_clock::universal_time(); });
+}
+
+std::unique_ptr<FloodControl> r::CreateAdaptiveFloodControl(
+    size_t maxNumberOfRequest,
+    const pt::time_duration &period,
+    const pt::time_duration &criticalWaitTimeToReport,
+    const boost::function<pt::ptime()> &getCurrentTime) {
+  class AdaptiveFloodControl : public FloodControl {
+   private:
+    typedef boost::mutex Mutex;
+    typedef Mutex::scoped_lock Lock;
+    typedef boost::condition_variable Condition;
+
+   public:
+    AdaptiveFloodControl(size_t maxNumberOfRequest,
+                         const pt::time_duration &period,
+                         const pt::time_duration &criticalWaitTimeToReport,
+                         const boost::function<pt::ptime()> &getCurrentTime)
+        : m_capacity(static_cast<double>(maxNumberOfRequest)),
+          m_reserve(std::floor(m_capacity / 10)),
+          m_period(period),
+          m_maxRate(m_capacity / period.total_microseconds()),
+          m_criticalWaitTimeToReport(criticalWaitTimeToReport),
+          m_getCurrentTime(getCurrentTime),
+          m_rate(m_maxRate),
+          m_numberOfTokens(m_capacity),
+          m_updateTime(GetCurrentTime()),
+          m_rateChangeTime(m_updateTime),
+          m_nextTicket(0) {
+      AssertLt(0, maxNumberOfRequest);
+      AssertLt(pt::microseconds(0), period);
+    }
+
+    virtual ~AdaptiveFloodControl() override = default;
+
+   public:
+    virtual void Check(bool isPriority, ModuleEventsLog &log) override {
+      Check(isPriority ? REQUEST_CLASS_ORDER_PLACEMENT
+                       : REQUEST_CLASS_MARKET_DATA,
+            log);
+    }
+
+    virtual void Check(const RequestClass &requestClass,
+                       ModuleEventsLog &log) override {
+      AssertGt(numberOfRequestClasses, requestClass);
+
+      Lock lock(m_mutex);
+
+      const auto &startTime = GetCurrentTime();
+
+      auto &queue = m_queues[requestClass];
+      const auto ticket = m_nextTicket++;
+      queue.emplace_back(ticket);
+
+      // Market data and balances requests can't take the reserve, so trading
+      // requests don't wait for them when the limit is near.
+      const auto requiredNumberOfTokens =
+          requestClass > REQUEST_CLASS_ORDER_STATUS ? 1 + m_reserve : 1;
+
+      auto now = startTime;
+      try {
+        for (;;) {
+          Refill(now);
+          if (!IsTurn(requestClass, ticket)) {
+            m_condition.wait(lock);
+          } else if (m_numberOfTokens < requiredNumberOfTokens) {
+            m_condition.timed_wait(
+                lock, pt::microseconds(static_cast<int64_t>(std::ceil(
+                          (requiredNumberOfTokens - m_numberOfTokens) /
+                          m_rate))));
+          } else {
+            break;
+          }
+          now = GetCurrentTime();
+        }
+      } catch (...) {
+        queue.erase(std::find(queue.begin(), queue.end(), ticket));
+        m_condition.notify_all();
+        throw;
+      }
+
+      AssertEq(ticket, queue.front());
+      queue.pop_front();
+      m_numberOfTokens -= 1;
+      m_condition.notify_all();
+
+      ReportDelay(startTime, now, m_criticalWaitTimeToReport,
+                  requestClass <= REQUEST_CLASS_ORDER_CANCEL, GetQueueSize(),
+                  log);
+    }
+
+    virtual void OnRateLimitExceeded() override {
+      const Lock lock(m_mutex);
+      const auto &now = GetCurrentTime();
+      Refill(now);
+      m_numberOfTokens = 0;
+      m_rate = std::max(m_rate / 2, m_maxRate / 16);
+      m_rateChangeTime = now;
+    }
+
+    virtual void OnRemainingNumberOfRequests(size_t numberOfRequests) override {
+      const Lock lock(m_mutex);
+      Refill(GetCurrentTime());
+      m_numberOfTokens =
+          std::min(m_numberOfTokens, static_cast<double>(numberOfRequests));
+    }
+
+   private:
+    pt::ptime GetCurrentTime() const { return m_getCurrentTime(); }
+
+    void Refill(const pt::ptime &now) {
+      if (m_rate < m_maxRate && now - m_rateChangeTime >= m_period) {
+        m_rate = std::min(m_rate * 2, m_maxRate);
+        m_rateChangeTime = now;
+      }
+      m_numberOfTokens =
+          std::min(m_numberOfTokens +
+                       (now - m_updateTime).total_microseconds() * m_rate,
+                   m_capacity);
+      m_updateTime = now;
+    }
+
+    bool IsTurn(const RequestClass &requestClass, uint64_t ticket) const {
+      if (m_queues[requestClass].front() != ticket) {
+        return false;
+      }
+      for (size_t i = 0; i < requestClass; ++i) {
+        if (!m_queues[i].empty()) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    size_t GetQueueSize() const {
+      size_t result = 0;
+      for (const auto &queue : m_queues) {
+        result += queue.size();
+      }
+      return result;
+    }
+
+   private:
+    const double m_capacity;
+    const double m_reserve;
+    const pt::time_duration m_period;
+    //! Tokens per microsecond.
+    const double m_maxRate;
+    const pt::time_duration m_criticalWaitTimeToReport;
+    const boost::function<pt::ptime()> m_getCurrentTime;
+
+    Mutex m_mutex;
+    Condition m_condition;
+    double m_rate;
+    double m_numberOfTokens;
+    pt::ptime m_updateTime;
+    pt::ptime m_rateChangeTime;
+    uint64_t m_nextTicket;
+    std::array<std::deque<uint64_t>, numberOfRequestClasses> m_queues;
+  };
+
+  return boost::make_unique<AdaptiveFloodControl>(
+      maxNumberOfRequest, period, criticalWaitTimeToReport, getCurrentTime);
+}
+
+////////////////////////////////////////////////////////////////////////////////
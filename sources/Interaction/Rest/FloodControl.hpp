@@ -16,12 +16,33 @@ namespace Rest {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+//! Request class for the flood control, from the highest priority to the
+//! lowest.
+enum RequestClass {
+  REQUEST_CLASS_ORDER_PLACEMENT,
+  REQUEST_CLASS_ORDER_CANCEL,
+  REQUEST_CLASS_ORDER_STATUS,
+  REQUEST_CLASS_MARKET_DATA,
+  REQUEST_CLASS_BALANCES,
+  numberOfRequestClasses
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 class TRDK_INTERACTION_REST_API FloodControl : boost::noncopyable {
  public:
   virtual ~FloodControl() = default;
 
   virtual void Check(bool isPriority, ModuleEventsLog &) = 0;
+  //! Checks request by its class.
+  /**
+   * By default, order placement and cancel requests are priority requests.
+   */
+  virtual void Check(const RequestClass &, ModuleEventsLog &);
+
   virtual void OnRateLimitExceeded();
+  //! Server reports the number of requests left for the current period.
+  virtual void OnRemainingNumberOfRequests(size_t);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -38,6 +59,26 @@ std::unique_ptr<FloodControl> CreateFloodControlWithMaxRequestsPerPeriod(
     const boost::posix_time::time_duration &period,
     const boost::posix_time::time_duration &criticalWaitTimeToReport);
 
+//! Token bucket which learns the actual server limit.
+/**
+ * Waiting requests are served in the order of request classes, market data and
+ * balances requests leave a reserve of tokens for trading requests. The rate is
+ * halved each time the server rejects a request by the rate limit and is
+ * restored step by step after each period without rejections.
+ */
+std::unique_ptr<FloodControl> CreateAdaptiveFloodControl(
+    size_t maxNumberOfRequest,
+    const boost::posix_time::time_duration &period,
+    const boost::posix_time::time_duration &criticalWaitTimeToReport);
+//! Creates adaptive flood control which takes the current time from the
+//! custom source.
+TRDK_INTERACTION_REST_API std::unique_ptr<FloodControl>
+CreateAdaptiveFloodControl(
+    size_t maxNumberOfRequest,
+    const boost::posix_time::time_duration &period,
+    const boost::posix_time::time_duration &criticalWaitTimeToReport,
+    const boost::function<boost::posix_time::ptime()> &getCurrentTime);
+
 ////////////////////////////////////////////////////////////////////////////////
 }  // namespace Rest
 }  // namespace Interaction
@@ -0,0 +1,211 @@
+/*******************************************************************************
+ *   Created: 2026/10/17 16:12:45
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Core/ContextDummy.hpp"
+#include "Core/EventsLog.hpp"
+#include "Interaction/Rest/Api.h"
+#include "Interaction/Rest/FloodControl.hpp"
+
+using namespace trdk;
+using namespace trdk::Interaction::Rest;
+namespace pt = boost::posix_time;
+
+namespace {
+
+//! Time source which is moved only by the test.
+class Clock : private boost::noncopyable {
+ public:
+  Clock() : m_time(0) {}
+
+  pt::ptime operator()() const {
+    return pt::ptime(boost::gregorian::date(2018, 3, 4)) +
+           pt::microseconds(m_time.load());
+  }
+
+  void Move(const pt::time_duration &time) {
+    m_time += time.total_microseconds();
+  }
+
+ private:
+  boost::atomic_int64_t m_time;
+};
+
+//! The test time is frozen while the request waits, so the request is blocked
+//! until the test moves the time.
+class Request : private boost::noncopyable {
+ public:
+  explicit Request(FloodControl &floodControl,
+                   const RequestClass &requestClass,
+                   ModuleEventsLog &log)
+      : m_thread([&floodControl, requestClass, &log]() {
+          floodControl.Check(requestClass, log);
+        }) {}
+  ~Request() {
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+  }
+
+  bool IsBlocked() {
+    return m_thread.joinable() &&
+           !m_thread.try_join_for(boost::chrono::milliseconds(100));
+  }
+
+ private:
+  boost::thread m_thread;
+};
+
+class FloodControlTest : public testing::Test {
+ protected:
+  FloodControlTest()
+      : m_log("Test", Tests::Dummies::Context::GetInstance().GetLog()) {}
+
+  std::unique_ptr<FloodControl> Create(size_t maxNumberOfRequest) {
+    // Each token is restored in 1 millisecond.
+    return CreateAdaptiveFloodControl(
+        maxNumberOfRequest,
+        pt::milliseconds(static_cast<int64_t>(maxNumberOfRequest)),
+        pt::hours(1), boost::cref(m_clock));
+  }
+
+  std::unique_ptr<Request> Start(FloodControl &floodControl,
+                                 const RequestClass &requestClass) {
+    return boost::make_unique<Request>(floodControl, requestClass, m_log);
+  }
+
+  Clock m_clock;
+  ModuleEventsLog m_log;
+};
+
+}  // namespace
+
+TEST_F(FloodControlTest, ClassOrdering) {
+  const auto &floodControl = Create(10);
+  for (size_t i = 0; i < 10; ++i) {
+    floodControl->Check(REQUEST_CLASS_ORDER_PLACEMENT, m_log);
+  }
+
+  // Requests are started from the lowest priority:
+  std::vector<std::unique_ptr<Request>> requests(numberOfRequestClasses);
+  for (size_t i = numberOfRequestClasses; i > 0; --i) {
+    auto &request = requests[i - 1];
+    request = Start(*floodControl, static_cast<RequestClass>(i - 1));
+    EXPECT_TRUE(request->IsBlocked());
+  }
+
+  // Each move restores a token for the next request:
+  const auto &checkTurn = [&requests](size_t passed) {
+    EXPECT_FALSE(requests[passed]->IsBlocked());
+    for (size_t i = passed + 1; i < requests.size(); ++i) {
+      EXPECT_TRUE(requests[i]->IsBlocked());
+    }
+  };
+  m_clock.Move(pt::microseconds(1500));
+  checkTurn(REQUEST_CLASS_ORDER_PLACEMENT);
+  m_clock.Move(pt::milliseconds(1));
+  checkTurn(REQUEST_CLASS_ORDER_CANCEL);
+  m_clock.Move(pt::milliseconds(1));
+  checkTurn(REQUEST_CLASS_ORDER_STATUS);
+  // Market data and balances requests also wait for the reserve of 1 token:
+  m_clock.Move(pt::milliseconds(1));
+  EXPECT_TRUE(requests[REQUEST_CLASS_MARKET_DATA]->IsBlocked());
+  m_clock.Move(pt::milliseconds(1));
+  checkTurn(REQUEST_CLASS_MARKET_DATA);
+  m_clock.Move(pt::milliseconds(1));
+  checkTurn(REQUEST_CLASS_BALANCES);
+}
+
+TEST_F(FloodControlTest, ReserveBlocksMarketData) {
+  // The reserve is 2 tokens.
+  const auto &floodControl = Create(20);
+  for (size_t i = 0; i < 17; ++i) {
+    floodControl->Check(REQUEST_CLASS_ORDER_STATUS, m_log);
+  }
+  floodControl->Check(REQUEST_CLASS_MARKET_DATA, m_log);
+
+  {
+    const auto &request = Start(*floodControl, REQUEST_CLASS_MARKET_DATA);
+    EXPECT_TRUE(request->IsBlocked());
+    // Trading requests take the reserve and overtake the waiting market data
+    // request:
+    floodControl->Check(REQUEST_CLASS_ORDER_PLACEMENT, m_log);
+    floodControl->Check(REQUEST_CLASS_ORDER_CANCEL, m_log);
+    EXPECT_TRUE(request->IsBlocked());
+
+    m_clock.Move(pt::milliseconds(2));
+    EXPECT_TRUE(request->IsBlocked());
+    m_clock.Move(pt::microseconds(1500));
+    EXPECT_FALSE(request->IsBlocked());
+  }
+}
+
+TEST_F(FloodControlTest, RateHalving) {
+  const auto &floodControl = Create(10);
+
+  floodControl->OnRateLimitExceeded();
+  {
+    // The halved rate restores 1 token in 2 milliseconds:
+    const auto &request = Start(*floodControl, REQUEST_CLASS_ORDER_PLACEMENT);
+    EXPECT_TRUE(request->IsBlocked());
+    m_clock.Move(pt::microseconds(1500));
+    EXPECT_TRUE(request->IsBlocked());
+    m_clock.Move(pt::milliseconds(1));
+    EXPECT_FALSE(request->IsBlocked());
+  }
+
+  floodControl->OnRateLimitExceeded();
+  {
+    // The rate is halved again, 1 token in 4 milliseconds:
+    const auto &request = Start(*floodControl, REQUEST_CLASS_ORDER_PLACEMENT);
+    m_clock.Move(pt::microseconds(3500));
+    EXPECT_TRUE(request->IsBlocked());
+    m_clock.Move(pt::milliseconds(1));
+    EXPECT_FALSE(request->IsBlocked());
+  }
+
+  // The rate is doubled after each period without rejections:
+  m_clock.Move(pt::milliseconds(10));
+  floodControl->Check(REQUEST_CLASS_ORDER_PLACEMENT, m_log);
+  m_clock.Move(pt::milliseconds(10));
+  for (size_t i = 0; i < 10; ++i) {
+    floodControl->Check(REQUEST_CLASS_ORDER_PLACEMENT, m_log);
+  }
+  {
+    const auto &request = Start(*floodControl, REQUEST_CLASS_ORDER_PLACEMENT);
+    EXPECT_TRUE(request->IsBlocked());
+    m_clock.Move(pt::microseconds(1500));
+    EXPECT_FALSE(request->IsBlocked());
+  }
+}
+
+TEST_F(FloodControlTest, RemainingNumberOfRequests) {
+  const auto &floodControl = Create(10);
+
+  floodControl->OnRemainingNumberOfRequests(3);
+  for (size_t i = 0; i < 3; ++i) {
+    floodControl->Check(REQUEST_CLASS_ORDER_PLACEMENT, m_log);
+  }
+  {
+    const auto &request = Start(*floodControl, REQUEST_CLASS_ORDER_PLACEMENT);
+    EXPECT_TRUE(request->IsBlocked());
+    m_clock.Move(pt::microseconds(1500));
+    EXPECT_FALSE(request->IsBlocked());
+  }
+
+  // Can't add tokens, only half of the token is left:
+  floodControl->OnRemainingNumberOfRequests(20);
+  {
+    const auto &request = Start(*floodControl, REQUEST_CLASS_ORDER_PLACEMENT);
+    EXPECT_TRUE(request->IsBlocked());
+    m_clock.Move(pt::milliseconds(1));
+    EXPECT_FALSE(request->IsBlocked());
+  }
+}
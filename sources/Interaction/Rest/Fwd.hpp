@@ -19,8 +19,10 @@ struct Settings;
 
 class PollingSettings;
 class PollingTask;
+class SessionPool;
 
 class Request;
+class RequestParamsTemplate;
 }  // namespace Rest
 }  // namespace Interaction
 }  // namespace trdk
@@ -24,6 +24,7 @@ const size_t defaultPriceRequestFrequency = 1;
 const size_t defaultActualOrdersRequestFrequency = 1;
 const size_t defaultAllOrdersRequestFrequency = 4;
 const size_t defaultBalancesRequestFrequency = 4;
+const size_t defaultNumberOfThreads = 1;
 }  // namespace
 
 PollingSettings::PollingSettings(const ptr::ptree &conf)
@@ -44,7 +45,11 @@ PollingSettings::PollingSettings(const ptr::ptree &conf)
                            1)),
       m_balancesRequestFrequency(
           conf.get<size_t>("config.polling.frequency.balances",
-                           defaultBalancesRequestFrequency)) {}
+                           defaultBalancesRequestFrequency)),
+      m_numberOfThreads(
+          std::max<size_t>(conf.get<size_t>("config.polling.numberOfThreads",
+                                            defaultNumberOfThreads),
+                           1)) {}
 
 void PollingSettings::Log(ModuleEventsLog &log) const {
   if (GetInterval() == defaultInterval &&
@@ -52,15 +57,17 @@ void PollingSettings::Log(ModuleEventsLog &log) const {
       GetActualOrdersRequestFrequency() ==
           defaultActualOrdersRequestFrequency &&
       GetAllOrdersRequestFrequency() == defaultAllOrdersRequestFrequency &&
-      GetBalancesRequestFrequency() == defaultBalancesRequestFrequency) {
+      GetBalancesRequestFrequency() == defaultBalancesRequestFrequency &&
+      GetNumberOfThreads() == defaultNumberOfThreads) {
     return;
   }
   log.Info(
       "Polling settings: interval = %1%, actual orders freq. = %2%, all orders "
-      "freq. = %3%, balances freq. = %4%, prices freq. = %5%.",
+      "freq. = %3%, balances freq. = %4%, prices freq. = %5%, threads = %6%.",
       GetInterval(),                      // 1
       GetActualOrdersRequestFrequency(),  // 2
       GetAllOrdersRequestFrequency(),     // 3
       GetBalancesRequestFrequency(),      // 4
-      GetPricesRequestFrequency());       // 5
+      GetPricesRequestFrequency(),        // 5
+      GetNumberOfThreads());              // 6
 }
@@ -33,6 +33,8 @@ class TRDK_INTERACTION_REST_API PollingSettings {
   size_t GetBalancesRequestFrequency() const {
     return m_balancesRequestFrequency;
   }
+  //! Number of threads to run concurrent polling tasks.
+  size_t GetNumberOfThreads() const { return m_numberOfThreads; }
 
  private:
   boost::posix_time::time_duration m_interval;
@@ -40,6 +42,7 @@ class TRDK_INTERACTION_REST_API PollingSettings {
   size_t m_allOrdersRequestFrequency;
   size_t m_pricesRequestFrequency;
   size_t m_balancesRequestFrequency;
+  size_t m_numberOfThreads;
 };
 
 }  // namespace Rest
@@ -19,11 +19,22 @@ using namespace Rest;
 namespace pt = boost::posix_time;
 namespace ch = boost::chrono;
 
+namespace {
+const auto statReportPeriod = ch::minutes(5);
+}  // namespace
+
 PollingTask::PollingTask(const PollingSettings &setttings, ModuleEventsLog &log)
+    : PollingTask(
+          setttings.GetInterval(), setttings.GetNumberOfThreads(), log) {}
+
+PollingTask::PollingTask(const pt::time_duration &interval,
+                         const size_t numberOfThreads,
+                         ModuleEventsLog &log)
     : m_log(log),
-      m_pollingInterval(
-          ch::microseconds(setttings.GetInterval().total_microseconds())),
-      m_isAccelerated(false) {}
+      m_pollingInterval(ch::microseconds(interval.total_microseconds())),
+      m_numberOfThreads(numberOfThreads),
+      m_isAccelerated(false),
+      m_isChainScheduled(false) {}
 
 PollingTask::~PollingTask() {
   if (!m_thread) {
@@ -33,11 +44,14 @@ PollingTask::~PollingTask() {
   try {
     Lock lock(m_mutex);
     m_newTasks.clear();
+    m_jobs.clear();
     auto thread = std::move(*m_thread);
     m_thread = boost::none;
     lock.unlock();
     m_condition.notify_all();
+    m_jobsCondition.notify_all();
     thread.join();
+    m_workers.join_all();
   } catch (...) {
     AssertFailNoException();
     terminate();
@@ -48,18 +62,20 @@ void PollingTask::AddTask(std::string name,
                           const size_t priority,
                           boost::function<bool()> task,
                           const size_t frequency,
-                          const bool isAccelerable) {
+                          const bool isAccelerable,
+                          const bool isConcurrent) {
   ScheduleTaskSetting(std::move(name), priority, std::move(task), frequency,
-                      isAccelerable, false);
+                      isAccelerable, isConcurrent, false);
 }
 
 void PollingTask::ReplaceTask(std::string name,
                               const size_t priority,
                               boost::function<bool()> task,
                               const size_t frequency,
-                              const bool isAccelerable) {
+                              const bool isAccelerable,
+                              const bool isConcurrent) {
   ScheduleTaskSetting(std::move(name), priority, std::move(task), frequency,
-                      isAccelerable, true);
+                      isAccelerable, isConcurrent, true);
 }
 
 void PollingTask::ScheduleTaskSetting(std::string name,
@@ -67,40 +83,76 @@ void PollingTask::ScheduleTaskSetting(std::string name,
                                       boost::function<bool()> task,
                                       const size_t frequency,
                                       const bool isAccelerable,
+                                      const bool isConcurrent,
                                       bool replace) {
+  auto newTask = boost::make_shared<Task>();
+  newTask->name = std::move(name);
+  newTask->priority = priority;
+  newTask->isAccelerable = isAccelerable;
+  newTask->isConcurrent = isConcurrent;
+  newTask->task = std::move(task);
+  newTask->frequency = frequency;
+  newTask->numberOfErrors = 0;
+  newTask->skipCount = 0;
+  newTask->isScheduled = false;
+  newTask->isCompleted = false;
+  newTask->numberOfMissedDeadlines = 0;
+
   const Lock lock(m_mutex);
-  m_newTasks.emplace_back(Task{std::move(name), priority, isAccelerable,
-                               std::move(task), frequency},
-                          replace);
+  m_newTasks.emplace_back(std::move(newTask), replace);
   if (!m_thread) {
     m_thread = boost::thread(boost::bind(&PollingTask::RunTasks, this));
+    if (m_numberOfThreads > 1) {
+      for (size_t i = 0; i < m_numberOfThreads; ++i) {
+        m_workers.create_thread(boost::bind(&PollingTask::RunJobs, this));
+      }
+    }
   }
 }
 
 void PollingTask::SetTasks() {
+  m_tasks.erase(
+      std::remove_if(m_tasks.begin(), m_tasks.end(),
+                     [](const boost::shared_ptr<Task> &task) {
+                       return task->isCompleted && !task->isScheduled;
+                     }),
+      m_tasks.end());
+
   if (m_newTasks.empty()) {
     return;
   }
 
   for (const auto &newTask : m_newTasks) {
-    const auto &it = std::find_if(m_tasks.begin(), m_tasks.end(),
-                                  [&newTask](const Task &task) {
-                                    return newTask.first.name == task.name;
-                                  });
+    const auto &it =
+        std::find_if(m_tasks.begin(), m_tasks.end(),
+                     [&newTask](const boost::shared_ptr<Task> &task) {
+                       return newTask.first->name == task->name;
+                     });
 
     if (it != m_tasks.cend()) {
       if (!newTask.second) {
-        AssertEq(it->priority, newTask.first.priority);
+        AssertEq((*it)->priority, newTask.first->priority);
         continue;
       }
-      *it = newTask.first;
+      // The task object is kept as it could be running now, so it will not be
+      // started again until the current run is completed.
+      auto &task = **it;
+      task.priority = newTask.first->priority;
+      task.isAccelerable = newTask.first->isAccelerable;
+      task.isConcurrent = newTask.first->isConcurrent;
+      task.task = newTask.first->task;
+      task.frequency = newTask.first->frequency;
+      task.skipCount = 0;
+      task.isCompleted = false;
     } else {
       m_tasks.emplace_back(newTask.first);
     }
 
-    std::sort(m_tasks.begin(), m_tasks.end(), [](const Task &a, const Task &b) {
-      return a.priority < b.priority;
-    });
+    std::sort(m_tasks.begin(), m_tasks.end(),
+              [](const boost::shared_ptr<Task> &a,
+                 const boost::shared_ptr<Task> &b) {
+                return a->priority < b->priority;
+              });
   }
 
   m_newTasks.clear();
@@ -119,38 +171,48 @@ void PollingTask::AccelerateNextPolling() {
 void PollingTask::RunTasks() {
   StructuredException::SetupForThisThread();
 
-  m_log.Debug("Starting polling task...");
+  m_log.Debug("Starting polling task (%1% thread(s))...", m_numberOfThreads);
 
   try {
     Lock lock(m_mutex);
     SetTasks();
 
-    auto nextStartTime = ch::system_clock::now() + m_pollingInterval;
+    auto nextStartTime = Clock::now() + m_pollingInterval;
+    auto nextStatReportTime = Clock::now() + statReportPeriod;
     while (!m_tasks.empty()) {
       const auto isAccelerated = m_isAccelerated;
       m_isAccelerated = false;
       if (!isAccelerated) {
-        nextStartTime = ch::system_clock::now() + m_pollingInterval;
+        nextStartTime = Clock::now() + m_pollingInterval;
       }
-      lock.unlock();
 
-      for (auto it = m_tasks.begin(); it != m_tasks.cend();) {
-        if (RunTask(*it++, isAccelerated)) {
-          const auto pos = std::distance(m_tasks.begin(), std::prev(it));
-          m_tasks.erase(m_tasks.begin() + pos);
-          it = m_tasks.begin() + pos;
+      auto jobs = ScheduleJobs(isAccelerated);
+      if (m_workers.size() == 0) {
+        lock.unlock();
+        for (auto &job : jobs) {
+          RunJob(job);
         }
+        lock.lock();
+      } else if (!jobs.empty()) {
+        for (auto &job : jobs) {
+          m_jobs.emplace_back(std::move(job));
+        }
+        m_jobsCondition.notify_all();
       }
 
-      lock.lock();
       if (!m_thread) {
         break;
       }
+      if (Clock::now() >= nextStatReportTime) {
+        ReportStat();
+        nextStatReportTime = Clock::now() + statReportPeriod;
+      }
       if (!m_isAccelerated) {
         m_condition.wait_until(lock, nextStartTime);
       }
       SetTasks();
     }
+    ReportStat();
   } catch (const std::exception &ex) {
     m_log.Error("Fatal error in the polling task: \"%1%\".", ex.what());
     throw;
@@ -162,21 +224,137 @@ void PollingTask::RunTasks() {
   m_log.Debug("Polling task is completed.");
 }
 
-bool PollingTask::RunTask(Task &task, bool isAccelerated) const {
-  if (!isAccelerated) {
-    if (task.skipCount > 0) {
-      --task.skipCount;
-      return false;
+std::vector<PollingTask::Job> PollingTask::ScheduleJobs(
+    const bool isAccelerated) {
+  std::vector<Job> result;
+  boost::optional<size_t> chain;
+  const auto &now = Clock::now();
+
+  for (const auto &task : m_tasks) {
+    if (task->isCompleted) {
+      continue;
     }
-  } else if (!task.isAccelerable) {
-    return false;
+    if (!isAccelerated) {
+      if (task->skipCount > 0) {
+        --task->skipCount;
+        continue;
+      }
+    } else if (!task->isAccelerable) {
+      continue;
+    }
+    if (task->isScheduled || (!task->isConcurrent && m_isChainScheduled)) {
+      // The previous run is not completed yet.
+      ++task->numberOfMissedDeadlines;
+      continue;
+    }
+    task->skipCount = task->frequency;
+    task->isScheduled = true;
+
+    if (task->isConcurrent) {
+      result.emplace_back(
+          Job{{std::make_pair(task, task->task)},
+              now + m_pollingInterval *
+                        static_cast<ch::microseconds::rep>(task->frequency + 1),
+              false});
+      continue;
+    }
+    if (!chain) {
+      chain = result.size();
+      result.emplace_back(Job{{}, now + m_pollingInterval, true});
+    }
+    result[*chain].tasks.emplace_back(task, task->task);
+  }
+
+  if (chain) {
+    m_isChainScheduled = true;
   }
 
-  task.skipCount = task.frequency;
+  return result;
+}
+
+void PollingTask::RunJobs() {
+  StructuredException::SetupForThisThread();
+  try {
+    Lock lock(m_mutex);
+    for (;;) {
+      while (m_jobs.empty() && m_thread) {
+        m_jobsCondition.wait(lock);
+      }
+      if (!m_thread) {
+        break;
+      }
+      auto job = std::move(m_jobs.front());
+      m_jobs.pop_front();
+      lock.unlock();
+      RunJob(job);
+      lock.lock();
+    }
+  } catch (const std::exception &ex) {
+    m_log.Error("Fatal error in the polling task thread: \"%1%\".", ex.what());
+    throw;
+  } catch (...) {
+    m_log.Error("Fatal unknown error in the polling task thread.");
+    AssertFailNoException();
+    throw;
+  }
+}
+
+void PollingTask::RunJob(Job &job) {
+  // The deadline is checked only at the job start, so a slow task doesn't make
+  // next tasks of the same chain missed.
+  const auto isMissed = Clock::now() > job.deadline;
+  for (const auto &task : job.tasks) {
+    const auto start = Clock::now();
+    const auto isCompleted = !isMissed && RunTask(*task.first, task.second);
+    const auto end = Clock::now();
+    const Lock lock(m_mutex);
+    if (isMissed) {
+      ++task.first->numberOfMissedDeadlines;
+    } else {
+      task.first->latency.Add(
+          ch::duration_cast<ch::nanoseconds>(end - start).count());
+    }
+    task.first->isScheduled = false;
+    if (isCompleted) {
+      task.first->isCompleted = true;
+    }
+  }
+  if (job.isChain) {
+    const Lock lock(m_mutex);
+    m_isChainScheduled = false;
+  }
+}
+
+void PollingTask::ReportStat() {
+  for (const auto &task : m_tasks) {
+    if (!task->latency && !task->numberOfMissedDeadlines) {
+      continue;
+    }
+    const char *const message =
+        "Polling task \"%1%\": %2% runs, latency avg %3% us, p50 %4% us, p99 "
+        "%5% us, max %6% us; missed deadlines: %7%.";
+    const auto &latency = task->latency;
+    if (task->numberOfMissedDeadlines) {
+      m_log.Warn(message, task->name, latency.GetSize(),
+                 latency.GetAvg() / 1000, latency.GetPercentile(50) / 1000,
+                 latency.GetPercentile(99) / 1000, latency.GetMax() / 1000,
+                 task->numberOfMissedDeadlines);
+    } else {
+      m_log.Debug(message, task->name, latency.GetSize(),
+                  latency.GetAvg() / 1000, latency.GetPercentile(50) / 1000,
+                  latency.GetPercentile(99) / 1000, latency.GetMax() / 1000,
+                  task->numberOfMissedDeadlines);
+    }
+    task->latency.Reset();
+    task->numberOfMissedDeadlines = 0;
+  }
+}
 
+bool PollingTask::RunTask(Task &task,
+                          const boost::function<bool()> &function) const {
   bool isCompleted;
   try {
-    isCompleted = !task.task();
+    isCompleted = !function();
   } catch (const std::exception &ex) {
     ++task.numberOfErrors;
     if (task.numberOfErrors <= 2) {
@@ -14,45 +14,85 @@ namespace trdk {
 namespace Interaction {
 namespace Rest {
 
+//! Polls exchange by registered tasks.
+/**
+ * Tasks are run at each polling interval, a task with frequency N is run at
+ * each N+1 interval. Tasks which are not concurrent are run one after another
+ * in the priority order, as one chain. Each concurrent task is run
+ * independently, so a slow request doesn't delay other requests. Concurrent
+ * tasks are run in parallel only if the polling settings allow more than one
+ * thread, and they have to use own sessions, see SessionPool.
+ *
+ * A task has to be completed before its next run time. If its chain or its
+ * concurrent run is not started before this deadline, it's skipped, if it's
+ * still running at the next run time, the next run is skipped. Such misses and
+ * task run latency are reported to the log periodically.
+ */
 class TRDK_INTERACTION_REST_API PollingTask : boost::noncopyable {
   typedef boost::mutex Mutex;
   typedef Mutex::scoped_lock Lock;
+  typedef boost::chrono::system_clock Clock;
 
   struct Task {
     std::string name;
     size_t priority;
     bool isAccelerable;
+    bool isConcurrent;
     boost::function<bool()> task;
     size_t frequency;
     size_t numberOfErrors;
     size_t skipCount;
+    //! Task is queued or is running.
+    bool isScheduled;
+    bool isCompleted;
+    Lib::TimeMeasurement::Histogram latency;
+    size_t numberOfMissedDeadlines;
+  };
+
+  //! Tasks which are run one after another by one thread.
+  struct Job {
+    std::vector<std::pair<boost::shared_ptr<Task>, boost::function<bool()>>>
+        tasks;
+    Clock::time_point deadline;
+    bool isChain;
   };
 
  public:
   explicit PollingTask(const PollingSettings &, ModuleEventsLog &);
+  explicit PollingTask(const boost::posix_time::time_duration &interval,
+                       size_t numberOfThreads,
+                       ModuleEventsLog &);
   ~PollingTask();
 
   void AddTask(std::string name,
                size_t priority,
                boost::function<bool()>,
                size_t frequency,
-               bool isAccelerable);
+               bool isAccelerable,
+               bool isConcurrent = false);
   void ReplaceTask(std::string name,
                    size_t priority,
                    boost::function<bool()>,
                    size_t frequency,
-                   bool isAccelerable);
+                   bool isAccelerable,
+                   bool isConcurrent = false);
   void AccelerateNextPolling();
 
  private:
   void RunTasks();
-  bool RunTask(Task &, bool isAccelerated) const;
+  void RunJobs();
+  void RunJob(Job &);
+  bool RunTask(Task &, const boost::function<bool()> &) const;
+
+  std::vector<Job> ScheduleJobs(bool isAccelerated);
+  void ReportStat();
 
   void ScheduleTaskSetting(std::string name,
                            size_t priority,
                            boost::function<bool()>,
                            size_t frequency,
                            bool isAccelerable,
+                           bool isConcurrent,
                            bool replace);
 
   void SetTasks();
@@ -61,10 +101,17 @@ class TRDK_INTERACTION_REST_API PollingTask : boost::noncopyable {
   Mutex m_mutex;
   boost::condition_variable m_condition;
   const boost::chrono::microseconds m_pollingInterval;
-  std::vector<Task> m_tasks;
-  std::vector<std::pair<Task, bool /* replace */>> m_newTasks;
+  const size_t m_numberOfThreads;
+  std::vector<boost::shared_ptr<Task>> m_tasks;
+  std::vector<std::pair<boost::shared_ptr<Task>, bool /* replace */>>
+      m_newTasks;
   boost::optional<boost::thread> m_thread;
   bool m_isAccelerated;
+  bool m_isChainScheduled;
+
+  boost::thread_group m_workers;
+  boost::condition_variable m_jobsCondition;
+  std::deque<Job> m_jobs;
 };
 
 }  // namespace Rest
@@ -0,0 +1,282 @@
+/*******************************************************************************
+ *   Created: 2026/10/18 13:36:50
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Core/ContextDummy.hpp"
+#include "Core/EventsLog.hpp"
+#include "Interaction/Rest/Api.h"
+#include "Interaction/Rest/Fwd.hpp"
+#include "Interaction/Rest/PollingTask.hpp"
+
+using namespace trdk;
+using namespace trdk::Interaction::Rest;
+namespace pt = boost::posix_time;
+namespace ch = boost::chrono;
+
+namespace {
+
+//! Records of task runs which are added by polling threads.
+class Journal : private boost::noncopyable {
+ public:
+  void Add(const std::string &record) {
+    {
+      const boost::mutex::scoped_lock lock(m_mutex);
+      m_records.emplace_back(record);
+    }
+    m_condition.notify_all();
+  }
+
+  //! Waits until the record is added the given number of times.
+  bool Wait(const std::string &record, size_t numberOfRecords = 1) {
+    boost::mutex::scoped_lock lock(m_mutex);
+    return m_condition.wait_for(
+        lock, ch::seconds(5), [this, &record, numberOfRecords]() {
+          return static_cast<size_t>(std::count(
+                     m_records.cbegin(), m_records.cend(), record)) >=
+                 numberOfRecords;
+        });
+  }
+
+  std::vector<std::string> Get() const {
+    const boost::mutex::scoped_lock lock(m_mutex);
+    return m_records;
+  }
+
+ private:
+  mutable boost::mutex m_mutex;
+  boost::condition_variable m_condition;
+  std::vector<std::string> m_records;
+};
+
+//! Blocks a task until the test opens it.
+class Gate : private boost::noncopyable {
+ public:
+  Gate() : m_isOpened(false) {}
+
+  void Open() {
+    {
+      const boost::mutex::scoped_lock lock(m_mutex);
+      m_isOpened = true;
+    }
+    m_condition.notify_all();
+  }
+
+  void Wait() {
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_condition.wait(lock, [this]() { return m_isOpened; });
+  }
+
+ private:
+  boost::mutex m_mutex;
+  boost::condition_variable m_condition;
+  bool m_isOpened;
+};
+
+class PollingTaskTest : public testing::Test {
+ protected:
+  PollingTaskTest()
+      : m_log("Test", Tests::Dummies::Context::GetInstance().GetLog()) {}
+
+  std::unique_ptr<PollingTask> Create(size_t numberOfThreads) {
+    return boost::make_unique<PollingTask>(pt::milliseconds(20),
+                                           numberOfThreads, m_log);
+  }
+
+  //! The first task holds the polling until the gate is opened, so the tasks
+  //! which are added after it are scheduled together at the next run.
+  void Hold(PollingTask &pollingTask) {
+    pollingTask.AddTask("Hold", 0,
+                        [this]() {
+                          m_hold.Wait();
+                          return false;
+                        },
+                        0, false);
+  }
+  void Release() { m_hold.Open(); }
+
+  //! Adds the task which adds its name to the journal at each run.
+  void AddRecording(PollingTask &pollingTask,
+                    const std::string &name,
+                    size_t priority,
+                    bool isConcurrent = false) {
+    pollingTask.AddTask(name, priority,
+                        [this, name]() {
+                          m_journal.Add(name);
+                          return true;
+                        },
+                        0, false, isConcurrent);
+  }
+
+  ModuleEventsLog m_log;
+  Journal m_journal;
+  Gate m_hold;
+};
+
+}  // namespace
+
+TEST_F(PollingTaskTest, ChainOrdering) {
+  const auto &pollingTask = Create(1);
+  Hold(*pollingTask);
+  AddRecording(*pollingTask, "c", 3);
+  AddRecording(*pollingTask, "a", 1);
+  AddRecording(*pollingTask, "b", 2);
+  Release();
+
+  ASSERT_TRUE(m_journal.Wait("c", 2));
+  const auto &records = m_journal.Get();
+  ASSERT_LE(6, records.size());
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "c", "a", "b", "c"}),
+            std::vector<std::string>(records.cbegin(), records.cbegin() + 6));
+}
+
+TEST_F(PollingTaskTest, SlowTaskDoesntMakeChainMissed) {
+  const auto &pollingTask = Create(1);
+  // Each run is longer than the polling interval:
+  pollingTask->AddTask("Slow", 1,
+                       []() {
+                         boost::this_thread::sleep_for(ch::milliseconds(50));
+                         return true;
+                       },
+                       0, false);
+  AddRecording(*pollingTask, "Next", 2);
+  EXPECT_TRUE(m_journal.Wait("Next", 2));
+}
+
+TEST_F(PollingTaskTest, ConcurrentJobsRunInParallel) {
+  boost::atomic_size_t numberOfStarted(0);
+  boost::atomic_size_t numberOfParallelRuns(0);
+  const auto &pollingTask = Create(2);
+  const auto &task = [this, &numberOfStarted, &numberOfParallelRuns]() {
+    ++numberOfStarted;
+    const auto &end = ch::steady_clock::now() + ch::seconds(5);
+    while (numberOfStarted < 2 && ch::steady_clock::now() < end) {
+      boost::this_thread::yield();
+    }
+    if (numberOfStarted >= 2) {
+      ++numberOfParallelRuns;
+    }
+    m_journal.Add("Done");
+    return false;
+  };
+  pollingTask->AddTask("a", 1, task, 0, false, true);
+  pollingTask->AddTask("b", 2, task, 0, false, true);
+
+  ASSERT_TRUE(m_journal.Wait("Done", 2));
+  EXPECT_EQ(2, numberOfParallelRuns.load());
+}
+
+TEST_F(PollingTaskTest, MissedDeadline) {
+  ch::steady_clock::time_point slowEnd;
+  std::vector<ch::steady_clock::time_point> runs;
+  auto pollingTask = Create(1);
+  Hold(*pollingTask);
+
+  // Runs longer than the next task deadline, which is 2 polling intervals:
+  pollingTask->AddTask("Slow", 1,
+                       [&slowEnd]() {
+                         boost::this_thread::sleep_for(ch::milliseconds(100));
+                         slowEnd = ch::steady_clock::now();
+                         return false;
+                       },
+                       0, false, true);
+  pollingTask->AddTask("Missed", 2,
+                       [this, &runs]() {
+                         runs.emplace_back(ch::steady_clock::now());
+                         m_journal.Add("Missed");
+                         return true;
+                       },
+                       1, false, true);
+  Release();
+
+  ASSERT_TRUE(m_journal.Wait("Missed"));
+  pollingTask.reset();
+  ASSERT_FALSE(runs.empty());
+  // The missed run is skipped, the next run is after the skipped interval:
+  EXPECT_LE(ch::milliseconds(10), runs.front() - slowEnd);
+}
+
+TEST_F(PollingTaskTest, ReplaceTaskDuringRun) {
+  Gate gate;
+  auto pollingTask = Create(2);
+  pollingTask->AddTask("Task", 1,
+                       [this, &gate]() {
+                         m_journal.Add("Old");
+                         gate.Wait();
+                         return true;
+                       },
+                       0, false, true);
+  ASSERT_TRUE(m_journal.Wait("Old"));
+
+  pollingTask->ReplaceTask("Task", 1,
+                           [this]() {
+                             m_journal.Add("New");
+                             return true;
+                           },
+                           0, false, true);
+  // The task is not started again until the current run is completed:
+  boost::this_thread::sleep_for(ch::milliseconds(100));
+  EXPECT_EQ(std::vector<std::string>{"Old"}, m_journal.Get());
+
+  gate.Open();
+  ASSERT_TRUE(m_journal.Wait("New", 2));
+  pollingTask.reset();
+  const auto &records = m_journal.Get();
+  EXPECT_EQ(1, std::count(records.cbegin(), records.cend(), "Old"));
+}
+
+TEST_F(PollingTaskTest, CompletedTaskIsRemoved) {
+  const auto &pollingTask = Create(1);
+  pollingTask->AddTask("Once", 1,
+                       [this]() {
+                         m_journal.Add("Once");
+                         return false;
+                       },
+                       0, false);
+  AddRecording(*pollingTask, "Repeated", 2);
+  ASSERT_TRUE(m_journal.Wait("Repeated", 3));
+  {
+    const auto &records = m_journal.Get();
+    EXPECT_EQ(1, std::count(records.cbegin(), records.cend(), "Once"));
+  }
+
+  // The removed task could be added again with the same name:
+  pollingTask->AddTask("Once", 1,
+                       [this]() {
+                         m_journal.Add("Once");
+                         return false;
+                       },
+                       0, false);
+  EXPECT_TRUE(m_journal.Wait("Once", 2));
+}
+
+TEST_F(PollingTaskTest, DestructionWhileWorkersAreRunning) {
+  boost::atomic_size_t numberOfRunning(0);
+  boost::atomic_size_t numberOfRuns(0);
+  auto pollingTask = Create(2);
+  const auto &task = [this, &numberOfRunning, &numberOfRuns]() {
+    ++numberOfRunning;
+    ++numberOfRuns;
+    m_journal.Add("Started");
+    boost::this_thread::sleep_for(ch::milliseconds(50));
+    --numberOfRunning;
+    return true;
+  };
+  pollingTask->AddTask("a", 1, task, 0, false, true);
+  pollingTask->AddTask("b", 2, task, 0, false, true);
+  AddRecording(*pollingTask, "Chain", 3);
+  ASSERT_TRUE(m_journal.Wait("Started", 2));
+
+  // Waits for running tasks and doesn't start new:
+  pollingTask.reset();
+  EXPECT_EQ(0, numberOfRunning.load());
+  const auto numberOfRunsAtDestruction = numberOfRuns.load();
+  boost::this_thread::sleep_for(ch::milliseconds(100));
+  EXPECT_EQ(numberOfRunsAtDestruction, numberOfRuns.load());
+}
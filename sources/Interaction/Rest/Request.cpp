@@ -83,6 +83,46 @@ void Request::PrepareRequest(const net::HTTPClientSession&,
 
 boost::tuple<pt::ptime, ptr::ptree, TimeMeasurement::Milestones> Request::Send(
     std::unique_ptr<net::HTTPSClientSession>& session) {
+  ptr::ptree result;
+  std::string responseBuffer;
+  const auto& response = SendRequest(
+      session, responseBuffer,
+      [this, &result](std::istream& responseStream, std::string& content) {
+        try {
+          if (content.empty()) {
+            read_json(responseStream, result);
+          } else {
+            ios::array_source source(&content[0], content.size());
+            ios::stream<ios::array_source> is(source);
+            read_json(is, result);
+          }
+        } catch (const ptr::ptree_error& ex) {
+          boost::format error(
+              "Failed to read server response to the request \"%1%\" (%2%): "
+              "\"%3%\"");
+          error % m_name             // 1
+              % m_request->getURI()  // 2
+              % ex.what();           // 3
+          throw CommunicationError(error.str().c_str());
+        }
+      });
+  return {boost::get<0>(response), result, boost::get<1>(response)};
+}
+
+Request::RawResponse Request::SendRaw(
+    std::unique_ptr<net::HTTPSClientSession>& session, std::string& content) {
+  return SendRequest(session, content,
+                     [](std::istream& responseStream, std::string& content) {
+                       if (content.empty()) {
+                         CopyToString(responseStream, content);
+                       }
+                     });
+}
+
+Request::RawResponse Request::SendRequest(
+    std::unique_ptr<net::HTTPSClientSession>& session,
+    std::string& responseBuffer,
+    const boost::function<void(std::istream&, std::string&)>& read) {
   Assert(session);
 
   WriteUri(m_uri, *m_request);
@@ -92,7 +132,7 @@ boost::tuple<pt::ptime, ptr::ptree, TimeMeasurement::Milestones> Request::Send(
   PrepareRequest(*session, body, *m_request);
   m_request->setContentLength(body.size());
 
-  GetFloodControl().Check(IsPriority(), GetLog());
+  GetFloodControl().Check(GetRequestClass(), GetLog());
 
   for (size_t attempt = 1;; ++attempt) {
     try {
@@ -132,7 +172,8 @@ boost::tuple<pt::ptime, ptr::ptree, TimeMeasurement::Milestones> Request::Send(
     try {
       net::HTTPResponse response;
       auto& responseStream = session->receiveResponse(response);
-      std::string responseBuffer;
+      ReportRateLimitState(response);
+      responseBuffer.clear();
       if (m_tradingLog) {
         m_tradingLog->Write(
             "response-dump %1%\t%2%",
@@ -151,26 +192,8 @@ boost::tuple<pt::ptime, ptr::ptree, TimeMeasurement::Milestones> Request::Send(
         continue;
       }
 
-      ptr::ptree result;
-      try {
-        if (responseBuffer.empty()) {
-          read_json(responseStream, result);
-        } else {
-          ios::array_source source(&responseBuffer[0], responseBuffer.size());
-          ios::stream<ios::array_source> is(source);
-          read_json(is, result);
-        }
-      } catch (const ptr::ptree_error& ex) {
-        boost::format error(
-            "Failed to read server response to the request \"%1%\" (%2%): "
-            "\"%3%\"");
-        error % m_name             // 1
-            % m_request->getURI()  // 2
-            % ex.what();           // 3
-        throw CommunicationError(error.str().c_str());
-      }
-
-      return {updateTime, result, delayMeasurement};
+      read(responseStream, responseBuffer);
+      return {updateTime, delayMeasurement};
     } catch (const Poco::Exception& ex) {
       session = RecreateSession(*session);
       if (attempt < GetNumberOfAttempts()) {
@@ -245,6 +268,31 @@ void Request::CheckErrorResponse(const net::HTTPResponse& response,
   }
 }
 
+void Request::ReportRateLimitState(const net::HTTPResponse& response) const {
+  if (response.getStatus() == 429) {  // Too Many Requests
+    m_log.Warn("Server rejects requests by rate limit exceeding.");
+    GetFloodControl().OnRateLimitExceeded();
+    return;
+  }
+  const std::string remaining =
+      response.get("X-RateLimit-Remaining", std::string());
+  if (remaining.empty()) {
+    return;
+  }
+  size_t numberOfRequests;
+  try {
+    numberOfRequests = boost::lexical_cast<size_t>(remaining);
+  } catch (const boost::bad_lexical_cast&) {
+    return;
+  }
+  GetFloodControl().OnRemainingNumberOfRequests(numberOfRequests);
+}
+
+RequestClass Request::GetRequestClass() const {
+  return IsPriority() ? REQUEST_CLASS_ORDER_PLACEMENT
+                      : REQUEST_CLASS_MARKET_DATA;
+}
+
 void Request::WriteUri(std::string uri, net::HTTPRequest& request) const {
   if (!m_uriParams.empty() &&
       request.getMethod() == net::HTTPRequest::HTTP_GET) {
@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include "FloodControl.hpp"
+
 namespace trdk {
 namespace Interaction {
 namespace Rest {
@@ -20,6 +22,9 @@ class TRDK_INTERACTION_REST_API Request {
                        boost::property_tree::ptree,
                        Lib::TimeMeasurement::Milestones>
       Response;
+  typedef boost::tuple<boost::posix_time::ptime,
+                       Lib::TimeMeasurement::Milestones>
+      RawResponse;
 
   class CommunicationErrorWithUndeterminedRemoteResult
       : public Lib::CommunicationError {
@@ -49,6 +54,13 @@ class TRDK_INTERACTION_REST_API Request {
   void SetBody(const std::string &body) { m_body = body; }
 
   virtual Response Send(std::unique_ptr<Poco::Net::HTTPSClientSession> &);
+  //! Sends request and returns response content as is.
+  /**
+   * Allows parsing the response by Lib::Json::Document without building a
+   * property tree. The content buffer keeps its capacity between requests.
+   */
+  RawResponse SendRaw(std::unique_ptr<Poco::Net::HTTPSClientSession> &,
+                      std::string &content);
 
   const Poco::Net::HTTPRequest &GetRequest() const { return *m_request; }
 
@@ -73,6 +85,12 @@ class TRDK_INTERACTION_REST_API Request {
   virtual FloodControl &GetFloodControl() const = 0;
 
   virtual bool IsPriority() const = 0;
+  //! Request class for the flood control.
+  /**
+   * By default, priority requests are order placement requests, others are
+   * market data requests.
+   */
+  virtual RequestClass GetRequestClass() const;
 
   virtual size_t GetNumberOfAttempts() const { return 2; }
 
@@ -83,9 +101,17 @@ class TRDK_INTERACTION_REST_API Request {
   ModuleEventsLog &GetLog() const;
 
  private:
+  RawResponse SendRequest(
+      std::unique_ptr<Poco::Net::HTTPSClientSession> &,
+      std::string &responseBuffer,
+      const boost::function<void(std::istream &, std::string &)> &read);
+
   std::unique_ptr<Poco::Net::HTTPSClientSession> RecreateSession(
       const Poco::Net::HTTPSClientSession &);
 
+  //! Passes the server rate limit state to the flood control.
+  void ReportRateLimitState(const Poco::Net::HTTPResponse &) const;
+
   const Context &m_context;
   ModuleEventsLog &m_log;
   ModuleTradingLog *const m_tradingLog;
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ *   Created: 2026/10/17 08:53:38
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "RequestParamsTemplate.hpp"
+
+using namespace trdk;
+using namespace Lib;
+using namespace Interaction::Rest;
+
+RequestParamsTemplate::RequestParamsTemplate(const std::string &source) {
+  Part part = {std::string(), 0};
+  for (auto it = source.cbegin(); it != source.cend(); ++it) {
+    if (*it != '%') {
+      part.text.push_back(*it);
+      continue;
+    }
+    const auto begin = ++it;
+    while (it != source.cend() && *it >= '0' && *it <= '9') {
+      ++it;
+    }
+    if (it == source.cend() || *it != '%') {
+      boost::format error(R"(Wrong request parameters template "%1%")");
+      error % source;
+      throw LogicError(error.str().c_str());
+    }
+    if (begin == it) {
+      // "%%"
+      part.text.push_back('%');
+      continue;
+    }
+    const auto number = boost::lexical_cast<size_t>(std::string(begin, it));
+    if (number == 0) {
+      boost::format error(R"(Wrong request parameters template "%1%")");
+      error % source;
+      throw LogicError(error.str().c_str());
+    }
+    part.valueIndex = number - 1;
+    m_parts.emplace_back(std::move(part));
+    part = {std::string(), 0};
+  }
+  m_parts.emplace_back(std::move(part));
+}
+
+std::string RequestParamsTemplate::Build(const Value *values,
+                                         size_t numberOfValues) const {
+  UseUnused(numberOfValues);
+  std::ostringstream result;
+  // Each value is written with the initial stream format, as boost::format
+  // does it, so a value which changes the format doesn't change next values.
+  const auto flags = result.flags();
+  const auto precision = result.precision();
+  const auto &last = std::prev(m_parts.cend());
+  for (auto it = m_parts.cbegin(); it != last; ++it) {
+    result << it->text;
+    AssertGt(numberOfValues, it->valueIndex);
+    const auto &value = values[it->valueIndex];
+    value.write(result, value.value);
+    result.flags(flags);
+    result.precision(precision);
+  }
+  result << last->text;
+  return result.str();
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************
+ *   Created: 2026/10/17 08:47:20
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#pragma once
+
+namespace trdk {
+namespace Interaction {
+namespace Rest {
+
+//! Pre-serialized request parameters.
+/**
+ * The source has boost::format-like placeholders ("%1%", "%2%"...) and is
+ * split once, so building parameters for a request only writes values between
+ * constant parts, without format parsing each time. Values are written by
+ * stream operators, as boost::format does it.
+ */
+class TRDK_INTERACTION_REST_API RequestParamsTemplate {
+ public:
+  //! @throw Lib::LogicError If the source has a wrong placeholder.
+  explicit RequestParamsTemplate(const std::string &source);
+
+ public:
+  template <typename... Values>
+  std::string Build(const Values &... values) const {
+    static_assert(sizeof...(Values) > 0, "Template has to have values.");
+    const Value args[] = {{&Write<Values>, &values}...};
+    return Build(args, sizeof...(Values));
+  }
+
+ private:
+  struct Value {
+    void (*write)(std::ostream &, const void *);
+    const void *value;
+  };
+  template <typename T>
+  static void Write(std::ostream &os, const void *value) {
+    os << *static_cast<const T *>(value);
+  }
+
+  std::string Build(const Value *, size_t numberOfValues) const;
+
+ private:
+  struct Part {
+    std::string text;
+    //! Index of the value after the text, if it's not the last part.
+    size_t valueIndex;
+  };
+  std::vector<Part> m_parts;
+};
+
+}  // namespace Rest
+}  // namespace Interaction
+}  // namespace trdk
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ *   Created: 2026/10/18 15:04:52
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Interaction/Rest/Api.h"
+#include "Interaction/Rest/RequestParamsTemplate.hpp"
+
+using namespace trdk;
+using namespace trdk::Lib;
+using namespace trdk::Interaction::Rest;
+
+namespace {
+
+//! Builds parameters by the template and by boost::format which was used
+//! before the template.
+template <typename... Values>
+void Check(const std::string &source, const Values &... values) {
+  boost::format expected(source);
+  const auto unused = {(expected % values, 0)...};
+  UseUnused(unused);
+  EXPECT_EQ(expected.str(), RequestParamsTemplate(source).Build(values...))
+      << "Template: \"" << source << "\".";
+}
+}  // namespace
+
+TEST(Interaction_Rest_RequestParamsTemplate, Placeholders) {
+  Check("pair=eth_btc&type=buy&rate=%1%&amount=%2%", 1, 2);
+  Check("%1%", "abc");
+  Check("%1%%2%", "a", "b");
+  Check("%1%&%1%", "a");
+  Check("a=%1%&b=%2%", 0.5, 2.25);
+}
+
+TEST(Interaction_Rest_RequestParamsTemplate, Escaping) {
+  Check("%%%1%", 1);
+  Check("a%%b&c=%1%", 1);
+  Check("fee=100%%%1%%%", 2);
+  Check("%%1%%=%1%", 3);
+}
+
+TEST(Interaction_Rest_RequestParamsTemplate, PlaceholderOrder) {
+  Check("amount=%2%&rate=%1%", "rate", "amount");
+  Check("%3%%1%%2%", 'a', 'b', 'c');
+  Check("c=%3%&a=%1%", "a", "b", "c");
+}
+
+TEST(Interaction_Rest_RequestParamsTemplate, PriceAndQty) {
+  Check("rate=%1%&amount=%2%", Price(0.00012345), Qty(12.5));
+  Check("rate=%1%&amount=%2%", Price(1), Qty(0));
+  Check("rate=%1%&amount=%2%", Price(98765.4321), Qty(0.00000001));
+  Check("amount=%2%&rate=%1%", Price(1.1), Qty(3));
+  // Price stream format is not applied to next values:
+  Check("rate=%1%&amount=%2%&fee=%3%", Price(1.1), 0.5, 0.25);
+}
+
+TEST(Interaction_Rest_RequestParamsTemplate, WrongPlaceholders) {
+  EXPECT_THROW(RequestParamsTemplate("%0%"), LogicError);
+  EXPECT_THROW(RequestParamsTemplate("a=%0%&b=%1%"), LogicError);
+  EXPECT_THROW(RequestParamsTemplate("%"), LogicError);
+  EXPECT_THROW(RequestParamsTemplate("a=%1"), LogicError);
+  EXPECT_THROW(RequestParamsTemplate("a=%1%&b=%2"), LogicError);
+  EXPECT_THROW(RequestParamsTemplate("a=%x%"), LogicError);
+  EXPECT_THROW(RequestParamsTemplate("%%%"), LogicError);
+}
@@ -25,6 +25,7 @@ class TRDK_INTERACTION_REST_API Security : public trdk::Security {
 
   using Base::GetStartedBars;
   using Base::SetBarsStartTime;
+  using Base::SetBook;
   using Base::SetLevel1;
   using Base::SetOnline;
   using Base::SetTradingSessionState;
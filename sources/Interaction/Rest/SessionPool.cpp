@@ -0,0 +1,65 @@
+/*******************************************************************************
+ *   Created: 2026/10/17 05:09:43
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "SessionPool.hpp"
+
+using namespace trdk;
+using namespace Interaction::Rest;
+namespace net = Poco::Net;
+
+SessionPool::Session::Session(SessionPool &pool,
+                              std::unique_ptr<net::HTTPSClientSession> &&session)
+    : m_pool(&pool), m_session(std::move(session)) {
+  Assert(m_session);
+}
+
+SessionPool::Session::Session(Session &&rhs)
+    : m_pool(rhs.m_pool), m_session(std::move(rhs.m_session)) {
+  rhs.m_pool = nullptr;
+}
+
+SessionPool::Session::~Session() {
+  if (!m_pool || !m_session) {
+    return;
+  }
+  try {
+    m_pool->Return(std::move(m_session));
+  } catch (...) {
+    AssertFailNoException();
+    terminate();
+  }
+}
+
+SessionPool::SessionPool(Factory factory, const size_t maxNumberOfIdleSessions)
+    : m_factory(std::move(factory)),
+      m_maxNumberOfIdleSessions(std::max<size_t>(maxNumberOfIdleSessions, 1)) {
+  m_sessions.reserve(m_maxNumberOfIdleSessions);
+}
+
+SessionPool::Session SessionPool::Take() {
+  {
+    const boost::mutex::scoped_lock lock(m_mutex);
+    if (!m_sessions.empty()) {
+      auto result = std::move(m_sessions.back());
+      m_sessions.pop_back();
+      return Session(*this, std::move(result));
+    }
+  }
+  return Session(*this, m_factory());
+}
+
+void SessionPool::Return(std::unique_ptr<net::HTTPSClientSession> &&session) {
+  const boost::mutex::scoped_lock lock(m_mutex);
+  if (m_sessions.size() >= m_maxNumberOfIdleSessions) {
+    return;
+  }
+  m_sessions.emplace_back(std::move(session));
+}
@@ -0,0 +1,63 @@
+/*******************************************************************************
+ *   Created: 2026/10/17 05:02:16
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#pragma once
+
+namespace trdk {
+namespace Interaction {
+namespace Rest {
+
+//! Keep-alive sessions to one host.
+/**
+ * A session is taken for a request and is returned back after it, so
+ * concurrent requests don't share a session and don't reconnect for each
+ * request. Taking never waits: a new session is created if there is no idle
+ * one. Not more than the max number of idle sessions is kept.
+ */
+class TRDK_INTERACTION_REST_API SessionPool : boost::noncopyable {
+ public:
+  typedef boost::function<std::unique_ptr<Poco::Net::HTTPSClientSession>()>
+      Factory;
+
+  //! Returns the session back to the pool at destruction.
+  class TRDK_INTERACTION_REST_API Session : boost::noncopyable {
+   public:
+    explicit Session(SessionPool &,
+                     std::unique_ptr<Poco::Net::HTTPSClientSession> &&);
+    Session(Session &&);
+    ~Session();
+
+    //! Request could recreate the session after an error.
+    std::unique_ptr<Poco::Net::HTTPSClientSession> &operator*() {
+      return m_session;
+    }
+
+   private:
+    SessionPool *m_pool;
+    std::unique_ptr<Poco::Net::HTTPSClientSession> m_session;
+  };
+
+ public:
+  explicit SessionPool(Factory, size_t maxNumberOfIdleSessions);
+
+  Session Take();
+
+ private:
+  void Return(std::unique_ptr<Poco::Net::HTTPSClientSession> &&);
+
+  const Factory m_factory;
+  const size_t m_maxNumberOfIdleSessions;
+  boost::mutex m_mutex;
+  std::vector<std::unique_ptr<Poco::Net::HTTPSClientSession>> m_sessions;
+};
+
+}  // namespace Rest
+}  // namespace Interaction
+}  // namespace trdk
@@ -13,7 +13,9 @@
 #include "NonceStorage.hpp"
 #include "PollingTask.hpp"
 #include "Request.hpp"
+#include "RequestParamsTemplate.hpp"
 #include "Security.hpp"
+#include "SessionPool.hpp"
 #include "Settings.hpp"
 #include "Util.hpp"
 
@@ -38,12 +40,14 @@ struct Settings : Rest::Settings {
   struct Auth {
     std::string key;
     std::string secret;
+    Crypto::Hmac::Sha512Signer signer;
 
     explicit Auth(const ptr::ptree& conf,
                   const std::string& apiKeyKey,
                   const std::string& apiSecretKey)
         : key(conf.get<std::string>(apiKeyKey)),
-          secret(conf.get<std::string>(apiSecretKey)) {}
+          secret(conf.get<std::string>(apiSecretKey)),
+          signer(secret) {}
   };
 
   Auth generalAuth;
@@ -112,6 +116,9 @@ struct Product {
   Price maxPrice;
   Qty minQty;
   double feeRatio;
+  //! New order request parameters for each side, with rate and amount.
+  RequestParamsTemplate buyParams;
+  RequestParamsTemplate sellParams;
 };
 
 class Request : public Rest::Request {
@@ -235,8 +242,7 @@ class TradeRequest : public Request {
     request.set("Key", m_auth.settings.key);
     {
       using namespace Crypto;
-      const auto& digest =
-          Hmac::CalcSha512Digest(GetUriParams(), m_auth.settings.secret);
+      const auto& digest = m_auth.settings.signer.Sign(GetUriParams());
       request.set("Sign", EncodeToHex(&digest[0], digest.size()));
     }
     Base::PrepareRequest(session, body, request);
@@ -352,6 +358,9 @@ class YobitnetExchange : public TradingSystem, public MarketDataSource {
                           : Auth{m_settings.generalAuth, m_generalNonces}),
         m_marketDataSession(CreateSession("yobit.net", m_settings, false)),
         m_tradingSession(CreateSession("yobit.net", m_settings, true)),
+        m_pricesSessions(
+            [this]() { return CreateSession("yobit.net", m_settings, false); },
+            m_settings.pollingSettings.GetNumberOfThreads()),
         m_balances(*this, GetTsLog(), GetTsTradingLog()),
         m_pollingTask(boost::make_unique<PollingTask>(
             m_settings.pollingSettings, GetMdsLog())) {}
@@ -406,13 +415,15 @@ class YobitnetExchange : public TradingSystem, public MarketDataSource {
     const auto& depthRequest = boost::make_shared<PublicRequest>(
         "/api/3/depth/" + boost::join(uriSymbolsPath, "-"), "Depth", "limit=1",
         GetContext(), GetTsLog());
+    // Prices are polled by own sessions, so they are not delayed by orders and
+    // balances polling.
     m_pollingTask->ReplaceTask(
         "Prices", 1,
         [this, depthRequest]() {
           UpdatePrices(*depthRequest);
           return true;
         },
-        m_settings.pollingSettings.GetPricesRequestFrequency(), false);
+        m_settings.pollingSettings.GetPricesRequestFrequency(), false, true);
 
     m_pollingTask->AccelerateNextPolling();
   }
@@ -587,15 +598,14 @@ class YobitnetExchange : public TradingSystem, public MarketDataSource {
     const auto actualPrice =
         RoundByPrecisionPower(*price, product->second.precisionPower);
 
-    boost::format requestParams("pair=%1%&type=%2%&rate=%3%&amount=%4%");
-    requestParams % productId  // 1
-        % actualSide           // 2
-        % actualPrice          // 3
-        % qty;                 // 4
+    const auto& requestParams =
+        (side == ORDER_SIDE_SELL ? product->second.sellParams
+                                 : product->second.buyParams)
+            .Build(actualPrice, qty);
 
     ptr::ptree response;
     const auto& startTime = GetContext().GetCurrentTime();
-    TradeRequest request("Trade", m_tradingAuth, true, requestParams.str(),
+    TradeRequest request("Trade", m_tradingAuth, true, requestParams,
                          GetContext(), GetTsLog(), &GetTsTradingLog());
     try {
       response = boost::get<1>(request.Send(m_tradingSession));
@@ -673,15 +683,20 @@ class YobitnetExchange : public TradingSystem, public MarketDataSource {
       for (const auto& node : response.get_child("pairs")) {
         const auto& exchangeSymbol = boost::to_upper_copy(node.first);
         auto symbol = NormilizeSymbol(exchangeSymbol);
+        auto productId = NormilizeProductId(exchangeSymbol);
         const auto& info = node.second;
         const auto& productIt = products.emplace(
             std::move(symbol),
-            Product{NormilizeProductId(exchangeSymbol),
+            Product{productId,
                     static_cast<uintmax_t>(
                         std::pow(10, info.get<uintmax_t>("decimal_places"))),
                     info.get<Price>("min_price"), info.get<Price>("max_price"),
                     info.get<Qty>("min_amount"),
-                    info.get<Volume>("fee") / 100.0});
+                    info.get<Volume>("fee") / 100.0,
+                    RequestParamsTemplate("pair=" + productId +
+                                          "&type=buy&rate=%1%&amount=%2%"),
+                    RequestParamsTemplate("pair=" + productId +
+                                          "&type=sell&rate=%1%&amount=%2%")});
         if (!productIt.second) {
           GetTsLog().Error(R"(Product duplicate: "%1%")",
                            productIt.first->first);
@@ -804,7 +819,7 @@ class YobitnetExchange : public TradingSystem, public MarketDataSource {
 
   void UpdatePrices(PublicRequest& depthRequest) {
     try {
-      const auto& response = depthRequest.Send(m_marketDataSession);
+      const auto& response = depthRequest.Send(*m_pricesSessions.Take());
       const auto& time = boost::get<0>(response);
       const auto& delayMeasurement = boost::get<2>(response);
       for (const auto& updateRecord : boost::get<1>(response)) {
@@ -1196,6 +1211,7 @@ class YobitnetExchange : public TradingSystem, public MarketDataSource {
 
   mutable std::unique_ptr<net::HTTPSClientSession> m_marketDataSession;
   mutable std::unique_ptr<net::HTTPSClientSession> m_tradingSession;
+  SessionPool m_pricesSessions;
 
   boost::unordered_map<std::string, Product> m_products;
   boost::unordered_set<std::string> m_symbolListHint;
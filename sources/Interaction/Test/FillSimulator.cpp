@@ -0,0 +1,352 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 22:05:12
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "FillSimulator.hpp"
+#include "Core/PriceBook.hpp"
+
+using namespace trdk;
+using namespace trdk::Lib;
+using namespace trdk::Interaction::Test;
+
+namespace {
+template <typename Side>
+void LoadLiquidity(const Side &side,
+                   std::vector<std::pair<Price, Qty>> &result) {
+  result.clear();
+  for (size_t i = 0; i < side.GetSize(); ++i) {
+    const auto &level = side.GetLevel(i);
+    if (level.GetQty() > 0) {
+      result.emplace_back(level.GetPrice(), level.GetQty());
+    }
+  }
+}
+void LoadLiquidity(const Price &price,
+                   const Qty &qty,
+                   std::vector<std::pair<Price, Qty>> &result) {
+  result.clear();
+  if (!price.IsNan() && !qty.IsNan() && qty > 0) {
+    result.emplace_back(price, qty);
+  }
+}
+}  // namespace
+
+FillSimulator::FillSimulator(const Fees &fees) : m_fees(fees) {}
+
+Volume FillSimulator::CalcFee(const Price &price,
+                              const Qty &qty,
+                              bool isMaker) const {
+  return (qty * price) * (isMaker ? m_fees.maker : m_fees.taker);
+}
+
+void FillSimulator::AddOrder(const OrderId &id,
+                             const Security &security,
+                             const OrderSide &side,
+                             const Qty &qty,
+                             const boost::optional<Price> &price,
+                             const TimeInForce &tif,
+                             Executions &executions) {
+  Assert(m_orders.find(id) == m_orders.cend());
+  auto &book = m_books[&security];
+  side == ORDER_SIDE_BUY
+      ? AddOrder(id, book, book.buys, book.asks, book.bids, true, qty, price,
+                 tif, executions)
+      : AddOrder(id, book, book.sells, book.bids, book.asks, false, qty, price,
+                 tif, executions);
+}
+
+template <typename Levels>
+void FillSimulator::AddOrder(const OrderId &id,
+                             Book &book,
+                             Levels &levels,
+                             Liquidity &opposite,
+                             const Liquidity &same,
+                             bool isBuy,
+                             const Qty &qty,
+                             const boost::optional<Price> &price,
+                             const TimeInForce &tif,
+                             Executions &executions) {
+  const auto &isBetter = levels.key_comp();
+  const auto &isCrossed = [&isBetter, &price](const Price &oppositePrice) {
+    return !price || !isBetter(oppositePrice, *price);
+  };
+
+  if (tif == TIME_IN_FORCE_FOK) {
+    Qty availableQty = 0;
+    for (const auto &level : opposite) {
+      if (availableQty >= qty || !isCrossed(level.first)) {
+        break;
+      }
+      availableQty += level.second;
+    }
+    if (availableQty < qty) {
+      executions.push_back(
+          {Execution::STATUS_CANCELED, id, Price(0), Qty(0), qty, Volume(0)});
+      return;
+    }
+  }
+
+  auto remainingQty = qty;
+  Volume commission = 0;
+  auto liquidity = opposite.begin();
+  for (; liquidity != opposite.cend() && remainingQty > 0 &&
+         isCrossed(liquidity->first);
+       ++liquidity) {
+    const auto tradeQty = std::min(remainingQty, liquidity->second);
+    remainingQty -= tradeQty;
+    liquidity->second -= tradeQty;
+    commission += CalcFee(liquidity->first, tradeQty, false);
+    executions.push_back(
+        {remainingQty > 0 ? Execution::STATUS_TRADE : Execution::STATUS_FILLED,
+         id, liquidity->first, tradeQty, remainingQty, commission});
+    if (liquidity->second > 0) {
+      break;
+    }
+  }
+  opposite.erase(opposite.begin(), liquidity);
+
+  if (remainingQty == 0) {
+    return;
+  }
+  if (!price || tif == TIME_IN_FORCE_IOC || tif == TIME_IN_FORCE_FOK) {
+    executions.push_back({Execution::STATUS_CANCELED, id, Price(0), Qty(0),
+                          remainingQty, commission});
+    return;
+  }
+
+  Qty queueAhead = 0;
+  for (const auto &level : same) {
+    if (!isBetter(level.first, *price)) {
+      if (level.first == *price) {
+        queueAhead = level.second;
+      }
+      break;
+    }
+  }
+
+  auto &queue = levels[*price];
+  queue.push_back({id, remainingQty, queueAhead, commission});
+  m_orders.emplace(id, OrderLocation{&book, isBuy, *price,
+                                     std::prev(queue.end())});
+
+  if (remainingQty == qty) {
+    executions.push_back({Execution::STATUS_OPENED, id, Price(0), Qty(0),
+                          remainingQty, commission});
+  }
+}
+
+bool FillSimulator::CancelOrder(const OrderId &id, Executions &executions) {
+  const auto &it = m_orders.find(id);
+  if (it == m_orders.cend()) {
+    return false;
+  }
+  const auto &location = it->second;
+  executions.push_back({Execution::STATUS_CANCELED, id, Price(0), Qty(0),
+                        location.order->remainingQty,
+                        location.order->commission});
+  location.isBuy
+      ? Remove(location.book->buys, location.price, location.order)
+      : Remove(location.book->sells, location.price, location.order);
+  m_orders.erase(it);
+  return true;
+}
+
+template <typename Levels>
+void FillSimulator::Remove(Levels &levels,
+                           const Price &price,
+                           const Queue::iterator &order) {
+  const auto &level = levels.find(price);
+  Assert(level != levels.cend());
+  level->second.erase(order);
+  if (level->second.empty()) {
+    levels.erase(level);
+  }
+}
+
+void FillSimulator::UpdateBook(const Security &security,
+                               const PriceBook &priceBook,
+                               Executions &executions) {
+  auto &book = m_books[&security];
+  book.hasPriceBook = true;
+  LoadLiquidity(priceBook.GetBid(), book.bids);
+  LoadLiquidity(priceBook.GetAsk(), book.asks);
+  OnLiquidityUpdate(book, executions);
+}
+
+void FillSimulator::UpdateLevel1(const Security &security,
+                                 const Price &bidPrice,
+                                 const Qty &bidQty,
+                                 const Price &askPrice,
+                                 const Qty &askQty,
+                                 Executions &executions) {
+  auto &book = m_books[&security];
+  if (book.hasPriceBook) {
+    return;
+  }
+  LoadLiquidity(bidPrice, bidQty, book.bids);
+  LoadLiquidity(askPrice, askQty, book.asks);
+  OnLiquidityUpdate(book, executions);
+}
+
+void FillSimulator::OnLiquidityUpdate(Book &book, Executions &executions) {
+  FillByLiquidity(book.buys, book.asks, executions);
+  FillByLiquidity(book.sells, book.bids, executions);
+  UpdateQueueAhead(book.buys, book.bids);
+  UpdateQueueAhead(book.sells, book.asks);
+}
+
+void FillSimulator::AddTrade(const Security &security,
+                             const Price &price,
+                             const Qty &qty,
+                             Executions &executions) {
+  const auto &it = m_books.find(&security);
+  if (it == m_books.cend()) {
+    return;
+  }
+  FillByTrade(it->second.buys, price, qty, executions);
+  FillByTrade(it->second.sells, price, qty, executions);
+}
+
+template <typename Levels>
+void FillSimulator::FillByLiquidity(Levels &levels,
+                                    Liquidity &opposite,
+                                    Executions &executions) {
+  // The book crossed resting orders, so the liquidity would be taken by
+  // these orders before it, at the resting order price.
+  const auto &isBetter = levels.key_comp();
+  auto liquidity = opposite.begin();
+  for (auto level = levels.begin(); level != levels.cend();) {
+    auto &queue = level->second;
+    for (auto order = queue.begin();
+         order != queue.cend() && liquidity != opposite.cend() &&
+         !isBetter(liquidity->first, level->first);) {
+      const auto qty = std::min(order->remainingQty, liquidity->second);
+      liquidity->second -= qty;
+      if (liquidity->second == 0) {
+        ++liquidity;
+      }
+      order->queueAhead = 0;
+      if (Fill(*order, level->first, qty, executions)) {
+        m_orders.erase(order->id);
+        order = queue.erase(order);
+      }
+    }
+    if (!queue.empty()) {
+      // Liquidity is over or doesn't cross this and worse levels.
+      break;
+    }
+    level = levels.erase(level);
+  }
+  opposite.erase(opposite.begin(), liquidity);
+}
+
+template <typename Levels>
+void FillSimulator::FillByTrade(Levels &levels,
+                                const Price &price,
+                                const Qty &qty,
+                                Executions &executions) {
+  const auto &isBetter = levels.key_comp();
+  auto remainingQty = qty;
+  for (auto level = levels.begin();
+       level != levels.cend() && remainingQty > 0 &&
+       !isBetter(price, level->first);) {
+    auto &queue = level->second;
+
+    if (isBetter(level->first, price)) {
+      // The trade went through the order price, so all orders at this price
+      // are before it.
+      for (auto order = queue.begin();
+           order != queue.cend() && remainingQty > 0;) {
+        const auto fillQty = std::min(remainingQty, order->remainingQty);
+        remainingQty -= fillQty;
+        order->queueAhead = 0;
+        if (Fill(*order, level->first, fillQty, executions)) {
+          m_orders.erase(order->id);
+          order = queue.erase(order);
+        } else {
+          ++order;
+        }
+      }
+
+    } else {
+      // The trade at the order price takes the queue ahead of each order at
+      // first.
+      Qty takenAheadQty = 0;
+      for (auto order = queue.begin(); order != queue.cend();) {
+        if (remainingQty > 0 && order->queueAhead > takenAheadQty) {
+          const auto aheadQty =
+              std::min(order->queueAhead - takenAheadQty, remainingQty);
+          takenAheadQty += aheadQty;
+          remainingQty -= aheadQty;
+        }
+        order->queueAhead = order->queueAhead > takenAheadQty
+                                ? order->queueAhead - takenAheadQty
+                                : Qty(0);
+        if (remainingQty > 0 && order->queueAhead == 0) {
+          const auto fillQty = std::min(remainingQty, order->remainingQty);
+          remainingQty -= fillQty;
+          if (Fill(*order, level->first, fillQty, executions)) {
+            m_orders.erase(order->id);
+            order = queue.erase(order);
+            continue;
+          }
+        }
+        ++order;
+      }
+    }
+
+    if (queue.empty()) {
+      level = levels.erase(level);
+    } else {
+      ++level;
+    }
+  }
+}
+
+template <typename Levels>
+void FillSimulator::UpdateQueueAhead(Levels &levels, const Liquidity &same) {
+  if (same.empty()) {
+    return;
+  }
+  const auto &isBetter = levels.key_comp();
+  auto liquidity = same.cbegin();
+  for (auto &level : levels) {
+    if (isBetter(same.back().first, level.first)) {
+      // Deeper than the book.
+      break;
+    }
+    while (liquidity != same.cend() &&
+           isBetter(liquidity->first, level.first)) {
+      ++liquidity;
+    }
+    const auto &bookQty =
+        liquidity != same.cend() && liquidity->first == level.first
+            ? liquidity->second
+            : Qty(0);
+    for (auto &order : level.second) {
+      order.queueAhead = std::min(order.queueAhead, bookQty);
+    }
+  }
+}
+
+bool FillSimulator::Fill(Order &order,
+                         const Price &price,
+                         const Qty &qty,
+                         Executions &executions) const {
+  AssertLt(0, qty);
+  AssertLe(qty, order.remainingQty);
+  order.remainingQty -= qty;
+  order.commission += CalcFee(price, qty, true);
+  executions.push_back({order.remainingQty > 0 ? Execution::STATUS_TRADE
+                                               : Execution::STATUS_FILLED,
+                        order.id, price, qty, order.remainingQty,
+                        order.commission});
+  return order.remainingQty == 0;
+}
@@ -0,0 +1,175 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 22:05:12
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#pragma once
+
+#include "Core/Types.hpp"
+
+namespace trdk {
+namespace Interaction {
+namespace Test {
+
+//! Exchange matching emulation by market data.
+/**
+ * Incoming orders take the liquidity of the last known book (or Level 1 if
+ * the security doesn't have the book), the rest of the order is placed at the
+ * end of the queue at its price. The queue ahead is the book quantity at the
+ * order price at the placement time, it becomes smaller only by trades at
+ * this price or if the book quantity at this price becomes smaller. Resting
+ * orders are filled by trades at the order price after the queue ahead, by
+ * trades through the order price and by the book which crosses the order
+ * price.
+ *
+ * Resting orders are stored by securities in price levels, so each market
+ * data update touches only levels which may be affected by it.
+ *
+ * Not thread-safe. Doesn't know anything about time, the caller applies
+ * orders, cancels and market data in the exchange time order.
+ */
+class FillSimulator : private boost::noncopyable {
+ public:
+  //! Fee ratios, from the trade volume.
+  struct Fees {
+    double maker;
+    double taker;
+  };
+
+  struct Execution {
+    enum Status {
+      //! Order is placed in the book without trades.
+      STATUS_OPENED,
+      //! Order has a new trade and still has remaining quantity.
+      STATUS_TRADE,
+      //! Order has a new trade and doesn't have remaining quantity anymore.
+      STATUS_FILLED,
+      //! Order is canceled by request or as IOC or FOK.
+      STATUS_CANCELED,
+    };
+
+    Status status;
+    OrderId orderId;
+    //! Trade price, set only for trades.
+    Price price;
+    //! Trade quantity, set only for trades.
+    Qty qty;
+    Qty remainingQty;
+    //! The sum of fees for all trades of the order.
+    Volume commission;
+  };
+  typedef std::vector<Execution> Executions;
+
+ private:
+  struct Order {
+    OrderId id;
+    Qty remainingQty;
+    //! Quantity of others orders before this order at the same price.
+    Qty queueAhead;
+    Volume commission;
+  };
+  //! Orders at one price in time priority.
+  typedef std::list<Order> Queue;
+
+  typedef std::vector<std::pair<Price, Qty>> Liquidity;
+
+  template <typename Compare>
+  using PriceLevels = std::map<Price, Queue, Compare>;
+
+  struct Book {
+    //! Bid liquidity which isn't taken yet, from the best price.
+    Liquidity bids;
+    //! Ask liquidity which isn't taken yet, from the best price.
+    Liquidity asks;
+    bool hasPriceBook;
+    PriceLevels<std::greater<Price>> buys;
+    PriceLevels<std::less<Price>> sells;
+  };
+
+  struct OrderLocation {
+    Book *book;
+    bool isBuy;
+    Price price;
+    Queue::iterator order;
+  };
+
+ public:
+  explicit FillSimulator(const Fees &);
+
+ public:
+  const Fees &GetFees() const { return m_fees; }
+
+  size_t GetNumberOfActiveOrders() const { return m_orders.size(); }
+
+  //! Places new order. Order without price is a market order, it's never
+  //! placed in the book.
+  void AddOrder(const OrderId &,
+                const Security &,
+                const OrderSide &,
+                const Qty &,
+                const boost::optional<Price> &,
+                const TimeInForce &,
+                Executions &);
+  //! Cancels resting order.
+  /**
+   * @return false if the order isn't active anymore (or never was).
+   */
+  bool CancelOrder(const OrderId &, Executions &);
+
+  void UpdateBook(const Security &, const PriceBook &, Executions &);
+  //! Updates Level 1 liquidity, it's ignored if the security has the book.
+  /**
+   * Side without price or quantity doesn't have liquidity.
+   */
+  void UpdateLevel1(const Security &,
+                    const Price &bidPrice,
+                    const Qty &bidQty,
+                    const Price &askPrice,
+                    const Qty &askQty,
+                    Executions &);
+  void AddTrade(const Security &, const Price &, const Qty &, Executions &);
+
+ private:
+  //! Places the order at the side with levels, which are ordered by the
+  //! comparator from the best price for this side.
+  template <typename Levels>
+  void AddOrder(const OrderId &,
+                Book &,
+                Levels &,
+                Liquidity &opposite,
+                const Liquidity &same,
+                bool isBuy,
+                const Qty &,
+                const boost::optional<Price> &,
+                const TimeInForce &,
+                Executions &);
+  template <typename Levels>
+  void FillByLiquidity(Levels &, Liquidity &opposite, Executions &);
+  template <typename Levels>
+  void FillByTrade(Levels &, const Price &, const Qty &, Executions &);
+  template <typename Levels>
+  static void UpdateQueueAhead(Levels &, const Liquidity &same);
+  void OnLiquidityUpdate(Book &, Executions &);
+
+  //! Fills resting order, returns true if the order doesn't have remaining
+  //! quantity anymore.
+  bool Fill(Order &, const Price &, const Qty &, Executions &) const;
+
+  template <typename Levels>
+  void Remove(Levels &, const Price &, const Queue::iterator &);
+
+  Volume CalcFee(const Price &, const Qty &, bool isMaker) const;
+
+ private:
+  const Fees m_fees;
+  boost::unordered_map<const Security *, Book> m_books;
+  boost::unordered_map<OrderId, OrderLocation> m_orders;
+};
+}  // namespace Test
+}  // namespace Interaction
+}  // namespace trdk
@@ -0,0 +1,267 @@
+/*******************************************************************************
+ *   Created: 2026/10/17 13:42:07
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "Core/PriceBook.hpp"
+#include "Core/SecurityMock.hpp"
+#include "Interaction/Test/FillSimulator.hpp"
+
+using namespace trdk;
+using namespace trdk::Interaction::Test;
+namespace pt = boost::posix_time;
+
+namespace {
+
+typedef FillSimulator::Execution Execution;
+typedef FillSimulator::Executions Executions;
+
+const FillSimulator::Fees fees = {0.001, 0.002};
+
+PriceBook CreateBook(const std::vector<std::pair<double, double>> &bids,
+                     const std::vector<std::pair<double, double>> &asks) {
+  const pt::ptime time(boost::gregorian::date(2018, 3, 4));
+  PriceBook result(time);
+  for (const auto &level : bids) {
+    result.GetBid().Add(time, level.first, level.second);
+  }
+  for (const auto &level : asks) {
+    result.GetAsk().Add(time, level.first, level.second);
+  }
+  return result;
+}
+
+void CheckExecution(const Execution &execution,
+                    const Execution::Status &status,
+                    const OrderId &orderId,
+                    const Price &price,
+                    const Qty &qty,
+                    const Qty &remainingQty) {
+  EXPECT_EQ(status, execution.status);
+  EXPECT_EQ(orderId, execution.orderId);
+  EXPECT_EQ(price, execution.price);
+  EXPECT_EQ(qty, execution.qty);
+  EXPECT_EQ(remainingQty, execution.remainingQty);
+}
+}  // namespace
+
+TEST(Test_FillSimulator, PartialFill) {
+  const Tests::Mocks::Security security;
+  FillSimulator simulator(fees);
+  Executions executions;
+
+  simulator.UpdateLevel1(security, 99, 5, 100, 2, executions);
+  EXPECT_TRUE(executions.empty());
+
+  // Takes the liquidity as taker, the rest is placed in the book:
+  simulator.AddOrder(1, security, ORDER_SIDE_BUY, 5, Price(100),
+                     TIME_IN_FORCE_GTC, executions);
+  ASSERT_EQ(1, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_TRADE, 1, 100, 2, 3);
+  EXPECT_DOUBLE_EQ(0.4, executions[0].commission);
+  EXPECT_EQ(1, simulator.GetNumberOfActiveOrders());
+  executions.clear();
+
+  // Taken liquidity isn't available until the next update:
+  simulator.AddOrder(2, security, ORDER_SIDE_BUY, 1, Price(100),
+                     TIME_IN_FORCE_IOC, executions);
+  ASSERT_EQ(1, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_CANCELED, 2, 0, 0, 1);
+  executions.clear();
+
+  // The resting order doesn't have queue ahead, it's filled as maker:
+  simulator.AddTrade(security, 100, 1, executions);
+  ASSERT_EQ(1, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_TRADE, 1, 100, 1, 2);
+  EXPECT_DOUBLE_EQ(0.5, executions[0].commission);
+  executions.clear();
+
+  simulator.AddTrade(security, 100, 5, executions);
+  ASSERT_EQ(1, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_FILLED, 1, 100, 2, 0);
+  EXPECT_DOUBLE_EQ(0.7, executions[0].commission);
+  EXPECT_EQ(0, simulator.GetNumberOfActiveOrders());
+}
+
+TEST(Test_FillSimulator, QueueAheadByTrades) {
+  const Tests::Mocks::Security security;
+  FillSimulator simulator(fees);
+  Executions executions;
+
+  simulator.UpdateBook(security, CreateBook({{100, 3}}, {{101, 5}}),
+                       executions);
+  EXPECT_TRUE(executions.empty());
+
+  simulator.AddOrder(1, security, ORDER_SIDE_BUY, 2, Price(100),
+                     TIME_IN_FORCE_GTC, executions);
+  ASSERT_EQ(1, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_OPENED, 1, 0, 0, 2);
+  executions.clear();
+
+  // Trades at other price don't touch the queue:
+  simulator.AddTrade(security, 101, 10, executions);
+  EXPECT_TRUE(executions.empty());
+
+  // Takes 2 from 3 of the queue ahead:
+  simulator.AddTrade(security, 100, 2, executions);
+  EXPECT_TRUE(executions.empty());
+
+  // Takes the last 1 of the queue ahead and fills the order by the rest:
+  simulator.AddTrade(security, 100, 2, executions);
+  ASSERT_EQ(1, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_TRADE, 1, 100, 1, 1);
+  executions.clear();
+
+  // The trade through the order price fills it at the order price:
+  simulator.AddTrade(security, 99, 5, executions);
+  ASSERT_EQ(1, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_FILLED, 1, 100, 1, 0);
+  EXPECT_EQ(0, simulator.GetNumberOfActiveOrders());
+}
+
+TEST(Test_FillSimulator, QueueAheadByBook) {
+  const Tests::Mocks::Security security;
+  FillSimulator simulator(fees);
+  Executions executions;
+
+  simulator.UpdateBook(security, CreateBook({{100, 3}, {99, 1}}, {{101, 5}}),
+                       executions);
+  simulator.AddOrder(1, security, ORDER_SIDE_BUY, 2, Price(100),
+                     TIME_IN_FORCE_GTC, executions);
+  simulator.AddOrder(2, security, ORDER_SIDE_BUY, 2, Price(99),
+                     TIME_IN_FORCE_GTC, executions);
+  ASSERT_EQ(2, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_OPENED, 1, 0, 0, 2);
+  CheckExecution(executions[1], Execution::STATUS_OPENED, 2, 0, 0, 2);
+  executions.clear();
+
+  // Book quantity becomes smaller, so the queue ahead also becomes smaller,
+  // the level 99 isn't in the book anymore, so the queue ahead is over:
+  simulator.UpdateBook(security, CreateBook({{100, 1}, {98, 1}}, {{101, 5}}),
+                       executions);
+  EXPECT_TRUE(executions.empty());
+  // Book quantity becomes greater by orders after the placed order, the level
+  // 99 is deeper than the book, so the queue ahead is unknown and not changed:
+  simulator.UpdateBook(security, CreateBook({{100, 4}}, {{101, 5}}),
+                       executions);
+  EXPECT_TRUE(executions.empty());
+
+  simulator.AddTrade(security, 100, 2, executions);
+  ASSERT_EQ(1, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_TRADE, 1, 100, 1, 1);
+  executions.clear();
+
+  simulator.AddTrade(security, 99, 1, executions);
+  ASSERT_EQ(1, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_FILLED, 1, 100, 1, 0);
+  executions.clear();
+
+  simulator.AddTrade(security, 99, 2, executions);
+  ASSERT_EQ(1, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_FILLED, 2, 99, 2, 0);
+  EXPECT_EQ(0, simulator.GetNumberOfActiveOrders());
+}
+
+TEST(Test_FillSimulator, ImmediateOrCancel) {
+  const Tests::Mocks::Security security;
+  FillSimulator simulator(fees);
+  Executions executions;
+
+  simulator.UpdateBook(security,
+                       CreateBook({{100, 1}}, {{101, 1}, {102, 5}, {103, 5}}),
+                       executions);
+
+  simulator.AddOrder(1, security, ORDER_SIDE_BUY, 3, Price(101),
+                     TIME_IN_FORCE_IOC, executions);
+  ASSERT_EQ(2, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_TRADE, 1, 101, 1, 2);
+  CheckExecution(executions[1], Execution::STATUS_CANCELED, 1, 0, 0, 2);
+  executions.clear();
+
+  // Not enough liquidity up to the order price:
+  simulator.AddOrder(2, security, ORDER_SIDE_BUY, 6, Price(102),
+                     TIME_IN_FORCE_FOK, executions);
+  ASSERT_EQ(1, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_CANCELED, 2, 0, 0, 6);
+  executions.clear();
+
+  simulator.AddOrder(3, security, ORDER_SIDE_BUY, 6, Price(103),
+                     TIME_IN_FORCE_FOK, executions);
+  ASSERT_EQ(2, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_TRADE, 3, 102, 5, 1);
+  CheckExecution(executions[1], Execution::STATUS_FILLED, 3, 103, 1, 0);
+  executions.clear();
+
+  // Market order takes the rest and never rests in the book:
+  simulator.AddOrder(4, security, ORDER_SIDE_BUY, 10, boost::none,
+                     TIME_IN_FORCE_GTC, executions);
+  ASSERT_EQ(2, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_TRADE, 4, 103, 4, 6);
+  CheckExecution(executions[1], Execution::STATUS_CANCELED, 4, 0, 0, 6);
+
+  EXPECT_EQ(0, simulator.GetNumberOfActiveOrders());
+}
+
+TEST(Test_FillSimulator, Cancel) {
+  const Tests::Mocks::Security security;
+  FillSimulator simulator(fees);
+  Executions executions;
+
+  simulator.UpdateLevel1(security, 99, 5, 100, 2, executions);
+  simulator.AddOrder(1, security, ORDER_SIDE_SELL, 5, Price(100),
+                     TIME_IN_FORCE_GTC, executions);
+  simulator.AddTrade(security, 100, 3, executions);
+  ASSERT_EQ(2, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_OPENED, 1, 0, 0, 5);
+  CheckExecution(executions[1], Execution::STATUS_TRADE, 1, 100, 1, 4);
+  executions.clear();
+
+  EXPECT_TRUE(simulator.CancelOrder(1, executions));
+  ASSERT_EQ(1, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_CANCELED, 1, 0, 0, 4);
+  EXPECT_DOUBLE_EQ(0.1, executions[0].commission);
+  EXPECT_EQ(0, simulator.GetNumberOfActiveOrders());
+  executions.clear();
+
+  EXPECT_FALSE(simulator.CancelOrder(1, executions));
+  EXPECT_FALSE(simulator.CancelOrder(2, executions));
+  simulator.AddTrade(security, 100, 10, executions);
+  simulator.AddTrade(security, 101, 10, executions);
+  EXPECT_TRUE(executions.empty());
+}
+
+TEST(Test_FillSimulator, CrossingBook) {
+  const Tests::Mocks::Security security;
+  FillSimulator simulator(fees);
+  Executions executions;
+
+  simulator.UpdateBook(security, CreateBook({{100, 1}}, {{102, 5}}),
+                       executions);
+  simulator.AddOrder(1, security, ORDER_SIDE_SELL, 3, Price(101),
+                     TIME_IN_FORCE_GTC, executions);
+  simulator.AddOrder(2, security, ORDER_SIDE_SELL, 3, Price(102),
+                     TIME_IN_FORCE_GTC, executions);
+  ASSERT_EQ(2, executions.size());
+  executions.clear();
+
+  // The bid crosses resting orders, so it's taken by them at their prices,
+  // from the best resting price:
+  simulator.UpdateBook(security, CreateBook({{102, 4}}, {{103, 5}}),
+                       executions);
+  ASSERT_EQ(2, executions.size());
+  CheckExecution(executions[0], Execution::STATUS_FILLED, 1, 101, 3, 0);
+  EXPECT_DOUBLE_EQ(0.303, executions[0].commission);
+  CheckExecution(executions[1], Execution::STATUS_TRADE, 2, 102, 1, 2);
+  EXPECT_EQ(1, simulator.GetNumberOfActiveOrders());
+  executions.clear();
+
+  // Level 1 is ignored as the security has the book:
+  simulator.UpdateLevel1(security, 103, 10, 104, 10, executions);
+  EXPECT_TRUE(executions.empty());
+}
@@ -13,5 +13,7 @@
 #include "Common/Common.hpp"
 #include "Api.h"
 #include <boost/algorithm/string.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/random.hpp>
 #include <boost/thread.hpp>
+#include <queue>
@@ -10,6 +10,7 @@
 
 #include "Prec.hpp"
 #include "TradingSystem.hpp"
+#include "FillSimulator.hpp"
 #include "Core/Security.hpp"
 #include "Core/Settings.hpp"
 #include "Core/Trade.hpp"
@@ -26,20 +27,20 @@ using namespace Test;
 
 namespace {
 
-struct Order {
-  bool isIoc;
+//! Order or cancel which is sent to the exchange.
+struct Request {
+  OrderId orderId;
+  //! Not set for cancels.
   Security *security;
-  bool isSell;
-  OrderId id;
-  boost::function<void()> callback;
+  OrderSide side;
   Qty qty;
-  Price price;
-  size_t isCanceled;
+  boost::optional<Price> price;
+  TimeInForce tif;
+  bool isCancel;
 };
 
 typedef boost::shared_mutex SettingsMutex;
 typedef boost::shared_lock<SettingsMutex> SettingsReadLock;
-typedef boost::unique_lock<SettingsMutex> SettingsWriteLock;
 }  // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -48,56 +49,33 @@ class Test::TradingSystem::Implementation : boost::noncopyable {
  public:
   TradingSystem *m_self;
 
-  struct DelayGenerator {
-    boost::mt19937 random;
-    boost::uniform_int<size_t> executionDelayRange;
-    mutable boost::variate_generator<boost::mt19937, boost::uniform_int<size_t>>
-        executionDelayGenerator;
-
-    explicit DelayGenerator(const ptr::ptree &conf)
-        : executionDelayRange(
-              conf.get<size_t>("config.delayMicroseconds.execution.min"),
-              conf.get<size_t>("config.delayMicroseconds.execution.max")),
-          executionDelayGenerator(random, executionDelayRange) {}
+  class LatencyGenerator {
+   public:
+    explicit LatencyGenerator(const ptr::ptree &conf)
+        : m_range(conf.get<size_t>("min", 0), conf.get<size_t>("max", 0)),
+          m_generator(m_random, m_range) {}
 
     void Validate() const {
-      if (executionDelayRange.min() > executionDelayRange.max()) {
+      if (m_range.min() > m_range.max()) {
         throw ModuleError("Min delay can't be more then max delay");
       }
     }
 
-    void Report(TradingSystem::Log &log) const {
-      log.Info("Execution delay range: %1% - %2%.",
-               pt::microseconds(executionDelayRange.min()),
-               pt::microseconds(executionDelayRange.max()));
+    pt::time_duration Choose() const {
+      return pt::microseconds(m_generator());
     }
-  };
 
-  class ExecChanceGenerator {
-   public:
-    explicit ExecChanceGenerator(const ptr::ptree &conf)
-        : m_executionProbability(
-              conf.get<uint16_t>("config.executionProbability")),
-          m_range(0, 100),
-          m_generator(m_random, m_range) {}
-
-    void Validate() const {
-      if (m_executionProbability <= 0 || m_executionProbability > 100) {
-        throw ModuleError("Execution probability must be between 0% and 101%.");
-      }
-    }
-
-    bool HasChance() const {
-      return m_executionProbability >= 100 ||
-             m_generator() <= m_executionProbability;
+    void Report(const char *name, TradingSystem::Log &log) const {
+      log.Info("%1% delay range: %2% - %3%.",
+               name,                              // 1
+               pt::microseconds(m_range.min()),   // 2
+               pt::microseconds(m_range.max()));  // 3
     }
 
    private:
-    uint16_t m_executionProbability;
     boost::mt19937 m_random;
-    boost::uniform_int<uint8_t> m_range;
-    mutable boost::variate_generator<boost::mt19937,
-                                     boost::uniform_int<uint8_t>>
+    boost::uniform_int<size_t> m_range;
+    mutable boost::variate_generator<boost::mt19937, boost::uniform_int<size_t>>
         m_generator;
   };
 
@@ -107,41 +85,58 @@ class Test::TradingSystem::Implementation : boost::noncopyable {
   typedef boost::condition_variable Condition;
 
  public:
-  DelayGenerator m_delayGenerator;
-  ExecChanceGenerator m_execChanceGenerator;
+  //! Delay from the order or cancel sending to the exchange matching.
+  LatencyGenerator m_executionDelay;
+  //! Delay from the exchange matching to the client notification.
+  LatencyGenerator m_responseDelay;
 
   mutable SettingsMutex m_settingsMutex;
 
+  const bool m_isReplayMode;
+
   Context::CurrentTimeChangeSlotConnection m_currentTimeChangeSlotConnection;
 
   boost::atomic_uintmax_t m_id;
+  uintmax_t m_tradeId;
   bool m_isStarted;
 
   mutable Mutex m_mutex;
   Condition m_condition;
   boost::thread m_thread;
 
-  std::multimap<pt::ptime, ::Order> m_orders;
-  std::vector<std::pair<pt::ptime, ::Order>> m_newOrders;
-  std::vector<std::pair<pt::ptime, OrderId>> m_cancels;
+  FillSimulator m_simulator;
+  //! Requests by the time of the exchange matching.
+  std::multimap<pt::ptime, Request> m_requests;
+  //! Executions by the time of the client notification.
+  std::multimap<pt::ptime, FillSimulator::Execution> m_reports;
+  pt::ptime m_lastReportTime;
+
+  boost::unordered_set<const Security *> m_securities;
+  std::vector<ScopedSlotConnection> m_marketDataConnections;
 
   const std::string m_orderNumberSuffix;
 
   explicit Implementation(TradingSystem &self, const ptr::ptree &conf)
       : m_self(&self),
-        m_delayGenerator(conf),
-        m_execChanceGenerator(conf),
+        m_executionDelay(
+            conf.get_child("config.delayMicroseconds.execution")),
+        m_responseDelay(conf.get_child("config.delayMicroseconds.response",
+                                       ptr::ptree())),
+        m_isReplayMode(m_self->GetContext().GetSettings().IsReplayMode()),
         m_id(1),
+        m_tradeId(1),
         m_isStarted(0),
-        m_orderNumberSuffix(m_self->GetContext().GetSettings().IsReplayMode()
-                                ? "REPLAY"
-                                : "PAPER") {
-    m_delayGenerator.Validate();
-    m_execChanceGenerator.Validate();
+        m_simulator(
+            {conf.get<double>("config.feesPercent.maker", 0) / 100,
+             conf.get<double>("config.feesPercent.taker", 0) / 100}),
+        m_orderNumberSuffix(m_isReplayMode ? "REPLAY" : "PAPER") {
+    m_executionDelay.Validate();
+    m_responseDelay.Validate();
   }
 
   ~Implementation() {
-    if (!m_self->GetContext().GetSettings().IsReplayMode()) {
+    m_marketDataConnections.clear();
+    if (!m_isReplayMode) {
       if (m_isStarted) {
         m_self->GetLog().Debug("Stopping Test Trading System task...");
         {
@@ -166,7 +161,7 @@ class Test::TradingSystem::Implementation : boost::noncopyable {
   }
 
   void Start() {
-    if (!m_self->GetContext().GetSettings().IsReplayMode()) {
+    if (!m_isReplayMode) {
       Lock lock(m_mutex);
       Assert(!m_isStarted);
       boost::thread thread(boost::bind(&Implementation::Task, this));
@@ -181,216 +176,228 @@ class Test::TradingSystem::Implementation : boost::noncopyable {
     }
   }
 
-  void SendOrder(::Order &&order) {
-    Assert(order.callback);
-
-    const auto &now = m_self->GetContext().GetCurrentTime();
-
-    auto execTime = now + ChooseExecutionDelay();
-    if (!m_self->GetContext().GetSettings().IsReplayMode()) {
-      const auto callback = order.callback;
-      //       order.callback = [this, callback](
-      //           const OrderId &, const OrderStatus &, const Qty &,
-      //           const boost::optional<Volume> &, const Trade *) {
-      //         // callback(id, status, remainingQty, commission, trade);
-      //       };
-    }
-
+  void SendRequest(Request &&request) {
+    auto time = m_self->GetContext().GetCurrentTime() + ChooseExecutionDelay();
     {
       const Lock lock(m_mutex);
-      m_newOrders.emplace_back(std::move(execTime), std::move(order));
+      if (request.security && m_securities.emplace(request.security).second) {
+        SubscribeToMarketData(*request.security);
+      }
+      m_requests.emplace(std::move(time), std::move(request));
     }
     m_condition.notify_all();
   }
 
   pt::time_duration ChooseExecutionDelay() const {
     const SettingsReadLock lock(m_settingsMutex);
-    return pt::microseconds(m_delayGenerator.executionDelayGenerator());
+    return m_executionDelay.Choose();
   }
 
- private:
-  void Task() {
-    StructuredException::SetupForThisThread();
-    try {
-      {
-        Lock lock(m_mutex);
-        m_condition.notify_all();
-      }
-
-      m_self->GetLog().Info("Started Test Trading System task...");
+  pt::time_duration ChooseResponseDelay() const {
+    const SettingsReadLock lock(m_settingsMutex);
+    return m_responseDelay.Choose();
+  }
 
-      for (pt::ptime nextTime;;) {
-        {
-          Lock lock(m_mutex);
-
-          if (!m_isStarted) {
-            break;
-          }
-          while (m_isStarted && m_newOrders.empty() && m_cancels.empty() &&
-                 m_orders.empty()) {
-            if (nextTime.is_not_a_date_time()) {
-              m_condition.wait(lock);
-            } else {
-              m_condition.timed_wait(lock, nextTime);
-              nextTime = pt::not_a_date_time;
-            }
-          }
-          if (!m_isStarted) {
-            break;
-          }
-
-          LoadNewOrders();
-        }
+ private:
+  void SubscribeToMarketData(Security &security) {
+    m_marketDataConnections.emplace_back(security.SubscribeToBookUpdateTicks(
+        [this, &security](const PriceBookSnapshot &book,
+                          const TimeMeasurement::Milestones &) {
+          UpdateMarketData([&](FillSimulator::Executions &executions) {
+            m_simulator.UpdateBook(security, *book, executions);
+          });
+        }));
+    m_marketDataConnections.emplace_back(security.SubscribeToLevel1Updates(
+        [this, &security](const TimeMeasurement::Milestones &) {
+          UpdateMarketData([&](FillSimulator::Executions &executions) {
+            m_simulator.UpdateLevel1(
+                security, security.GetBidPriceValue(),
+                security.GetBidQtyValue(), security.GetAskPriceValue(),
+                security.GetAskQtyValue(), executions);
+          });
+        }));
+    m_marketDataConnections.emplace_back(security.SubscribeToTrades(
+        [this, &security](const pt::ptime &, const Price &price,
+                          const Qty &qty, const TimeMeasurement::Milestones &) {
+          UpdateMarketData([&](FillSimulator::Executions &executions) {
+            m_simulator.AddTrade(security, price, qty, executions);
+          });
+        }));
+    FillSimulator::Executions executions;
+    m_simulator.UpdateLevel1(security, security.GetBidPriceValue(),
+                             security.GetBidQtyValue(),
+                             security.GetAskPriceValue(),
+                             security.GetAskQtyValue(), executions);
+    Assert(executions.empty());
+  }
 
-        for (auto it = m_orders.begin(); it != m_orders.cend();) {
-          const auto &execTime = it->first;
-          const auto &order = it->second;
-          Assert(order.callback);
-          Assert(order.price);
-
-          const auto &now = m_self->GetContext().GetCurrentTime();
-          if (now < execTime) {
-            nextTime = execTime;
-            break;
-          }
-
-          if (ExecuteOrder(order)) {
-            it = m_orders.erase(it);
-          } else {
-            ++it;
-          }
-        }
+  template <typename Callback>
+  void UpdateMarketData(const Callback &callback) {
+    const auto &now = m_self->GetContext().GetCurrentTime();
+    {
+      const Lock lock(m_mutex);
+      // Requests, which came to the exchange before this update, have to be
+      // matched with the previous market data.
+      while (!m_requests.empty() && m_requests.cbegin()->first < now) {
+        ExecuteRequest();
       }
-
-    } catch (...) {
-      AssertFailNoException();
-      throw;
+      FillSimulator::Executions executions;
+      callback(executions);
+      if (executions.empty()) {
+        return;
+      }
+      AddReports(now, executions);
     }
-
-    m_self->GetLog().Info("Test Trading System stopped.");
+    m_condition.notify_all();
   }
 
-  void OnCurrentTimeChanged(const pt::ptime &newTime) {
-    for (bool hasUpdates = true; hasUpdates;) {
-      {
-        const Lock lock(m_mutex);
-        hasUpdates = LoadNewOrders();
-      }
-
-      while (!m_orders.empty()) {
-        const auto &execTime = m_orders.cbegin()->first;
-        const auto &order = m_orders.cbegin()->second;
-        Assert(order.callback);
-        Assert(order.price);
-
-        // More or equal because market data snapshot for newTime will
-        // be set after OnCurrentTimeChanged event.
-        if (newTime <= execTime) {
-          break;
-        }
-
-        m_self->GetContext().SetCurrentTime(execTime, false);
-
-        if (ExecuteOrder(order)) {
-          m_self->GetContext().SyncDispatching();
-          m_orders.erase(m_orders.begin());
-          {
-            const Lock lock(m_mutex);
-            LoadNewOrders();
-          }
-        } else {
-          {
-            const Lock lock(m_mutex);
-            m_orders.emplace(newTime, std::move(order));
-          }
-          m_orders.erase(m_orders.begin());
-        }
-
-        hasUpdates = true;
-      }
+  void ExecuteRequest() {
+    Assert(!m_requests.empty());
+    const auto &time = m_requests.cbegin()->first;
+    const auto &request = m_requests.cbegin()->second;
+    FillSimulator::Executions executions;
+    if (!request.isCancel) {
+      m_simulator.AddOrder(request.orderId, *request.security, request.side,
+                           request.qty, request.price, request.tif,
+                           executions);
+    } else if (!m_simulator.CancelOrder(request.orderId, executions)) {
+      m_self->GetLog().Debug(
+          "Failed to cancel order %1% as it already canceled, executed, or "
+          "was never sent.",
+          request.orderId);
     }
+    AddReports(time, executions);
+    m_requests.erase(m_requests.cbegin());
   }
 
-  bool ExecuteOrder(const ::Order &order) {
-    const auto &tradeId =
-        (boost::format("%1%%2%") % m_orderNumberSuffix % order.id).str();
+  void AddReports(const pt::ptime &time,
+                  const FillSimulator::Executions &executions) {
+    if (executions.empty()) {
+      return;
+    }
+    // The client receives notifications in the same order as the exchange
+    // sends them.
+    m_lastReportTime =
+        std::max(time + ChooseResponseDelay(),
+                 m_lastReportTime.is_not_a_date_time() ? time
+                                                       : m_lastReportTime);
+    for (const auto &execution : executions) {
+      m_reports.emplace(m_lastReportTime, execution);
+    }
+  }
 
-    if (!order.isCanceled) {
-      Trade trade = {};
+  bool IsTimeToExecute(const pt::ptime &eventTime, const pt::ptime &now) const {
+    // In the replay mode, market data snapshot for now will be set after
+    // OnCurrentTimeChanged event.
+    return m_isReplayMode ? eventTime < now : eventTime <= now;
+  }
 
-      bool isMatched = order.isSell
-                           ? order.price <= order.security->GetBidPrice()
-                           : order.price >= order.security->GetAskPrice();
-      if (isMatched) {
-        isMatched = m_execChanceGenerator.HasChance();
+  //! Executes all requests and reports before the time.
+  void ExecuteEvents(const pt::ptime &now) {
+    for (;;) {
+      Lock lock(m_mutex);
+      const auto request = m_requests.cbegin();
+      const auto report = m_reports.cbegin();
+      const bool hasRequest = request != m_requests.cend() &&
+                              IsTimeToExecute(request->first, now);
+      const bool hasReport =
+          report != m_reports.cend() && IsTimeToExecute(report->first, now);
+      if (hasRequest && (!hasReport || request->first <= report->first)) {
+        ExecuteRequest();
+        continue;
       }
+      if (!hasReport) {
+        break;
+      }
+      const auto time = report->first;
+      const auto execution = report->second;
+      m_reports.erase(report);
+      lock.unlock();
 
-      if (isMatched) {
-        trade.price = order.isSell ? order.security->GetBidPrice()
-                                   : order.security->GetAskPrice();
-        trade.id = tradeId;
-        trade.qty = order.qty;
-
-        //         order.callback(order.id, ORDER_STATUS_FILLED_FULLY, 0,
-        //         boost::none,
-        //                        &trade);
-
-        return true;
-
-      } else if (!order.isIoc) {
-        return false;
+      if (m_isReplayMode) {
+        m_self->GetContext().SetCurrentTime(time, false);
+      }
+      Report(time, execution);
+      if (m_isReplayMode) {
+        m_self->GetContext().SyncDispatching();
       }
     }
+  }
 
-    const auto &status =
-        order.isCanceled <= 1 ? ORDER_STATUS_CANCELED : ORDER_STATUS_ERROR;
-
-    if (status == ORDER_STATUS_ERROR) {
-      m_self->GetLog().Error(
-          "Failed to cancel order %1% as it already canceled,"
-          " executed, or was never sent.",
-          order.id);
+  void Report(const pt::ptime &time,
+              const FillSimulator::Execution &execution) {
+    const auto &createTrade = [this, &execution]() -> Trade {
+      return {
+          execution.price, execution.qty,
+          (boost::format("%1%%2%") % m_orderNumberSuffix % m_tradeId++).str()};
+    };
+    try {
+      switch (execution.status) {
+        case FillSimulator::Execution::STATUS_OPENED:
+          m_self->OnOrderOpened(time, execution.orderId);
+          break;
+        case FillSimulator::Execution::STATUS_TRADE:
+          m_self->OnTrade(time, execution.orderId, createTrade());
+          break;
+        case FillSimulator::Execution::STATUS_FILLED:
+          m_self->OnOrderFilled(time, execution.orderId, createTrade(),
+                                execution.commission);
+          break;
+        case FillSimulator::Execution::STATUS_CANCELED:
+          m_self->OnOrderCanceled(time, execution.orderId,
+                                  execution.remainingQty,
+                                  execution.commission);
+          break;
+      }
+    } catch (const OrderIsUnknownException &ex) {
+      m_self->GetLog().Error("Failed to report order %1% update: \"%2%\".",
+                             execution.orderId,  // 1
+                             ex.what());         // 2
     }
-
-    // order.callback(order.id, status, order.qty, boost::none, nullptr);
-
-    return true;
   }
 
-  bool LoadNewOrders() {
-    bool hasUpdates = false;
+  void Task() {
+    StructuredException::SetupForThisThread();
+    try {
+      {
+        Lock lock(m_mutex);
+        m_condition.notify_all();
+      }
 
-    for (const auto &order : m_newOrders) {
-      AssertLe(m_self->GetContext().GetCurrentTime(), order.first);
-      m_orders.emplace(std::move(order.first), std::move(order.second));
-      hasUpdates = true;
-    }
-    m_newOrders.clear();
-
-    if (!m_cancels.empty()) {
-      for (const auto &cancel : m_cancels) {
-        bool isFound = false;
-        for (auto order = m_orders.cbegin(); order != m_orders.cend();
-             ++order) {
-          if (order->second.id == cancel.second) {
-            auto newOrder = order->second;
-            ++newOrder.isCanceled;
-            m_orders.erase(order);
-            m_orders.emplace(std::move(cancel.first), std::move(newOrder));
-            isFound = true;
-            break;
-          }
+      m_self->GetLog().Info("Started Test Trading System task...");
+
+      for (;;) {
+        ExecuteEvents(m_self->GetContext().GetCurrentTime());
+        Lock lock(m_mutex);
+        if (!m_isStarted) {
+          break;
         }
-        if (!isFound) {
-          AssertFail("Implement error if cancel without order.");
+        if (m_requests.empty() && m_reports.empty()) {
+          m_condition.wait(lock);
+          continue;
+        }
+        const auto &nextTime =
+            m_requests.empty()
+                ? m_reports.cbegin()->first
+                : m_reports.empty() ? m_requests.cbegin()->first
+                                    : std::min(m_requests.cbegin()->first,
+                                               m_reports.cbegin()->first);
+        const auto &now = m_self->GetContext().GetCurrentTime();
+        if (now < nextTime) {
+          m_condition.timed_wait(lock, nextTime - now);
         }
       }
-      m_cancels.clear();
 
-      hasUpdates = true;
+    } catch (...) {
+      AssertFailNoException();
+      throw;
     }
 
-    return hasUpdates;
+    m_self->GetLog().Info("Test Trading System stopped.");
+  }
+
+  void OnCurrentTimeChanged(const pt::ptime &newTime) {
+    ExecuteEvents(newTime);
   }
 };
 
@@ -403,7 +410,11 @@ Test::TradingSystem::TradingSystem(const TradingMode &mode,
                                    const ptr::ptree &conf)
     : Base(mode, context, std::move(instanceName), std::move(title)),
       m_pimpl(std::make_unique<Implementation>(*this, conf)) {
-  m_pimpl->m_delayGenerator.Report(GetLog());
+  m_pimpl->m_executionDelay.Report("Execution", GetLog());
+  m_pimpl->m_responseDelay.Report("Response", GetLog());
+  GetLog().Info("Fees: maker %1%%%, taker %2%%%.",
+                m_pimpl->m_simulator.GetFees().maker * 100,   // 1
+                m_pimpl->m_simulator.GetFees().taker * 100);  // 2
 }
 
 Test::TradingSystem::~TradingSystem() = default;
@@ -413,34 +424,29 @@ bool Test::TradingSystem::IsConnected() const { return m_pimpl->IsStarted(); }
 void Test::TradingSystem::CreateConnection() { m_pimpl->Start(); }
 
 std::unique_ptr<OrderTransactionContext>
-Test::TradingSystem::SendOrderTransaction(Security &,
+Test::TradingSystem::SendOrderTransaction(Security &security,
                                           const Currency &,
-                                          const Qty &,
-                                          const boost::optional<Price> &,
+                                          const Qty &qty,
+                                          const boost::optional<Price> &price,
                                           const OrderParams &,
-                                          const OrderSide &,
-                                          const TimeInForce &) {
-  throw MethodIsNotImplementedException(
-      "Test::TradingSystem::SendOrderTransaction is not implemented");
+                                          const OrderSide &side,
+                                          const TimeInForce &tif) {
+  OrderId id = m_pimpl->TakeOrderId();
+  m_pimpl->SendRequest({id, &security, side, qty, price, tif, false});
+  return boost::make_unique<OrderTransactionContext>(*this, std::move(id));
 }
 
 void Test::TradingSystem::SendCancelOrderTransaction(
     const OrderTransactionContext &transaction) {
-  const auto &now = GetContext().GetCurrentTime();
-  auto execTime = now + m_pimpl->ChooseExecutionDelay();
-  {
-    const Implementation::Lock lock(m_pimpl->m_mutex);
-    m_pimpl->m_cancels.emplace_back(std::move(execTime),
-                                    transaction.GetOrderId());
-  }
-  m_pimpl->m_condition.notify_all();
+  m_pimpl->SendRequest({transaction.GetOrderId(), nullptr, ORDER_SIDE_BUY, 0,
+                        boost::none, TIME_IN_FORCE_GTC, true});
 }
 
-Volume Test::TradingSystem::CalcCommission(const Qty &,
-                                           const Price &,
+Volume Test::TradingSystem::CalcCommission(const Qty &qty,
+                                           const Price &price,
                                            const OrderSide &,
                                            const Security &) const {
-  return 0;
+  return (qty * price) * m_pimpl->m_simulator.GetFees().taker;
 }
 
 //////////////////////////////////////////////////////////////////////////
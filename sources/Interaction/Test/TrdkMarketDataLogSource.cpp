@@ -9,15 +9,15 @@
  **************************************************************************/
 
 #include "Prec.hpp"
+#include "Core/MarketDataCapture.hpp"
 #include "Core/Security.hpp"
 #include "MarketDataSource.hpp"
 #include "Security.hpp"
-#include "Common/ExpirationCalendar.hpp"
 
 namespace pt = boost::posix_time;
 namespace ptr = boost::property_tree;
-namespace gr = boost::gregorian;
 namespace fs = boost::filesystem;
+namespace mdc = trdk::MarketDataCapture;
 using namespace trdk;
 using namespace Lib;
 using namespace Interaction;
@@ -25,18 +25,63 @@ using namespace Test;
 
 namespace {
 
+//! Replays market data from binary capture files.
+/**
+ * Source path may be a capture file or a directory, in this case all capture
+ * files from the directory are replayed. Files are memory-mapped (once for
+ * all contexts in the process) and merged by record time, so one source
+ * replays all securities from all sources which were captured. Records are
+ * applied to the securities with the same symbols, records for other symbols
+ * are skipped.
+ *
+ * Events are pushed to the dispatcher in batches: records which have the same
+ * record time, or which are in the period "batchPeriod" (microseconds, 0 by
+ * default) from the first record of the batch, are dispatched by one
+ * synchronization.
+ */
 class TrdkMarketDataLogSource : public Test::MarketDataSource {
  public:
   typedef Test::MarketDataSource Base;
 
+ private:
+  struct Stream {
+    size_t index;
+    fs::path path;
+    mdc::SharedFile file;
+    std::unique_ptr<mdc::Reader> reader;
+    //! Securities by file symbol IDs, nullptr if the symbol is not replayed.
+    boost::unordered_map<mdc::SymbolId, Test::Security *> securities;
+    size_t numberOfRecords;
+
+    explicit Stream(size_t index, const fs::path &path)
+        : index(index),
+          path(path),
+          file(mdc::OpenSharedFile(path)),
+          numberOfRecords(0) {
+      reader = boost::make_unique<mdc::Reader>(file->data(),
+                                               file->data() + file->size());
+    }
+  };
+
+  //! Orders streams by the next record time, the earliest is on the top.
+  struct StreamOrder {
+    bool operator()(const Stream *lhs, const Stream *rhs) const {
+      const auto &lhsTime = lhs->reader->GetRecordTime();
+      const auto &rhsTime = rhs->reader->GetRecordTime();
+      return lhsTime > rhsTime ||
+             (lhsTime == rhsTime && lhs->index > rhs->index);
+    }
+  };
+
  public:
   explicit TrdkMarketDataLogSource(Context &context,
                                    std::string instanceName,
                                    std::string title,
                                    const ptr::ptree &conf)
       : Base(context, std::move(instanceName), std::move(title), conf),
-        m_filePath(Normalize(conf.get<fs::path>("source"))) {
-    GetLog().Info("Source is %1%.", m_filePath);
+        m_path(Normalize(conf.get<fs::path>("source"))),
+        m_batchPeriod(pt::microseconds(conf.get<long>("batchPeriod", 0))) {
+    GetLog().Info("Source is %1%. Batch period: %2%.", m_path, m_batchPeriod);
   }
 
   ~TrdkMarketDataLogSource() override {
@@ -53,8 +98,6 @@ class TrdkMarketDataLogSource : public Test::MarketDataSource {
       const Symbol &symbol) override {
     if (!symbol.IsExplicit()) {
       throw Exception("Source works only with explicit symbols");
-    } else if (m_security) {
-      throw Exception("Source works only with one security");
     }
 
     auto result = boost::make_shared<Test::Security>(
@@ -62,108 +105,169 @@ class TrdkMarketDataLogSource : public Test::MarketDataSource {
     result->SetTradingSessionState(pt::not_a_date_time, true);
     result->SetOnline(pt::not_a_date_time, true);
 
-    m_security = result;
+    Verify(m_securities.emplace(symbol.GetAsString(), result).second);
 
     return *result;
   }
 
   virtual void Run() override {
-    if (!m_security) {
+    if (m_securities.empty()) {
       throw Exception("Security is not set");
     }
 
-    std::ifstream file(m_filePath.string().c_str());
-    if (!file) {
-      GetLog().Error("Failed to open market data source file %1%.", m_filePath);
-      throw ConnectError("Failed to open market data source file");
-    } else {
-      GetLog().Info("Opened market data source file %1%.", m_filePath);
+    auto streams = OpenStreams();
+    std::priority_queue<Stream *, std::vector<Stream *>, StreamOrder> queue;
+    for (auto &stream : streams) {
+      if (stream->reader->Next()) {
+        queue.emplace(stream.get());
+      }
     }
 
-    std::string line;
-    size_t lineNo = 0;
-    while (std::getline(file, line)) {
+    size_t numberOfRecords = 0;
+    size_t numberOfBatches = 0;
+    while (!queue.empty()) {
       if (IsStopped()) {
         GetLog().Info("Stopped.");
         break;
       }
-
-      ++lineNo;
-
-      std::vector<std::string> fields;
-      boost::split(fields, line, boost::is_any_of(","),
-                   boost::token_compress_on);
-
-      const bool isBreakPoint = fields[0] == "b";
-      if (isBreakPoint) {
-        fields.erase(fields.begin());
+      const auto batchEnd =
+          queue.top()->reader->GetRecordTime() + m_batchPeriod;
+      while (!queue.empty() &&
+             queue.top()->reader->GetRecordTime() <= batchEnd) {
+        auto &stream = *queue.top();
+        queue.pop();
+        ApplyRecord(stream);
+        ++stream.numberOfRecords;
+        ++numberOfRecords;
+        if (stream.reader->Next()) {
+          queue.emplace(&stream);
+        }
       }
+      ++numberOfBatches;
+      GetContext().SyncDispatching();
+    }
+
+    for (const auto &stream : streams) {
+      GetLog().Debug("Read %1% records from %2%.", stream->numberOfRecords,
+                     stream->path);
+    }
+    GetLog().Info("Replayed %1% records by %2% batches from %3% file(s).",
+                  numberOfRecords,   // 1
+                  numberOfBatches,   // 2
+                  streams.size());  // 3
+  }
 
-      if (fields.size() < 3) {
-        if (boost::starts_with(line, "[Start]")) {
-          GetLog().Info("Found session end on line %1%.", lineNo);
-          break;
+ private:
+  std::vector<std::unique_ptr<Stream>> OpenStreams() const {
+    std::vector<fs::path> paths;
+    if (fs::is_directory(m_path)) {
+      for (fs::directory_iterator it(m_path), end; it != end; ++it) {
+        if (fs::is_regular_file(it->status()) &&
+            it->path().extension() == ".trdkmd") {
+          paths.emplace_back(it->path());
         }
-        GetLog().Error("Wrong file format at line %1%.", lineNo);
-        throw Exception("Wrong file format");
       }
+      // Records with the same time are applied in the order of the files:
+      std::sort(paths.begin(), paths.end());
+    } else {
+      paths.emplace_back(m_path);
+    }
+    if (paths.empty()) {
+      GetLog().Error("Failed to find market data files in %1%.", m_path);
+      throw ConnectError("Failed to find market data files");
+    }
 
-      const auto recordTime = pt::time_from_string(fields[0]);
-      if (isBreakPoint) {
-        GetLog().Debug("Breakpoint found on line %1%. Record time: %2%.",
-                       lineNo, recordTime);
+    std::vector<std::unique_ptr<Stream>> result;
+    result.reserve(paths.size());
+    for (const auto &path : paths) {
+      try {
+        result.emplace_back(boost::make_unique<Stream>(result.size(), path));
+      } catch (const std::exception &ex) {
+        GetLog().Error("Failed to open market data source file %1%: \"%2%\".",
+                       path,        // 1
+                       ex.what());  // 2
+        throw ConnectError("Failed to open market data source file");
       }
+      GetLog().Info("Opened market data source file %1%.", path);
+    }
+    return result;
+  }
 
-      GetContext().SetCurrentTime(recordTime, true);
-
-      const pt::ptime dataTime = fields[1] == "not-a-date-time"
-                                     ? pt::not_a_date_time
-                                     : pt::time_from_string(fields[1]);
-
-      if (fields[2] == "T") {
-        OnTick(dataTime, fields);
-      } else if (fields[2] == "L1U") {
-        OnLevel1Update(dataTime, fields);
-      } else {
-        throw Exception("Unknown data record type");
+  Test::Security *FindSecurity(Stream &stream) {
+    const auto &symbolId = stream.reader->GetSymbolId();
+    {
+      const auto &it = stream.securities.find(symbolId);
+      if (it != stream.securities.cend()) {
+        return it->second;
       }
-
-      GetContext().SyncDispatching();
     }
-
-    GetLog().Info("Read %1% lines from %2%.", lineNo, m_filePath);
+    const auto &symbol = stream.reader->GetSymbol();
+    const auto &it = m_securities.find(symbol.symbol);
+    Test::Security *const result =
+        it != m_securities.cend() ? it->second.get() : nullptr;
+    stream.securities.emplace(symbolId, result);
+    if (!result) {
+      GetLog().Debug("Skipping \"%1%\" from %2%.", symbol.symbol, stream.path);
+    }
+    return result;
   }
 
- protected:
-  void OnTick(const pt::ptime &time, const std::vector<std::string> &fields) {
-    if (fields.size() != 7 && fields.size() != 6) {
-      throw Exception("Tick record has wrong number of fields");
-    }
-    m_security->AddTrade(time, boost::lexical_cast<double>(fields[3]),
-                         boost::lexical_cast<double>(fields[4]),
-                         TimeMeasurement::Milestones(),
-                         boost::lexical_cast<bool>(fields[5]));
-  }
+  void ApplyRecord(Stream &stream) {
+    auto *const security = FindSecurity(stream);
+    if (!security) {
+      return;
+    }
 
-  void OnLevel1Update(const pt::ptime &time,
-                      const std::vector<std::string> &fields) {
-    if (fields.size() < 4 || (fields.size() - 3) % 2) {
-      throw Exception("Level 1 Update record has wrong format");
+    const auto &reader = *stream.reader;
+    // Records from different threads may be logged not in the time order:
+    if (m_currentTime.is_not_a_date_time() ||
+        m_currentTime < reader.GetRecordTime()) {
+      m_currentTime = reader.GetRecordTime();
+      GetContext().SetCurrentTime(m_currentTime, true);
     }
 
-    std::vector<Level1TickValue> update;
-    for (auto it = fields.cbegin() + 3; it != fields.cend();
-         std::advance(it, 2)) {
-      update.emplace_back(ConvertToLevel1TickType(*it),
-                          boost::lexical_cast<double>(*std::next(it)));
+    static_assert(mdc::numberOfRecordTypes == 7, "List changed.");
+    switch (reader.GetType()) {
+      case mdc::RECORD_TYPE_LEVEL1_UPDATE:
+        security->SetLevel1(reader.GetDataTime(), ReadLevel1(reader),
+                            TimeMeasurement::Milestones());
+        break;
+      case mdc::RECORD_TYPE_LEVEL1_TICK:
+        security->AddLevel1Tick(reader.GetDataTime(), ReadLevel1(reader),
+                                TimeMeasurement::Milestones());
+        break;
+      case mdc::RECORD_TYPE_TRADE:
+        security->AddTrade(reader.GetDataTime(), reader.GetTradePrice(),
+                           reader.GetTradeQty(), TimeMeasurement::Milestones(),
+                           reader.IsLastTrade());
+        break;
+      case mdc::RECORD_TYPE_BOOK: {
+        auto book = reader.GetBook();
+        security->SetBook(book, TimeMeasurement::Milestones());
+        break;
+      }
+      default:
+        AssertEq(mdc::RECORD_TYPE_LEVEL1_UPDATE, reader.GetType());
+        break;
     }
+  }
 
-    m_security->SetLevel1(time, update, TimeMeasurement::Milestones());
+  const std::vector<Level1TickValue> &ReadLevel1(const mdc::Reader &reader) {
+    // The buffer is reused, so it doesn't allocate memory for each record.
+    m_level1.clear();
+    for (size_t i = 0; i < reader.GetNumberOfLevel1Ticks(); ++i) {
+      m_level1.emplace_back(reader.GetLevel1Tick(i));
+    }
+    return m_level1;
   }
 
  private:
-  const boost::filesystem::path m_filePath;
-  boost::shared_ptr<Test::Security> m_security;
+  const fs::path m_path;
+  const pt::time_duration m_batchPeriod;
+  pt::ptime m_currentTime;
+  boost::unordered_map<std::string, boost::shared_ptr<Test::Security>>
+      m_securities;
+  std::vector<Level1TickValue> m_level1;
 };
 }  // namespace
 
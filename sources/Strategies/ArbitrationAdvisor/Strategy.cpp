@@ -206,16 +206,16 @@ class aa::Strategy::Implementation : boost::noncopyable {
     bids.reserve(allSecurities.size());
     asks.reserve(allSecurities.size());
 
-    Price updatedSecurityBidPrice = std::numeric_limits<double>::quiet_NaN();
-    Price updatedSecurityAskPrice = std::numeric_limits<double>::quiet_NaN();
+    // Bid, ask and their quantities of one security have to be from the same
+    // update.
+    const auto &updatedSecurityLevel1 = updatedSecurity.GetLevel1Snapshot();
     for (auto &security : allSecurities) {
       security.isBestBid = security.isBestAsk = false;
-      bids.emplace_back(security.security->GetBidPriceValue(), &security);
-      asks.emplace_back(security.security->GetAskPriceValue(), &security);
-      if (security.security == &updatedSecurity) {
-        updatedSecurityBidPrice = bids.back().first;
-        updatedSecurityAskPrice = asks.back().first;
-      }
+      const auto &level1 = security.security == &updatedSecurity
+                               ? updatedSecurityLevel1
+                               : security.security->GetLevel1Snapshot();
+      bids.emplace_back(level1.bidPrice, &security);
+      asks.emplace_back(level1.askPrice, &security);
       if (bids.back().first.IsNan()) {
         bids.pop_back();
       }
@@ -256,9 +256,9 @@ class aa::Strategy::Implementation : boost::noncopyable {
 
     m_adviceSignal(
         Advice{&updatedSecurity,
-               updatedSecurity.GetLastMarketDataTime(),
-               {updatedSecurityBidPrice, updatedSecurity.GetBidQtyValue()},
-               {updatedSecurityAskPrice, updatedSecurity.GetAskQtyValue()},
+               updatedSecurityLevel1.time,
+               {updatedSecurityLevel1.bidPrice, updatedSecurityLevel1.bidQty},
+               {updatedSecurityLevel1.askPrice, updatedSecurityLevel1.askQty},
                spread,
                spreadRatio,
                spreadRatio >= m_minPriceDifferenceRatioToAdvice,
@@ -18,6 +18,7 @@
 #include <boost/multi_index_container.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <boost/random.hpp>
+#include <boost/thread/barrier.hpp>
 #include <boost/uuid/uuid_generators.hpp>  // Strategies/MrigeshKejriwal/MrigeshKejriwalStrategyUTest.cpp
 #undef Assert
 #include <gmock/gmock.h>
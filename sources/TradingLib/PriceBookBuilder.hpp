@@ -0,0 +1,280 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 15:22:47
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#pragma once
+
+#include "Core/IncrementalPriceBook.hpp"
+#include <functional>
+#include <map>
+
+namespace trdk {
+namespace TradingLib {
+
+//! Builds security price book from the snapshot and incremental diffs.
+/**
+ * The top levels are stored in the preallocated flat sorted arrays, so the
+ * building of the top doesn't allocate memory. Levels which are out of the
+ * array depth are kept in the ordered maps and are moved back to the top when
+ * the better levels are deleted, so the book depth is not limited. Diffs may
+ * have sequence numbers: the builder skips diffs which are already in the
+ * snapshot and stops the book if a diff is lost, the book is restored by the
+ * next snapshot.
+ *
+ * Not thread-safe, caller should provide thread synchronization.
+ *
+ * @tparam SecurityT Security implementation which provides access to
+ *                   trdk::Security::SetBook and trdk::Security::SetOnline.
+ * @tparam maxDepth  Number of levels for each side, which are stored in the
+ *                   flat arrays.
+ */
+template <typename SecurityT, size_t maxDepth = 100>
+class PriceBookBuilder {
+ public:
+  typedef SecurityT Security;
+  typedef IncrementalPriceBook<maxDepth> Book;
+  typedef uintmax_t SequenceNumber;
+
+  //! Diff sequence number check result.
+  enum DiffCheckResult {
+    //! The diff should be applied.
+    DIFF_CHECK_RESULT_ACTUAL,
+    //! The diff is already in the snapshot or the book waits for the snapshot,
+    //! the diff should be skipped.
+    DIFF_CHECK_RESULT_SKIP,
+    //! The diff sequence has a gap. The book is stopped and should be
+    //! restored by new snapshot.
+    DIFF_CHECK_RESULT_GAP
+  };
+
+ public:
+  explicit PriceBookBuilder(Security &security)
+      : m_security(security),
+        m_book(security.GetPricePrecisionPower()),
+        m_isSynchronized(false),
+        m_isChanged(false) {}
+
+ public:
+  Security &GetSecurity() const { return m_security; }
+
+  const Book &GetBook() const { return m_book; }
+
+  //! Returns true if the book has a snapshot and doesn't have lost diffs.
+  bool IsSynchronized() const { return m_isSynchronized; }
+
+  const boost::optional<SequenceNumber> &GetSequenceNumber() const {
+    return m_sequenceNumber;
+  }
+
+  //! Starts new snapshot.
+  /**
+   * Drops all levels, levels from the snapshot should be set by Update.
+   * @param sequenceNumber The last diff sequence number, which is included in
+   *                       the snapshot, or none if the diffs don't have
+   *                       sequence numbers.
+   */
+  void StartSnapshot(
+      const boost::optional<SequenceNumber> &sequenceNumber = boost::none) {
+    Clear();
+    m_sequenceNumber = sequenceNumber;
+    m_isSynchronized = true;
+    m_isChanged = true;
+  }
+
+  //! Checks the sequence number of the diff which has only one number.
+  DiffCheckResult CheckSequenceNumber(const SequenceNumber &sequenceNumber) {
+    return CheckSequenceNumber(sequenceNumber, sequenceNumber);
+  }
+  //! Checks the sequence number of the diff which covers a range of numbers.
+  /**
+   * If the result is DIFF_CHECK_RESULT_ACTUAL, the last number of the range
+   * is stored as the number of the last applied diff.
+   * @param first  The first sequence number in the diff.
+   * @param last   The last sequence number in the diff.
+   */
+  DiffCheckResult CheckSequenceNumber(const SequenceNumber &first,
+                                      const SequenceNumber &last) {
+    AssertLe(first, last);
+    if (!m_isSynchronized) {
+      return DIFF_CHECK_RESULT_SKIP;
+    }
+    if (m_sequenceNumber) {
+      if (last <= *m_sequenceNumber) {
+        return DIFF_CHECK_RESULT_SKIP;
+      }
+      if (first > *m_sequenceNumber + 1) {
+        Stop();
+        return DIFF_CHECK_RESULT_GAP;
+      }
+    }
+    m_sequenceNumber = last;
+    return DIFF_CHECK_RESULT_ACTUAL;
+  }
+
+  //! Sets new level quantity, deletes the level if the quantity is zero.
+  void Update(const OrderSide &side, const Price &price, const Qty &qty) {
+    const auto &ticks = m_book.ConvertToTicks(price);
+    const auto &apply = [&ticks, &qty](auto &bookSide) {
+      return bookSide.Apply(ticks, qty);
+    };
+    const auto &applyDeep = [&ticks, &qty](auto &deepSide) {
+      if (qty == 0) {
+        deepSide.erase(ticks);
+      } else {
+        deepSide[ticks] = qty;
+      }
+    };
+    if (side == ORDER_SIDE_BID ? Apply(m_book.GetBid(), m_deepBids, ticks,
+                                       apply, applyDeep)
+                               : Apply(m_book.GetAsk(), m_deepAsks, ticks,
+                                       apply, applyDeep)) {
+      m_isChanged = true;
+    }
+  }
+
+  //! Adds quantity to the level, negative quantity reduces the level.
+  /**
+   * For sources which report separated orders, each order adds its quantity
+   * to the price level.
+   */
+  void AddQty(const OrderSide &side, const Price &price, const Qty &qty) {
+    const auto &ticks = m_book.ConvertToTicks(price);
+    const auto &apply = [&ticks, &qty](auto &bookSide) {
+      return bookSide.Add(ticks, qty);
+    };
+    const auto &applyDeep = [&ticks, &qty](auto &deepSide) {
+      const auto &it = deepSide.find(ticks);
+      if (it == deepSide.cend()) {
+        if (qty > 0) {
+          deepSide.emplace(ticks, qty);
+        }
+      } else if ((it->second += qty) <= 0) {
+        deepSide.erase(it);
+      }
+    };
+    if (side == ORDER_SIDE_BID ? Apply(m_book.GetBid(), m_deepBids, ticks,
+                                       apply, applyDeep)
+                               : Apply(m_book.GetAsk(), m_deepAsks, ticks,
+                                       apply, applyDeep)) {
+      m_isChanged = true;
+    }
+  }
+
+  //! Returns the number of levels which are out of the flat arrays depth.
+  size_t GetNumberOfDeepLevels(const OrderSide &side) const {
+    return side == ORDER_SIDE_BID ? m_deepBids.size() : m_deepAsks.size();
+  }
+
+  //! Stops the book until the next snapshot.
+  /**
+   * Should be called if the book can't be synchronized anymore, for example,
+   * at connection loss.
+   */
+  void Stop() {
+    m_isSynchronized = false;
+    Clear();
+    m_security.SetOnline(boost::posix_time::not_a_date_time, false);
+  }
+
+  //! Sets the book and the best prices to the security if the book is
+  //! changed.
+  /**
+   * Sets security offline if the book is not synchronized or if a book side
+   * is empty.
+   */
+  void Flush(const boost::posix_time::ptime &time,
+             const Lib::TimeMeasurement::Milestones &delayMeasurement) {
+    if (!m_isSynchronized || m_book.GetBid().IsEmpty() ||
+        m_book.GetAsk().IsEmpty()) {
+      m_security.SetOnline(boost::posix_time::not_a_date_time, false);
+      return;
+    }
+    if (m_isChanged) {
+      m_book.SetTime(time);
+      auto book = m_book.Export();
+      // Also sets Level 1 from the top of the book:
+      m_security.SetBook(book, delayMeasurement);
+      m_isChanged = false;
+    }
+    m_security.SetOnline(boost::posix_time::not_a_date_time, true);
+  }
+
+ private:
+  typedef typename Book::Ticks Ticks;
+  // Deep levels are sorted from the best price as the book sides:
+  typedef std::map<Ticks, Qty, std::greater<Ticks>> DeepBids;
+  typedef std::map<Ticks, Qty, std::less<Ticks>> DeepAsks;
+
+  void Clear() {
+    m_book.Clear();
+    m_deepBids.clear();
+    m_deepAsks.clear();
+  }
+
+  //! Applies the level change to the flat side or to the deep levels.
+  /**
+   * If the flat side is full and the changed level is worse than the worst
+   * level of the side, the change is applied to the deep levels. If the
+   * insertion drops the worst level from the full side, the level is moved to
+   * the deep levels, if the deletion frees a place, the best deep level is
+   * moved to the side.
+   * @return true if the flat side is changed.
+   */
+  template <typename BookSide,
+            typename DeepSide,
+            typename ApplyCallback,
+            typename ApplyDeepCallback>
+  static bool Apply(BookSide &side,
+                    DeepSide &deepSide,
+                    const Ticks &ticks,
+                    const ApplyCallback &apply,
+                    const ApplyDeepCallback &applyDeep) {
+    const auto &isBetter = deepSide.key_comp();
+    const auto isFull = side.GetSize() >= maxDepth;
+    if (isFull && isBetter(side.GetTicks(maxDepth - 1), ticks)) {
+      applyDeep(deepSide);
+      return false;
+    }
+
+    boost::optional<std::pair<Ticks, Qty>> worst;
+    if (isFull) {
+      worst.emplace(side.GetTicks(maxDepth - 1), side.GetQty(maxDepth - 1));
+    }
+
+    if (!apply(side)) {
+      return false;
+    }
+
+    if (worst && side.GetSize() >= maxDepth &&
+        side.GetTicks(maxDepth - 1) != worst->first) {
+      // The worst level is dropped by the insertion.
+      deepSide.emplace(worst->first, worst->second);
+    } else {
+      while (side.GetSize() < maxDepth && !deepSide.empty()) {
+        // The deletion frees a place for the best deep level.
+        const auto &best = deepSide.cbegin();
+        Verify(side.Apply(best->first, best->second));
+        deepSide.erase(best);
+      }
+    }
+    return true;
+  }
+
+ private:
+  Security &m_security;
+  Book m_book;
+  DeepBids m_deepBids;
+  DeepAsks m_deepAsks;
+  boost::optional<SequenceNumber> m_sequenceNumber;
+  bool m_isSynchronized;
+  bool m_isChanged;
+};
+
+}  // namespace TradingLib
+}  // namespace trdk
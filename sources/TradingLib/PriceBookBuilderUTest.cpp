@@ -0,0 +1,232 @@
+/*******************************************************************************
+ *   Created: 2026/10/16 15:58:12
+ *    Author: Eugene V. Palchukovsky
+ *    E-mail: eugene@palchukovsky.com
+ * -------------------------------------------------------------------
+ *   Project: Trading Robot Development Kit
+ *       URL: http://robotdk.com
+ * Copyright: Eugene V. Palchukovsky
+ ******************************************************************************/
+
+#include "Prec.hpp"
+#include "PriceBookBuilder.hpp"
+
+using namespace trdk;
+using namespace trdk::Lib::TimeMeasurement;
+namespace pt = boost::posix_time;
+
+namespace {
+
+class SecurityMock {
+ public:
+  SecurityMock() : m_isOnline(false), m_numberOfBooks(0) {}
+
+ public:
+  uintmax_t GetPricePrecisionPower() const { return 100; }
+
+  void SetOnline(const pt::ptime &, bool isOnline) { m_isOnline = isOnline; }
+  bool IsOnline() const { return m_isOnline; }
+
+  void SetBook(PriceBook &book, const Milestones &) {
+    m_book = book;
+    ++m_numberOfBooks;
+  }
+  const PriceBook &GetBook() const { return m_book; }
+  size_t GetNumberOfBooks() const { return m_numberOfBooks; }
+
+ private:
+  bool m_isOnline;
+  PriceBook m_book;
+  size_t m_numberOfBooks;
+};
+
+typedef TradingLib::PriceBookBuilder<SecurityMock, 20> Builder;
+typedef TradingLib::PriceBookBuilder<SecurityMock, 3> ShallowBuilder;
+}  // namespace
+
+TEST(TradingLib_PriceBookBuilder, Snapshot) {
+  SecurityMock security;
+  Builder builder(security);
+  const auto &time = pt::microsec_clock::local_time();
+
+  builder.Update(ORDER_SIDE_BID, 1.01, 1);
+  builder.Update(ORDER_SIDE_ASK, 1.02, 2);
+  builder.Flush(time, Milestones());
+  EXPECT_FALSE(builder.IsSynchronized());
+  EXPECT_FALSE(security.IsOnline());
+  EXPECT_EQ(0, security.GetNumberOfBooks());
+
+  builder.StartSnapshot();
+  builder.Update(ORDER_SIDE_BID, 1.01, 1);
+  builder.Flush(time, Milestones());
+  EXPECT_TRUE(builder.IsSynchronized());
+  // Ask side is empty:
+  EXPECT_FALSE(security.IsOnline());
+  EXPECT_EQ(0, security.GetNumberOfBooks());
+
+  builder.Update(ORDER_SIDE_ASK, 1.03, 3);
+  builder.Update(ORDER_SIDE_ASK, 1.02, 2);
+  builder.Flush(time, Milestones());
+  EXPECT_TRUE(security.IsOnline());
+  ASSERT_EQ(1, security.GetNumberOfBooks());
+  EXPECT_EQ(time, security.GetBook().GetTime());
+  ASSERT_EQ(1, security.GetBook().GetBid().GetSize());
+  EXPECT_EQ(1.01, security.GetBook().GetBid().GetTop().GetPrice());
+  EXPECT_EQ(1, security.GetBook().GetBid().GetTop().GetQty());
+  ASSERT_EQ(2, security.GetBook().GetAsk().GetSize());
+  EXPECT_EQ(1.02, security.GetBook().GetAsk().GetTop().GetPrice());
+  EXPECT_EQ(2, security.GetBook().GetAsk().GetTop().GetQty());
+
+  // Not changed:
+  builder.Update(ORDER_SIDE_ASK, 1.04, 0);
+  builder.Flush(time, Milestones());
+  EXPECT_EQ(1, security.GetNumberOfBooks());
+
+  builder.Update(ORDER_SIDE_ASK, 1.02, 0);
+  builder.Flush(time, Milestones());
+  ASSERT_EQ(2, security.GetNumberOfBooks());
+  ASSERT_EQ(1, security.GetBook().GetAsk().GetSize());
+  EXPECT_EQ(1.03, security.GetBook().GetAsk().GetTop().GetPrice());
+}
+
+TEST(TradingLib_PriceBookBuilder, SequenceNumbers) {
+  SecurityMock security;
+  Builder builder(security);
+  const auto &time = pt::microsec_clock::local_time();
+
+  EXPECT_EQ(Builder::DIFF_CHECK_RESULT_SKIP, builder.CheckSequenceNumber(10));
+
+  builder.StartSnapshot(10);
+  builder.Update(ORDER_SIDE_BID, 1.01, 1);
+  builder.Update(ORDER_SIDE_ASK, 1.02, 1);
+  builder.Flush(time, Milestones());
+  EXPECT_TRUE(security.IsOnline());
+
+  EXPECT_EQ(Builder::DIFF_CHECK_RESULT_SKIP, builder.CheckSequenceNumber(9));
+  EXPECT_EQ(Builder::DIFF_CHECK_RESULT_SKIP, builder.CheckSequenceNumber(10));
+  EXPECT_EQ(Builder::DIFF_CHECK_RESULT_ACTUAL,
+            builder.CheckSequenceNumber(11));
+  // Range which overlaps the last applied diff:
+  EXPECT_EQ(Builder::DIFF_CHECK_RESULT_ACTUAL,
+            builder.CheckSequenceNumber(9, 15));
+  EXPECT_EQ(15, *builder.GetSequenceNumber());
+  EXPECT_EQ(Builder::DIFF_CHECK_RESULT_ACTUAL,
+            builder.CheckSequenceNumber(16, 20));
+
+  EXPECT_EQ(Builder::DIFF_CHECK_RESULT_GAP, builder.CheckSequenceNumber(22));
+  EXPECT_FALSE(builder.IsSynchronized());
+  EXPECT_FALSE(security.IsOnline());
+  EXPECT_TRUE(builder.GetBook().GetBid().IsEmpty());
+  EXPECT_EQ(Builder::DIFF_CHECK_RESULT_SKIP, builder.CheckSequenceNumber(21));
+  EXPECT_EQ(Builder::DIFF_CHECK_RESULT_SKIP, builder.CheckSequenceNumber(23));
+  builder.Flush(time, Milestones());
+  EXPECT_FALSE(security.IsOnline());
+
+  builder.StartSnapshot(30);
+  builder.Update(ORDER_SIDE_BID, 1.01, 1);
+  builder.Update(ORDER_SIDE_ASK, 1.02, 1);
+  builder.Flush(time, Milestones());
+  EXPECT_TRUE(security.IsOnline());
+  EXPECT_EQ(Builder::DIFF_CHECK_RESULT_ACTUAL,
+            builder.CheckSequenceNumber(31));
+}
+
+TEST(TradingLib_PriceBookBuilder, Stop) {
+  SecurityMock security;
+  Builder builder(security);
+
+  builder.StartSnapshot();
+  builder.Update(ORDER_SIDE_BID, 1.01, 1);
+  builder.Update(ORDER_SIDE_ASK, 1.02, 1);
+  builder.Flush(pt::microsec_clock::local_time(), Milestones());
+  EXPECT_TRUE(security.IsOnline());
+  EXPECT_EQ(Builder::DIFF_CHECK_RESULT_ACTUAL,
+            builder.CheckSequenceNumber(100));
+
+  builder.Stop();
+  EXPECT_FALSE(builder.IsSynchronized());
+  EXPECT_FALSE(security.IsOnline());
+  EXPECT_TRUE(builder.GetBook().GetBid().IsEmpty());
+  EXPECT_TRUE(builder.GetBook().GetAsk().IsEmpty());
+}
+
+TEST(TradingLib_PriceBookBuilder, DeleteOutOfDepth) {
+  SecurityMock security;
+  ShallowBuilder builder(security);
+  const auto &time = pt::microsec_clock::local_time();
+
+  builder.StartSnapshot();
+  for (size_t i = 1; i <= 8; ++i) {
+    builder.Update(ORDER_SIDE_BID, 2 - 0.01 * i, static_cast<double>(i));
+    builder.Update(ORDER_SIDE_ASK, 2 + 0.01 * i, static_cast<double>(i));
+  }
+  EXPECT_EQ(3, builder.GetBook().GetBid().GetSize());
+  EXPECT_EQ(5, builder.GetNumberOfDeepLevels(ORDER_SIDE_BID));
+  EXPECT_EQ(5, builder.GetNumberOfDeepLevels(ORDER_SIDE_ASK));
+
+  // Inserts the best level, so the worst level goes out of the depth:
+  builder.Update(ORDER_SIDE_BID, 1.995, 10);
+  EXPECT_EQ(6, builder.GetNumberOfDeepLevels(ORDER_SIDE_BID));
+  // Changes and deletes levels which are out of the depth:
+  builder.Update(ORDER_SIDE_BID, 1.96, 40);
+  builder.Update(ORDER_SIDE_BID, 1.95, 0);
+  builder.AddQty(ORDER_SIDE_BID, 1.94, 0.5);
+  builder.AddQty(ORDER_SIDE_BID, 1.93, -7);
+  EXPECT_EQ(4, builder.GetNumberOfDeepLevels(ORDER_SIDE_BID));
+
+  // Deletes all levels of the depth and more:
+  builder.Update(ORDER_SIDE_BID, 1.995, 0);
+  builder.Update(ORDER_SIDE_BID, 1.99, 0);
+  builder.AddQty(ORDER_SIDE_BID, 1.98, -2);
+  builder.Update(ORDER_SIDE_BID, 1.97, 0);
+  for (size_t i = 1; i <= 5; ++i) {
+    builder.Update(ORDER_SIDE_ASK, 2 + 0.01 * i, 0);
+  }
+  builder.Flush(time, Milestones());
+  ASSERT_TRUE(security.IsOnline());
+
+  const auto &bid = security.GetBook().GetBid();
+  ASSERT_EQ(3, bid.GetSize());
+  EXPECT_EQ(1.96, bid.GetLevel(0).GetPrice());
+  EXPECT_EQ(40, bid.GetLevel(0).GetQty());
+  EXPECT_EQ(1.94, bid.GetLevel(1).GetPrice());
+  EXPECT_EQ(6.5, bid.GetLevel(1).GetQty());
+  EXPECT_EQ(1.92, bid.GetLevel(2).GetPrice());
+  EXPECT_EQ(8, bid.GetLevel(2).GetQty());
+  EXPECT_EQ(0, builder.GetNumberOfDeepLevels(ORDER_SIDE_BID));
+
+  const auto &ask = security.GetBook().GetAsk();
+  ASSERT_EQ(3, ask.GetSize());
+  EXPECT_EQ(2.06, ask.GetLevel(0).GetPrice());
+  EXPECT_EQ(2.07, ask.GetLevel(1).GetPrice());
+  EXPECT_EQ(2.08, ask.GetLevel(2).GetPrice());
+  EXPECT_EQ(8, ask.GetLevel(2).GetQty());
+  EXPECT_EQ(0, builder.GetNumberOfDeepLevels(ORDER_SIDE_ASK));
+
+  // New snapshot drops levels which are out of the depth:
+  builder.StartSnapshot();
+  EXPECT_EQ(0, builder.GetNumberOfDeepLevels(ORDER_SIDE_BID));
+}
+
+TEST(TradingLib_PriceBookBuilder, ReduceDeepLevelToZero) {
+  SecurityMock security;
+  ShallowBuilder builder(security);
+
+  builder.StartSnapshot();
+  for (size_t i = 1; i <= 3; ++i) {
+    builder.Update(ORDER_SIDE_BID, 2 - 0.01 * i, 1);
+  }
+  builder.AddQty(ORDER_SIDE_BID, 1.9, 1);
+  ASSERT_EQ(1, builder.GetNumberOfDeepLevels(ORDER_SIDE_BID));
+
+  // 1 - 0.7 - 0.2 - 0.1 is not exactly zero in floating point, but the level is
+  // deleted at the deep side as it's deleted at the flat side:
+  builder.AddQty(ORDER_SIDE_BID, 1.9, -0.7);
+  builder.AddQty(ORDER_SIDE_BID, 1.9, -0.2);
+  builder.AddQty(ORDER_SIDE_BID, 1.9, -0.1);
+  EXPECT_EQ(0, builder.GetNumberOfDeepLevels(ORDER_SIDE_BID));
+  builder.AddQty(ORDER_SIDE_BID, 1.98, -0.7);
+  builder.AddQty(ORDER_SIDE_BID, 1.98, -0.2);
+  builder.AddQty(ORDER_SIDE_BID, 1.98, -0.1);
+  EXPECT_EQ(2, builder.GetBook().GetBid().GetSize());
+}
@@ -133,3 +133,19 @@ void WebSocketMarketDataSource::Send(const ptr::ptree &message) {
   }
   m_pimpl->m_connection->Write(message);
 }
+
+void WebSocketMarketDataSource::Reconnect() {
+  GetContext().GetTimer().Schedule(
+      [this]() {
+        boost::mutex::scoped_lock lock(m_pimpl->m_connectionMutex);
+        if (!m_pimpl->m_connection) {
+          // Already reconnecting.
+          return;
+        }
+        GetLog().Info("Closing connection to reconnect...");
+        auto connection = std::move(m_pimpl->m_connection);
+        m_pimpl->ScheduleReconnect();
+        lock.unlock();
+      },
+      m_pimpl->m_timerScope);
+}
@@ -37,6 +37,13 @@ class WebSocketMarketDataSource : public MarketDataSource {
  protected:
   void Send(const boost::property_tree::ptree &);
 
+  //! Closes the current connection and connects again.
+  /**
+   * Asynchronous, could be called from the message handler, for example, to
+   * get new price book snapshots after the lost update.
+   */
+  void Reconnect();
+
  private:
   virtual std::unique_ptr<Connection> CreateConnection() const = 0;
 